@@ -4,19 +4,29 @@
 #include <vector>
 #include <memory>
 #include <cmath>
+#include <cstdint>
 #include "tensors/tensor.h"
+#include "autograd/grad_buffer.h"
+#include "utils/parallel.h"
 
+// Saves one bit per element (input > 0) instead of the whole input tensor.
+// parent_input is the input's gradient edge (see gradient_edge), so the input's
+// buffer is not kept alive by the graph. The same holds for tanh, sigmoid and
+// softmax, which read only their output.
 template<typename T>
 struct ReluBackward : public Function<T> {
     std::shared_ptr<Tensor<T>> parent_input;
+    std::vector<uint32_t> mask;
 
-    ReluBackward(std::shared_ptr<Tensor<T>> a) : parent_input(a) {}
+    ReluBackward(std::shared_ptr<Tensor<T>> a, std::vector<uint32_t> positive_mask)
+        : parent_input(a), mask(std::move(positive_mask)) {}
 
     void backward(std::shared_ptr<Tensor<T>> grad_out) override {
         if (parent_input->requires_grad) {
             auto grad_a_data = std::vector<T>(grad_out->size);
             for (int i = 0; i < grad_out->size; ++i) {
-                grad_a_data[i] = (parent_input->data[i] > 0) ? grad_out->data[i] : static_cast<T>(0);
+                bool positive = (mask[i >> 5] >> (i & 31)) & 1u;
+                grad_a_data[i] = positive ? grad_out->data[i] : static_cast<T>(0);
             }
             
             auto grad_a = std::make_shared<Tensor<T>>(grad_a_data, grad_out->shape);
@@ -28,25 +38,27 @@ struct ReluBackward : public Function<T> {
                     parent_input->grad->data[i] += grad_a->data[i];
                 }
             }
-            if (parent_input->grad_fn) {
-                parent_input->grad_fn->backward(grad_a);
-            }
         }
     }
 };
 
+// The output owns this node, so it is held weakly to avoid a reference cycle;
+// it is always alive while its grad_fn runs.
 template<typename T>
 struct TanhBackward : public Function<T> {
     std::shared_ptr<Tensor<T>> parent_input;
-    std::shared_ptr<Tensor<T>> parent_output;
+    std::weak_ptr<Tensor<T>> parent_output;
+
+    TanhBackward(std::shared_ptr<Tensor<T>> a, std::weak_ptr<Tensor<T>> b) : parent_input(a), parent_output(b) {}
 
-    TanhBackward(std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) : parent_input(a), parent_output(b) {}
+    bool reads_output() const override { return true; }
 
     void backward(std::shared_ptr<Tensor<T>> grad_out) override {
         if (parent_input->requires_grad) {
+            auto output = parent_output.lock();
             auto grad_a_data = std::vector<T>(grad_out->size);
             for (int i = 0; i < grad_out->size; ++i) {
-                grad_a_data[i] = grad_out->data[i] * (static_cast<T>(1) - (parent_output->data[i] * parent_output->data[i]));
+                grad_a_data[i] = grad_out->data[i] * (static_cast<T>(1) - (output->data[i] * output->data[i]));
             }
             
             auto grad_a = std::make_shared<Tensor<T>>(grad_a_data, grad_out->shape);
@@ -58,25 +70,26 @@ struct TanhBackward : public Function<T> {
                     parent_input->grad->data[i] += grad_a->data[i];
                 }
             }
-            if (parent_input->grad_fn) {
-                parent_input->grad_fn->backward(grad_a);
-            }
         }
     }
 };
 
 template<typename T>
 struct SigmoidBackward : public Function<T> {
-    std::shared_ptr<Tensor<T>> parent_output;
+    std::shared_ptr<Tensor<T>> parent_input;
+    std::weak_ptr<Tensor<T>> parent_output;
 
-    SigmoidBackward(std::shared_ptr<Tensor<T>> output) : parent_output(output) {}
+    SigmoidBackward(std::shared_ptr<Tensor<T>> input, std::weak_ptr<Tensor<T>> output)
+        : parent_input(input), parent_output(output) {}
+
+    bool reads_output() const override { return true; }
 
     void backward(std::shared_ptr<Tensor<T>> grad_out) override {
-        auto parent_input = parent_output->parents[0];
         if (parent_input->requires_grad) {
+            auto output = parent_output.lock();
             auto grad_a_data = std::vector<T>(grad_out->size);
             for (int i = 0; i < grad_out->size; ++i) {
-                T sig_out = parent_output->data[i];
+                T sig_out = output->data[i];
                 grad_a_data[i] = grad_out->data[i] * (sig_out * (static_cast<T>(1) - sig_out));
             }
             
@@ -89,11 +102,38 @@ struct SigmoidBackward : public Function<T> {
                     parent_input->grad->data[i] += grad_a->data[i];
                 }
             }
-            if (parent_input->grad_fn) {
-                parent_input->grad_fn->backward(grad_a);
-            }
         }
     }
 };
 
+// Softmax over rows of length dim: grad_in = s * (grad_out - sum_j grad_out_j * s_j).
+template<typename T>
+struct SoftmaxBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+    std::weak_ptr<Tensor<T>> parent_output;
+    int dim;
+
+    SoftmaxBackward(std::shared_ptr<Tensor<T>> input, std::weak_ptr<Tensor<T>> output, int d)
+        : parent_input(input), parent_output(output), dim(d) {}
+
+    bool reads_output() const override { return true; }
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        T* grad = grad_buffer(parent_input);
+        if (!grad) return;
+        auto output = parent_output.lock();
+        const T* s = output->data.get();
+        const T* go = grad_out->data.get();
+        int rows = parent_input->size / dim;
+        parallel_for(0, rows, std::max(1, 4096 / dim), [&](int begin, int end) {
+            for (int r = begin; r < end; ++r) {
+                size_t offset = static_cast<size_t>(r) * dim;
+                T dot = 0;
+                for (int j = 0; j < dim; ++j) dot += go[offset + j] * s[offset + j];
+                for (int j = 0; j < dim; ++j) grad[offset + j] += s[offset + j] * (go[offset + j] - dot);
+            }
+        });
+    }
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef AUTOGRAD_ATTENTION_H
+#define AUTOGRAD_ATTENTION_H
+
+#include <vector>
+#include <memory>
+#include "tensors/tensor.h"
+#include "tensors/tensor_attention.h"
+#include "autograd/grad_buffer.h"
+#include "utils/parallel.h"
+
+// Keeps q, k, v, the output and one logsumexp per query row; the attention
+// probabilities are recomputed tile by tile.
+template<typename T>
+struct AttentionBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> query, key, value, mask;
+    std::weak_ptr<Tensor<T>> output;
+    std::vector<T> lse;
+    AttentionGeometry geometry;
+    int heads;
+
+    AttentionBackward(std::shared_ptr<Tensor<T>> q, std::shared_ptr<Tensor<T>> k, std::shared_ptr<Tensor<T>> v,
+                      std::shared_ptr<Tensor<T>> m, std::weak_ptr<Tensor<T>> out, std::vector<T> saved_lse,
+                      AttentionGeometry g, int h)
+        : query(q), key(k), value(v), mask(m), output(out), lse(std::move(saved_lse)), geometry(g), heads(h) {}
+
+    bool reads_output() const override { return true; }
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        auto out = output.lock();
+        if (!out) throw std::runtime_error("ERROR: Attention output was freed before backward.");
+        T* dq = grad_buffer(query);
+        T* dk = grad_buffer(key);
+        T* dv = grad_buffer(value);
+        const AttentionGeometry& g = geometry;
+        size_t q_head = static_cast<size_t>(g.q_len) * g.head_dim;
+        size_t k_head = static_cast<size_t>(g.k_len) * g.head_dim;
+        size_t v_head = static_cast<size_t>(g.k_len) * g.value_dim;
+        size_t o_head = static_cast<size_t>(g.q_len) * g.value_dim;
+
+        parallel_for(0, heads, 1, [&](int begin, int end) {
+            for (int h = begin; h < end; ++h) {
+                attention_backward_head(query->data.get() + h * q_head, key->data.get() + h * k_head,
+                                        value->data.get() + h * v_head, mask ? mask->data.get() : nullptr,
+                                        out->data.get() + h * o_head, grad_out->data.get() + h * o_head,
+                                        lse.data() + static_cast<size_t>(h) * g.q_len, g,
+                                        dq ? dq + h * q_head : nullptr, dk ? dk + h * k_head : nullptr,
+                                        dv ? dv + h * v_head : nullptr);
+            }
+        });
+    }
+};
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef AUTOGRAD_CONV_H
+#define AUTOGRAD_CONV_H
+
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include "tensors/tensor.h"
+#include "tensors/tensor_conv.h"
+#include "utils/parallel.h"
+
+template<typename T>
+struct Conv2dBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> input, weight, bias;
+    int stride, padding, dilation, groups;
+
+    Conv2dBackward(std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> w, std::shared_ptr<Tensor<T>> b,
+                   int s, int p, int d, int g)
+        : input(x), weight(w), bias(b), stride(s), padding(p), dilation(d), groups(g) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        int batch = input->shape[0];
+        int in_c = input->shape[1];
+        int out_c = weight->shape[0];
+        int in_per_group = in_c / groups;
+        int out_per_group = out_c / groups;
+
+        Conv2dGeometry g(in_per_group, input->shape[2], input->shape[3],
+                         weight->shape[2], weight->shape[3], stride, padding, dilation);
+        ConvKernel kernel = select_conv_kernel(g, out_per_group);
+        int plane = g.height * g.width;
+        int pixels = g.out_pixels();
+        int weight_group = out_per_group * g.col_rows();
+
+        std::shared_ptr<Tensor<T>> grad_x, grad_w;
+        if (input->requires_grad) {
+            grad_x = std::make_shared<Tensor<T>>(input->shape, false);
+            std::fill(grad_x->data.get(), grad_x->data.get() + grad_x->size, static_cast<T>(0));
+        }
+        if (weight->requires_grad) {
+            grad_w = std::make_shared<Tensor<T>>(weight->shape, false);
+            std::fill(grad_w->data.get(), grad_w->data.get() + grad_w->size, static_cast<T>(0));
+        }
+
+        // Tasks are (batch slice, group) pairs. grad_x blocks are disjoint per
+        // (image, group); grad_w is summed into one buffer per slice and the
+        // slices are added in order afterwards. The slice count depends only on
+        // the shapes, so the result does not change with the thread count.
+        int slices = batch;
+        if (grad_w) slices = std::max(1, std::min({batch, 16, (1 << 22) / std::max(1, weight->size)}));
+        std::vector<T> partials(grad_w ? static_cast<size_t>(slices - 1) * weight->size : 0, static_cast<T>(0));
+        int task_work = std::max(1, weight_group * pixels * (batch / slices));
+        parallel_for(0, slices * groups, std::max(1, 65536 / task_work), [&](int begin, int end) {
+            for (int t = begin; t < end; ++t) {
+                int s = t / groups;
+                int gi = t % groups;
+                T* gw_slice = !grad_w ? nullptr
+                            : s == 0 ? grad_w->data.get()
+                            : partials.data() + static_cast<size_t>(s - 1) * weight->size;
+                for (int n = s * batch / slices; n < (s + 1) * batch / slices; ++n) {
+                    const T* x_group = input->data.get() + (n * in_c + gi * in_per_group) * plane;
+                    const T* go_group = grad_out->data.get() + (n * out_c + gi * out_per_group) * pixels;
+                    T* gx_group = grad_x ? grad_x->data.get() + (n * in_c + gi * in_per_group) * plane : nullptr;
+                    T* gw_group = gw_slice ? gw_slice + gi * weight_group : nullptr;
+                    conv2d_backward_group(x_group, weight->data.get() + gi * weight_group, go_group,
+                                          gx_group, gw_group, g, out_per_group, kernel);
+                }
+            }
+        });
+        if (grad_w && slices > 1) {
+            parallel_for(0, weight->size, 32768, [&](int begin, int end) {
+                for (int s = 1; s < slices; ++s) {
+                    const T* part = partials.data() + static_cast<size_t>(s - 1) * weight->size;
+                    for (int i = begin; i < end; ++i) grad_w->data[i] += part[i];
+                }
+            });
+        }
+
+        if (grad_x) {
+            if (!input->grad) {
+                input->grad = grad_x;
+            } else {
+                for (int i = 0; i < input->grad->size; ++i) input->grad->data[i] += grad_x->data[i];
+            }
+        }
+        if (grad_w) {
+            if (!weight->grad) {
+                weight->grad = grad_w;
+            } else {
+                for (int i = 0; i < weight->grad->size; ++i) weight->grad->data[i] += grad_w->data[i];
+            }
+        }
+        if (bias && bias->requires_grad) {
+            auto grad_b = std::make_shared<Tensor<T>>(bias->shape, false);
+            parallel_for(0, out_c, std::max(1, 16384 / std::max(1, batch * pixels)), [&](int begin, int end) {
+                for (int oc = begin; oc < end; ++oc) {
+                    T acc = static_cast<T>(0);
+                    for (int n = 0; n < batch; ++n) {
+                        const T* go = grad_out->data.get() + (n * out_c + oc) * pixels;
+                        for (int i = 0; i < pixels; ++i) acc += go[i];
+                    }
+                    grad_b->data[oc] = acc;
+                }
+            });
+            if (!bias->grad) {
+                bias->grad = grad_b;
+            } else {
+                for (int i = 0; i < bias->grad->size; ++i) bias->grad->data[i] += grad_b->data[i];
+            }
+        }
+    }
+};
+
+template<typename T>
+struct MaxPool2dBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+    std::vector<int> max_indices;
+
+    MaxPool2dBackward(std::shared_ptr<Tensor<T>> input, std::vector<int> indices)
+        : parent_input(input), max_indices(std::move(indices)) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        if (parent_input->requires_grad) {
+            auto grad_a = std::make_shared<Tensor<T>>(parent_input->shape, false);
+            std::fill(grad_a->data.get(), grad_a->data.get() + grad_a->size, static_cast<T>(0));
+
+            int planes = parent_input->shape[0] * parent_input->shape[1];
+            int in_plane = parent_input->shape[2] * parent_input->shape[3];
+            int out_plane = grad_out->shape[2] * grad_out->shape[3];
+            for (int p = 0; p < planes; ++p) {
+                for (int i = 0; i < out_plane; ++i) {
+                    int idx = max_indices[p * out_plane + i];
+                    if (idx >= 0) grad_a->data[p * in_plane + idx] += grad_out->data[p * out_plane + i];
+                }
+            }
+
+            if (!parent_input->grad) {
+                parent_input->grad = grad_a;
+            } else {
+                for (int i = 0; i < parent_input->grad->size; ++i) {
+                    parent_input->grad->data[i] += grad_a->data[i];
+                }
+            }
+        }
+    }
+};
+
+template<typename T>
+struct AvgPool2dBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+    int kernel_size, stride, padding;
+
+    AvgPool2dBackward(std::shared_ptr<Tensor<T>> input, int k, int s, int p)
+        : parent_input(input), kernel_size(k), stride(s), padding(p) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        if (parent_input->requires_grad) {
+            auto grad_a = std::make_shared<Tensor<T>>(parent_input->shape, false);
+            std::fill(grad_a->data.get(), grad_a->data.get() + grad_a->size, static_cast<T>(0));
+
+            Conv2dGeometry g(1, parent_input->shape[2], parent_input->shape[3],
+                             kernel_size, kernel_size, stride, padding, 1);
+            int planes = parent_input->shape[0] * parent_input->shape[1];
+            int in_plane = g.height * g.width;
+            int out_plane = g.out_pixels();
+            for (int p = 0; p < planes; ++p) {
+                avg_pool2d_plane_backward(grad_out->data.get() + p * out_plane, grad_a->data.get() + p * in_plane, g);
+            }
+
+            if (!parent_input->grad) {
+                parent_input->grad = grad_a;
+            } else {
+                for (int i = 0; i < parent_input->grad->size; ++i) {
+                    parent_input->grad->data[i] += grad_a->data[i];
+                }
+            }
+        }
+    }
+};
+
+#endif
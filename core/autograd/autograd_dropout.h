@@ -0,0 +1,44 @@
+#ifndef AUTOGRAD_DROPOUT_H
+#define AUTOGRAD_DROPOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "tensors/tensor.h"
+#include "autograd/grad_buffer.h"
+#include "utils/random.h"
+
+// out[i] (+)= in[i] * mask[i], where mask[i] is scale when word i of the draw
+// is at least threshold and 0 otherwise. Forward and backward call it with the
+// same state, so the mask is regenerated instead of stored.
+template<typename T>
+void dropout_apply(const PhiloxState& state, const T* in, T* out, size_t n, uint32_t threshold, T scale, bool accumulate) {
+    philox_for_each_batch(state, (n + 3) / 4, [&](uint64_t first, const uint32_t (&words)[4][PHILOX_BATCH]) {
+        size_t base = static_cast<size_t>(first) * 4;
+        size_t count = std::min(n - base, static_cast<size_t>(4 * PHILOX_BATCH));
+        for (size_t i = 0; i < count; ++i) {
+            T m = words[i % 4][i / 4] >= threshold ? scale : static_cast<T>(0);
+            T v = in[base + i] * m;
+            out[base + i] = accumulate ? out[base + i] + v : v;
+        }
+    });
+}
+
+template<typename T>
+struct DropoutBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> input;
+    PhiloxState state;
+    uint32_t threshold;
+    T scale;
+
+    DropoutBackward(std::shared_ptr<Tensor<T>> x, const PhiloxState& state, uint32_t threshold, T scale)
+        : input(x), state(state), threshold(threshold), scale(scale) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        if (T* gx = grad_buffer(input)) {
+            dropout_apply(state, grad_out->data.get(), gx, static_cast<size_t>(input->size), threshold, scale, true);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef AUTOGRAD_EMBEDDING_H
+#define AUTOGRAD_EMBEDDING_H
+
+#include <vector>
+#include <memory>
+#include "tensors/tensor.h"
+#include "tensors/tensor_sparse_grad.h"
+#include "utils/parallel.h"
+
+// The gradient of a lookup only touches the rows that were looked up. In sparse
+// mode it is stored in weight->sparse_grad as coalesced (indices, rows) and the
+// dense weight->grad is never allocated.
+template<typename T>
+struct EmbeddingBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> weight;
+    std::vector<int> indices;
+    bool sparse;
+
+    EmbeddingBackward(std::shared_ptr<Tensor<T>> w, std::vector<int> idx, bool s)
+        : weight(w), indices(std::move(idx)), sparse(s) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        if (!weight->requires_grad) return;
+        int dim = weight->shape[1];
+
+        if (sparse) {
+            accumulate_sparse_grad(*weight, indices, grad_out->data.get(), dim);
+            return;
+        }
+
+        auto rows = coalesce_rows(indices, grad_out->data.get(), dim);
+        if (!weight->grad) {
+            weight->grad = std::make_shared<Tensor<T>>(weight->shape, false);
+            std::fill(weight->grad->data.get(), weight->grad->data.get() + weight->grad->size, static_cast<T>(0));
+        }
+        T* grad = weight->grad->data.get();
+        const T* values = rows->values->data.get();
+        parallel_for(0, rows->nnz(), std::max(1, 16384 / dim), [&](int begin, int end) {
+            for (int k = begin; k < end; ++k) {
+                T* dst = grad + static_cast<size_t>(rows->indices[k]) * dim;
+                const T* src = values + static_cast<size_t>(k) * dim;
+                for (int j = 0; j < dim; ++j) dst[j] += src[j];
+            }
+        });
+    }
+};
+
+#endif
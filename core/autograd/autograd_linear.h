@@ -0,0 +1,97 @@
+#ifndef AUTOGRAD_LINEAR_H
+#define AUTOGRAD_LINEAR_H
+
+#include <memory>
+#include "tensors/tensor.h"
+#include "tensors/tensor_gemm.h"
+#include "autograd/grad_buffer.h"
+#include "utils/parallel.h"
+
+// y = x W^T + b as one node: dx = dy W, dW = dy^T x, db = column sums of dy,
+// each accumulated straight into the gradient buffers.
+template<typename T>
+struct LinearBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> input, weight, bias;
+
+    LinearBackward(std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> w, std::shared_ptr<Tensor<T>> b)
+        : input(x), weight(w), bias(b) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        int rows = input->shape[0];
+        int in_f = weight->shape[1];
+        int out_f = weight->shape[0];
+        const T* go = grad_out->data.get();
+
+        if (T* gx = grad_buffer(input)) {
+            gemm(false, false, rows, in_f, out_f, go, out_f, weight->data.get(), in_f, gx, in_f, true);
+        }
+        if (T* gw = grad_buffer(weight)) {
+            gemm(true, false, out_f, in_f, rows, go, out_f, input->data.get(), in_f, gw, in_f, true);
+        }
+        if (T* gb = grad_buffer(bias)) {
+            for (int r = 0; r < rows; ++r) {
+                const T* row = go + static_cast<size_t>(r) * out_f;
+                for (int j = 0; j < out_f; ++j) gb[j] += row[j];
+            }
+        }
+    }
+};
+
+// y[m] = x[m] W[m]^T + b[m] for every member m of an ensemble, as one node.
+// A shared input [rows x in] feeds every member, so its gradient sums dy[m] W[m]
+// over the members; it is split by rows so threads never write the same row.
+template<typename T>
+struct EnsembleLinearBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> input, weight, bias;
+    int grain;
+
+    EnsembleLinearBackward(std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> w, std::shared_ptr<Tensor<T>> b, int grain)
+        : input(x), weight(w), bias(b), grain(grain) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        int members = weight->shape[0];
+        int out_f = weight->shape[1];
+        int in_f = weight->shape[2];
+        bool shared = input->ndim == 2;
+        int rows = input->shape[input->ndim - 2];
+        size_t x_step = shared ? 0 : static_cast<size_t>(rows) * in_f;
+        size_t w_step = static_cast<size_t>(out_f) * in_f;
+        size_t y_step = static_cast<size_t>(rows) * out_f;
+        const T* go = grad_out->data.get();
+        const T* x = input->data.get();
+        const T* w = weight->data.get();
+
+        T* gx = grad_buffer(input);
+        T* gw = grad_buffer(weight);
+        T* gb = grad_buffer(bias);
+        parallel_for(0, members, grain, [&](int begin, int end) {
+            for (int m = begin; m < end; ++m) {
+                const T* go_m = go + m * y_step;
+                if (gx && !shared) {
+                    gemm(false, false, rows, in_f, out_f, go_m, out_f, w + m * w_step, in_f, gx + m * x_step, in_f, true);
+                }
+                if (gw) {
+                    gemm(true, false, out_f, in_f, rows, go_m, out_f, x + m * x_step, in_f, gw + m * w_step, in_f, true);
+                }
+                if (gb) {
+                    T* gb_m = gb + static_cast<size_t>(m) * out_f;
+                    for (int r = 0; r < rows; ++r) {
+                        const T* row = go_m + static_cast<size_t>(r) * out_f;
+                        for (int j = 0; j < out_f; ++j) gb_m[j] += row[j];
+                    }
+                }
+            }
+        });
+        if (gx && shared) {
+            int row_grain = std::max(1, rows / std::max(1, get_num_threads()));
+            parallel_for(0, rows, row_grain, [&](int begin, int end) {
+                for (int m = 0; m < members; ++m) {
+                    gemm(false, false, end - begin, in_f, out_f, go + m * y_step + static_cast<size_t>(begin) * out_f, out_f,
+                         w + m * w_step, in_f, gx + static_cast<size_t>(begin) * in_f, in_f, true);
+                }
+            });
+        }
+    }
+};
+
+#endif
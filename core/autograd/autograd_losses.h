@@ -32,10 +32,6 @@ struct MseLossBackward : public Function<T> {
                     y_pred->grad->data[i] += grad_y_hat->data[i];
                 }
             }
-
-            if (y_pred->grad_fn) {
-                y_pred->grad_fn->backward(grad_y_hat);
-            }
         }
     }
 };
@@ -67,10 +63,6 @@ struct MaeLossBackward : public Function<T> {
                     y_pred->grad->data[i] += grad_y_hat->data[i];
                 }
             }
-
-            if (y_pred->grad_fn) {
-                y_pred->grad_fn->backward(grad_y_hat);
-            }
         }
     }
 };
@@ -103,10 +95,6 @@ struct BceLossBackward : public Function<T> {
                     y_pred->grad->data[i] += grad_y_hat->data[i];
                 }
             }
-
-            if (y_pred->grad_fn) {
-                y_pred->grad_fn->backward(grad_y_hat);
-            }
         }
     }
 };
@@ -0,0 +1,146 @@
+#ifndef AUTOGRAD_MATH_H
+#define AUTOGRAD_MATH_H
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/vec_math.h"
+#include "autograd/grad_buffer.h"
+#include "utils/parallel.h"
+
+// grad_in += grad_out * f'(x) for elementwise math ops. derivative(begin, end, d)
+// fills d[0, end - begin) with f' over that range, one chunk per task, so the
+// derivative can use the same vectorized kernels as the forward pass.
+template<typename T, typename Derivative>
+void accumulate_math_grad(const std::shared_ptr<Tensor<T>>& input, const std::shared_ptr<Tensor<T>>& grad_out,
+                          Derivative derivative) {
+    T* grad = grad_buffer(input);
+    if (!grad) return;
+    const T* go = grad_out->data.get();
+    parallel_for(0, input->size, VEC_MATH_GRAIN, [&](int begin, int end) {
+        std::vector<T> d(end - begin);
+        derivative(begin, end, d.data());
+        for (int i = begin; i < end; ++i) grad[i] += go[i] * d[i - begin];
+    });
+}
+
+// Nodes that need the result hold it weakly: the output owns the node.
+template<typename T>
+struct SqrtBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+    std::weak_ptr<Tensor<T>> parent_output;
+
+    SqrtBackward(std::shared_ptr<Tensor<T>> input, std::weak_ptr<Tensor<T>> output)
+        : parent_input(input), parent_output(output) {}
+
+    bool reads_output() const override { return true; }
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        auto output = parent_output.lock();
+        const T* y = output->data.get();
+        accumulate_math_grad(parent_input, grad_out, [&](int begin, int end, T* d) {
+            for (int i = begin; i < end; ++i) d[i - begin] = static_cast<T>(0.5) / y[i];
+        });
+    }
+};
+
+template<typename T>
+struct LogBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+
+    LogBackward(std::shared_ptr<Tensor<T>> input) : parent_input(input) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        const T* x = parent_input->data.get();
+        accumulate_math_grad(parent_input, grad_out, [&](int begin, int end, T* d) {
+            for (int i = begin; i < end; ++i) d[i - begin] = static_cast<T>(1) / x[i];
+        });
+    }
+};
+
+template<typename T>
+struct ExpBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+    std::weak_ptr<Tensor<T>> parent_output;
+
+    ExpBackward(std::shared_ptr<Tensor<T>> input, std::weak_ptr<Tensor<T>> output)
+        : parent_input(input), parent_output(output) {}
+
+    bool reads_output() const override { return true; }
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        auto output = parent_output.lock();
+        const T* y = output->data.get();
+        accumulate_math_grad(parent_input, grad_out, [&](int begin, int end, T* d) {
+            std::copy(y + begin, y + end, d);
+        });
+    }
+};
+
+template<typename T>
+struct PowBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+    float exponent;
+
+    PowBackward(std::shared_ptr<Tensor<T>> input, float p) : parent_input(input), exponent(p) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        const T* x = parent_input->data.get();
+        const T p = static_cast<T>(exponent);
+        accumulate_math_grad(parent_input, grad_out, [&](int begin, int end, T* d) {
+            for (int i = begin; i < end; ++i) d[i - begin] = p * std::pow(x[i], p - static_cast<T>(1));
+        });
+    }
+};
+
+template<typename T>
+struct SinBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+
+    SinBackward(std::shared_ptr<Tensor<T>> input) : parent_input(input) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        const T* x = parent_input->data.get();
+        accumulate_math_grad(parent_input, grad_out, [&](int begin, int end, T* d) {
+            vec_cos(x + begin, d, end - begin);
+        });
+    }
+};
+
+template<typename T>
+struct CosBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+
+    CosBackward(std::shared_ptr<Tensor<T>> input) : parent_input(input) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        const T* x = parent_input->data.get();
+        accumulate_math_grad(parent_input, grad_out, [&](int begin, int end, T* d) {
+            vec_sin(x + begin, d, end - begin);
+            for (int i = 0; i < end - begin; ++i) d[i] = -d[i];
+        });
+    }
+};
+
+template<typename T>
+struct TanBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> parent_input;
+    std::weak_ptr<Tensor<T>> parent_output;
+
+    TanBackward(std::shared_ptr<Tensor<T>> input, std::weak_ptr<Tensor<T>> output)
+        : parent_input(input), parent_output(output) {}
+
+    bool reads_output() const override { return true; }
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        auto output = parent_output.lock();
+        const T* y = output->data.get();
+        accumulate_math_grad(parent_input, grad_out, [&](int begin, int end, T* d) {
+            for (int i = begin; i < end; ++i) d[i - begin] = static_cast<T>(1) + y[i] * y[i];
+        });
+    }
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef AUTOGRAD_NORM_H
+#define AUTOGRAD_NORM_H
+
+#include <vector>
+#include <memory>
+#include "tensors/tensor.h"
+#include "tensors/tensor_norm.h"
+#include "autograd/grad_buffer.h"
+
+template<typename T>
+struct LayerNormBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> input, gamma, beta;
+    std::vector<T> mean, inv_std;
+
+    LayerNormBackward(std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> g, std::shared_ptr<Tensor<T>> b,
+                      std::vector<T> m, std::vector<T> s)
+        : input(x), gamma(g), beta(b), mean(std::move(m)), inv_std(std::move(s)) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        int dim = input->shape.back();
+        int rows = input->size / dim;
+        layer_norm_backward(input->data.get(), gamma ? gamma->data.get() : nullptr, grad_out->data.get(),
+                            mean.data(), inv_std.data(),
+                            grad_buffer(input), grad_buffer(gamma), grad_buffer(beta), rows, dim);
+    }
+};
+
+template<typename T>
+struct BatchNormBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> input, gamma, beta;
+    std::vector<T> mean, inv_std;
+    bool training;
+
+    BatchNormBackward(std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> g, std::shared_ptr<Tensor<T>> b,
+                      std::vector<T> m, std::vector<T> s, bool train)
+        : input(x), gamma(g), beta(b), mean(std::move(m)), inv_std(std::move(s)), training(train) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        int batch = input->shape[0];
+        int channels = input->shape[1];
+        int length = input->ndim == 3 ? input->shape[2] : 1;
+        batch_norm_backward(input->data.get(), gamma ? gamma->data.get() : nullptr, grad_out->data.get(),
+                            mean.data(), inv_std.data(),
+                            grad_buffer(input), grad_buffer(gamma), grad_buffer(beta),
+                            batch, channels, length, training);
+    }
+};
+
+#endif
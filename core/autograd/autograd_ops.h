@@ -26,7 +26,6 @@ struct AddBackward : public Function<T> {
             } else {
                 for (int i = 0; i < a_parent->grad->size; ++i) a_parent->grad->data[i] += grad_a->data[i];
             }
-            if (a_parent->grad_fn) a_parent->grad_fn->backward(grad_a);
         }
         if (b_parent->requires_grad) {
             auto grad_b = std::make_shared<Tensor<T>>(unbroadcast(*grad_out, b_shape));
@@ -35,7 +34,6 @@ struct AddBackward : public Function<T> {
             } else {
                 for (int i = 0; i < b_parent->grad->size; ++i) b_parent->grad->data[i] += grad_b->data[i];
             }
-            if (b_parent->grad_fn) b_parent->grad_fn->backward(grad_b);
         }
     }
 };
@@ -56,7 +54,6 @@ struct SubBackward : public Function<T> {
             } else {
                 for (int i = 0; i < a_parent->grad->size; ++i) a_parent->grad->data[i] += grad_a->data[i];
             }
-            if (a_parent->grad_fn) a_parent->grad_fn->backward(grad_a);
         }
         if (b_parent->requires_grad) {
             auto neg_grad = tensor_scalar_mul(grad_out, static_cast<T>(-1));
@@ -66,7 +63,6 @@ struct SubBackward : public Function<T> {
             } else {
                 for (int i = 0; i < b_parent->grad->size; ++i) b_parent->grad->data[i] += grad_b->data[i];
             }
-            if (b_parent->grad_fn) b_parent->grad_fn->backward(neg_grad);
         }
     }
 };
@@ -88,7 +84,6 @@ struct MulBackward : public Function<T> {
             } else {
                 for (int i = 0; i < a_parent->grad->size; ++i) a_parent->grad->data[i] += grad_a->data[i];
             }
-            if (a_parent->grad_fn) a_parent->grad_fn->backward(grad_a);
         }
         if (b_parent->requires_grad) {
             auto grad_b_unsummed = tensor_mul(grad_out, a_parent);
@@ -98,7 +93,6 @@ struct MulBackward : public Function<T> {
             } else {
                 for (int i = 0; i < b_parent->grad->size; ++i) b_parent->grad->data[i] += grad_b->data[i];
             }
-            if (b_parent->grad_fn) b_parent->grad_fn->backward(grad_b);
         }
     }
 };
@@ -120,7 +114,6 @@ struct DivBackward : public Function<T> {
             } else {
                 for (int i = 0; i < a_parent->grad->size; ++i) a_parent->grad->data[i] += grad_a->data[i];
             }
-            if (a_parent->grad_fn) a_parent->grad_fn->backward(grad_a);
         }
         if (b_parent->requires_grad) {
             auto term1 = scalar_tensor_sub(static_cast<T>(0), a_parent);
@@ -133,7 +126,6 @@ struct DivBackward : public Function<T> {
             } else {
                 for (int i = 0; i < b_parent->grad->size; ++i) b_parent->grad->data[i] += grad_b->data[i];
             }
-            if (b_parent->grad_fn) b_parent->grad_fn->backward(grad_b);
         }
     }
 };
@@ -145,11 +137,10 @@ struct AddScalarBackward : public Function<T> {
     void backward(std::shared_ptr<Tensor<T>> grad_out) override {
         if (parent->requires_grad) {
             if (!parent->grad) {
-                parent->grad = grad_out;
+                parent->grad = std::make_shared<Tensor<T>>(to_vector(*grad_out), grad_out->shape);
             } else {
                 for (int i = 0; i < parent->size; ++i) parent->grad->data[i] += grad_out->data[i];
             }
-            if (parent->grad_fn) parent->grad_fn->backward(grad_out);
         }
     }
 };
@@ -161,11 +152,10 @@ struct SubScalarBackward : public Function<T> {
     void backward(std::shared_ptr<Tensor<T>> grad_out) override {
         if (parent->requires_grad) {
             if (!parent->grad) {
-                parent->grad = grad_out;
+                parent->grad = std::make_shared<Tensor<T>>(to_vector(*grad_out), grad_out->shape);
             } else {
                 for (int i = 0; i < parent->size; ++i) parent->grad->data[i] += grad_out->data[i];
             }
-            if (parent->grad_fn) parent->grad_fn->backward(grad_out);
         }
     }
 };
@@ -183,7 +173,6 @@ struct MulScalarBackward : public Function<T> {
             } else {
                 for (int i = 0; i < parent->size; ++i) parent->grad->data[i] += grad_a->data[i];
             }
-            if (parent->grad_fn) parent->grad_fn->backward(grad_a);
         }
     }
 };
@@ -201,7 +190,6 @@ struct DivScalarBackward : public Function<T> {
             } else {
                 for (int i = 0; i < parent->size; ++i) parent->grad->data[i] += grad_a->data[i];
             }
-            if (parent->grad_fn) parent->grad_fn->backward(grad_a);
         }
     }
 };
@@ -218,7 +206,6 @@ struct ScalarTensorSubBackward : public Function<T> {
             } else {
                 for (int i = 0; i < parent->size; ++i) parent->grad->data[i] += neg_grad->data[i];
             }
-            if (parent->grad_fn) parent->grad_fn->backward(neg_grad);
         }
     }
 };
@@ -239,7 +226,6 @@ struct ScalarTensorDivBackward : public Function<T> {
             } else {
                 for (int i = 0; i < parent->size; ++i) parent->grad->data[i] += grad_a->data[i];
             }
-            if (parent->grad_fn) parent->grad_fn->backward(grad_a);
         }
     }
 };
@@ -258,7 +244,6 @@ struct MatMulBackward : public Function<T> {
             } else {
                  for (int i = 0; i < a->grad->size; ++i) a->grad->data[i] += grad_a->data[i];
             }
-            if (a->grad_fn) a->grad_fn->backward(grad_a);
         }
         if (b->requires_grad) {
             auto a_transposed = transpose(a);
@@ -268,7 +253,6 @@ struct MatMulBackward : public Function<T> {
             } else {
                 for (int i = 0; i < b->grad->size; ++i) b->grad->data[i] += grad_b->data[i];
             }
-            if (b->grad_fn) b->grad_fn->backward(grad_b);
         }
     }
 };
@@ -286,7 +270,6 @@ struct TransposeBackward : public Function<T> {
             } else {
                 for(int i = 0; i < parent->grad->size; ++i) parent->grad->data[i] += grad_in->data[i];
             }
-            if (parent->grad_fn) parent->grad_fn->backward(grad_in);
         }
     }
 };
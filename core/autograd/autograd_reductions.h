@@ -38,10 +38,6 @@ struct SumBackward : public Function<T> {
                     parent_input->grad->data[i] += grad_a->data[i];
                 }
             }
-
-            if (parent_input->grad_fn) {
-                parent_input->grad_fn->backward(grad_a);
-            }
         }
     }
 };
@@ -87,10 +83,6 @@ struct MeanBackward : public Function<T> {
                     parent_input->grad->data[i] += grad_a->data[i];
                 }
             }
-
-            if (parent_input->grad_fn) {
-                parent_input->grad_fn->backward(grad_a);
-            }
         }
     }
 };
@@ -119,10 +111,6 @@ struct MaxBackward : public Function<T> {
                     parent_input->grad->data[i] += grad_a->data[i];
                 }
             }
-
-            if (parent_input->grad_fn) {
-                parent_input->grad_fn->backward(grad_a);
-            }
         }
     }
 };
@@ -151,10 +139,6 @@ struct MinBackward : public Function<T> {
                     parent_input->grad->data[i] += grad_a->data[i];
                 }
             }
-
-            if (parent_input->grad_fn) {
-                parent_input->grad_fn->backward(grad_a);
-            }
         }
     }
 };
@@ -0,0 +1,59 @@
+#ifndef AUTOGRAD_RNN_H
+#define AUTOGRAD_RNN_H
+
+#include <vector>
+#include <memory>
+#include "tensors/tensor.h"
+#include "tensors/tensor_rnn.h"
+#include "autograd/grad_buffer.h"
+
+// One node for a whole LSTM sequence: backpropagation through time runs inside
+// lstm_backward, so no per-timestep tensors or nodes are created.
+template<typename T>
+struct LSTMBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> input, h0, c0, w_ih, w_hh, bias;
+    std::shared_ptr<Tensor<T>> gates, hidden_states, cell_states;
+    bool sequences;
+
+    LSTMBackward(std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> h_init, std::shared_ptr<Tensor<T>> c_init,
+                 std::shared_ptr<Tensor<T>> wi, std::shared_ptr<Tensor<T>> wh, std::shared_ptr<Tensor<T>> b,
+                 std::shared_ptr<Tensor<T>> saved_gates, std::shared_ptr<Tensor<T>> saved_h,
+                 std::shared_ptr<Tensor<T>> saved_c, bool seq)
+        : input(x), h0(h_init), c0(c_init), w_ih(wi), w_hh(wh), bias(b),
+          gates(saved_gates), hidden_states(saved_h), cell_states(saved_c), sequences(seq) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        lstm_backward(input->data.get(), w_ih->data.get(), w_hh->data.get(),
+                      gates->data.get(), hidden_states->data.get(), cell_states->data.get(),
+                      grad_out->data.get(), sequences,
+                      input->shape[0], input->shape[1], input->shape[2], w_hh->shape[1],
+                      grad_buffer(input), grad_buffer(h0), grad_buffer(c0),
+                      grad_buffer(w_ih), grad_buffer(w_hh), grad_buffer(bias));
+    }
+};
+
+template<typename T>
+struct GRUBackward : public Function<T> {
+    std::shared_ptr<Tensor<T>> input, h0, w_ih, w_hh, b_ih, b_hh;
+    std::shared_ptr<Tensor<T>> gates, recurrent_candidate, hidden_states;
+    bool sequences;
+
+    GRUBackward(std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> h_init,
+                std::shared_ptr<Tensor<T>> wi, std::shared_ptr<Tensor<T>> wh,
+                std::shared_ptr<Tensor<T>> bi, std::shared_ptr<Tensor<T>> bh,
+                std::shared_ptr<Tensor<T>> saved_gates, std::shared_ptr<Tensor<T>> saved_hn,
+                std::shared_ptr<Tensor<T>> saved_h, bool seq)
+        : input(x), h0(h_init), w_ih(wi), w_hh(wh), b_ih(bi), b_hh(bh),
+          gates(saved_gates), recurrent_candidate(saved_hn), hidden_states(saved_h), sequences(seq) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        gru_backward(input->data.get(), w_ih->data.get(), w_hh->data.get(),
+                     gates->data.get(), recurrent_candidate->data.get(), hidden_states->data.get(),
+                     grad_out->data.get(), sequences,
+                     input->shape[0], input->shape[1], input->shape[2], w_hh->shape[1],
+                     grad_buffer(input), grad_buffer(h0),
+                     grad_buffer(w_ih), grad_buffer(w_hh), grad_buffer(b_ih), grad_buffer(b_hh));
+    }
+};
+
+#endif
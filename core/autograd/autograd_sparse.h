@@ -0,0 +1,67 @@
+#ifndef AUTOGRAD_SPARSE_H
+#define AUTOGRAD_SPARSE_H
+
+#include <vector>
+#include <memory>
+#include "tensors/tensor.h"
+#include "tensors/sparse_tensor.h"
+#include "autograd/grad_buffer.h"
+#include "utils/parallel.h"
+
+// Gradient of C = A * B with respect to the dense operand: dB = A^T * dC. The
+// transpose is built once in CSR form so each row of dB is owned by one thread.
+template<typename T>
+struct SpMMBackward : public Function<T> {
+    std::shared_ptr<SparseTensor<T>> sparse_parent;
+    std::shared_ptr<Tensor<T>> dense_parent;
+
+    SpMMBackward(std::shared_ptr<SparseTensor<T>> a, std::shared_ptr<Tensor<T>> b)
+        : sparse_parent(a), dense_parent(b) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        if (dense_parent->requires_grad) {
+            auto a_t = sparse_parent->transposed();
+            int n = dense_parent->shape[1];
+            if (!dense_parent->grad) {
+                dense_parent->grad = std::make_shared<Tensor<T>>(dense_parent->shape, false);
+                spmm_kernel(*a_t, grad_out->data.get(), n, dense_parent->grad->data.get());
+            } else {
+                spmm_kernel(*a_t, grad_out->data.get(), n, dense_parent->grad->data.get(), true);
+            }
+        }
+    }
+};
+
+// Gradient of C = A * W^T with respect to W [N x K]:
+// dW[n, k] += sum_i dC[i, n] * A[i, k]. Each thread owns a range of rows of
+// dW and only the columns that A touches are written.
+template<typename T>
+struct SpMMTransposedBackward : public Function<T> {
+    std::shared_ptr<SparseTensor<T>> sparse_parent;
+    std::shared_ptr<Tensor<T>> weight_parent;
+
+    SpMMTransposedBackward(std::shared_ptr<SparseTensor<T>> a, std::shared_ptr<Tensor<T>> w)
+        : sparse_parent(a), weight_parent(w) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        T* dw = grad_buffer(weight_parent);
+        if (!dw) return;
+        const SparseTensor<T>& a = *sparse_parent;
+        int n_out = weight_parent->shape[0];
+        int k_in = weight_parent->shape[1];
+        const T* g = grad_out->data.get();
+        int grain = std::max(1, 32768 / std::max(1, a.nnz()));
+        parallel_for(0, n_out, grain, [&](int begin, int end) {
+            for (int n = begin; n < end; ++n) {
+                T* dw_row = dw + static_cast<size_t>(n) * k_in;
+                for (int i = 0; i < a.rows; ++i) {
+                    const T scale = g[static_cast<size_t>(i) * n_out + n];
+                    if (scale == static_cast<T>(0)) continue;
+                    for (int k = a.row_ptr[i]; k < a.row_ptr[i + 1]; ++k) dw_row[a.col_idx[k]] += a.values[k] * scale;
+                }
+            }
+        });
+    }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef BACKWARD_CALLBACKS_H
+#define BACKWARD_CALLBACKS_H
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Callbacks queued while a backward pass runs (typically from a gradient-ready
+// hook) and executed on the same thread once the outermost backward call on
+// that thread has finished. Nested passes, such as the recomputation done by
+// checkpoint, do not flush the queue.
+class BackwardCallbacks {
+public:
+    static void queue(std::function<void()> callback) {
+        pending().push_back(std::move(callback));
+    }
+
+    static int depth() { return depth_ref(); }
+
+private:
+    friend class BackwardPass;
+
+    static std::vector<std::function<void()>>& pending() {
+        thread_local std::vector<std::function<void()>> callbacks;
+        return callbacks;
+    }
+
+    static int& depth_ref() {
+        thread_local int depth = 0;
+        return depth;
+    }
+};
+
+// Marks the extent of one backward call; the outermost one runs the queue
+// when it completes normally and drops it when the pass threw.
+class BackwardPass {
+public:
+    BackwardPass() { ++BackwardCallbacks::depth_ref(); }
+
+    ~BackwardPass() {
+        if (--BackwardCallbacks::depth_ref() == 0) BackwardCallbacks::pending().clear();
+    }
+
+    void finish() {
+        if (BackwardCallbacks::depth_ref() != 1) return;
+        auto callbacks = std::move(BackwardCallbacks::pending());
+        BackwardCallbacks::pending().clear();
+        for (auto& callback : callbacks) callback();
+    }
+
+    BackwardPass(const BackwardPass&) = delete;
+    BackwardPass& operator=(const BackwardPass&) = delete;
+};
+
+#endif
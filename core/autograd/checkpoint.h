@@ -0,0 +1,89 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "tensors/tensor.h"
+#include "autograd/grad_mode.h"
+#include "utils/random.h"
+
+template<typename T>
+using Segment = std::function<std::shared_ptr<Tensor<T>>(std::shared_ptr<Tensor<T>>)>;
+
+// Runs the segment again with the graph enabled and backpropagates through the
+// fresh graph. Only the segment input is kept between forward and backward;
+// random draws (dropout) replay the segment's private stream, so the
+// recomputation sees the same masks as the forward pass, and RecomputeGuard
+// keeps ops from repeating side effects such as running statistics.
+template<typename T>
+struct CheckpointBackward : public Function<T> {
+    Segment<T> segment;
+    std::shared_ptr<Tensor<T>> parent_input;
+    PhiloxState random_stream;
+
+    CheckpointBackward(Segment<T> fn, std::shared_ptr<Tensor<T>> input, const PhiloxState& stream)
+        : segment(std::move(fn)), parent_input(input), random_stream(stream) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        std::shared_ptr<Tensor<T>> detached, recomputed;
+        {
+            GradModeGuard guard(true);
+            RecomputeGuard recompute;
+            MemoryScope scope("checkpoint", MemoryCategory::Activation);
+            RandomStreamGuard random_guard(random_stream);
+            detached = std::make_shared<Tensor<T>>(to_vector(*parent_input), parent_input->shape, parent_input->requires_grad);
+            recomputed = segment(detached);
+        }
+        if (recomputed->requires_grad) {
+            recomputed->grad = std::make_shared<Tensor<T>>(to_vector(*grad_out), grad_out->shape);
+            recomputed->backward();
+        }
+
+        if (parent_input->requires_grad && detached->grad) {
+            auto grad_a = detached->grad;
+            if (!parent_input->grad) {
+                parent_input->grad = grad_a;
+            } else {
+                for (int i = 0; i < parent_input->size; ++i) parent_input->grad->data[i] += grad_a->data[i];
+            }
+        }
+    }
+};
+
+// Evaluates the segment without recording a graph and attaches a single node
+// that recomputes it during backward, trading compute for activation memory.
+// The output requires grad only if the segment would have produced one that
+// does, i.e. it depends on the input or on a parameter requiring grad.
+// Nested inside another checkpoint, the segment draws from a child of the
+// outer private stream whether or not grad is enabled, so the outer forward
+// (grad off) and its recomputation (grad on) see the same masks.
+template<typename T>
+std::shared_ptr<Tensor<T>> checkpoint(Segment<T> segment, const std::shared_ptr<Tensor<T>>& input) {
+    if (!GradMode::is_enabled()) {
+        if (!RandomGenerator::in_private_stream()) return segment(input);
+        RandomStreamGuard random_guard(RandomGenerator::global().fork_stream());
+        return segment(input);
+    }
+
+    std::shared_ptr<Tensor<T>> output;
+    bool requires_grad = false;
+    PhiloxState stream = RandomGenerator::global().fork_stream();
+    {
+        NoGradGuard guard;
+        RandomStreamGuard random_guard(stream);
+        GradRequestProbe probe;
+        output = segment(input);
+        requires_grad = probe.requested();
+    }
+    if (output == input || !requires_grad) {
+        return output;
+    }
+
+    output->requires_grad = true;
+    output->parents = {input};
+    output->grad_fn = std::make_unique<CheckpointBackward<T>>(std::move(segment), input, stream);
+    return output;
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef FORWARD_AD_H
+#define FORWARD_AD_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_broadcast.h"
+#include "autograd/grad_mode.h"
+#include "utils/parallel.h"
+
+// Forward-mode differentiation. A tensor whose `tangent` is set is a dual
+// tensor (primal, tangent). Ops with a forward rule give their result the
+// tangent J * t of their inputs' tangents, computed in the loop that computes
+// the result, so one forward pass yields a Jacobian-vector product. Ops
+// without a rule return results without a tangent; jvp reports those.
+
+// Vectorized kernels (vec_exp, vec_sin, ...) run over blocks of this many
+// elements, each block's tangent being computed right after it while the
+// block is still in L1.
+constexpr int TANGENT_BLOCK = 512;
+
+template<bool kDual, typename Primal, typename Tangent>
+void dual_loop_impl(int n, Primal& primal, Tangent& tangent) {
+    for (int i = 0; i < n; ++i) {
+        primal(i);
+        if constexpr (kDual) tangent(i);
+    }
+}
+
+// The single loop of an elementwise op: primal(i) for every element, followed
+// by tangent(i) when the op has a tangent to compute. The loop is instantiated
+// with and without the tangent, so the primal-only loop has no extra branch.
+template<typename Primal, typename Tangent>
+void dual_loop(int n, bool dual, Primal&& primal, Tangent&& tangent) {
+    if (dual) {
+        dual_loop_impl<true>(n, primal, tangent);
+    } else {
+        dual_loop_impl<false>(n, primal, tangent);
+    }
+}
+
+// The same for vectorized kernels: kernel(begin, n) over parallel chunks and,
+// when dual, tangent(begin, n) on every TANGENT_BLOCK right after it.
+template<typename Kernel, typename Tangent>
+void dual_blocks(int size, int grain, bool dual, Kernel&& kernel, Tangent&& tangent) {
+    parallel_for(0, size, grain, [&](int begin, int end) {
+        if (!dual) {
+            kernel(begin, end - begin);
+            return;
+        }
+        for (int b = begin; b < end; b += TANGENT_BLOCK) {
+            int n = std::min(TANGENT_BLOCK, end - b);
+            kernel(b, n);
+            tangent(b, n);
+        }
+    });
+}
+
+template<typename T>
+bool has_tangent(const std::shared_ptr<Tensor<T>>& tensor) {
+    return tensor->tangent != nullptr;
+}
+
+// Tangent buffer for the result of a unary op, or null if x has no tangent.
+template<typename T>
+std::shared_ptr<Tensor<T>> unary_tangent(const Tensor<T>& x) {
+    if (!x.tangent) return nullptr;
+    return std::make_shared<Tensor<T>>(x.shape, false);
+}
+
+// The operand tangents of a binary op expanded to the result's shape, a
+// missing tangent reading as zeros, and the result's tangent buffer.
+template<typename T>
+struct BinaryTangents {
+    Tensor<T> a;
+    Tensor<T> b;
+    std::shared_ptr<Tensor<T>> out;
+};
+
+template<typename T>
+std::optional<BinaryTangents<T>> binary_tangents(const Tensor<T>& a, const Tensor<T>& b, const TensorShape& shape) {
+    if (!a.tangent && !b.tangent) return std::nullopt;
+    auto expand = [&shape](const Tensor<T>& x) {
+        if (!x.tangent) return Tensor<T>(shape, false);
+        if (x.tangent->shape == shape) return Tensor<T>(x.tangent, false);
+        return expand_tensor(*x.tangent, shape);
+    };
+    return BinaryTangents<T>{expand(a), expand(b), std::make_shared<Tensor<T>>(shape, false)};
+}
+
+// A dual tensor sharing primal's values, with the given tangent. It is a new
+// leaf, so gradients do not flow back to primal through it.
+template<typename T>
+std::shared_ptr<Tensor<T>> make_dual(const std::shared_ptr<Tensor<T>>& primal, const std::shared_ptr<Tensor<T>>& tangent) {
+    if (tangent->shape != primal->shape) {
+        throw std::invalid_argument("ERROR: A tangent must have the shape of its primal.");
+    }
+    auto dual = std::make_shared<Tensor<T>>(primal, false);
+    dual->tangent = tangent;
+    return dual;
+}
+
+template<typename T>
+using JvpFunction = std::function<std::vector<std::shared_ptr<Tensor<T>>>(const std::vector<std::shared_ptr<Tensor<T>>>&)>;
+
+// Evaluates fn at primals and its Jacobian-vector product with tangents in one
+// forward pass, without building a graph. Returns fn's outputs and their
+// tangents.
+template<typename T>
+std::pair<std::vector<std::shared_ptr<Tensor<T>>>, std::vector<std::shared_ptr<Tensor<T>>>>
+jvp(const JvpFunction<T>& fn,
+    const std::vector<std::shared_ptr<Tensor<T>>>& primals,
+    const std::vector<std::shared_ptr<Tensor<T>>>& tangents) {
+    if (primals.size() != tangents.size()) {
+        throw std::invalid_argument("ERROR: jvp needs one tangent per primal.");
+    }
+    NoGradGuard no_grad;
+    std::vector<std::shared_ptr<Tensor<T>>> duals;
+    duals.reserve(primals.size());
+    for (size_t k = 0; k < primals.size(); ++k) duals.push_back(make_dual(primals[k], tangents[k]));
+
+    auto outputs = fn(duals);
+    std::vector<std::shared_ptr<Tensor<T>>> output_tangents;
+    output_tangents.reserve(outputs.size());
+    for (size_t k = 0; k < outputs.size(); ++k) {
+        if (!outputs[k]->tangent) {
+            throw std::runtime_error("ERROR: Output " + std::to_string(k) + " has no tangent: it does not depend on "
+                                     "the primals or goes through an op without a forward-mode rule.");
+        }
+        output_tangents.push_back(outputs[k]->tangent);
+    }
+    for (auto& output : outputs) output->tangent.reset();
+    return {std::move(outputs), std::move(output_tangents)};
+}
+
+#endif
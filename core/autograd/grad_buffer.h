@@ -0,0 +1,21 @@
+#ifndef GRAD_BUFFER_H
+#define GRAD_BUFFER_H
+
+#include <algorithm>
+#include <memory>
+#include "tensors/tensor.h"
+
+// Returns the gradient buffer of t, creating it zero-filled on first use, or
+// null when t does not take part in autograd. Fused backward kernels accumulate
+// into it directly instead of allocating a temporary and adding it afterwards.
+template<typename T>
+T* grad_buffer(const std::shared_ptr<Tensor<T>>& t) {
+    if (!t || !t->requires_grad) return nullptr;
+    if (!t->grad) {
+        t->grad = std::make_shared<Tensor<T>>(t->shape, false);
+        std::fill(t->grad->data.get(), t->grad->data.get() + t->grad->size, static_cast<T>(0));
+    }
+    return t->grad->data.get();
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef GRAD_MODE_H
+#define GRAD_MODE_H
+
+// Thread-local switch for graph construction. While disabled, ops give their
+// results requires_grad = false (see resolve), so they neither attach a grad_fn
+// nor keep their inputs alive. Tensors created directly (parameters, user
+// tensors, master weights) keep the requires_grad they were created with.
+class GradMode {
+public:
+    static bool is_enabled() {
+        return enabled_flag();
+    }
+
+    static void set_enabled(bool enabled) {
+        enabled_flag() = enabled;
+    }
+
+    // requires_grad of an op result whose inputs ask for req_grad. A request
+    // turned down because grad is disabled is noted for GradRequestProbe.
+    static bool resolve(bool req_grad) {
+        if (enabled_flag()) return req_grad;
+        if (req_grad) suppressed_flag() = true;
+        return false;
+    }
+
+    static bool& suppressed_flag() {
+        thread_local bool suppressed = false;
+        return suppressed;
+    }
+
+private:
+    static bool& enabled_flag() {
+        thread_local bool enabled = true;
+        return enabled;
+    }
+};
+
+class GradModeGuard {
+public:
+    explicit GradModeGuard(bool enabled) : prev(GradMode::is_enabled()) {
+        GradMode::set_enabled(enabled);
+    }
+
+    ~GradModeGuard() {
+        GradMode::set_enabled(prev);
+    }
+
+    GradModeGuard(const GradModeGuard&) = delete;
+    GradModeGuard& operator=(const GradModeGuard&) = delete;
+
+private:
+    bool prev;
+};
+
+class NoGradGuard : public GradModeGuard {
+public:
+    NoGradGuard() : GradModeGuard(false) {}
+};
+
+// Tells whether code run without a graph computed any op result that would
+// have required grad with the graph enabled, i.e. whether its result depends
+// on something trainable. Probes nest; an outer probe sees the inner requests.
+class GradRequestProbe {
+public:
+    GradRequestProbe() : prev(GradMode::suppressed_flag()) {
+        GradMode::suppressed_flag() = false;
+    }
+
+    ~GradRequestProbe() {
+        GradMode::suppressed_flag() = GradMode::suppressed_flag() || prev;
+    }
+
+    bool requested() const {
+        return GradMode::suppressed_flag();
+    }
+
+    GradRequestProbe(const GradRequestProbe&) = delete;
+    GradRequestProbe& operator=(const GradRequestProbe&) = delete;
+
+private:
+    bool prev;
+};
+
+// Set while checkpoint reruns a segment during backward. Ops with effects
+// beyond their result, such as BatchNorm's running statistics, skip them
+// because the original forward pass already applied them.
+class RecomputeGuard {
+public:
+    RecomputeGuard() : prev(active_flag()) {
+        active_flag() = true;
+    }
+
+    ~RecomputeGuard() {
+        active_flag() = prev;
+    }
+
+    static bool active() {
+        return active_flag();
+    }
+
+    RecomputeGuard(const RecomputeGuard&) = delete;
+    RecomputeGuard& operator=(const RecomputeGuard&) = delete;
+
+private:
+    static bool& active_flag() {
+        thread_local bool recomputing = false;
+        return recomputing;
+    }
+
+    bool prev;
+};
+
+#endif
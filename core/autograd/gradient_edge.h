@@ -0,0 +1,68 @@
+#ifndef GRADIENT_EDGE_H
+#define GRADIENT_EDGE_H
+
+#include <memory>
+#include <mutex>
+#include "tensors/tensor.h"
+#include "autograd/grad_buffer.h"
+
+// Backward of a tensor whose place in the graph was taken over by a sink:
+// gradients from its other consumers are passed on to the sink.
+template<typename T>
+struct GradientSinkForward : public Function<T> {
+    std::shared_ptr<Tensor<T>> sink;
+
+    explicit GradientSinkForward(std::shared_ptr<Tensor<T>> s) : sink(std::move(s)) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        T* grad = grad_buffer(sink);
+        if (!grad) return;
+        const T* go = grad_out->data.get();
+        for (int i = 0; i < sink->size; ++i) grad[i] += go[i];
+    }
+};
+
+// Backward of a sink: the gradient it accumulated is the full gradient of the
+// tensor it stands in for, which gets it as its .grad (as any non-leaf does)
+// before that tensor's own backward runs.
+template<typename T>
+struct GradientSinkBackward : public Function<T> {
+    std::unique_ptr<Function<T>> inner;
+    std::weak_ptr<Tensor<T>> input;
+
+    GradientSinkBackward(std::unique_ptr<Function<T>> f, const std::shared_ptr<Tensor<T>>& in)
+        : inner(std::move(f)), input(in) {}
+
+    void backward(std::shared_ptr<Tensor<T>> grad_out) override {
+        if (auto in = input.lock()) in->grad = grad_out;
+        inner->backward(grad_out);
+    }
+};
+
+// Graph edge to `input` for a backward node that never reads input's values
+// (ReLU keeps a bit mask, tanh and sigmoid read their output). A value-less
+// sink takes over input's grad_fn and parents and the edge points to it, so
+// the graph no longer owns input's buffer: it is freed with its last other
+// owner. The sink only holds input weakly, to hand it its gradient. Leaves,
+// and inputs whose own backward reads their values, are returned unchanged.
+// The takeover rewrites input's graph node, so it is serialized: threads may
+// apply activations to the same intermediate tensor concurrently.
+template<typename T>
+std::shared_ptr<Tensor<T>> gradient_edge(const std::shared_ptr<Tensor<T>>& input) {
+    if (!input->requires_grad) return input;
+    static std::mutex takeover;
+    std::lock_guard<std::mutex> lock(takeover);
+    if (!input->grad_fn) return input;
+    if (auto* forward = dynamic_cast<GradientSinkForward<T>*>(input->grad_fn.get())) return forward->sink;
+    if (input->grad_fn->reads_output()) return input;
+
+    auto sink = std::make_shared<Tensor<T>>(input->shape, typename Tensor<T>::GradientSinkTag{});
+    sink->grad_fn = std::make_unique<GradientSinkBackward<T>>(std::move(input->grad_fn), input);
+    sink->parents = std::move(input->parents);
+    input->parents.clear();
+    input->parents.push_back(sink);
+    input->grad_fn = std::make_unique<GradientSinkForward<T>>(sink);
+    return sink;
+}
+
+#endif
@@ -0,0 +1,215 @@
+#ifndef DDP_H
+#define DDP_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "tensors/tensor.h"
+#include "autograd/backward_callbacks.h"
+#include "autograd/grad_buffer.h"
+#include "distributed/shm_comm.h"
+
+// Averages parameter gradients across the ranks of a communicator while
+// backward is still running. Parameters are grouped into buckets of about
+// bucket_bytes, filled in reverse registration order because that is roughly
+// the order in which backward finishes them. A gradient-ready hook on every
+// parameter copies its gradient into its bucket; a full bucket is handed to a
+// background thread that all-reduces it while backward continues with earlier
+// layers. When the outermost backward returns, the queued finalize step
+// copies in the parameters this pass did not reach (their gradient from
+// earlier backward calls, or zero if they have none), waits for the remaining
+// buckets and writes the averaged gradients back.
+//
+// Buckets are reduced strictly in index order, so every rank issues the same
+// sequence of collectives even if its backward finishes them in another order.
+// Gradients accumulated over several backward calls stay correct: the reduced
+// part is already equal on every rank, so averaging it again is a no-op.
+// Only dense gradients are supported.
+template<typename T>
+class GradReducer {
+public:
+    GradReducer(std::shared_ptr<ShmCommunicator> comm, const std::vector<std::shared_ptr<Tensor<T>>>& params,
+                size_t bucket_bytes = 25 << 20)
+        : state(std::make_shared<State>()) {
+        if (!comm) throw std::invalid_argument("ERROR: GradReducer needs a communicator.");
+        state->comm = std::move(comm);
+        for (auto& p : params) {
+            if (p->requires_grad) state->params.push_back(p);
+        }
+        build_buckets(std::max<size_t>(bucket_bytes / sizeof(T), 1));
+
+        std::weak_ptr<State> weak = state;
+        for (size_t k = 0; k < state->params.size(); ++k) {
+            state->params[k]->register_grad_ready_hook([weak, k](Tensor<T>& param) {
+                if (auto s = weak.lock()) s->on_grad_ready(k, param);
+            });
+        }
+        state->worker = std::thread([s = state.get()] { s->reduce_loop(); });
+    }
+
+    ~GradReducer() {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->stop = true;
+        }
+        state->cv.notify_all();
+        state->worker.join();
+    }
+
+    GradReducer(const GradReducer&) = delete;
+    GradReducer& operator=(const GradReducer&) = delete;
+
+    // Copies rank 0's parameter values to every rank so replicas start equal.
+    void broadcast_parameters() {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        for (auto& p : state->params) {
+            state->comm->broadcast(p->data.get(), p->size, 0);
+            p->bump_version();
+        }
+    }
+
+    // Blocks until the current pass (if any) has been reduced. Called
+    // automatically at the end of backward.
+    void finalize() { state->finalize(); }
+
+    int num_buckets() const { return static_cast<int>(state->buckets.size()); }
+
+private:
+    struct Bucket {
+        std::vector<int> members;
+        std::vector<T> buffer;
+        int pending = 0;
+    };
+
+    struct State : std::enable_shared_from_this<State> {
+        std::shared_ptr<ShmCommunicator> comm;
+        std::vector<std::shared_ptr<Tensor<T>>> params;
+        std::vector<Bucket> buckets;
+        std::vector<int> bucket_of;
+        std::vector<size_t> offset_of;
+        std::vector<char> ready;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::thread worker;
+        bool active = false;
+        bool stop = false;
+        size_t next_bucket = 0;
+        std::exception_ptr error;
+
+        void on_grad_ready(size_t k, Tensor<T>& param) {
+            if (param.sparse_grad) {
+                throw std::runtime_error("ERROR: GradReducer supports dense gradients only.");
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!active) {
+                active = true;
+                BackwardCallbacks::queue([weak = this->weak_from_this()] {
+                    if (auto s = weak.lock()) s->finalize();
+                });
+            }
+            Bucket& bucket = buckets[bucket_of[k]];
+            if (ready[k]) {
+                // a parameter used both inside and outside a checkpointed segment
+                // becomes ready twice; its bucket must not have been sent yet
+                if (bucket.pending == 0) {
+                    throw std::runtime_error("ERROR: Parameter gradient became ready after its bucket was reduced.");
+                }
+                copy_in(k, param.grad ? param.grad->data.get() : nullptr);
+                return;
+            }
+            copy_in(k, param.grad ? param.grad->data.get() : nullptr);
+            ready[k] = 1;
+            if (--bucket.pending == 0) cv.notify_all();
+        }
+
+        void copy_in(size_t k, const T* grad) {
+            T* dst = buckets[bucket_of[k]].buffer.data() + offset_of[k];
+            int n = params[k]->size;
+            if (grad) std::copy(grad, grad + n, dst);
+            else std::fill(dst, dst + n, static_cast<T>(0));
+        }
+
+        void reduce_loop() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                cv.wait(lock, [&] {
+                    return stop || (active && next_bucket < buckets.size() && buckets[next_bucket].pending == 0);
+                });
+                if (stop) return;
+                Bucket& bucket = buckets[next_bucket];
+                bool failed = static_cast<bool>(error);
+                std::exception_ptr caught;
+                lock.unlock();
+                try {
+                    if (!failed) comm->all_reduce(bucket.buffer.data(), bucket.buffer.size(), true);
+                } catch (...) {
+                    caught = std::current_exception();
+                }
+                lock.lock();
+                if (caught) error = caught;
+                ++next_bucket;
+                cv.notify_all();
+            }
+        }
+
+        void finalize() {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!active) return;
+            for (size_t k = 0; k < params.size(); ++k) {
+                if (ready[k]) continue;
+                // not reached by this pass: keep what earlier micro-batches accumulated
+                copy_in(k, params[k]->grad ? params[k]->grad->data.get() : nullptr);
+                ready[k] = 1;
+                --buckets[bucket_of[k]].pending;
+            }
+            cv.notify_all();
+            cv.wait(lock, [&] { return next_bucket == buckets.size(); });
+
+            for (auto& bucket : buckets) {
+                for (int k : bucket.members) {
+                    const T* src = bucket.buffer.data() + offset_of[k];
+                    std::copy(src, src + params[k]->size, grad_buffer(params[k]));
+                }
+                bucket.pending = static_cast<int>(bucket.members.size());
+            }
+            std::fill(ready.begin(), ready.end(), 0);
+            next_bucket = 0;
+            active = false;
+
+            if (error) {
+                auto e = error;
+                error = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+    };
+
+    void build_buckets(size_t bucket_elems) {
+        auto& s = *state;
+        s.bucket_of.assign(s.params.size(), 0);
+        s.offset_of.assign(s.params.size(), 0);
+        s.ready.assign(s.params.size(), 0);
+        for (int k = static_cast<int>(s.params.size()) - 1; k >= 0; --k) {
+            size_t n = s.params[k]->size;
+            if (s.buckets.empty() || (!s.buckets.back().buffer.empty() && s.buckets.back().buffer.size() + n > bucket_elems)) {
+                s.buckets.emplace_back();
+            }
+            Bucket& bucket = s.buckets.back();
+            bucket.members.push_back(k);
+            s.offset_of[k] = bucket.buffer.size();
+            bucket.buffer.resize(bucket.buffer.size() + n);
+            bucket.pending = static_cast<int>(bucket.members.size());
+            s.bucket_of[k] = static_cast<int>(s.buckets.size()) - 1;
+        }
+    }
+
+    std::shared_ptr<State> state;
+};
+
+#endif
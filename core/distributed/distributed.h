@@ -0,0 +1,7 @@
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include "distributed/shm_comm.h"
+#include "distributed/ddp.h"
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef SHM_COMM_H
+#define SHM_COMM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "utils/parallel.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Collective communication between the processes of one machine through a
+// POSIX shared-memory segment. Every rank maps the same segment, laid out as
+//
+//     [control block][result region][slot of rank 0]...[slot of rank world-1]
+//
+// where each region holds `capacity_bytes`. all_reduce is a reduce-scatter
+// followed by an all-gather: every rank publishes its chunk in its slot, reduces
+// its own shard of the chunk across all slots in rank order into the result
+// region, and then copies the whole result back. The summation order is fixed,
+// so every rank ends with bit-identical values. Larger buffers are processed
+// chunk by chunk.
+//
+// One communicator must only be used by one thread at a time, and every rank
+// has to issue the same sequence of collectives.
+class ShmCommunicator {
+public:
+    ShmCommunicator(const std::string& name, int rank, int world_size,
+                    size_t capacity_bytes = 4 << 20, double timeout_seconds = 300.0)
+        : shm_name(name[0] == '/' ? name : "/" + name), my_rank(rank), world(world_size),
+          capacity(capacity_bytes), timeout(timeout_seconds) {
+        if (world_size < 1 || rank < 0 || rank >= world_size) {
+            throw std::invalid_argument("ERROR: Rank " + std::to_string(rank) + " is out of range for world size " +
+                                        std::to_string(world_size) + ".");
+        }
+        if (capacity_bytes < 64) {
+            throw std::invalid_argument("ERROR: Communicator capacity must be at least 64 bytes.");
+        }
+        capacity = (capacity + 63) / 64 * 64;
+        mapped_bytes = CONTROL_BYTES + capacity * (world_size + 1);
+
+#ifdef _WIN32
+        throw std::runtime_error("ERROR: Shared-memory communication requires a POSIX system.");
+#else
+        int fd = shm_open(shm_name.c_str(), O_CREAT | O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::runtime_error("ERROR: shm_open('" + shm_name + "') failed: " + std::strerror(errno));
+        }
+        // every rank sizes the segment; new pages are zero, which is the initial control state
+        if (ftruncate(fd, static_cast<off_t>(mapped_bytes)) != 0) {
+            int err = errno;
+            close(fd);
+            throw std::runtime_error("ERROR: Sizing shared memory '" + shm_name + "' failed: " + std::strerror(err));
+        }
+        void* ptr = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error("ERROR: Mapping shared memory '" + shm_name + "' failed: " + std::strerror(errno));
+        }
+        base = static_cast<char*>(ptr);
+#endif
+
+        // once every rank has mapped the segment its name is no longer needed
+        try {
+            barrier();
+        } catch (...) {
+            release();
+            throw;
+        }
+#ifndef _WIN32
+        if (my_rank == 0) shm_unlink(shm_name.c_str());
+#endif
+    }
+
+    ~ShmCommunicator() { release(); }
+
+    ShmCommunicator(const ShmCommunicator&) = delete;
+    ShmCommunicator& operator=(const ShmCommunicator&) = delete;
+
+    int rank() const { return my_rank; }
+    int world_size() const { return world; }
+    size_t capacity_bytes() const { return capacity; }
+
+    // Sense-counting barrier: the last rank to arrive resets the counter and
+    // advances the generation the others are spinning on.
+    void barrier() {
+        std::atomic<int>& arrived = control(0);
+        std::atomic<int>& generation = control(1);
+        int gen = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) == world - 1) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int spins = 0; generation.load(std::memory_order_acquire) == gen; ++spins) {
+            if (spins < 1024) continue;
+            std::this_thread::yield();
+            if ((spins & 1023) == 0 && timeout > 0 &&
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > timeout) {
+                throw std::runtime_error("ERROR: Timed out waiting for the other ranks in '" + shm_name + "'.");
+            }
+        }
+    }
+
+    // Sums data over all ranks in place; average divides the sum by the world size.
+    template<typename T>
+    void all_reduce(T* data, size_t n, bool average = false) {
+        if (world == 1) return;
+        size_t chunk = capacity / sizeof(T);
+        T* result = reinterpret_cast<T*>(base + CONTROL_BYTES);
+        T* mine = slot<T>(my_rank);
+
+        for (size_t offset = 0; offset < n; offset += chunk) {
+            size_t count = std::min(chunk, n - offset);
+            std::memcpy(mine, data + offset, count * sizeof(T));
+            barrier();
+
+            size_t shard = (count + world - 1) / world;
+            size_t shard_begin = std::min(count, shard * my_rank);
+            size_t shard_end = std::min(count, shard_begin + shard);
+            parallel_for(static_cast<int>(shard_begin), static_cast<int>(shard_end), 32768, [&](int begin, int end) {
+                for (int i = begin; i < end; ++i) result[i] = slot<T>(0)[i];
+                for (int r = 1; r < world; ++r) {
+                    const T* other = slot<T>(r);
+                    for (int i = begin; i < end; ++i) result[i] += other[i];
+                }
+                if (average) {
+                    for (int i = begin; i < end; ++i) result[i] /= static_cast<T>(world);
+                }
+            });
+            barrier();
+
+            std::memcpy(data + offset, result, count * sizeof(T));
+            // keeps the next chunk from overwriting the result before everyone has read it
+            barrier();
+        }
+    }
+
+    // Copies root's data into every other rank.
+    template<typename T>
+    void broadcast(T* data, size_t n, int root = 0) {
+        if (root < 0 || root >= world) {
+            throw std::invalid_argument("ERROR: Broadcast root " + std::to_string(root) + " is out of range.");
+        }
+        if (world == 1) return;
+        size_t chunk = capacity / sizeof(T);
+        T* result = reinterpret_cast<T*>(base + CONTROL_BYTES);
+
+        for (size_t offset = 0; offset < n; offset += chunk) {
+            size_t count = std::min(chunk, n - offset);
+            if (my_rank == root) std::memcpy(result, data + offset, count * sizeof(T));
+            barrier();
+            if (my_rank != root) std::memcpy(data + offset, result, count * sizeof(T));
+            barrier();
+        }
+    }
+
+private:
+    static constexpr size_t CONTROL_BYTES = 128;
+    static_assert(std::atomic<int>::is_always_lock_free, "shared-memory barrier needs lock-free atomics");
+
+    void release() {
+#ifndef _WIN32
+        if (base) munmap(base, mapped_bytes);
+#endif
+        base = nullptr;
+    }
+
+    // the two counters live on separate cache lines
+    std::atomic<int>& control(int index) {
+        return *reinterpret_cast<std::atomic<int>*>(base + 64 * index);
+    }
+
+    template<typename T>
+    T* slot(int r) {
+        return reinterpret_cast<T*>(base + CONTROL_BYTES + capacity * (r + 1));
+    }
+
+    std::string shm_name;
+    int my_rank;
+    int world;
+    size_t capacity;
+    double timeout;
+    size_t mapped_bytes = 0;
+    char* base = nullptr;
+};
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include "export/inference_plan.h"
+#include "export/plan_builder.h"
+
+#endif
\ No newline at end of file
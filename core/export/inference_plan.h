@@ -0,0 +1,387 @@
+#ifndef INFERENCE_PLAN_H
+#define INFERENCE_PLAN_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tensors/tensor_gemm.h"
+#include "tensors/vec_math.h"
+
+// A feed-forward model compiled ahead of time into a flat list of float32
+// steps over a fixed set of activation buffers. Only standard headers and the
+// standalone GEMM / vec_math kernels are used, so a plan can be loaded and run
+// by programs that link neither Python nor pybind11.
+//
+// Dense weights are stored already packed into the [GEMM_KC x GEMM_NC] panels
+// that gemm_block consumes, so running a plan never repacks them.
+
+enum class PlanOp : uint32_t { Dense = 1, Affine = 2, LayerNorm = 3, Softmax = 4, Activation = 5 };
+enum class PlanActivation : uint32_t { None = 0, ReLU = 1, Tanh = 2, Sigmoid = 3 };
+
+// Storage ids of the caller's arrays; ids >= 0 index InferencePlan::buffer_widths.
+constexpr int PLAN_INPUT = -1;
+constexpr int PLAN_OUTPUT = -2;
+
+struct PlanStep {
+    PlanOp op = PlanOp::Activation;
+    PlanActivation activation = PlanActivation::None;
+    int in_features = 0;
+    int out_features = 0;
+    int input = PLAN_INPUT;
+    int output = PLAN_OUTPUT;
+    float eps = 0.0f;
+    std::vector<float> weights;   // Dense: packed panels of W^T
+    std::vector<float> scale;     // Affine / LayerNorm: per-feature scale
+    std::vector<float> shift;     // Dense: bias; Affine / LayerNorm: per-feature shift
+};
+
+inline const char* plan_op_name(PlanOp op) {
+    switch (op) {
+        case PlanOp::Dense: return "dense";
+        case PlanOp::Affine: return "affine";
+        case PlanOp::LayerNorm: return "layer_norm";
+        case PlanOp::Softmax: return "softmax";
+        case PlanOp::Activation: return "activation";
+    }
+    return "unknown";
+}
+
+inline const char* plan_activation_name(PlanActivation act) {
+    switch (act) {
+        case PlanActivation::None: return "none";
+        case PlanActivation::ReLU: return "relu";
+        case PlanActivation::Tanh: return "tanh";
+        case PlanActivation::Sigmoid: return "sigmoid";
+    }
+    return "unknown";
+}
+
+// Packs W [out x in] (row-major, as stored by Linear) into the panels gemm_block
+// reads for y = x * W^T.
+inline std::vector<float> plan_pack_weights(const float* W, int out_features, int in_features) {
+    std::vector<float> packed(static_cast<size_t>(out_features) * in_features);
+    gemm_pack_b_panels(true, W, in_features, in_features, out_features, packed.data());
+    return packed;
+}
+
+struct InferencePlan {
+    static constexpr char kMagic[8] = {'M', 'T', 'P', 'L', 'A', 'N', '\0', '\0'};
+    static constexpr uint32_t kVersion = 1;
+
+    int input_features = 0;
+    int output_features = 0;
+    int max_batch = 0;                 // rows per chunk the buffers are sized for
+    std::vector<int> buffer_widths;    // floats per row of each intermediate buffer
+    std::vector<PlanStep> steps;
+
+    // Floats of scratch a runner allocates once: the buffers plus one A panel.
+    size_t arena_floats() const {
+        size_t total = static_cast<size_t>(GEMM_MC) * GEMM_KC;
+        for (int width : buffer_widths) total += static_cast<size_t>(max_batch) * width;
+        return total;
+    }
+
+    std::string summary() const {
+        std::ostringstream out;
+        out << "InferencePlan(input_features=" << input_features << ", output_features=" << output_features
+            << ", max_batch=" << max_batch << ", buffers=" << buffer_widths.size()
+            << ", arena_bytes=" << arena_floats() * sizeof(float) << ")\n";
+        for (size_t i = 0; i < steps.size(); ++i) {
+            const PlanStep& s = steps[i];
+            out << "  " << i << ": " << plan_op_name(s.op) << " " << s.in_features << " -> " << s.out_features;
+            if (s.activation != PlanActivation::None) out << " + " << plan_activation_name(s.activation);
+            out << "  [" << storage_name(s.input) << " -> " << storage_name(s.output) << "]\n";
+        }
+        return out.str();
+    }
+
+    std::string to_bytes() const {
+        std::string bytes(kMagic, sizeof(kMagic));
+        put<uint32_t>(bytes, kVersion);
+        put<int32_t>(bytes, input_features);
+        put<int32_t>(bytes, output_features);
+        put<int32_t>(bytes, max_batch);
+        put<uint32_t>(bytes, static_cast<uint32_t>(buffer_widths.size()));
+        for (int width : buffer_widths) put<int32_t>(bytes, width);
+        put<uint32_t>(bytes, static_cast<uint32_t>(steps.size()));
+        for (const PlanStep& s : steps) {
+            put<uint32_t>(bytes, static_cast<uint32_t>(s.op));
+            put<uint32_t>(bytes, static_cast<uint32_t>(s.activation));
+            put<int32_t>(bytes, s.in_features);
+            put<int32_t>(bytes, s.out_features);
+            put<int32_t>(bytes, s.input);
+            put<int32_t>(bytes, s.output);
+            put<float>(bytes, s.eps);
+            put_array(bytes, s.weights);
+            put_array(bytes, s.scale);
+            put_array(bytes, s.shift);
+        }
+        return bytes;
+    }
+
+    static InferencePlan from_bytes(const std::string& bytes) {
+        size_t pos = 0;
+        if (bytes.size() < sizeof(kMagic) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+            throw std::runtime_error("ERROR: Not a MiniTensor inference plan.");
+        }
+        pos = sizeof(kMagic);
+        if (get<uint32_t>(bytes, pos) != kVersion) {
+            throw std::runtime_error("ERROR: Unsupported inference plan version.");
+        }
+        InferencePlan plan;
+        plan.input_features = get<int32_t>(bytes, pos);
+        plan.output_features = get<int32_t>(bytes, pos);
+        plan.max_batch = get<int32_t>(bytes, pos);
+        plan.buffer_widths.resize(get_count(bytes, pos));
+        for (int& width : plan.buffer_widths) width = get<int32_t>(bytes, pos);
+        plan.steps.resize(get_count(bytes, pos));
+        for (PlanStep& s : plan.steps) {
+            s.op = static_cast<PlanOp>(get<uint32_t>(bytes, pos));
+            s.activation = static_cast<PlanActivation>(get<uint32_t>(bytes, pos));
+            s.in_features = get<int32_t>(bytes, pos);
+            s.out_features = get<int32_t>(bytes, pos);
+            s.input = get<int32_t>(bytes, pos);
+            s.output = get<int32_t>(bytes, pos);
+            s.eps = get<float>(bytes, pos);
+            s.weights = get_array(bytes, pos);
+            s.scale = get_array(bytes, pos);
+            s.shift = get_array(bytes, pos);
+        }
+        if (pos != bytes.size()) throw std::runtime_error("ERROR: Trailing bytes after the inference plan.");
+        plan.validate();
+        return plan;
+    }
+
+    void save(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("ERROR: Cannot open '" + path + "' for writing.");
+        std::string bytes = to_bytes();
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!file) throw std::runtime_error("ERROR: Failed to write '" + path + "'.");
+    }
+
+    static InferencePlan load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("ERROR: Cannot open '" + path + "'.");
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return from_bytes(contents.str());
+    }
+
+    // Checks that every step reads what the previous one wrote and that all
+    // sizes agree, so a runner can trust a loaded plan.
+    void validate() const {
+        if (steps.empty() || max_batch < 1 || input_features < 1) {
+            throw std::runtime_error("ERROR: Inference plan is empty.");
+        }
+        int features = input_features;
+        int storage = PLAN_INPUT;
+        for (size_t i = 0; i < steps.size(); ++i) {
+            const PlanStep& s = steps[i];
+            bool last = i + 1 == steps.size();
+            if (s.in_features != features || s.input != storage) {
+                throw std::runtime_error("ERROR: Inference plan step " + std::to_string(i) + " does not follow its predecessor.");
+            }
+            if (last ? s.output != PLAN_OUTPUT
+                     : (s.output < 0 || s.output >= static_cast<int>(buffer_widths.size()) ||
+                        buffer_widths[s.output] < s.out_features)) {
+                throw std::runtime_error("ERROR: Inference plan step " + std::to_string(i) + " has an invalid output buffer.");
+            }
+            size_t in = s.in_features, out = s.out_features;
+            bool ok = false;
+            switch (s.op) {
+                case PlanOp::Dense:
+                    ok = s.weights.size() == in * out && s.shift.size() == out && s.output != s.input;
+                    break;
+                case PlanOp::Affine:
+                case PlanOp::LayerNorm:
+                    ok = in == out && s.scale.size() == out && s.shift.size() == out;
+                    break;
+                case PlanOp::Softmax:
+                case PlanOp::Activation:
+                    ok = in == out;
+                    break;
+            }
+            if (!ok || static_cast<uint32_t>(s.activation) > static_cast<uint32_t>(PlanActivation::Sigmoid)) {
+                throw std::runtime_error("ERROR: Inference plan step " + std::to_string(i) + " is malformed.");
+            }
+            features = s.out_features;
+            storage = s.output;
+        }
+        if (features != output_features) throw std::runtime_error("ERROR: Inference plan output size mismatch.");
+    }
+
+private:
+    static std::string storage_name(int id) {
+        if (id == PLAN_INPUT) return "input";
+        if (id == PLAN_OUTPUT) return "output";
+        return "buf" + std::to_string(id);
+    }
+
+    template<typename V>
+    static void put(std::string& bytes, V value) {
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(V));
+    }
+
+    static void put_array(std::string& bytes, const std::vector<float>& values) {
+        put<uint64_t>(bytes, values.size());
+        if (!values.empty()) bytes.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    }
+
+    template<typename V>
+    static V get(const std::string& bytes, size_t& pos) {
+        if (bytes.size() - pos < sizeof(V)) throw std::runtime_error("ERROR: Truncated inference plan.");
+        V value;
+        std::memcpy(&value, bytes.data() + pos, sizeof(V));
+        pos += sizeof(V);
+        return value;
+    }
+
+    // Every counted entry takes at least 4 bytes, which bounds a corrupt count.
+    static size_t get_count(const std::string& bytes, size_t& pos) {
+        uint32_t n = get<uint32_t>(bytes, pos);
+        if ((bytes.size() - pos) / 4 < n) throw std::runtime_error("ERROR: Truncated inference plan.");
+        return n;
+    }
+
+    static std::vector<float> get_array(const std::string& bytes, size_t& pos) {
+        uint64_t n = get<uint64_t>(bytes, pos);
+        if ((bytes.size() - pos) / sizeof(float) < n) throw std::runtime_error("ERROR: Truncated inference plan.");
+        std::vector<float> values(n);
+        if (n > 0) std::memcpy(values.data(), bytes.data() + pos, n * sizeof(float));
+        pos += n * sizeof(float);
+        return values;
+    }
+};
+
+// Executes a plan. All scratch memory is allocated by the constructor, so
+// run() performs no allocation; batches larger than the plan's max_batch are
+// processed in chunks. A runner is not thread-safe: use one per thread.
+class PlanRunner {
+public:
+    explicit PlanRunner(std::shared_ptr<const InferencePlan> plan)
+        : plan(std::move(plan)) {
+        if (!this->plan) throw std::invalid_argument("ERROR: PlanRunner needs a plan.");
+        this->plan->validate();
+        arena.assign(this->plan->arena_floats(), 0.0f);
+        size_t offset = static_cast<size_t>(GEMM_MC) * GEMM_KC;
+        for (int width : this->plan->buffer_widths) {
+            buffers.push_back(arena.data() + offset);
+            offset += static_cast<size_t>(this->plan->max_batch) * width;
+        }
+    }
+
+    const InferencePlan& get_plan() const { return *plan; }
+
+    // input: [rows x input_features], output: [rows x output_features]
+    void run(const float* input, int rows, float* output) {
+        const InferencePlan& p = *plan;
+        for (int r0 = 0; r0 < rows; r0 += p.max_batch) {
+            int n = std::min(p.max_batch, rows - r0);
+            const float* in = input + static_cast<size_t>(r0) * p.input_features;
+            float* out = output + static_cast<size_t>(r0) * p.output_features;
+            for (const PlanStep& step : p.steps) {
+                const float* x = step.input == PLAN_INPUT ? in : buffers[step.input];
+                float* y = step.output == PLAN_OUTPUT ? out : buffers[step.output];
+                run_step(step, x, y, n);
+            }
+        }
+    }
+
+    std::vector<float> run(const std::vector<float>& input) {
+        int in = plan->input_features;
+        if (input.size() % in != 0) {
+            throw std::invalid_argument("ERROR: Plan input size is not a multiple of " + std::to_string(in) + ".");
+        }
+        int rows = static_cast<int>(input.size() / in);
+        std::vector<float> output(static_cast<size_t>(rows) * plan->output_features);
+        run(input.data(), rows, output.data());
+        return output;
+    }
+
+private:
+    void run_step(const PlanStep& s, const float* x, float* y, int rows) {
+        int in = s.in_features, out = s.out_features;
+        switch (s.op) {
+            case PlanOp::Dense: dense(s, x, y, rows); break;
+            case PlanOp::Affine:
+                for (int r = 0; r < rows; ++r) {
+                    const float* xr = x + static_cast<size_t>(r) * in;
+                    float* yr = y + static_cast<size_t>(r) * out;
+                    for (int j = 0; j < out; ++j) yr[j] = xr[j] * s.scale[j] + s.shift[j];
+                }
+                break;
+            case PlanOp::LayerNorm:
+                for (int r = 0; r < rows; ++r) {
+                    const float* xr = x + static_cast<size_t>(r) * in;
+                    float* yr = y + static_cast<size_t>(r) * out;
+                    float mean = 0.0f, var = 0.0f;
+                    for (int j = 0; j < in; ++j) mean += xr[j];
+                    mean /= in;
+                    for (int j = 0; j < in; ++j) var += (xr[j] - mean) * (xr[j] - mean);
+                    float inv_std = 1.0f / std::sqrt(var / in + s.eps);
+                    for (int j = 0; j < out; ++j) yr[j] = (xr[j] - mean) * inv_std * s.scale[j] + s.shift[j];
+                }
+                break;
+            case PlanOp::Softmax:
+                for (int r = 0; r < rows; ++r) {
+                    const float* xr = x + static_cast<size_t>(r) * in;
+                    float* yr = y + static_cast<size_t>(r) * out;
+                    float row_max = *std::max_element(xr, xr + in);
+                    for (int j = 0; j < out; ++j) yr[j] = xr[j] - row_max;
+                    vec_exp(yr, yr, out);
+                    float row_sum = 0.0f;
+                    for (int j = 0; j < out; ++j) row_sum += yr[j];
+                    float inv = 1.0f / row_sum;
+                    for (int j = 0; j < out; ++j) yr[j] *= inv;
+                }
+                break;
+            case PlanOp::Activation:
+                if (x != y) std::copy(x, x + static_cast<size_t>(rows) * in, y);
+                break;
+        }
+        activate(s.activation, y, rows * out);
+    }
+
+    // y = x * W^T + b on the pre-packed panels; only the rows of x are packed.
+    void dense(const PlanStep& s, const float* x, float* y, int rows) {
+        int K = s.in_features, N = s.out_features;
+        for (int r = 0; r < rows; ++r) std::copy(s.shift.begin(), s.shift.end(), y + static_cast<size_t>(r) * N);
+        float* a_pack = arena.data();
+        const float* b_pack = s.weights.data();
+        for (int jc = 0; jc < N; jc += GEMM_NC) {
+            int nc = std::min(GEMM_NC, N - jc);
+            for (int pc = 0; pc < K; pc += GEMM_KC) {
+                int kc = std::min(GEMM_KC, K - pc);
+                for (int ic = 0; ic < rows; ic += GEMM_MC) {
+                    int mc = std::min(GEMM_MC, rows - ic);
+                    gemm_pack_a(false, x, K, ic, pc, mc, kc, a_pack);
+                    gemm_block(mc, nc, kc, a_pack, b_pack, y + static_cast<size_t>(ic) * N + jc, N);
+                }
+                b_pack += static_cast<size_t>(kc) * nc;
+            }
+        }
+    }
+
+    static void activate(PlanActivation act, float* y, int n) {
+        switch (act) {
+            case PlanActivation::None: break;
+            case PlanActivation::ReLU: for (int i = 0; i < n; ++i) y[i] = y[i] > 0.0f ? y[i] : 0.0f; break;
+            case PlanActivation::Tanh: vec_tanh(y, y, n); break;
+            case PlanActivation::Sigmoid: vec_sigmoid(y, y, n); break;
+        }
+    }
+
+    std::shared_ptr<const InferencePlan> plan;
+    std::vector<float> arena;
+    std::vector<float*> buffers;
+};
+
+#endif
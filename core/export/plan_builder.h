@@ -0,0 +1,217 @@
+#ifndef PLAN_BUILDER_H
+#define PLAN_BUILDER_H
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tensors/tensor.h"
+#include "nn/layers/linear.h"
+#include "nn/layers/normalization.h"
+#include "export/inference_plan.h"
+
+// Compiles a chain of layers into an InferencePlan. Layers are added in
+// forward order and optimized as they arrive:
+//   - an eval-mode BatchNorm1d directly after or before a Linear is folded
+//     into that Linear's weights and bias; otherwise it becomes one Affine step
+//   - an activation directly after a Dense, Affine or LayerNorm step is fused
+//     into that step instead of making another pass over the rows
+// build() then assigns every intermediate result to one of a few reusable
+// buffers. Only neighbouring results are alive at the same time, and
+// elementwise steps overwrite their input, so a chain of any length needs at
+// most two buffers.
+template<typename T>
+class PlanBuilder {
+public:
+    explicit PlanBuilder(int input_features) : features(input_features) {
+        if (input_features < 1) throw std::invalid_argument("ERROR: input_features must be positive.");
+        plan.input_features = input_features;
+    }
+
+    void add_linear(const std::shared_ptr<Linear<T>>& layer) {
+        auto params = layer->parameters();
+        int out = params[0]->shape[0], in = params[0]->shape[1];
+        expect_features(in, "Linear");
+        Node node;
+        node.op = PlanOp::Dense;
+        node.in_features = in;
+        node.out_features = out;
+        node.weights.assign(params[0]->data.get(), params[0]->data.get() + params[0]->size);
+        node.shift.assign(params[1]->data.get(), params[1]->data.get() + params[1]->size);
+
+        // fold a preceding batch norm: W (s * x + t) + b = (W diag(s)) x + (W t + b)
+        if (!nodes.empty() && nodes.back().op == PlanOp::Affine && nodes.back().activation == PlanActivation::None) {
+            const Node& bn = nodes.back();
+            for (int o = 0; o < out; ++o) {
+                double acc = node.shift[o];
+                for (int i = 0; i < in; ++i) {
+                    double& w = node.weights[static_cast<size_t>(o) * in + i];
+                    acc += w * bn.shift[i];
+                    w *= bn.scale[i];
+                }
+                node.shift[o] = acc;
+            }
+            nodes.pop_back();
+            ++folded;
+        }
+        nodes.push_back(std::move(node));
+        features = out;
+    }
+
+    void add_batch_norm(const std::shared_ptr<BatchNorm1d<T>>& layer) {
+        if (layer->training) {
+            throw std::invalid_argument("ERROR: Export BatchNorm1d in eval mode; its running statistics are folded into the plan.");
+        }
+        int c = layer->num_features;
+        expect_features(c, "BatchNorm1d");
+        auto affine = layer->parameters();
+        std::vector<double> scale(c), shift(c);
+        for (int j = 0; j < c; ++j) {
+            double g = affine.empty() ? 1.0 : static_cast<double>(affine[0]->data[j]);
+            double b = affine.empty() ? 0.0 : static_cast<double>(affine[1]->data[j]);
+            scale[j] = g / std::sqrt(static_cast<double>(layer->running_var->data[j]) + static_cast<double>(layer->eps));
+            shift[j] = b - static_cast<double>(layer->running_mean->data[j]) * scale[j];
+        }
+
+        // fold into a preceding Linear: s * (W x + b) + t = (diag(s) W) x + (s * b + t)
+        if (!nodes.empty() && nodes.back().op == PlanOp::Dense && nodes.back().activation == PlanActivation::None) {
+            Node& dense = nodes.back();
+            for (int o = 0; o < c; ++o) {
+                for (int i = 0; i < dense.in_features; ++i) dense.weights[static_cast<size_t>(o) * dense.in_features + i] *= scale[o];
+                dense.shift[o] = dense.shift[o] * scale[o] + shift[o];
+            }
+            ++folded;
+            return;
+        }
+        Node node;
+        node.op = PlanOp::Affine;
+        node.in_features = node.out_features = c;
+        node.scale = std::move(scale);
+        node.shift = std::move(shift);
+        nodes.push_back(std::move(node));
+    }
+
+    void add_layer_norm(const std::shared_ptr<LayerNorm<T>>& layer) {
+        int d = layer->normalized_shape;
+        expect_features(d, "LayerNorm");
+        auto affine = layer->parameters();
+        Node node;
+        node.op = PlanOp::LayerNorm;
+        node.in_features = node.out_features = d;
+        node.eps = static_cast<double>(layer->eps);
+        node.scale.assign(d, 1.0);
+        node.shift.assign(d, 0.0);
+        if (!affine.empty()) {
+            node.scale.assign(affine[0]->data.get(), affine[0]->data.get() + d);
+            node.shift.assign(affine[1]->data.get(), affine[1]->data.get() + d);
+        }
+        nodes.push_back(std::move(node));
+    }
+
+    // "relu", "tanh", "sigmoid" or "softmax" (over the feature axis).
+    void add_activation(const std::string& name) {
+        if (name == "softmax") {
+            nodes.push_back(elementwise(PlanOp::Softmax));
+            return;
+        }
+        PlanActivation act = parse_activation(name);
+        if (!nodes.empty() && nodes.back().op != PlanOp::Softmax && nodes.back().activation == PlanActivation::None) {
+            nodes.back().activation = act;
+            ++fused;
+            return;
+        }
+        Node node = elementwise(PlanOp::Activation);
+        node.activation = act;
+        nodes.push_back(std::move(node));
+    }
+
+    int folded_norms() const { return folded; }
+    int fused_activations() const { return fused; }
+
+    // max_batch: rows per chunk the runner's buffers are sized for.
+    InferencePlan build(int max_batch) const {
+        if (nodes.empty()) throw std::runtime_error("ERROR: Nothing to export.");
+        if (max_batch < 1) throw std::invalid_argument("ERROR: max_batch must be positive.");
+        InferencePlan result = plan;
+        result.max_batch = max_batch;
+        result.output_features = features;
+
+        int previous = PLAN_INPUT;
+        for (size_t k = 0; k < nodes.size(); ++k) {
+            const Node& node = nodes[k];
+            PlanStep step;
+            step.op = node.op;
+            step.activation = node.activation;
+            step.in_features = node.in_features;
+            step.out_features = node.out_features;
+            step.input = previous;
+            step.eps = static_cast<float>(node.eps);
+            step.scale.assign(node.scale.begin(), node.scale.end());
+            step.shift.assign(node.shift.begin(), node.shift.end());
+            if (node.op == PlanOp::Dense) {
+                std::vector<float> w(node.weights.begin(), node.weights.end());
+                step.weights = plan_pack_weights(w.data(), node.out_features, node.in_features);
+            }
+
+            if (k + 1 == nodes.size()) {
+                step.output = PLAN_OUTPUT;
+            } else if (node.op != PlanOp::Dense && previous >= 0) {
+                step.output = previous;   // elementwise: overwrite the input in place
+            } else {
+                // any buffer except the one being read
+                int b = previous == 0 ? 1 : 0;
+                if (b >= static_cast<int>(result.buffer_widths.size())) result.buffer_widths.resize(b + 1, 0);
+                result.buffer_widths[b] = std::max(result.buffer_widths[b], node.out_features);
+                step.output = b;
+            }
+            previous = step.output;
+            result.steps.push_back(std::move(step));
+        }
+        result.validate();
+        return result;
+    }
+
+private:
+    // Folding is done in double so exporting float64 layers loses nothing
+    // before the final rounding to float32.
+    struct Node {
+        PlanOp op = PlanOp::Activation;
+        PlanActivation activation = PlanActivation::None;
+        int in_features = 0;
+        int out_features = 0;
+        double eps = 0.0;
+        std::vector<double> weights;   // [out x in], unpacked until build()
+        std::vector<double> scale;
+        std::vector<double> shift;
+    };
+
+    static PlanActivation parse_activation(const std::string& name) {
+        if (name == "relu") return PlanActivation::ReLU;
+        if (name == "tanh") return PlanActivation::Tanh;
+        if (name == "sigmoid") return PlanActivation::Sigmoid;
+        throw std::invalid_argument("ERROR: Unknown activation '" + name + "'. Use relu, tanh, sigmoid or softmax.");
+    }
+
+    Node elementwise(PlanOp op) const {
+        Node node;
+        node.op = op;
+        node.in_features = node.out_features = features;
+        return node;
+    }
+
+    void expect_features(int in, const std::string& layer) const {
+        if (in != features) {
+            throw std::invalid_argument("ERROR: " + layer + " expects " + std::to_string(in) +
+                                        " features but receives " + std::to_string(features) + ".");
+        }
+    }
+
+    InferencePlan plan;
+    std::vector<Node> nodes;
+    int features;
+    int folded = 0;
+    int fused = 0;
+};
+
+#endif
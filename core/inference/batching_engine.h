@@ -0,0 +1,262 @@
+#ifndef BATCHING_ENGINE_H
+#define BATCHING_ENGINE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tensors/tensor.h"
+#include "inference/inference_model.h"
+
+// Log-scale histogram of latencies in microseconds with 8 buckets per octave,
+// so percentiles are exact to within about 4.5% at any magnitude.
+class LatencyHistogram {
+public:
+    static constexpr int kPerOctave = 8;
+    static constexpr int kBuckets = 32 * kPerOctave;
+
+    LatencyHistogram() : counts(kBuckets, 0) {}
+
+    void record(double us) {
+        int b = us <= 1.0 ? 0 : static_cast<int>(std::log2(us) * kPerOctave);
+        ++counts[std::min(b, kBuckets - 1)];
+        ++total;
+        sum += us;
+        max_us = std::max(max_us, us);
+    }
+
+    // Geometric midpoint of the bucket holding the p-th percentile (p in [0, 100]).
+    double percentile(double p) const {
+        if (total == 0) return 0.0;
+        long long rank = static_cast<long long>(std::ceil(p / 100.0 * total));
+        rank = std::max(1LL, std::min(rank, total));
+        long long seen = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            seen += counts[b];
+            if (seen >= rank) return std::min(std::exp2((b + 0.5) / kPerOctave), max_us);
+        }
+        return max_us;
+    }
+
+    long long count() const { return total; }
+    double mean() const { return total ? sum / total : 0.0; }
+    double max() const { return max_us; }
+
+    void reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        total = 0;
+        sum = 0.0;
+        max_us = 0.0;
+    }
+
+private:
+    std::vector<long long> counts;
+    long long total = 0;
+    double sum = 0.0;
+    double max_us = 0.0;
+};
+
+struct InferenceStats {
+    long long requests = 0;
+    long long batches = 0;
+    double mean_batch_size = 0.0;
+    double requests_per_second = 0.0;
+    double mean_us = 0.0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+    std::vector<long long> batch_sizes;   // batch_sizes[b] = number of batches of b rows
+};
+
+// Serves single-row requests from any number of threads by grouping them into
+// batches. A worker dispatches as soon as max_batch_size rows are queued or the
+// oldest queued row has waited max_latency_ms, runs one batched forward and
+// fulfils every request's future with its output row. With several workers one
+// batch is collected while others are being computed. Latency is measured from
+// submit() until the result is available.
+template<typename T>
+class BatchingEngine {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    BatchingEngine(std::shared_ptr<InferenceModel<T>> model, int max_batch_size = 32,
+                   double max_latency_ms = 2.0, int num_workers = 1)
+        : model(std::move(model)), max_batch_size(max_batch_size),
+          max_latency(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(max_latency_ms))),
+          batch_hist(max_batch_size + 1, 0), stats_start(Clock::now()) {
+        if (!this->model || this->model->input_features() == 0) {
+            throw std::invalid_argument("ERROR: BatchingEngine needs a model with at least one Linear layer.");
+        }
+        if (max_batch_size < 1) throw std::invalid_argument("ERROR: max_batch_size must be at least 1.");
+        if (max_latency_ms < 0) throw std::invalid_argument("ERROR: max_latency_ms must be non-negative.");
+        num_workers = std::max(1, num_workers);
+        for (int w = 0; w < num_workers; ++w) workers.emplace_back([this] { worker_loop(); });
+    }
+
+    ~BatchingEngine() { shutdown(); }
+
+    BatchingEngine(const BatchingEngine&) = delete;
+    BatchingEngine& operator=(const BatchingEngine&) = delete;
+
+    std::future<std::vector<T>> submit(std::vector<T> row) {
+        if (static_cast<int>(row.size()) != model->input_features()) {
+            throw std::invalid_argument("ERROR: Inference request has " + std::to_string(row.size()) +
+                                        " features, the model expects " + std::to_string(model->input_features()) + ".");
+        }
+        Request request{std::move(row), {}, Clock::now()};
+        auto future = request.result.get_future();
+        size_t queued;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stop) throw std::runtime_error("ERROR: The inference engine has been shut down.");
+            queue.push_back(std::move(request));
+            queued = queue.size();
+        }
+        // wake idle workers when a batch starts and the collecting one when it is full
+        if (queued == 1 || queued >= static_cast<size_t>(max_batch_size)) cv.notify_all();
+        return future;
+    }
+
+    std::vector<T> infer(std::vector<T> row) { return submit(std::move(row)).get(); }
+
+    // Finishes the queued requests, then stops the workers. Further submits throw.
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stop && workers.empty()) return;
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& worker : workers) worker.join();
+        workers.clear();
+    }
+
+    InferenceStats stats() const {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        InferenceStats s;
+        s.requests = latency.count();
+        s.batches = batches;
+        s.mean_batch_size = batches ? static_cast<double>(s.requests) / batches : 0.0;
+        double seconds = std::chrono::duration<double>(Clock::now() - stats_start).count();
+        s.requests_per_second = seconds > 0 ? s.requests / seconds : 0.0;
+        s.mean_us = latency.mean();
+        s.p50_us = latency.percentile(50);
+        s.p90_us = latency.percentile(90);
+        s.p99_us = latency.percentile(99);
+        s.max_us = latency.max();
+        s.batch_sizes = batch_hist;
+        return s;
+    }
+
+    void reset_stats() {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        latency.reset();
+        batches = 0;
+        std::fill(batch_hist.begin(), batch_hist.end(), 0);
+        stats_start = Clock::now();
+    }
+
+    int get_max_batch_size() const { return max_batch_size; }
+    double get_max_latency_ms() const { return std::chrono::duration<double, std::milli>(max_latency).count(); }
+    int num_workers() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct Request {
+        std::vector<T> row;
+        std::promise<std::vector<T>> result;
+        Clock::time_point enqueued;
+    };
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [&] { return stop || !queue.empty(); });
+            if (queue.empty()) return;   // stopped and drained
+
+            // hold the batch open until it is full or its oldest row is due
+            while (!stop && !queue.empty() && queue.size() < static_cast<size_t>(max_batch_size)) {
+                auto deadline = queue.front().enqueued + max_latency;
+                if (Clock::now() >= deadline) break;
+                cv.wait_until(lock, deadline);
+            }
+            if (queue.empty()) continue;   // another worker took it
+
+            size_t n = std::min(queue.size(), static_cast<size_t>(max_batch_size));
+            std::vector<Request> batch;
+            batch.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            lock.unlock();
+            run_batch(batch);
+            lock.lock();
+        }
+    }
+
+    void run_batch(std::vector<Request>& batch) {
+        int rows = static_cast<int>(batch.size());
+        int in = model->input_features();
+        std::shared_ptr<Tensor<T>> output;
+        std::exception_ptr error;
+        try {
+            auto input = std::make_shared<Tensor<T>>(std::vector<int>{rows, in}, false);
+            for (int r = 0; r < rows; ++r) {
+                std::copy(batch[r].row.begin(), batch[r].row.end(), input->data.get() + static_cast<size_t>(r) * in);
+            }
+            output = model->forward(input);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        // record before fulfilling, so a caller that has its result sees it counted
+        auto done = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            for (auto& request : batch) {
+                latency.record(std::chrono::duration<double, std::micro>(done - request.enqueued).count());
+            }
+            ++batches;
+            ++batch_hist[rows];
+        }
+
+        if (error) {
+            for (auto& request : batch) request.result.set_exception(error);
+            return;
+        }
+        int out = output->size / rows;
+        const T* data = output->data.get();
+        for (int r = 0; r < rows; ++r) {
+            const T* src = data + static_cast<size_t>(r) * out;
+            batch[r].result.set_value(std::vector<T>(src, src + out));
+        }
+    }
+
+    std::shared_ptr<InferenceModel<T>> model;
+    int max_batch_size;
+    Clock::duration max_latency;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request> queue;
+    bool stop = false;
+    std::vector<std::thread> workers;
+
+    mutable std::mutex stats_mutex;
+    LatencyHistogram latency;
+    long long batches = 0;
+    std::vector<long long> batch_hist;
+    Clock::time_point stats_start;
+};
+
+#endif
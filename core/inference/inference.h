@@ -0,0 +1,7 @@
+#ifndef INFERENCE_H
+#define INFERENCE_H
+
+#include "inference/inference_model.h"
+#include "inference/batching_engine.h"
+
+#endif
\ No newline at end of file
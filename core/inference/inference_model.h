@@ -0,0 +1,83 @@
+#ifndef INFERENCE_MODEL_H
+#define INFERENCE_MODEL_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_ops.h"
+#include "autograd/grad_mode.h"
+#include "nn/layers/linear.h"
+#include "nn/activations/activations.h"
+
+enum class StageKind { Linear, ReLU, Tanh, Sigmoid, Softmax };
+
+inline StageKind activation_stage(const std::string& name) {
+    if (name == "relu") return StageKind::ReLU;
+    if (name == "tanh") return StageKind::Tanh;
+    if (name == "sigmoid") return StageKind::Sigmoid;
+    if (name == "softmax") return StageKind::Softmax;
+    throw std::invalid_argument("ERROR: Unknown activation '" + name + "'. Use relu, tanh, sigmoid or softmax.");
+}
+
+// A feed-forward stack of Linear layers and activations evaluated without
+// autograd. Stages keep the layers they were added from, so a model keeps
+// serving the current weights (and their packed cache) without re-export.
+// forward() only reads the model and may be called from several threads.
+template<typename T>
+class InferenceModel {
+public:
+    struct Stage {
+        StageKind kind;
+        std::shared_ptr<Linear<T>> layer;
+    };
+
+    void add_linear(const std::shared_ptr<Linear<T>>& layer) {
+        auto params = layer->parameters();
+        int in = params[0]->shape[1];
+        if (out_f > 0 && in != out_f) {
+            throw std::invalid_argument("ERROR: Linear expects " + std::to_string(in) +
+                                        " input features but the previous stage produces " + std::to_string(out_f) + ".");
+        }
+        if (in_f == 0) in_f = in;
+        out_f = params[0]->shape[0];
+        stages.push_back({StageKind::Linear, layer});
+    }
+
+    void add_activation(const std::string& name) {
+        stages.push_back({activation_stage(name), nullptr});
+    }
+
+    int input_features() const { return in_f; }
+    int output_features() const { return out_f; }
+    const std::vector<Stage>& get_stages() const { return stages; }
+
+    // input: [batch, input_features]
+    std::shared_ptr<Tensor<T>> forward(std::shared_ptr<Tensor<T>> input) const {
+        if (stages.empty()) throw std::runtime_error("ERROR: The inference model has no stages.");
+        if (input->ndim != 2 || input->shape[1] != in_f) {
+            throw std::invalid_argument("ERROR: Inference input must have shape [batch, " + std::to_string(in_f) + "].");
+        }
+        NoGradGuard no_grad;
+        MemoryScope scope("inference");
+        auto h = std::move(input);
+        for (const Stage& stage : stages) {
+            switch (stage.kind) {
+                case StageKind::Linear: h = stage.layer->forward(h); break;
+                case StageKind::ReLU: h = relu(h); break;
+                case StageKind::Tanh: h = tanh_fn(h); break;
+                case StageKind::Sigmoid: h = sigmoid(h); break;
+                case StageKind::Softmax: h = softmax(h); break;
+            }
+        }
+        return h;
+    }
+
+private:
+    std::vector<Stage> stages;
+    int in_f = 0;
+    int out_f = 0;
+};
+
+#endif
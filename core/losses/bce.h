@@ -7,20 +7,35 @@
 #include "tensors/tensor.h"
 #include "tensors/tensor_ops.h"
 #include "autograd/autograd_losses.h"
+#include "autograd/forward_ad.h"
 
 template<typename T>
 std::shared_ptr<Tensor<T>> bce_loss(std::shared_ptr<Tensor<T>> y, std::shared_ptr<Tensor<T>> y_hat) {
+    MemoryScope scope("bce_loss");
     check_tensor_validity(y, y_hat);
+    const T* t_y = y->tangent ? y->tangent->data.get() : nullptr;
+    const T* t_y_hat = y_hat->tangent ? y_hat->tangent->data.get() : nullptr;
+    bool dual = t_y || t_y_hat;
     T loss_val = static_cast<T>(0);
+    T tangent_val = static_cast<T>(0);
     for (int i = 0; i < y_hat->size; ++i) {
-        loss_val += -(y->data[i] * std::log(y_hat->data[i]))
-            - ((1 - y->data[i]) * std::log(1 - y_hat->data[i]));
+        T log_p = std::log(y_hat->data[i]);
+        T log_q = std::log(1 - y_hat->data[i]);
+        loss_val += -(y->data[i] * log_p) - ((1 - y->data[i]) * log_q);
+        if (dual) {
+            T d_y_hat = -y->data[i] / y_hat->data[i] + (1 - y->data[i]) / (1 - y_hat->data[i]);
+            tangent_val += (t_y_hat ? d_y_hat * t_y_hat[i] : 0) + (t_y ? (log_q - log_p) * t_y[i] : 0);
+        }
     }
     loss_val /= static_cast<T>(y_hat->size);
+    tangent_val /= static_cast<T>(y_hat->size);
 
-    bool result_requires_grad = y->requires_grad || y_hat->requires_grad;
-    
+    bool result_requires_grad = GradMode::resolve(y->requires_grad || y_hat->requires_grad);
+
+    // kept by the caller after the step, so it must not pin a step arena chunk
+    StepArenaBypass heap;
     auto result = std::make_shared<Tensor<T>>(std::vector<T>{loss_val}, std::vector<int>{1}, result_requires_grad);
+    if (dual) result->tangent = std::make_shared<Tensor<T>>(std::vector<T>{tangent_val}, std::vector<int>{1}, false);
 
     if (result->requires_grad) {
         result->parents.push_back(y);
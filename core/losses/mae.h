@@ -7,19 +7,34 @@
 #include "tensors/tensor.h"
 #include "tensors/tensor_ops.h"
 #include "autograd/autograd_losses.h"
+#include "autograd/forward_ad.h"
 
 template<typename T>
 std::shared_ptr<Tensor<T>> mae_loss(std::shared_ptr<Tensor<T>> y, std::shared_ptr<Tensor<T>> y_hat) {
+    MemoryScope scope("mae_loss");
     check_tensor_validity(y, y_hat);
+    const T* t_y = y->tangent ? y->tangent->data.get() : nullptr;
+    const T* t_y_hat = y_hat->tangent ? y_hat->tangent->data.get() : nullptr;
+    bool dual = t_y || t_y_hat;
     T loss_val = static_cast<T>(0);
+    T tangent_val = static_cast<T>(0);
     for (int i = 0; i < y_hat->size; ++i) {
-        loss_val += std::abs(y_hat->data[i] - y->data[i]);
+        T diff = y_hat->data[i] - y->data[i];
+        loss_val += std::abs(diff);
+        if (dual) {
+            T sign = (diff > 0) ? static_cast<T>(1) : ((diff < 0) ? static_cast<T>(-1) : static_cast<T>(0));
+            tangent_val += sign * ((t_y_hat ? t_y_hat[i] : 0) - (t_y ? t_y[i] : 0));
+        }
     }
     loss_val /= static_cast<T>(y_hat->size);
+    tangent_val /= static_cast<T>(y_hat->size);
 
-    bool result_requires_grad = y->requires_grad || y_hat->requires_grad;
-    
+    bool result_requires_grad = GradMode::resolve(y->requires_grad || y_hat->requires_grad);
+
+    // kept by the caller after the step, so it must not pin a step arena chunk
+    StepArenaBypass heap;
     auto result = std::make_shared<Tensor<T>>(std::vector<T>{loss_val}, std::vector<int>{1}, result_requires_grad);
+    if (dual) result->tangent = std::make_shared<Tensor<T>>(std::vector<T>{tangent_val}, std::vector<int>{1}, false);
 
     if (result->requires_grad) {
         result->parents.push_back(y);
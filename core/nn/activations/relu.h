@@ -2,20 +2,37 @@
 #define RELU_H
 
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include "tensors/tensor.h"
+#include "tensors/tensor_precision.h"
 #include "autograd/autograd_activations.h"
+#include "autograd/gradient_edge.h"
+#include "autograd/forward_ad.h"
 
 template<typename T>
 std::shared_ptr<Tensor<T>> relu(std::shared_ptr<Tensor<T>> tensor) {
-    auto result = std::make_shared<Tensor<T>>(tensor->shape, tensor->requires_grad);
+    MemoryScope scope("relu");
+    auto result = std::make_shared<Tensor<T>>(tensor->shape, GradMode::resolve(tensor->requires_grad));
+    result->tangent = unary_tangent(*tensor);
+    const T* x = tensor->data.get();
+    T* y = result->data.get();
+    const T* tx = result->tangent ? tensor->tangent->data.get() : nullptr;
+    T* ty = result->tangent ? result->tangent->data.get() : nullptr;
 
-    for (int i = 0; i < result->size; ++i) {
-        result->data[i] = (tensor->data[i] > 0) ? tensor->data[i] : static_cast<T>(0);
-    }
+    dual_loop(result->size, ty != nullptr,
+              [&](int i) { y[i] = (x[i] > 0) ? x[i] : static_cast<T>(0); },
+              [&](int i) { ty[i] = (x[i] > 0) ? tx[i] : static_cast<T>(0); });
+    autocast_output(*result);
 
-    if (tensor->requires_grad) {
-        result->parents.push_back(tensor);
-        result->grad_fn = std::make_unique<ReluBackward<T>>(tensor);
+    if (result->requires_grad) {
+        std::vector<uint32_t> mask((result->size + 31) / 32, 0u);
+        for (int i = 0; i < result->size; ++i) {
+            mask[i >> 5] |= static_cast<uint32_t>(tensor->data[i] > 0) << (i & 31);
+        }
+        auto edge = gradient_edge(tensor);
+        result->parents.push_back(edge);
+        result->grad_fn = std::make_unique<ReluBackward<T>>(edge, std::move(mask));
     }
     return result;
 }
@@ -1,22 +1,38 @@
 #ifndef SIGMOID_H
 #define SIGMOID_H
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include "tensors/tensor.h"
+#include "tensors/tensor_precision.h"
+#include "tensors/vec_math.h"
+#include "utils/parallel.h"
 #include "autograd/autograd_activations.h"
+#include "autograd/gradient_edge.h"
+#include "autograd/forward_ad.h"
 
 template<typename T>
 std::shared_ptr<Tensor<T>> sigmoid(std::shared_ptr<Tensor<T>> tensor) {
-    auto result = std::make_shared<Tensor<T>>(tensor->shape, tensor->requires_grad);
+    MemoryScope scope("sigmoid");
+    auto result = std::make_shared<Tensor<T>>(tensor->shape, GradMode::resolve(tensor->requires_grad));
 
-    for (int i = 0; i < result->size; ++i) {
-        result->data[i] = 1 / (1 + exp(-tensor->data[i]));
-    }
+    const T* in = tensor->data.get();
+    T* out = result->data.get();
+    result->tangent = unary_tangent(*tensor);
+    const T* t_in = result->tangent ? tensor->tangent->data.get() : nullptr;
+    T* t_out = result->tangent ? result->tangent->data.get() : nullptr;
+    dual_blocks(result->size, VEC_MATH_GRAIN, t_out != nullptr,
+                [&](int b, int n) { vec_sigmoid(in + b, out + b, n); },
+                [&](int b, int n) {
+                    for (int i = b; i < b + n; ++i) t_out[i] = out[i] * (static_cast<T>(1) - out[i]) * t_in[i];
+                });
+    autocast_output(*result);
 
-    if (tensor->requires_grad) {
-        result->parents.push_back(tensor);
-        result->grad_fn = std::make_unique<SigmoidBackward<T>>(tensor);
+    if (result->requires_grad) {
+        auto edge = gradient_edge(tensor);
+        result->parents.push_back(edge);
+        result->grad_fn = std::make_unique<SigmoidBackward<T>>(edge, result);
     }
     return result;
 }
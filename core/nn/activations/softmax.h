@@ -1,39 +1,60 @@
 #ifndef SOFTMAX_H
 #define SOFTMAX_H
 
+#include <algorithm>
 #include <memory>
 #include "tensors/tensor.h"
-#include "tensors/tensor_ops.h"
-#include "tensors/tensor_math.h"
-#include "tensors/tensor_reductions.h"
-
+#include "tensors/vec_math.h"
+#include "utils/parallel.h"
+#include "autograd/autograd_activations.h"
+#include "autograd/gradient_edge.h"
+#include "autograd/forward_ad.h"
+
+// One pass per row: max, exp(x - max) with the vectorized kernel, then a
+// single normalization. Backward uses only the saved output. The tangent,
+// y * (tx - sum(y * tx)), is computed for each row right after it.
 template<typename T>
 std::shared_ptr<Tensor<T>> softmax(std::shared_ptr<Tensor<T>> tensor, int axis = -1) {
+    MemoryScope scope("softmax");
     if(axis != -1 && axis != tensor->ndim - 1) {
         throw std::runtime_error("ERROR: Softmax currently supports only the last axis");
     }
 
-    auto max_tensor = max(tensor, axis);
-
-    auto shifted = tensor_sub(tensor, max_tensor);
-
-    auto exp_tensor = tensor_exp<T, T>(shifted);
-
-    auto sum_tensor = std::make_shared<Tensor<T>>(tensor->shape, tensor->requires_grad);
-    for(int i = 0; i < tensor->shape[0]; ++i) { // i will replace this with sum() later
-        T row_sum = 0;
-        for(int j = 0; j < tensor->shape[1]; ++j) {
-            int idx = i * tensor->shape[1] + j;
-            row_sum += exp_tensor->data[idx];
+    int dim = tensor->shape.back();
+    int rows = dim > 0 ? tensor->size / dim : 0;
+    auto result = std::make_shared<Tensor<T>>(tensor->shape, GradMode::resolve(tensor->requires_grad));
+    const T* in = tensor->data.get();
+    T* out = result->data.get();
+    result->tangent = unary_tangent(*tensor);
+    const T* t_in = result->tangent ? tensor->tangent->data.get() : nullptr;
+    T* t_out = result->tangent ? result->tangent->data.get() : nullptr;
+
+    parallel_for(0, rows, std::max(1, 4096 / std::max(dim, 1)), [&](int begin, int end) {
+        for (int r = begin; r < end; ++r) {
+            const T* x = in + static_cast<size_t>(r) * dim;
+            T* y = out + static_cast<size_t>(r) * dim;
+            T row_max = *std::max_element(x, x + dim);
+            for (int j = 0; j < dim; ++j) y[j] = x[j] - row_max;
+            vec_exp(y, y, dim);
+            T row_sum = 0;
+            for (int j = 0; j < dim; ++j) row_sum += y[j];
+            T inv = static_cast<T>(1) / row_sum;
+            for (int j = 0; j < dim; ++j) y[j] *= inv;
+            if (!t_out) continue;
+
+            const T* tx = t_in + static_cast<size_t>(r) * dim;
+            T* ty = t_out + static_cast<size_t>(r) * dim;
+            T dot = 0;
+            for (int j = 0; j < dim; ++j) dot += y[j] * tx[j];
+            for (int j = 0; j < dim; ++j) ty[j] = y[j] * (tx[j] - dot);
         }
-        for(int j = 0; j < tensor->shape[1]; ++j) {
-            int idx = i * tensor->shape[1] + j;
-            sum_tensor->data[idx] = row_sum;
-        }
-    }
-
-    auto result = tensor_div(exp_tensor, sum_tensor);
+    });
 
+    if (result->requires_grad) {
+        auto edge = gradient_edge(tensor);
+        result->parents.push_back(edge);
+        result->grad_fn = std::make_unique<SoftmaxBackward<T>>(edge, result, dim);
+    }
     return result;
 }
 
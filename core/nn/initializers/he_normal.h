@@ -1,26 +1,20 @@
 #ifndef HE_NORMAL_H
 #define HE_NORMAL_H
 
-#include <random>
 #include <cmath>
 #include <cstddef>
 #include "tensors/tensor.h"
+#include "utils/random.h"
 
 template<typename T>
 class HeNormal {
 public:
     void initialize(Tensor<T>& weights) {
         if (!weights.data || weights.ndim < 2) return;
-        size_t fan_in = weights.shape[1];
+        size_t fan_in = weights.size / weights.shape[0];
         double std_dev = std::sqrt(2.0 / fan_in);
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::normal_distribution<T> dist(0.0, std_dev);
-
-        for (int i = 0; i < weights.size; ++i) {
-            weights.data[i] = dist(gen);
-        }
+        random_normal<T>(weights.data.get(), weights.size, 0, static_cast<T>(std_dev));
     }
 };
 
@@ -1,10 +1,10 @@
 #ifndef XAVIER_UNIFORM_H
 #define XAVIER_UNIFORM_H
 
-#include <random>
 #include <cmath>
 #include <cstddef>
 #include "tensors/tensor.h"
+#include "utils/random.h"
 
 template<typename T>
 class XavierUniform {
@@ -12,17 +12,12 @@ public:
     void initialize(Tensor<T>& weights) {
         if (!weights.data || weights.ndim < 2) return;
 
-        size_t fan_in = weights.shape[1];
-        size_t fan_out = weights.shape[0];
+        size_t receptive_field = weights.size / (weights.shape[0] * weights.shape[1]);
+        size_t fan_in = weights.shape[1] * receptive_field;
+        size_t fan_out = weights.shape[0] * receptive_field;
         double limit = std::sqrt(6.0 / (fan_in + fan_out));
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<T> dist(-limit, limit);
-
-        for (int i = 0; i < weights.size; ++i) {
-            weights.data[i] = dist(gen);
-        }
+        random_uniform<T>(weights.data.get(), weights.size, static_cast<T>(-limit), static_cast<T>(limit));
     }
 };
 
@@ -0,0 +1,74 @@
+#ifndef ATTENTION_H
+#define ATTENTION_H
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include "tensors/tensor.h"
+#include "tensors/tensor_attention.h"
+#include "autograd/autograd_attention.h"
+#include "utils/parallel.h"
+
+// softmax(q k^T * scale + mask) v over the last two dimensions.
+// q: [..., L, D], k: [..., S, D], v: [..., S, Dv] with identical leading
+// dimensions (e.g. batch and heads). mask is an additive [L, S] tensor shared by
+// all heads, or null; causal hides keys j > i. scale <= 0 selects 1 / sqrt(D).
+// Heads are processed in parallel.
+template<typename T>
+std::shared_ptr<Tensor<T>> scaled_dot_product_attention(const std::shared_ptr<Tensor<T>>& q,
+                                                        const std::shared_ptr<Tensor<T>>& k,
+                                                        const std::shared_ptr<Tensor<T>>& v,
+                                                        const std::shared_ptr<Tensor<T>>& mask = nullptr,
+                                                        bool causal = false, double scale = 0.0) {
+    MemoryScope scope("attention");
+    if (q->ndim < 2 || q->ndim != k->ndim || q->ndim != v->ndim) {
+        throw std::invalid_argument("ERROR: Attention inputs must have the same number of dimensions (at least 2).");
+    }
+    int nd = q->ndim;
+    for (int i = 0; i < nd - 2; ++i) {
+        if (q->shape[i] != k->shape[i] || q->shape[i] != v->shape[i]) {
+            throw std::invalid_argument("ERROR: Attention inputs must share their leading dimensions.");
+        }
+    }
+    AttentionGeometry g;
+    g.q_len = q->shape[nd - 2];
+    g.k_len = k->shape[nd - 2];
+    g.head_dim = q->shape[nd - 1];
+    g.value_dim = v->shape[nd - 1];
+    g.causal = causal;
+    g.scale = scale > 0.0 ? scale : 1.0 / std::sqrt(static_cast<double>(g.head_dim));
+    if (k->shape[nd - 1] != g.head_dim || v->shape[nd - 2] != g.k_len) {
+        throw std::invalid_argument("ERROR: Attention key/value shapes do not match the query.");
+    }
+    if (mask && (mask->ndim != 2 || mask->shape[0] != g.q_len || mask->shape[1] != g.k_len)) {
+        throw std::invalid_argument("ERROR: Attention mask must have shape [L, S].");
+    }
+
+    int heads = q->size / (g.q_len * g.head_dim);
+    std::vector<int> out_shape(q->shape);
+    out_shape.back() = g.value_dim;
+    bool requires_grad = GradMode::resolve(q->requires_grad || k->requires_grad || v->requires_grad);
+    auto result = std::make_shared<Tensor<T>>(out_shape, requires_grad);
+    std::vector<T> lse(static_cast<size_t>(heads) * g.q_len);
+
+    size_t q_head = static_cast<size_t>(g.q_len) * g.head_dim;
+    size_t k_head = static_cast<size_t>(g.k_len) * g.head_dim;
+    size_t v_head = static_cast<size_t>(g.k_len) * g.value_dim;
+    size_t o_head = static_cast<size_t>(g.q_len) * g.value_dim;
+    parallel_for(0, heads, 1, [&](int begin, int end) {
+        for (int h = begin; h < end; ++h) {
+            attention_forward_head(q->data.get() + h * q_head, k->data.get() + h * k_head,
+                                   v->data.get() + h * v_head, mask ? mask->data.get() : nullptr, g,
+                                   result->data.get() + h * o_head, lse.data() + static_cast<size_t>(h) * g.q_len);
+        }
+    });
+
+    if (result->requires_grad) {
+        result->parents = {q, k, v};
+        result->grad_fn = std::make_unique<AttentionBackward<T>>(q, k, v, mask, result, std::move(lse), g, heads);
+    }
+    return result;
+}
+
+#endif
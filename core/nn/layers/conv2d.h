@@ -0,0 +1,142 @@
+#ifndef CONV2D_H
+#define CONV2D_H
+
+#include <memory>
+#include <vector>
+#include <variant>
+#include <type_traits>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include "tensors/tensor.h"
+#include "tensors/tensor_conv.h"
+#include "autograd/autograd_conv.h"
+#include "utils/parallel.h"
+#include "nn/layers/linear.h"
+
+// input: [N, C, H, W], weight: [OC, C / groups, KH, KW], bias: [OC] or null.
+// Returns [N, OC, OH, OW]. See tensors/tensor_conv.h for the layout rationale.
+template<typename T>
+std::shared_ptr<Tensor<T>> conv2d(const std::shared_ptr<Tensor<T>>& input,
+                                  const std::shared_ptr<Tensor<T>>& weight,
+                                  const std::shared_ptr<Tensor<T>>& bias,
+                                  int stride = 1, int padding = 0, int dilation = 1, int groups = 1) {
+    MemoryScope scope("conv2d");
+    if (input->ndim != 4 || weight->ndim != 4) {
+        throw std::invalid_argument("ERROR: conv2d expects a 4D NCHW input and a 4D weight.");
+    }
+    if (stride < 1 || dilation < 1 || padding < 0 || groups < 1) {
+        throw std::invalid_argument("ERROR: Invalid stride, padding, dilation or groups for conv2d.");
+    }
+    int batch = input->shape[0];
+    int in_c = input->shape[1];
+    int out_c = weight->shape[0];
+    if (in_c % groups != 0 || out_c % groups != 0) {
+        throw std::invalid_argument("ERROR: Channels must be divisible by groups.");
+    }
+    int in_per_group = in_c / groups;
+    int out_per_group = out_c / groups;
+    if (weight->shape[1] != in_per_group) {
+        throw std::invalid_argument("ERROR: Weight shape does not match input channels.");
+    }
+    if (bias && bias->size != out_c) {
+        throw std::invalid_argument("ERROR: Bias size must equal the number of output channels.");
+    }
+
+    Conv2dGeometry g(in_per_group, input->shape[2], input->shape[3],
+                     weight->shape[2], weight->shape[3], stride, padding, dilation);
+    if (g.out_h <= 0 || g.out_w <= 0) {
+        throw std::invalid_argument("ERROR: Kernel is larger than the padded input.");
+    }
+    ConvKernel kernel = select_conv_kernel(g, out_per_group);
+    int plane = g.height * g.width;
+    int pixels = g.out_pixels();
+    int weight_group = out_per_group * g.col_rows();
+
+    bool requires_grad = GradMode::resolve(input->requires_grad || weight->requires_grad || (bias && bias->requires_grad));
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{batch, out_c, g.out_h, g.out_w}, requires_grad);
+
+    // One task per (image, group); each writes its own block of the output.
+    int task_work = std::max(1, weight_group * pixels);
+    parallel_for(0, batch * groups, std::max(1, 65536 / task_work), [&](int begin, int end) {
+        for (int t = begin; t < end; ++t) {
+            int n = t / groups;
+            int gi = t % groups;
+            T* out = result->data.get() + (n * out_c + gi * out_per_group) * pixels;
+            conv2d_forward_group(input->data.get() + (n * in_c + gi * in_per_group) * plane,
+                                 weight->data.get() + gi * weight_group, out, g, out_per_group, kernel);
+            if (bias) {
+                for (int oc = 0; oc < out_per_group; ++oc) {
+                    T b = bias->data[gi * out_per_group + oc];
+                    for (int i = 0; i < pixels; ++i) out[oc * pixels + i] += b;
+                }
+            }
+        }
+    });
+
+    if (result->requires_grad) {
+        result->parents = {input, weight};
+        if (bias) result->parents.push_back(bias);
+        result->grad_fn = std::make_unique<Conv2dBackward<T>>(input, weight, bias, stride, padding, dilation, groups);
+    }
+    return result;
+}
+
+template<typename T>
+class Conv2d;
+
+template<typename T>
+std::string conv2d_repr(const Conv2d<T>& conv_layer);
+
+template<typename T>
+class Conv2d {
+private:
+    std::shared_ptr<Tensor<T>> weights;
+    std::shared_ptr<Tensor<T>> bias;
+
+    int in_channels;
+    int out_channels;
+    int kernel_size;
+    int stride;
+    int padding;
+    int dilation;
+    int groups;
+    friend std::string conv2d_repr<T>(const Conv2d<T>&);
+
+public:
+    Conv2d(int in_ch, int out_ch, int kernel, int stride_, int padding_, int dilation_, int groups_,
+           Initializer<T> weight_init,
+           Initializer<T> bias_init)
+        : in_channels(in_ch), out_channels(out_ch), kernel_size(kernel),
+          stride(stride_), padding(padding_), dilation(dilation_), groups(groups_) {
+        if (groups < 1 || in_ch % groups != 0 || out_ch % groups != 0) {
+            throw std::invalid_argument("ERROR: Channels must be divisible by groups.");
+        }
+        MemoryScope scope("conv2d", MemoryCategory::Parameter);
+        weights = std::make_shared<Tensor<T>>(std::vector<int>{out_ch, in_ch / groups, kernel, kernel}, true);
+        bias = std::make_shared<Tensor<T>>(std::vector<int>{out_ch}, true);
+
+        std::visit([this](auto&& arg){ arg->initialize(*(this->weights)); }, weight_init);
+        std::visit([this](auto&& arg){ arg->initialize(*(this->bias)); }, bias_init);
+    }
+
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<T>>& input) {
+        return conv2d(input, weights, bias, stride, padding, dilation, groups);
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> parameters() {
+        return {weights, bias};
+    }
+};
+
+template<typename T>
+std::string conv2d_repr(const Conv2d<T>& conv_layer) {
+    return "Conv2d(" + std::to_string(conv_layer.in_channels) + ", " + std::to_string(conv_layer.out_channels) +
+           ", kernel_size=" + std::to_string(conv_layer.kernel_size) +
+           ", stride=" + std::to_string(conv_layer.stride) +
+           ", padding=" + std::to_string(conv_layer.padding) +
+           ", dilation=" + std::to_string(conv_layer.dilation) +
+           ", groups=" + std::to_string(conv_layer.groups) + ")";
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef DROPOUT_H
+#define DROPOUT_H
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tensors/tensor.h"
+#include "autograd/autograd_dropout.h"
+#include "utils/random.h"
+
+// Zeroes each element with probability p and scales the rest by 1 / (1 - p).
+// The mask is a function of the draw's counter range, so backward regenerates
+// it and nothing but the PhiloxState is kept. Outside training (or with p = 0)
+// the input is returned unchanged.
+template<typename T>
+std::shared_ptr<Tensor<T>> dropout(const std::shared_ptr<Tensor<T>>& input, double p, bool training = true) {
+    if (!(p >= 0.0 && p < 1.0)) {
+        throw std::invalid_argument("ERROR: Dropout probability must be in [0, 1).");
+    }
+    if (!training || p == 0.0) return input;
+
+    MemoryScope scope("dropout");
+    PhiloxState state = RandomGenerator::global().reserve((static_cast<size_t>(input->size) + 3) / 4);
+    uint32_t threshold = static_cast<uint32_t>(std::ldexp(p, 32));
+    T scale = static_cast<T>(1.0 / (1.0 - p));
+
+    auto result = std::make_shared<Tensor<T>>(input->shape, GradMode::resolve(input->requires_grad));
+    dropout_apply(state, input->data.get(), result->data.get(), static_cast<size_t>(input->size), threshold, scale, false);
+
+    if (result->requires_grad) {
+        result->parents = {input};
+        result->grad_fn = std::make_unique<DropoutBackward<T>>(input, state, threshold, scale);
+    }
+    return result;
+}
+
+template<typename T>
+class Dropout {
+public:
+    double p;
+    bool training = true;
+
+    explicit Dropout(double p) : p(p) {
+        if (!(p >= 0.0 && p < 1.0)) {
+            throw std::invalid_argument("ERROR: Dropout probability must be in [0, 1).");
+        }
+    }
+
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<T>>& input) {
+        return dropout(input, p, training);
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> parameters() {
+        return {};
+    }
+};
+
+template<typename T>
+std::string dropout_repr(const Dropout<T>& layer) {
+    return "Dropout(p=" + std::to_string(layer.p) + ", training=" + (layer.training ? "True" : "False") + ")";
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef EMBEDDING_H
+#define EMBEDDING_H
+
+#include <memory>
+#include <vector>
+#include <variant>
+#include <type_traits>
+#include <string>
+#include <stdexcept>
+#include "tensors/tensor.h"
+#include "autograd/autograd_embedding.h"
+#include "utils/parallel.h"
+#include "nn/layers/linear.h"
+
+// Gathers rows of weight [num_embeddings, dim]. The result has the shape of
+// indices with dim appended.
+template<typename T>
+std::shared_ptr<Tensor<T>> embedding(const std::shared_ptr<Tensor<T>>& weight,
+                                     const std::shared_ptr<Tensor<int>>& indices,
+                                     bool sparse = true) {
+    MemoryScope scope("embedding");
+    if (weight->ndim != 2) {
+        throw std::invalid_argument("ERROR: Embedding weight must be 2D.");
+    }
+    int rows = weight->shape[0];
+    int dim = weight->shape[1];
+
+    std::vector<int> idx(indices->data.get(), indices->data.get() + indices->size);
+    for (int i : idx) {
+        if (i < 0 || i >= rows) throw std::out_of_range("ERROR: Embedding index out of range.");
+    }
+
+    std::vector<int> out_shape(indices->shape);
+    out_shape.push_back(dim);
+    auto result = std::make_shared<Tensor<T>>(out_shape, GradMode::resolve(weight->requires_grad));
+
+    const T* table = weight->data.get();
+    T* out = result->data.get();
+    parallel_for(0, static_cast<int>(idx.size()), std::max(1, 16384 / dim), [&](int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            const T* src = table + static_cast<size_t>(idx[k]) * dim;
+            std::copy(src, src + dim, out + static_cast<size_t>(k) * dim);
+        }
+    });
+
+    if (result->requires_grad) {
+        result->parents = {weight};
+        result->grad_fn = std::make_unique<EmbeddingBackward<T>>(weight, std::move(idx), sparse);
+    }
+    return result;
+}
+
+template<typename T>
+class Embedding;
+
+template<typename T>
+std::string embedding_repr(const Embedding<T>& layer);
+
+template<typename T>
+class Embedding {
+private:
+    std::shared_ptr<Tensor<T>> weights;
+
+    int num_embeddings;
+    int embedding_dim;
+    bool sparse;
+    friend std::string embedding_repr<T>(const Embedding<T>&);
+
+public:
+    Embedding(int num_embeddings, int embedding_dim, bool sparse, Initializer<T> weight_init)
+        : num_embeddings(num_embeddings), embedding_dim(embedding_dim), sparse(sparse) {
+        MemoryScope scope("embedding", MemoryCategory::Parameter);
+        weights = std::make_shared<Tensor<T>>(std::vector<int>{num_embeddings, embedding_dim}, true);
+        std::visit([this](auto&& arg){ arg->initialize(*(this->weights)); }, weight_init);
+    }
+
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<int>>& indices) {
+        return embedding(weights, indices, sparse);
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> parameters() {
+        return {weights};
+    }
+};
+
+template<typename T>
+std::string embedding_repr(const Embedding<T>& layer) {
+    std::string dtype_name;
+    if (std::is_same_v<T, float>) {
+        dtype_name = "float32";
+    } else if (std::is_same_v<T, double>) {
+        dtype_name = "float64";
+    } else {
+        dtype_name = "int32";
+    }
+
+    return "Embedding(num_embeddings=" + std::to_string(layer.num_embeddings) +
+           ", embedding_dim=" + std::to_string(layer.embedding_dim) +
+           ", sparse=" + (layer.sparse ? "True" : "False") +
+           ", dtype='" + dtype_name + "')";
+}
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef ENSEMBLE_LINEAR_H
+#define ENSEMBLE_LINEAR_H
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_gemm.h"
+#include "autograd/autograd_linear.h"
+#include "nn/layers/linear.h"
+#include "utils/parallel.h"
+
+// Members per thread so that a chunk does at least ~64K multiply-adds.
+inline int ensemble_grain(int rows, int in_f, int out_f) {
+    long long work = static_cast<long long>(rows) * in_f * out_f;
+    return static_cast<int>(std::max(1LL, (1LL << 16) / std::max(1LL, work)));
+}
+
+// M independent Linear layers evaluated together: weight [M x out x in] and
+// bias [M x 1 x out] stack the members' parameters. input is either
+// [M x rows x in], one batch per member, or [rows x in] shared by all of them;
+// the result is [M x rows x out]. The members' GEMMs run in parallel.
+template<typename T>
+std::shared_ptr<Tensor<T>> ensemble_linear(const std::shared_ptr<Tensor<T>>& input,
+                                           const std::shared_ptr<Tensor<T>>& weight,
+                                           const std::shared_ptr<Tensor<T>>& bias) {
+    MemoryScope scope("ensemble_linear");
+    if (weight->ndim != 3 || bias->ndim != 3 || bias->shape[0] != weight->shape[0] || bias->shape[2] != weight->shape[1]) {
+        throw std::invalid_argument("ERROR: Ensemble weight must be [M, out, in] and bias [M, 1, out].");
+    }
+    int members = weight->shape[0];
+    int out_f = weight->shape[1];
+    int in_f = weight->shape[2];
+    bool shared = input->ndim == 2;
+    if ((input->ndim != 2 && input->ndim != 3) || input->shape[input->ndim - 1] != in_f ||
+        (!shared && input->shape[0] != members)) {
+        throw std::invalid_argument("ERROR: Ensemble input must be [M, rows, " + std::to_string(in_f) +
+                                    "] or [rows, " + std::to_string(in_f) + "].");
+    }
+    int rows = input->shape[input->ndim - 2];
+    size_t x_step = shared ? 0 : static_cast<size_t>(rows) * in_f;
+    size_t w_step = static_cast<size_t>(out_f) * in_f;
+    size_t y_step = static_cast<size_t>(rows) * out_f;
+
+    bool requires_grad = GradMode::resolve(input->requires_grad || weight->requires_grad || bias->requires_grad);
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{members, rows, out_f}, requires_grad);
+    const T* x = input->data.get();
+    const T* w = weight->data.get();
+    const T* b = bias->data.get();
+    T* y = result->data.get();
+    int grain = ensemble_grain(rows, in_f, out_f);
+    parallel_for(0, members, grain, [&](int begin, int end) {
+        for (int m = begin; m < end; ++m) {
+            T* y_m = y + m * y_step;
+            const T* b_m = b + static_cast<size_t>(m) * out_f;
+            for (int r = 0; r < rows; ++r) std::copy(b_m, b_m + out_f, y_m + static_cast<size_t>(r) * out_f);
+            gemm(false, true, rows, out_f, in_f, x + m * x_step, in_f, w + m * w_step, in_f, y_m, out_f, true);
+        }
+    });
+
+    if (result->requires_grad) {
+        result->parents = {input, weight, bias};
+        result->grad_fn = std::make_unique<EnsembleLinearBackward<T>>(input, weight, bias, grain);
+    }
+    return result;
+}
+
+template<typename T>
+class EnsembleLinear;
+
+template<typename T>
+std::string ensemble_linear_repr(const EnsembleLinear<T>& layer);
+
+// An ensemble of num_models Linear layers of the same shape, trained as one
+// layer: one graph node per forward and one optimizer update per stacked
+// tensor. Each member is initialized on its own, as a separate Linear would
+// be, and members can be copied from and to ordinary Linear layers.
+template<typename T>
+class EnsembleLinear {
+private:
+    std::shared_ptr<Tensor<T>> weights;
+    std::shared_ptr<Tensor<T>> bias;
+
+    int members;
+    int input_f;
+    int output_f;
+    friend std::string ensemble_linear_repr<T>(const EnsembleLinear<T>&);
+
+public:
+    EnsembleLinear(int num_models, int input_features, int output_features,
+                   Initializer<T> weight_init, Initializer<T> bias_init)
+        : members(num_models), input_f(input_features), output_f(output_features) {
+        if (num_models < 1) throw std::invalid_argument("ERROR: An ensemble needs at least one model.");
+        MemoryScope scope("ensemble_linear", MemoryCategory::Parameter);
+        weights = std::make_shared<Tensor<T>>(std::vector<int>{num_models, output_features, input_features}, true);
+        bias = std::make_shared<Tensor<T>>(std::vector<int>{num_models, 1, output_features}, true);
+
+        Tensor<T> member_w(std::vector<int>{output_features, input_features}, false);
+        Tensor<T> member_b(std::vector<int>{1, output_features}, false);
+        for (int m = 0; m < num_models; ++m) {
+            std::visit([&](auto&& arg) { arg->initialize(member_w); }, weight_init);
+            std::visit([&](auto&& arg) { arg->initialize(member_b); }, bias_init);
+            std::copy(member_w.data.get(), member_w.data.get() + member_w.size, weights->data.get() + static_cast<size_t>(m) * member_w.size);
+            std::copy(member_b.data.get(), member_b.data.get() + member_b.size, bias->data.get() + static_cast<size_t>(m) * member_b.size);
+        }
+    }
+
+    int num_models() const { return members; }
+
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<T>>& input) {
+        return ensemble_linear(input, weights, bias);
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> parameters() {
+        return {weights, bias};
+    }
+
+    // Overwrites member m with the parameters of layer.
+    void load_member(int m, Linear<T>& layer) {
+        auto params = checked_member(m, layer);
+        size_t w_size = static_cast<size_t>(output_f) * input_f;
+        std::copy(params[0]->data.get(), params[0]->data.get() + w_size, weights->data.get() + m * w_size);
+        std::copy(params[1]->data.get(), params[1]->data.get() + output_f, bias->data.get() + static_cast<size_t>(m) * output_f);
+        weights->bump_version();
+        bias->bump_version();
+    }
+
+    // Copies member m into layer, e.g. to keep the best model of a sweep.
+    void store_member(int m, Linear<T>& layer) const {
+        auto params = checked_member(m, layer);
+        size_t w_size = static_cast<size_t>(output_f) * input_f;
+        std::copy(weights->data.get() + m * w_size, weights->data.get() + (m + 1) * w_size, params[0]->data.get());
+        std::copy(bias->data.get() + static_cast<size_t>(m) * output_f, bias->data.get() + static_cast<size_t>(m + 1) * output_f,
+                  params[1]->data.get());
+        params[0]->bump_version();
+        params[1]->bump_version();
+    }
+
+private:
+    std::vector<std::shared_ptr<Tensor<T>>> checked_member(int m, Linear<T>& layer) const {
+        if (m < 0 || m >= members) throw std::out_of_range("ERROR: Ensemble member index out of range.");
+        auto params = layer.parameters();
+        if (params[0]->shape[0] != output_f || params[0]->shape[1] != input_f) {
+            throw std::invalid_argument("ERROR: Linear layer does not match the ensemble's shape.");
+        }
+        return params;
+    }
+};
+
+template<typename T>
+std::string ensemble_linear_repr(const EnsembleLinear<T>& layer) {
+    std::string dtype_name;
+    if (std::is_same_v<T, int>) {
+        dtype_name = "int32";
+    } else if (std::is_same_v<T, float>) {
+        dtype_name = "float32";
+    } else if (std::is_same_v<T, double>) {
+        dtype_name = "float64";
+    } else {
+        dtype_name = "unknown";
+    }
+
+    return "EnsembleLinear(num_models=" + std::to_string(layer.members) +
+           ", in_features=" + std::to_string(layer.input_f) +
+           ", out_features=" + std::to_string(layer.output_f) +
+           ", dtype='" + dtype_name + "')";
+}
+
+#endif
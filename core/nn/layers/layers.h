@@ -2,5 +2,13 @@
 #define LAYERS_H
 
 #include "linear.h"
+#include "conv2d.h"
+#include "pooling.h"
+#include "embedding.h"
+#include "normalization.h"
+#include "recurrent.h"
+#include "attention.h"
+#include "dropout.h"
+#include "ensemble_linear.h"
 
 #endif
\ No newline at end of file
@@ -2,14 +2,57 @@
 #define LINEAR_H
 
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <variant>
 #include <type_traits>
 #include <string>
 #include "tensors/tensor.h"
 #include "tensors/tensor_ops.h"
+#include "tensors/tensor_sparse_ops.h"
+#include "tensors/tensor_gemm.h"
+#include "tensors/tensor_precision.h"
+#include "autograd/autograd_linear.h"
+#include "autograd/forward_ad.h"
 #include "nn/initializers/initializers.h"
 
+// input [rows x in], weight [out x in], bias [1 x out]; packed_weight is
+// weight^T in the panel layout of gemm_pack_b_panels.
+template<typename T>
+std::shared_ptr<Tensor<T>> linear(const std::shared_ptr<Tensor<T>>& input,
+                                  const std::shared_ptr<Tensor<T>>& weight,
+                                  const std::shared_ptr<Tensor<T>>& bias,
+                                  const T* packed_weight) {
+    MemoryScope scope("linear");
+    if (input->ndim != 2 || input->shape[1] != weight->shape[1]) {
+        throw std::invalid_argument("ERROR: Shapes are not valid to multiply");
+    }
+    int rows = input->shape[0];
+    int in_f = weight->shape[1];
+    int out_f = weight->shape[0];
+    bool requires_grad = GradMode::resolve(input->requires_grad || weight->requires_grad || bias->requires_grad);
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{rows, out_f}, requires_grad);
+    T* out = result->data.get();
+    for (int r = 0; r < rows; ++r) std::copy(bias->data.get(), bias->data.get() + out_f, out + static_cast<size_t>(r) * out_f);
+    gemm_prepacked_b(false, rows, out_f, in_f, input->data.get(), in_f, packed_weight, out, out_f, true);
+    if (input->tangent || weight->tangent || bias->tangent) {
+        // tx W^T + x tW^T + tb
+        result->tangent = std::make_shared<Tensor<T>>(result->shape, false);
+        T* t = result->tangent->data.get();
+        if (bias->tangent) {
+            for (int r = 0; r < rows; ++r) std::copy(bias->tangent->data.get(), bias->tangent->data.get() + out_f, t + static_cast<size_t>(r) * out_f);
+        }
+        if (input->tangent) gemm_prepacked_b(false, rows, out_f, in_f, input->tangent->data.get(), in_f, packed_weight, t, out_f, true);
+        if (weight->tangent) gemm(false, true, rows, out_f, in_f, input->data.get(), in_f, weight->tangent->data.get(), in_f, t, out_f, true);
+    }
+
+    if (result->requires_grad) {
+        result->parents = {input, weight, bias};
+        result->grad_fn = std::make_unique<LinearBackward<T>>(input, weight, bias);
+    }
+    return result;
+}
+
 template<typename T>
 class Linear;
 
@@ -28,18 +71,36 @@ class Linear {
 private:
     std::shared_ptr<Tensor<T>> weights;
     std::shared_ptr<Tensor<T>> bias;
-    std::shared_ptr<Tensor<T>> input_cache; 
     
     int input_f;
     int output_f;
     friend std::string linear_repr<T>(const Linear<T>&);
 
+    // weights^T packed for the GEMM kernel, rebuilt when the weights' version
+    // moves on (set_data, an optimizer step), so a training loop repacks once
+    // per step and inference never does. Forwards on several threads share it.
+    std::mutex packed_mutex;
+    std::shared_ptr<const std::vector<T>> packed;
+    unsigned long long packed_version = 0;
+
+    std::shared_ptr<const std::vector<T>> packed_weights() {
+        unsigned long long version = weights->data_version();
+        std::lock_guard<std::mutex> lock(packed_mutex);
+        if (!packed || packed_version != version) {
+            auto fresh = std::make_shared<std::vector<T>>(static_cast<size_t>(weights->size));
+            gemm_pack_b_panels(true, weights->data.get(), input_f, input_f, output_f, fresh->data());
+            packed = std::move(fresh);
+            packed_version = version;
+        }
+        return packed;
+    }
+
 public:
     Linear(int input_features, int output_features,
            Initializer<T> weight_init,
            Initializer<T> bias_init)
         : input_f(input_features), output_f(output_features) {
-        
+        MemoryScope scope("linear", MemoryCategory::Parameter);
         weights = std::make_shared<Tensor<T>>(std::vector<int>{output_features, input_features}, true);
         bias = std::make_shared<Tensor<T>>(std::vector<int>{1, output_features}, true);
         
@@ -48,11 +109,20 @@ public:
     }
 
     std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<T>>& input) {
-        this->input_cache = input;
+        if constexpr (std::is_same_v<T, float>) {
+            // autocast rounds the operands of every matmul, which the cache would skip
+            if (Autocast::is_enabled()) return tensor_add(mat_mul(input, transpose(this->weights)), this->bias);
+        }
+        auto weights_packed = packed_weights();
+        return linear(input, this->weights, this->bias, weights_packed->data());
+    }
 
-        auto transposed_weights = transpose(this->weights); 
-        
-        auto output = mat_mul(input, transposed_weights);
+    // Sparse rows go through spmm over the packed weights, so the cost scales
+    // with the input's non-zeros and the weights are never transposed.
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<SparseTensor<T>>& input) {
+        if (input->cols != input_f) throw std::invalid_argument("ERROR: Shapes are not valid to multiply");
+        auto weights_packed = packed_weights();
+        auto output = spmm_transposed(input, this->weights, weights_packed->data());
         return tensor_add(output, this->bias);
     }
 
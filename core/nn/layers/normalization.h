@@ -0,0 +1,201 @@
+#ifndef NORMALIZATION_H
+#define NORMALIZATION_H
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include "tensors/tensor.h"
+#include "tensors/tensor_norm.h"
+#include "autograd/autograd_norm.h"
+#include "autograd/grad_mode.h"
+
+// Normalizes over the last dimension. gamma and beta have shape [D] or are null.
+template<typename T>
+std::shared_ptr<Tensor<T>> layer_norm(const std::shared_ptr<Tensor<T>>& input,
+                                      const std::shared_ptr<Tensor<T>>& gamma,
+                                      const std::shared_ptr<Tensor<T>>& beta,
+                                      T eps = static_cast<T>(1e-5)) {
+    MemoryScope scope("layer_norm");
+    int dim = input->shape.back();
+    int rows = input->size / dim;
+    if ((gamma && gamma->size != dim) || (beta && beta->size != dim) || (!gamma != !beta)) {
+        throw std::invalid_argument("ERROR: layer_norm weight and bias must both be given with size equal to the last dimension.");
+    }
+
+    bool requires_grad = GradMode::resolve(input->requires_grad || (gamma && gamma->requires_grad) || (beta && beta->requires_grad));
+    auto result = std::make_shared<Tensor<T>>(input->shape, requires_grad);
+    std::vector<T> mean(rows), inv_std(rows);
+    layer_norm_forward(input->data.get(), gamma ? gamma->data.get() : nullptr, beta ? beta->data.get() : nullptr,
+                       result->data.get(), mean.data(), inv_std.data(), rows, dim, eps);
+
+    if (result->requires_grad) {
+        result->parents = {input};
+        if (gamma) result->parents.insert(result->parents.end(), {gamma, beta});
+        result->grad_fn = std::make_unique<LayerNormBackward<T>>(input, gamma, beta, std::move(mean), std::move(inv_std));
+    }
+    return result;
+}
+
+// input: [N, C] or [N, C, L]. In training mode the batch statistics are used and
+// folded into running_mean / running_var (unbiased) with the given momentum,
+// except when a checkpoint recomputes the pass; in eval mode the running
+// statistics are used instead.
+template<typename T>
+std::shared_ptr<Tensor<T>> batch_norm(const std::shared_ptr<Tensor<T>>& input,
+                                      const std::shared_ptr<Tensor<T>>& running_mean,
+                                      const std::shared_ptr<Tensor<T>>& running_var,
+                                      const std::shared_ptr<Tensor<T>>& gamma,
+                                      const std::shared_ptr<Tensor<T>>& beta,
+                                      bool training, T momentum = static_cast<T>(0.1),
+                                      T eps = static_cast<T>(1e-5)) {
+    MemoryScope scope("batch_norm");
+    if (input->ndim != 2 && input->ndim != 3) {
+        throw std::invalid_argument("ERROR: batch_norm expects a [N, C] or [N, C, L] input.");
+    }
+    int batch = input->shape[0];
+    int channels = input->shape[1];
+    int length = input->ndim == 3 ? input->shape[2] : 1;
+    if (running_mean->size != channels || running_var->size != channels ||
+        (gamma && gamma->size != channels) || (beta && beta->size != channels) || (!gamma != !beta)) {
+        throw std::invalid_argument("ERROR: batch_norm statistics and affine parameters must have one entry per channel.");
+    }
+
+    std::vector<T> mean(channels), inv_std(channels);
+    if (training) {
+        int count = batch * length;
+        if (count < 2) throw std::invalid_argument("ERROR: batch_norm needs more than one value per channel in training mode.");
+        std::vector<T> var(channels);
+        batch_norm_stats(input->data.get(), mean.data(), var.data(), batch, channels, length);
+        T unbias = static_cast<T>(count) / static_cast<T>(count - 1);
+        bool update_running = !RecomputeGuard::active();
+        for (int c = 0; c < channels; ++c) {
+            inv_std[c] = static_cast<T>(1) / std::sqrt(var[c] + eps);
+            if (!update_running) continue;
+            running_mean->data[c] = (1 - momentum) * running_mean->data[c] + momentum * mean[c];
+            running_var->data[c] = (1 - momentum) * running_var->data[c] + momentum * var[c] * unbias;
+        }
+    } else {
+        for (int c = 0; c < channels; ++c) {
+            mean[c] = running_mean->data[c];
+            inv_std[c] = static_cast<T>(1) / std::sqrt(running_var->data[c] + eps);
+        }
+    }
+
+    bool requires_grad = GradMode::resolve(input->requires_grad || (gamma && gamma->requires_grad) || (beta && beta->requires_grad));
+    auto result = std::make_shared<Tensor<T>>(input->shape, requires_grad);
+    batch_norm_apply(input->data.get(), gamma ? gamma->data.get() : nullptr, beta ? beta->data.get() : nullptr,
+                     mean.data(), inv_std.data(), result->data.get(), batch, channels, length);
+
+    if (result->requires_grad) {
+        result->parents = {input};
+        if (gamma) result->parents.insert(result->parents.end(), {gamma, beta});
+        result->grad_fn = std::make_unique<BatchNormBackward<T>>(input, gamma, beta,
+                                                                 std::move(mean), std::move(inv_std), training);
+    }
+    return result;
+}
+
+template<typename T>
+std::shared_ptr<Tensor<T>> filled_parameter(int size, T value, bool requires_grad) {
+    auto t = std::make_shared<Tensor<T>>(std::vector<int>{size}, requires_grad);
+    std::fill(t->data.get(), t->data.get() + size, value);
+    return t;
+}
+
+template<typename T>
+class LayerNorm;
+
+template<typename T>
+class BatchNorm1d;
+
+template<typename T>
+std::string layer_norm_repr(const LayerNorm<T>& layer);
+
+template<typename T>
+std::string batch_norm1d_repr(const BatchNorm1d<T>& layer);
+
+template<typename T>
+class LayerNorm {
+private:
+    std::shared_ptr<Tensor<T>> gamma;
+    std::shared_ptr<Tensor<T>> beta;
+    friend std::string layer_norm_repr<T>(const LayerNorm<T>&);
+
+public:
+    int normalized_shape;
+    T eps;
+
+    LayerNorm(int normalized_shape, T eps, bool elementwise_affine)
+        : normalized_shape(normalized_shape), eps(eps) {
+        MemoryScope scope("layer_norm", MemoryCategory::Parameter);
+        if (elementwise_affine) {
+            gamma = filled_parameter<T>(normalized_shape, 1, true);
+            beta = filled_parameter<T>(normalized_shape, 0, true);
+        }
+    }
+
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<T>>& input) {
+        if (input->shape.back() != normalized_shape) {
+            throw std::invalid_argument("ERROR: LayerNorm input's last dimension does not match normalized_shape.");
+        }
+        return layer_norm(input, gamma, beta, eps);
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> parameters() {
+        if (!gamma) return {};
+        return {gamma, beta};
+    }
+};
+
+template<typename T>
+class BatchNorm1d {
+private:
+    std::shared_ptr<Tensor<T>> gamma;
+    std::shared_ptr<Tensor<T>> beta;
+    friend std::string batch_norm1d_repr<T>(const BatchNorm1d<T>&);
+
+public:
+    std::shared_ptr<Tensor<T>> running_mean;
+    std::shared_ptr<Tensor<T>> running_var;
+    int num_features;
+    T eps;
+    T momentum;
+    bool training = true;
+
+    BatchNorm1d(int num_features, T eps, T momentum, bool affine)
+        : num_features(num_features), eps(eps), momentum(momentum) {
+        MemoryScope scope("batch_norm", MemoryCategory::Parameter);
+        if (affine) {
+            gamma = filled_parameter<T>(num_features, 1, true);
+            beta = filled_parameter<T>(num_features, 0, true);
+        }
+        running_mean = filled_parameter<T>(num_features, 0, false);
+        running_var = filled_parameter<T>(num_features, 1, false);
+    }
+
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<T>>& input) {
+        return batch_norm(input, running_mean, running_var, gamma, beta, training, momentum, eps);
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> parameters() {
+        if (!gamma) return {};
+        return {gamma, beta};
+    }
+};
+
+template<typename T>
+std::string layer_norm_repr(const LayerNorm<T>& layer) {
+    return "LayerNorm(normalized_shape=" + std::to_string(layer.normalized_shape) +
+           ", elementwise_affine=" + (layer.gamma ? "True" : "False") + ")";
+}
+
+template<typename T>
+std::string batch_norm1d_repr(const BatchNorm1d<T>& layer) {
+    return "BatchNorm1d(num_features=" + std::to_string(layer.num_features) +
+           ", affine=" + (layer.gamma ? "True" : "False") +
+           ", training=" + (layer.training ? "True" : "False") + ")";
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef POOLING_H
+#define POOLING_H
+
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include "tensors/tensor.h"
+#include "tensors/tensor_conv.h"
+#include "autograd/autograd_conv.h"
+
+inline Conv2dGeometry pool_geometry(const std::vector<int>& shape, int kernel_size, int stride, int padding) {
+    if (shape.size() != 4) {
+        throw std::invalid_argument("ERROR: Pooling expects a 4D NCHW input.");
+    }
+    if (kernel_size < 1 || stride < 1 || padding < 0 || 2 * padding > kernel_size) {
+        throw std::invalid_argument("ERROR: Invalid kernel size, stride or padding for pooling.");
+    }
+    Conv2dGeometry g(1, shape[2], shape[3], kernel_size, kernel_size, stride, padding, 1);
+    if (g.out_h <= 0 || g.out_w <= 0) {
+        throw std::invalid_argument("ERROR: Kernel is larger than the padded input.");
+    }
+    return g;
+}
+
+template<typename T>
+std::shared_ptr<Tensor<T>> max_pool2d(const std::shared_ptr<Tensor<T>>& input, int kernel_size, int stride = -1, int padding = 0) {
+    MemoryScope scope("max_pool2d");
+    if (stride <= 0) stride = kernel_size;
+    Conv2dGeometry g = pool_geometry(input->shape, kernel_size, stride, padding);
+
+    int planes = input->shape[0] * input->shape[1];
+    int in_plane = g.height * g.width;
+    int out_plane = g.out_pixels();
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{input->shape[0], input->shape[1], g.out_h, g.out_w}, GradMode::resolve(input->requires_grad));
+    std::vector<int> max_indices(result->size);
+
+    for (int p = 0; p < planes; ++p) {
+        max_pool2d_plane(input->data.get() + p * in_plane, result->data.get() + p * out_plane,
+                         max_indices.data() + p * out_plane, g);
+    }
+
+    if (result->requires_grad) {
+        result->parents = {input};
+        result->grad_fn = std::make_unique<MaxPool2dBackward<T>>(input, std::move(max_indices));
+    }
+    return result;
+}
+
+// Padded taps count towards the window size (count_include_pad semantics).
+template<typename T>
+std::shared_ptr<Tensor<T>> avg_pool2d(const std::shared_ptr<Tensor<T>>& input, int kernel_size, int stride = -1, int padding = 0) {
+    MemoryScope scope("avg_pool2d");
+    if (stride <= 0) stride = kernel_size;
+    Conv2dGeometry g = pool_geometry(input->shape, kernel_size, stride, padding);
+
+    int planes = input->shape[0] * input->shape[1];
+    int in_plane = g.height * g.width;
+    int out_plane = g.out_pixels();
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{input->shape[0], input->shape[1], g.out_h, g.out_w}, GradMode::resolve(input->requires_grad));
+
+    for (int p = 0; p < planes; ++p) {
+        avg_pool2d_plane(input->data.get() + p * in_plane, result->data.get() + p * out_plane, g);
+    }
+
+    if (result->requires_grad) {
+        result->parents = {input};
+        result->grad_fn = std::make_unique<AvgPool2dBackward<T>>(input, kernel_size, stride, padding);
+    }
+    return result;
+}
+
+template<typename T>
+class MaxPool2d {
+public:
+    int kernel_size, stride, padding;
+
+    MaxPool2d(int kernel, int stride_ = -1, int padding_ = 0)
+        : kernel_size(kernel), stride(stride_ <= 0 ? kernel : stride_), padding(padding_) {}
+
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<T>>& input) {
+        return max_pool2d(input, kernel_size, stride, padding);
+    }
+};
+
+template<typename T>
+class AvgPool2d {
+public:
+    int kernel_size, stride, padding;
+
+    AvgPool2d(int kernel, int stride_ = -1, int padding_ = 0)
+        : kernel_size(kernel), stride(stride_ <= 0 ? kernel : stride_), padding(padding_) {}
+
+    std::shared_ptr<Tensor<T>> forward(const std::shared_ptr<Tensor<T>>& input) {
+        return avg_pool2d(input, kernel_size, stride, padding);
+    }
+};
+
+#endif
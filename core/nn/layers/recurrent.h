@@ -0,0 +1,256 @@
+#ifndef RECURRENT_H
+#define RECURRENT_H
+
+#include <memory>
+#include <vector>
+#include <variant>
+#include <type_traits>
+#include <string>
+#include <stdexcept>
+#include "tensors/tensor.h"
+#include "tensors/tensor_rnn.h"
+#include "autograd/autograd_rnn.h"
+#include "nn/layers/linear.h"
+
+// output is [steps, batch, hidden] (or [batch, hidden] for the last step only)
+// and carries the graph. h_n and c_n are detached copies of the final state,
+// meant to be fed back as the initial state of the next chunk of a sequence.
+template<typename T>
+struct RecurrentOutput {
+    std::shared_ptr<Tensor<T>> output;
+    std::shared_ptr<Tensor<T>> h_n;
+    std::shared_ptr<Tensor<T>> c_n;
+};
+
+template<typename T>
+void check_recurrent_input(const std::shared_ptr<Tensor<T>>& input, const std::shared_ptr<Tensor<T>>& w_ih,
+                           const std::shared_ptr<Tensor<T>>& w_hh, int gate_count) {
+    if (input->ndim != 3) {
+        throw std::invalid_argument("ERROR: Recurrent layers expect a [steps, batch, features] input.");
+    }
+    int hidden = w_hh->ndim == 2 ? w_hh->shape[1] : 0;
+    if (w_hh->ndim != 2 || w_hh->shape[0] != gate_count * hidden ||
+        w_ih->ndim != 2 || w_ih->shape[0] != gate_count * hidden || w_ih->shape[1] != input->shape[2]) {
+        throw std::invalid_argument("ERROR: Recurrent weight shapes do not match the input.");
+    }
+}
+
+template<typename T>
+void check_recurrent_state(const std::shared_ptr<Tensor<T>>& state, int batch, int hidden) {
+    if (state && (state->size != batch * hidden)) {
+        throw std::invalid_argument("ERROR: Initial state must have shape [batch, hidden].");
+    }
+}
+
+template<typename T>
+std::shared_ptr<Tensor<T>> copy_state(const T* src, int batch, int hidden) {
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{batch, hidden}, false);
+    std::copy(src, src + batch * hidden, result->data.get());
+    return result;
+}
+
+template<typename T>
+std::shared_ptr<Tensor<T>> recurrent_output(const std::shared_ptr<Tensor<T>>& hidden_states,
+                                            int steps, int batch, int hidden,
+                                            bool return_sequences, bool requires_grad) {
+    int state = batch * hidden;
+    std::vector<int> shape = return_sequences ? std::vector<int>{steps, batch, hidden} : std::vector<int>{batch, hidden};
+    auto result = std::make_shared<Tensor<T>>(shape, requires_grad);
+    const T* first = hidden_states->data.get() + (return_sequences ? state : static_cast<size_t>(steps) * state);
+    std::copy(first, first + result->size, result->data.get());
+    return result;
+}
+
+// w_ih: [4H, I], w_hh: [4H, H], bias: [4H] or null; gates ordered i, f, g, o.
+// h0 and c0 are [B, H] or null for zeros.
+template<typename T>
+RecurrentOutput<T> lstm(const std::shared_ptr<Tensor<T>>& input,
+                        const std::shared_ptr<Tensor<T>>& h0, const std::shared_ptr<Tensor<T>>& c0,
+                        const std::shared_ptr<Tensor<T>>& w_ih, const std::shared_ptr<Tensor<T>>& w_hh,
+                        const std::shared_ptr<Tensor<T>>& bias, bool return_sequences = true) {
+    MemoryScope scope("lstm");
+    check_recurrent_input(input, w_ih, w_hh, 4);
+    int steps = input->shape[0];
+    int batch = input->shape[1];
+    int features = input->shape[2];
+    int hidden = w_hh->shape[1];
+    int state = batch * hidden;
+    check_recurrent_state(h0, batch, hidden);
+    check_recurrent_state(c0, batch, hidden);
+    if (bias && bias->size != 4 * hidden) throw std::invalid_argument("ERROR: LSTM bias must have 4 * hidden entries.");
+
+    auto gates = std::make_shared<Tensor<T>>(std::vector<int>{steps, batch, 4 * hidden}, false);
+    auto h = std::make_shared<Tensor<T>>(std::vector<int>{steps + 1, batch, hidden}, false);
+    auto c = std::make_shared<Tensor<T>>(std::vector<int>{steps + 1, batch, hidden}, false);
+    std::fill(h->data.get(), h->data.get() + state, static_cast<T>(0));
+    std::fill(c->data.get(), c->data.get() + state, static_cast<T>(0));
+    if (h0) std::copy(h0->data.get(), h0->data.get() + state, h->data.get());
+    if (c0) std::copy(c0->data.get(), c0->data.get() + state, c->data.get());
+
+    lstm_forward(input->data.get(), w_ih->data.get(), w_hh->data.get(), bias ? bias->data.get() : nullptr,
+                 steps, batch, features, hidden, gates->data.get(), h->data.get(), c->data.get());
+
+    bool requires_grad = GradMode::resolve(input->requires_grad || w_ih->requires_grad || w_hh->requires_grad ||
+                                           (bias && bias->requires_grad) || (h0 && h0->requires_grad) ||
+                                           (c0 && c0->requires_grad));
+
+    RecurrentOutput<T> result;
+    result.output = recurrent_output(h, steps, batch, hidden, return_sequences, requires_grad);
+    result.h_n = copy_state(h->data.get() + static_cast<size_t>(steps) * state, batch, hidden);
+    result.c_n = copy_state(c->data.get() + static_cast<size_t>(steps) * state, batch, hidden);
+
+    if (result.output->requires_grad) {
+        result.output->parents = {input, w_ih, w_hh};
+        for (auto& extra : {bias, h0, c0}) {
+            if (extra) result.output->parents.push_back(extra);
+        }
+        result.output->grad_fn = std::make_unique<LSTMBackward<T>>(input, h0, c0, w_ih, w_hh, bias,
+                                                                   gates, h, c, return_sequences);
+    }
+    return result;
+}
+
+// w_ih: [3H, I], w_hh: [3H, H], b_ih / b_hh: [3H] or null; gates ordered r, z, n.
+template<typename T>
+RecurrentOutput<T> gru(const std::shared_ptr<Tensor<T>>& input, const std::shared_ptr<Tensor<T>>& h0,
+                       const std::shared_ptr<Tensor<T>>& w_ih, const std::shared_ptr<Tensor<T>>& w_hh,
+                       const std::shared_ptr<Tensor<T>>& b_ih, const std::shared_ptr<Tensor<T>>& b_hh,
+                       bool return_sequences = true) {
+    MemoryScope scope("gru");
+    check_recurrent_input(input, w_ih, w_hh, 3);
+    int steps = input->shape[0];
+    int batch = input->shape[1];
+    int features = input->shape[2];
+    int hidden = w_hh->shape[1];
+    int state = batch * hidden;
+    check_recurrent_state(h0, batch, hidden);
+    if ((b_ih && b_ih->size != 3 * hidden) || (b_hh && b_hh->size != 3 * hidden)) {
+        throw std::invalid_argument("ERROR: GRU biases must have 3 * hidden entries.");
+    }
+
+    auto gates = std::make_shared<Tensor<T>>(std::vector<int>{steps, batch, 3 * hidden}, false);
+    auto hn = std::make_shared<Tensor<T>>(std::vector<int>{steps, batch, hidden}, false);
+    auto h = std::make_shared<Tensor<T>>(std::vector<int>{steps + 1, batch, hidden}, false);
+    std::fill(h->data.get(), h->data.get() + state, static_cast<T>(0));
+    if (h0) std::copy(h0->data.get(), h0->data.get() + state, h->data.get());
+
+    gru_forward(input->data.get(), w_ih->data.get(), w_hh->data.get(),
+                b_ih ? b_ih->data.get() : nullptr, b_hh ? b_hh->data.get() : nullptr,
+                steps, batch, features, hidden, gates->data.get(), hn->data.get(), h->data.get());
+
+    bool requires_grad = GradMode::resolve(input->requires_grad || w_ih->requires_grad || w_hh->requires_grad ||
+                                           (b_ih && b_ih->requires_grad) || (b_hh && b_hh->requires_grad) ||
+                                           (h0 && h0->requires_grad));
+
+    RecurrentOutput<T> result;
+    result.output = recurrent_output(h, steps, batch, hidden, return_sequences, requires_grad);
+    result.h_n = copy_state(h->data.get() + static_cast<size_t>(steps) * state, batch, hidden);
+
+    if (result.output->requires_grad) {
+        result.output->parents = {input, w_ih, w_hh};
+        for (auto& extra : {b_ih, b_hh, h0}) {
+            if (extra) result.output->parents.push_back(extra);
+        }
+        result.output->grad_fn = std::make_unique<GRUBackward<T>>(input, h0, w_ih, w_hh, b_ih, b_hh,
+                                                                  gates, hn, h, return_sequences);
+    }
+    return result;
+}
+
+template<typename T>
+class LSTM;
+
+template<typename T>
+class GRU;
+
+template<typename T>
+std::string lstm_repr(const LSTM<T>& layer);
+
+template<typename T>
+std::string gru_repr(const GRU<T>& layer);
+
+template<typename T>
+class LSTM {
+private:
+    std::shared_ptr<Tensor<T>> w_ih;
+    std::shared_ptr<Tensor<T>> w_hh;
+    std::shared_ptr<Tensor<T>> bias;
+
+    int input_size;
+    int hidden_size;
+    friend std::string lstm_repr<T>(const LSTM<T>&);
+
+public:
+    LSTM(int input_size, int hidden_size, Initializer<T> weight_init, Initializer<T> bias_init)
+        : input_size(input_size), hidden_size(hidden_size) {
+        MemoryScope scope("lstm", MemoryCategory::Parameter);
+        w_ih = std::make_shared<Tensor<T>>(std::vector<int>{4 * hidden_size, input_size}, true);
+        w_hh = std::make_shared<Tensor<T>>(std::vector<int>{4 * hidden_size, hidden_size}, true);
+        bias = std::make_shared<Tensor<T>>(std::vector<int>{4 * hidden_size}, true);
+
+        std::visit([this](auto&& arg){ arg->initialize(*(this->w_ih)); }, weight_init);
+        std::visit([this](auto&& arg){ arg->initialize(*(this->w_hh)); }, weight_init);
+        std::visit([this](auto&& arg){ arg->initialize(*(this->bias)); }, bias_init);
+    }
+
+    RecurrentOutput<T> forward(const std::shared_ptr<Tensor<T>>& input,
+                               const std::shared_ptr<Tensor<T>>& h0, const std::shared_ptr<Tensor<T>>& c0,
+                               bool return_sequences) {
+        return lstm(input, h0, c0, w_ih, w_hh, bias, return_sequences);
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> parameters() {
+        return {w_ih, w_hh, bias};
+    }
+};
+
+template<typename T>
+class GRU {
+private:
+    std::shared_ptr<Tensor<T>> w_ih;
+    std::shared_ptr<Tensor<T>> w_hh;
+    std::shared_ptr<Tensor<T>> b_ih;
+    std::shared_ptr<Tensor<T>> b_hh;
+
+    int input_size;
+    int hidden_size;
+    friend std::string gru_repr<T>(const GRU<T>&);
+
+public:
+    GRU(int input_size, int hidden_size, Initializer<T> weight_init, Initializer<T> bias_init)
+        : input_size(input_size), hidden_size(hidden_size) {
+        MemoryScope scope("gru", MemoryCategory::Parameter);
+        w_ih = std::make_shared<Tensor<T>>(std::vector<int>{3 * hidden_size, input_size}, true);
+        w_hh = std::make_shared<Tensor<T>>(std::vector<int>{3 * hidden_size, hidden_size}, true);
+        b_ih = std::make_shared<Tensor<T>>(std::vector<int>{3 * hidden_size}, true);
+        b_hh = std::make_shared<Tensor<T>>(std::vector<int>{3 * hidden_size}, true);
+
+        std::visit([this](auto&& arg){ arg->initialize(*(this->w_ih)); }, weight_init);
+        std::visit([this](auto&& arg){ arg->initialize(*(this->w_hh)); }, weight_init);
+        std::visit([this](auto&& arg){ arg->initialize(*(this->b_ih)); }, bias_init);
+        std::visit([this](auto&& arg){ arg->initialize(*(this->b_hh)); }, bias_init);
+    }
+
+    RecurrentOutput<T> forward(const std::shared_ptr<Tensor<T>>& input, const std::shared_ptr<Tensor<T>>& h0,
+                               bool return_sequences) {
+        return gru(input, h0, w_ih, w_hh, b_ih, b_hh, return_sequences);
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> parameters() {
+        return {w_ih, w_hh, b_ih, b_hh};
+    }
+};
+
+template<typename T>
+std::string lstm_repr(const LSTM<T>& layer) {
+    return "LSTM(input_size=" + std::to_string(layer.input_size) +
+           ", hidden_size=" + std::to_string(layer.hidden_size) + ")";
+}
+
+template<typename T>
+std::string gru_repr(const GRU<T>& layer) {
+    return "GRU(input_size=" + std::to_string(layer.input_size) +
+           ", hidden_size=" + std::to_string(layer.hidden_size) + ")";
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef ADAM_H
+#define ADAM_H
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_sparse_grad.h"
+#include "utils/parallel.h"
+
+// Adam with per-parameter first and second moment buffers. For parameters with
+// a sparse gradient the update is lazy: only the moments and values of the rows
+// present in the batch are advanced, while the bias correction uses the global
+// step count.
+template<typename T>
+class Adam {
+private:
+    struct State {
+        std::shared_ptr<Tensor<T>> m;
+        std::shared_ptr<Tensor<T>> v;
+    };
+    std::vector<State> state;
+
+    static void update(T* data, const T* grad, T* m, T* v, int count,
+                       T lr, T beta1, T beta2, T eps, T correction1, T correction2) {
+        for (int i = 0; i < count; ++i) {
+            m[i] = beta1 * m[i] + (1 - beta1) * grad[i];
+            v[i] = beta2 * v[i] + (1 - beta2) * grad[i] * grad[i];
+            T m_hat = m[i] / correction1;
+            T v_hat = v[i] / correction2;
+            data[i] -= lr * m_hat / (std::sqrt(v_hat) + eps);
+        }
+    }
+
+public:
+    std::vector<std::shared_ptr<Tensor<T>>> params;
+    T lr, beta1, beta2, eps;
+    int step_count = 0;
+
+    Adam(const std::vector<std::shared_ptr<Tensor<T>>>& params, T lr, T beta1, T beta2, T eps)
+        : params(params), lr(lr), beta1(beta1), beta2(beta2), eps(eps) {
+        MemoryScope scope("adam", MemoryCategory::Parameter);
+        for (auto& p : params) {
+            State s;
+            s.m = std::make_shared<Tensor<T>>(p->shape, false);
+            s.v = std::make_shared<Tensor<T>>(p->shape, false);
+            std::fill(s.m->data.get(), s.m->data.get() + s.m->size, static_cast<T>(0));
+            std::fill(s.v->data.get(), s.v->data.get() + s.v->size, static_cast<T>(0));
+            state.push_back(s);
+        }
+    }
+
+    void step() {
+        ++step_count;
+        T correction1 = 1 - std::pow(beta1, static_cast<T>(step_count));
+        T correction2 = 1 - std::pow(beta2, static_cast<T>(step_count));
+
+        for (size_t n = 0; n < params.size(); ++n) {
+            auto& p = params[n];
+            T* m = state[n].m->data.get();
+            T* v = state[n].v->data.get();
+
+            if (p->grad) {
+                const T* grad = p->grad->data.get();
+                parallel_for(0, p->size, 32768, [&](int begin, int end) {
+                    update(p->data.get() + begin, grad + begin, m + begin, v + begin, end - begin,
+                           lr, beta1, beta2, eps, correction1, correction2);
+                });
+            }
+            if (p->sparse_grad) {
+                const SparseGrad<T>& sg = *p->sparse_grad;
+                int dim = p->size / p->shape[0];
+                const T* values = sg.values->data.get();
+                parallel_for(0, sg.nnz(), std::max(1, 16384 / dim), [&](int begin, int end) {
+                    for (int k = begin; k < end; ++k) {
+                        size_t row = static_cast<size_t>(sg.indices[k]) * dim;
+                        update(p->data.get() + row, values + static_cast<size_t>(k) * dim, m + row, v + row, dim,
+                               lr, beta1, beta2, eps, correction1, correction2);
+                    }
+                });
+            }
+            if (p->grad || p->sparse_grad) p->bump_version();
+        }
+    }
+
+    void zero_grad() {
+        for (auto& p : params) p->zero_grad();
+    }
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef FLAT_PARAMS_H
+#define FLAT_PARAMS_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_foreach.h"
+#include "distributed/shm_comm.h"
+
+// Moves a set of parameters into one contiguous buffer: afterwards each
+// parameter's data is a view into flat(), and each trainable parameter's grad
+// a view into flat()->grad, so backward accumulates straight into the flat
+// gradient. Every parameter starts on a 64-byte boundary; the padding between
+// them stays zero in both buffers.
+//
+// The flat tensor is itself a parameter: an optimizer built over {flat()}
+// updates every parameter in one pass, and the views see its version change,
+// so caches such as Linear's packed weights are refreshed. Norms, clipping,
+// checkpoints and all-reduce touch a single buffer.
+template<typename T>
+class FlatParameters {
+public:
+    static constexpr size_t ALIGN_ELEMENTS = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+
+    explicit FlatParameters(const std::vector<std::shared_ptr<Tensor<T>>>& parameters) {
+        std::unordered_set<const Tensor<T>*> seen;
+        size_t total = 0;
+        bool any_grad = false;
+        for (const auto& p : parameters) {
+            if (!seen.insert(p.get()).second) continue;
+            if (p->data.get_deleter().owner) {
+                throw std::invalid_argument("ERROR: Cannot flatten a parameter that is already a view.");
+            }
+            params.push_back(p);
+            offsets.push_back(total);
+            total += (static_cast<size_t>(p->size) + ALIGN_ELEMENTS - 1) / ALIGN_ELEMENTS * ALIGN_ELEMENTS;
+            any_grad |= p->requires_grad;
+        }
+        if (params.empty()) throw std::invalid_argument("ERROR: FlatParameters got an empty parameter list.");
+
+        {
+            MemoryScope scope("flat_parameters", MemoryCategory::Parameter);
+            flat_data = std::make_shared<Tensor<T>>(std::vector<int>{static_cast<int>(total)}, any_grad);
+        }
+        if (any_grad) {
+            MemoryScope scope("flat_parameters", MemoryCategory::Gradient);
+            flat_data->grad = std::make_shared<Tensor<T>>(std::vector<int>{static_cast<int>(total)}, false);
+        }
+        for (size_t k = 0; k < params.size(); ++k) rebind(*params[k], offsets[k]);
+    }
+
+    const std::shared_ptr<Tensor<T>>& flat() const { return flat_data; }
+    const std::shared_ptr<Tensor<T>>& flat_grad() const { return flat_data->grad; }
+    const std::vector<std::shared_ptr<Tensor<T>>>& parameters() const { return params; }
+    const std::vector<size_t>& parameter_offsets() const { return offsets; }
+    size_t size() const { return static_cast<size_t>(flat_data->size); }
+
+    double grad_norm() const { return foreach_norm(grads()); }
+
+    double clip_grad_norm(double max_norm) {
+        auto all = grads();
+        double norm = foreach_norm(all);
+        if (norm > max_norm) foreach_scale(all, static_cast<T>(max_norm / (norm + 1e-6)));
+        return norm;
+    }
+
+    void scale_grad(T alpha) { foreach_scale(grads(), alpha); }
+
+    void zero_grad() {
+        if (flat_data->grad) foreach_zero(std::vector<std::shared_ptr<Tensor<T>>>{flat_data->grad});
+        for (auto& p : params) p->sparse_grad.reset();
+    }
+
+    // One collective over the whole gradient instead of one per parameter.
+    void all_reduce_grad(ShmCommunicator& comm, bool average = true) {
+        if (!flat_data->grad) return;
+        comm.all_reduce(flat_data->grad->data.get(), size(), average);
+    }
+
+    void broadcast(ShmCommunicator& comm, int root = 0) {
+        comm.broadcast(flat_data->data.get(), size(), root);
+        flat_data->bump_version();
+    }
+
+    // The file holds the parameter sizes, so it only loads into the same layout.
+    void save(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("ERROR: Cannot open '" + path + "' for writing.");
+        std::string header = layout_header();
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<const char*>(flat_data->data.get()), static_cast<std::streamsize>(size() * sizeof(T)));
+        if (!file) throw std::runtime_error("ERROR: Failed to write '" + path + "'.");
+    }
+
+    void load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("ERROR: Cannot open '" + path + "'.");
+        std::string expected = layout_header();
+        std::string header(expected.size(), '\0');
+        file.read(&header[0], static_cast<std::streamsize>(header.size()));
+        if (!file || header != expected) {
+            throw std::runtime_error("ERROR: '" + path + "' does not match the layout of these parameters.");
+        }
+        file.read(reinterpret_cast<char*>(flat_data->data.get()), static_cast<std::streamsize>(size() * sizeof(T)));
+        if (!file || file.peek() != std::ifstream::traits_type::eof()) {
+            throw std::runtime_error("ERROR: '" + path + "' is truncated or has trailing bytes.");
+        }
+        flat_data->bump_version();
+    }
+
+private:
+    std::shared_ptr<Tensor<T>> flat_data;
+    std::vector<std::shared_ptr<Tensor<T>>> params;
+    std::vector<size_t> offsets;
+
+    void rebind(Tensor<T>& p, size_t offset) {
+        T* target = flat_data->data.get() + offset;
+        std::copy(p.data.get(), p.data.get() + p.size, target);
+        p.release_allocation();
+        p.data = std::unique_ptr<T[], StorageDeleter<T>>(target, StorageDeleter<T>(flat_data));
+        p.version_base = flat_data;
+        p.bump_version();
+        if (!p.requires_grad) return;
+
+        auto grad_view = std::make_shared<Tensor<T>>(flat_data->grad, offset, p.shape, false);
+        if (p.grad) std::copy(p.grad->data.get(), p.grad->data.get() + p.size, grad_view->data.get());
+        p.grad = grad_view;
+    }
+
+    std::vector<std::shared_ptr<Tensor<T>>> grads() const {
+        std::vector<std::shared_ptr<Tensor<T>>> all;
+        if (flat_data->grad) all.push_back(flat_data->grad);
+        for (const auto& p : params) {
+            if (p->sparse_grad) all.push_back(p->sparse_grad->values);
+        }
+        return all;
+    }
+
+    std::string layout_header() const {
+        std::string bytes = "MTFLAT01";
+        auto put = [&bytes](uint64_t value) { bytes.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        put(sizeof(T));
+        put(params.size());
+        for (const auto& p : params) put(static_cast<uint64_t>(p->size));
+        return bytes;
+    }
+};
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef HOGWILD_H
+#define HOGWILD_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_ops.h"
+#include "tensors/tensor_sparse_grad.h"
+#include "nn/layers/linear.h"
+#include "nn/activations/activations.h"
+#include "losses/losses.h"
+#include "utils/parallel.h"
+
+// Builds the loss of one step from views of the shared parameters. Called
+// concurrently from every worker with that worker's own views.
+template<typename T>
+using HogwildStep = std::function<std::shared_ptr<Tensor<T>>(
+    const std::vector<std::shared_ptr<Tensor<T>>>& params, int worker, long long step)>;
+
+struct HogwildReport {
+    long long steps = 0;
+    double seconds = 0.0;
+    double steps_per_second = 0.0;
+    double final_loss = 0.0;
+};
+
+// Asynchronous lock-free SGD (Hogwild!). Every worker thread builds its graphs
+// over views of the shared parameters, so gradients stay thread-local, and
+// subtracts lr * grad straight from the shared buffers without any lock. Reads
+// and updates from different workers race by design: an update may be based on
+// slightly stale weights and concurrent updates to the same element may be
+// lost, which for sparse or well-conditioned problems costs little accuracy.
+// Kernels inside a worker run single-threaded; the parallelism is the workers.
+template<typename T>
+class HogwildSGD {
+public:
+    std::vector<std::shared_ptr<Tensor<T>>> params;
+    T lr;
+    int num_workers;
+
+    HogwildSGD(const std::vector<std::shared_ptr<Tensor<T>>>& params, T lr, int num_workers)
+        : params(params), lr(lr), num_workers(std::max(1, num_workers)) {}
+
+    HogwildReport run(const HogwildStep<T>& step_fn, long long steps_per_worker) {
+        std::vector<std::exception_ptr> errors(num_workers);
+        std::vector<double> last_loss(num_workers, 0.0);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        workers.reserve(num_workers);
+        for (int w = 0; w < num_workers; ++w) {
+            workers.emplace_back([&, w] {
+                try {
+                    in_parallel_region() = true;
+                    last_loss[w] = worker_loop(step_fn, w, steps_per_worker);
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        // the workers wrote through views, which have their own versions
+        for (auto& p : params) p->bump_version();
+        for (auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+
+        HogwildReport report;
+        report.steps = steps_per_worker * num_workers;
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.steps_per_second = report.seconds > 0 ? report.steps / report.seconds : 0.0;
+        for (double loss : last_loss) report.final_loss += loss / num_workers;
+        return report;
+    }
+
+private:
+    double worker_loop(const HogwildStep<T>& step_fn, int worker, long long steps) {
+        std::vector<std::shared_ptr<Tensor<T>>> views;
+        for (auto& p : params) views.push_back(std::make_shared<Tensor<T>>(p, p->requires_grad));
+
+        double loss_value = 0.0;
+        for (long long step = 0; step < steps; ++step) {
+            for (auto& v : views) v->zero_grad();
+            auto loss = step_fn(views, worker, step);
+            loss->backward();
+            loss_value = static_cast<double>(loss->data[0]);
+            for (auto& v : views) apply(*v);
+        }
+        return loss_value;
+    }
+
+    void apply(Tensor<T>& view) {
+        T* data = view.data.get();
+        if (view.grad) {
+            const T* grad = view.grad->data.get();
+            for (int i = 0; i < view.size; ++i) data[i] -= lr * grad[i];
+        }
+        if (view.sparse_grad) {
+            const SparseGrad<T>& sg = *view.sparse_grad;
+            int dim = view.size / view.shape[0];
+            const T* values = sg.values->data.get();
+            for (int k = 0; k < sg.nnz(); ++k) {
+                T* row = data + static_cast<size_t>(sg.indices[k]) * dim;
+                const T* g = values + static_cast<size_t>(k) * dim;
+                for (int j = 0; j < dim; ++j) row[j] -= lr * g[j];
+            }
+        }
+    }
+};
+
+// Stateless row sampler, so workers need no shared or per-thread generator.
+inline uint64_t hogwild_hash(uint64_t seed, uint64_t worker, uint64_t step, uint64_t index) {
+    uint64_t z = seed * 0x9E3779B97F4A7C15ull + worker * 0xBF58476D1CE4E5B9ull + step * 0x94D049BB133111EBull + index;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Step function for a stack of Linear layers trained on random mini-batches of
+// (x, y): the activation follows every layer but the last, and the loss is
+// "mse", "mae" or "bce". Batch rows are drawn by hashing (seed, worker, step).
+template<typename T>
+HogwildStep<T> hogwild_mlp_step(const std::vector<std::shared_ptr<Linear<T>>>& layers,
+                                std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> y,
+                                const std::string& activation, const std::string& loss,
+                                int batch_size, unsigned seed) {
+    if (layers.empty()) throw std::invalid_argument("ERROR: Hogwild needs at least one Linear layer.");
+    if (x->ndim != 2 || y->ndim != 2 || x->shape[0] != y->shape[0]) {
+        throw std::invalid_argument("ERROR: Hogwild expects 2D x and y with the same number of rows.");
+    }
+    if (activation != "relu" && activation != "tanh" && activation != "sigmoid" && activation != "none") {
+        throw std::invalid_argument("ERROR: Unknown activation '" + activation + "'.");
+    }
+    if (loss != "mse" && loss != "mae" && loss != "bce") {
+        throw std::invalid_argument("ERROR: Unknown loss '" + loss + "'.");
+    }
+    int rows = x->shape[0];
+    batch_size = std::max(1, std::min(batch_size, rows));
+    int num_layers = static_cast<int>(layers.size());
+
+    return [=](const std::vector<std::shared_ptr<Tensor<T>>>& params, int worker, long long step) {
+        int x_cols = x->shape[1], y_cols = y->shape[1];
+        auto xb = std::make_shared<Tensor<T>>(std::vector<int>{batch_size, x_cols}, false);
+        auto yb = std::make_shared<Tensor<T>>(std::vector<int>{batch_size, y_cols}, false);
+        for (int b = 0; b < batch_size; ++b) {
+            int r = static_cast<int>(hogwild_hash(seed, worker, step, b) % static_cast<uint64_t>(rows));
+            std::copy(x->data.get() + static_cast<size_t>(r) * x_cols, x->data.get() + static_cast<size_t>(r + 1) * x_cols,
+                      xb->data.get() + static_cast<size_t>(b) * x_cols);
+            std::copy(y->data.get() + static_cast<size_t>(r) * y_cols, y->data.get() + static_cast<size_t>(r + 1) * y_cols,
+                      yb->data.get() + static_cast<size_t>(b) * y_cols);
+        }
+
+        auto h = xb;
+        for (int l = 0; l < num_layers; ++l) {
+            h = tensor_add(mat_mul(h, transpose(params[2 * l])), params[2 * l + 1]);
+            if (l + 1 == num_layers) break;
+            if (activation == "relu") h = relu(h);
+            else if (activation == "tanh") h = tanh_fn(h);
+            else if (activation == "sigmoid") h = sigmoid(h);
+        }
+        if (loss == "bce") return bce_loss(yb, sigmoid(h));
+        if (loss == "mae") return mae_loss(yb, h);
+        return mse_loss(yb, h);
+    };
+}
+
+// Parameters of the layers in the order hogwild_mlp_step indexes them.
+template<typename T>
+std::vector<std::shared_ptr<Tensor<T>>> hogwild_mlp_parameters(const std::vector<std::shared_ptr<Linear<T>>>& layers) {
+    std::vector<std::shared_ptr<Tensor<T>>> params;
+    for (auto& layer : layers) {
+        for (auto& p : layer->parameters()) params.push_back(p);
+    }
+    return params;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef MASTER_WEIGHTS_H
+#define MASTER_WEIGHTS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_precision.h"
+#include "tensors/tensor_sparse_grad.h"
+#include "utils/parallel.h"
+
+// Scales dst[i] = src[i] * scale and reports whether every element is finite.
+// The finiteness test is an OR reduction, so one pass both unscales and checks.
+template<typename T>
+bool scale_and_check_finite(const T* src, T* dst, int n, T scale) {
+    std::atomic<bool> overflow{false};
+    parallel_for(0, n, 32768, [&](int begin, int end) {
+        int found = 0;
+        for (int i = begin; i < end; ++i) {
+            T v = src[i] * scale;
+            dst[i] = v;
+            found |= static_cast<int>(!std::isfinite(v));
+        }
+        if (found) overflow.store(true, std::memory_order_relaxed);
+    });
+    return !overflow.load();
+}
+
+// Multiplies every gradient by inv_scale in place. Returns false when a
+// gradient holds inf or NaN, i.e. the scaled backward pass overflowed.
+template<typename T>
+bool unscale_grads(const std::vector<std::shared_ptr<Tensor<T>>>& params, T inv_scale) {
+    bool finite = true;
+    for (auto& p : params) {
+        if (p->grad) {
+            T* g = p->grad->data.get();
+            finite &= scale_and_check_finite(g, g, p->grad->size, inv_scale);
+        }
+        if (p->sparse_grad) {
+            T* v = p->sparse_grad->values->data.get();
+            finite &= scale_and_check_finite(v, v, p->sparse_grad->values->size, inv_scale);
+        }
+    }
+    return finite;
+}
+
+// float32 master copies of parameters trained in reduced precision. The model
+// parameters hold values rounded to `precision` and receive the gradients of
+// backward; an optimizer is built on master_parameters() instead. Each step
+// copies the model gradients (rounded to `precision`, as low-precision storage
+// would hold them, then unscaled) into the masters, lets the optimizer update
+// the masters in float32, and writes the rounded result back into the model.
+template<typename T>
+class MasterWeights {
+public:
+    MasterWeights(const std::vector<std::shared_ptr<Tensor<T>>>& model_params, Precision precision)
+        : params(model_params), precision(precision) {
+        MemoryScope scope("master_weights", MemoryCategory::Parameter);
+        for (auto& p : params) {
+            auto master = std::make_shared<Tensor<T>>(p->shape, true);
+            std::copy(p->data.get(), p->data.get() + p->size, master->data.get());
+            masters.push_back(master);
+        }
+        copy_to_model();
+    }
+
+    const std::vector<std::shared_ptr<Tensor<T>>>& master_parameters() const { return masters; }
+
+    // Returns false and leaves the master gradients cleared when any gradient
+    // overflowed, so the caller can skip the optimizer step.
+    bool unscale_grads(T inv_scale) {
+        bool finite = true;
+        for (size_t k = 0; k < params.size(); ++k) {
+            auto& p = params[k];
+            auto& m = masters[k];
+            m->zero_grad();
+            if (p->grad) {
+                round_to_precision(p->grad->data.get(), p->grad->size, precision);
+                m->grad = std::make_shared<Tensor<T>>(p->grad->shape, false);
+                finite &= scale_and_check_finite(p->grad->data.get(), m->grad->data.get(), p->grad->size, inv_scale);
+            }
+            if (p->sparse_grad) {
+                const SparseGrad<T>& sg = *p->sparse_grad;
+                round_to_precision(sg.values->data.get(), sg.values->size, precision);
+                auto copy = std::make_shared<SparseGrad<T>>();
+                copy->indices = sg.indices;
+                copy->values = std::make_shared<Tensor<T>>(sg.values->shape, false);
+                finite &= scale_and_check_finite(sg.values->data.get(), copy->values->data.get(), sg.values->size, inv_scale);
+                m->sparse_grad = copy;
+            }
+        }
+        if (!finite) {
+            for (auto& m : masters) m->zero_grad();
+        }
+        return finite;
+    }
+
+    void copy_to_model() {
+        for (size_t k = 0; k < params.size(); ++k) {
+            auto& p = params[k];
+            std::copy(masters[k]->data.get(), masters[k]->data.get() + p->size, p->data.get());
+            round_to_precision(p->data.get(), p->size, precision);
+            p->bump_version();
+        }
+    }
+
+    void zero_grad() {
+        for (auto& p : params) p->zero_grad();
+        for (auto& m : masters) m->zero_grad();
+    }
+
+private:
+    std::vector<std::shared_ptr<Tensor<T>>> params;
+    std::vector<std::shared_ptr<Tensor<T>>> masters;
+    Precision precision;
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef OPTIMS_H
+#define OPTIMS_H
+
+#include "sgd.h"
+#include "adam.h"
+#include "master_weights.h"
+#include "hogwild.h"
+#include "trainer.h"
+#include "flat_params.h"
+
+#endif
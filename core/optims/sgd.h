@@ -0,0 +1,52 @@
+#ifndef SGD_H
+#define SGD_H
+
+#include <memory>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_sparse_grad.h"
+#include "utils/parallel.h"
+
+// Plain gradient descent. Parameters with a sparse gradient only have the rows
+// listed in sparse_grad updated; the rest of the table is not touched.
+template<typename T>
+class SGD {
+public:
+    std::vector<std::shared_ptr<Tensor<T>>> params;
+    T lr;
+
+    SGD(const std::vector<std::shared_ptr<Tensor<T>>>& params, T lr)
+        : params(params), lr(lr) {}
+
+    void step() {
+        for (auto& p : params) {
+            if (p->grad) {
+                T* data = p->data.get();
+                const T* grad = p->grad->data.get();
+                parallel_for(0, p->size, 32768, [&](int begin, int end) {
+                    for (int i = begin; i < end; ++i) data[i] -= lr * grad[i];
+                });
+            }
+            if (p->sparse_grad) {
+                const SparseGrad<T>& sg = *p->sparse_grad;
+                int dim = p->size / p->shape[0];
+                T* data = p->data.get();
+                const T* values = sg.values->data.get();
+                parallel_for(0, sg.nnz(), std::max(1, 16384 / dim), [&](int begin, int end) {
+                    for (int k = begin; k < end; ++k) {
+                        T* row = data + static_cast<size_t>(sg.indices[k]) * dim;
+                        const T* g = values + static_cast<size_t>(k) * dim;
+                        for (int j = 0; j < dim; ++j) row[j] -= lr * g[j];
+                    }
+                });
+            }
+            if (p->grad || p->sparse_grad) p->bump_version();
+        }
+    }
+
+    void zero_grad() {
+        for (auto& p : params) p->zero_grad();
+    }
+};
+
+#endif
@@ -0,0 +1,221 @@
+#ifndef TRAINER_H
+#define TRAINER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_arena.h"
+#include "nn/layers/linear.h"
+#include "nn/layers/dropout.h"
+#include "nn/layers/normalization.h"
+#include "nn/activations/activations.h"
+#include "losses/losses.h"
+#include "optims/sgd.h"
+#include "optims/adam.h"
+
+// A stack of stages run in order. Stages keep the layers they were added from,
+// so training through the model updates the caller's layers in place.
+template<typename T>
+class TrainerModel {
+public:
+    using Stage = std::function<std::shared_ptr<Tensor<T>>(const std::shared_ptr<Tensor<T>>&)>;
+
+    void add_stage(Stage stage, const std::vector<std::shared_ptr<Tensor<T>>>& stage_params = {}) {
+        stages.push_back(std::move(stage));
+        params.insert(params.end(), stage_params.begin(), stage_params.end());
+    }
+
+    void add_linear(const std::shared_ptr<Linear<T>>& layer) {
+        add_stage([layer](const std::shared_ptr<Tensor<T>>& x) { return layer->forward(x); }, layer->parameters());
+    }
+
+    void add_activation(const std::string& name) {
+        if (name == "relu") add_stage([](const std::shared_ptr<Tensor<T>>& x) { return relu(x); });
+        else if (name == "tanh") add_stage([](const std::shared_ptr<Tensor<T>>& x) { return tanh_fn(x); });
+        else if (name == "sigmoid") add_stage([](const std::shared_ptr<Tensor<T>>& x) { return sigmoid(x); });
+        else if (name == "softmax") add_stage([](const std::shared_ptr<Tensor<T>>& x) { return softmax(x); });
+        else throw std::invalid_argument("ERROR: Unknown activation '" + name + "'. Use relu, tanh, sigmoid or softmax.");
+    }
+
+    void add_dropout(const std::shared_ptr<Dropout<T>>& layer) {
+        add_stage([layer](const std::shared_ptr<Tensor<T>>& x) { return layer->forward(x); });
+    }
+
+    void add_layer_norm(const std::shared_ptr<LayerNorm<T>>& layer) {
+        add_stage([layer](const std::shared_ptr<Tensor<T>>& x) { return layer->forward(x); }, layer->parameters());
+    }
+
+    void add_batch_norm(const std::shared_ptr<BatchNorm1d<T>>& layer) {
+        add_stage([layer](const std::shared_ptr<Tensor<T>>& x) { return layer->forward(x); }, layer->parameters());
+    }
+
+    std::shared_ptr<Tensor<T>> forward(std::shared_ptr<Tensor<T>> x) const {
+        for (const Stage& stage : stages) x = stage(x);
+        return x;
+    }
+
+    const std::vector<std::shared_ptr<Tensor<T>>>& parameters() const { return params; }
+    bool empty() const { return stages.empty(); }
+
+private:
+    std::vector<Stage> stages;
+    std::vector<std::shared_ptr<Tensor<T>>> params;
+};
+
+// loss(y, y_hat), with the target first as in the loss functions.
+template<typename T>
+using TrainerLoss = std::function<std::shared_ptr<Tensor<T>>(const std::shared_ptr<Tensor<T>>&, const std::shared_ptr<Tensor<T>>&)>;
+
+template<typename T>
+TrainerLoss<T> trainer_loss(const std::string& name) {
+    if (name == "mse") return [](const std::shared_ptr<Tensor<T>>& y, const std::shared_ptr<Tensor<T>>& y_hat) { return mse_loss(y, y_hat); };
+    if (name == "mae") return [](const std::shared_ptr<Tensor<T>>& y, const std::shared_ptr<Tensor<T>>& y_hat) { return mae_loss(y, y_hat); };
+    if (name == "bce") return [](const std::shared_ptr<Tensor<T>>& y, const std::shared_ptr<Tensor<T>>& y_hat) { return bce_loss(y, y_hat); };
+    throw std::invalid_argument("ERROR: Unknown loss '" + name + "'. Use mse, mae or bce.");
+}
+
+template<typename T>
+using TrainerOptimizer = std::variant<std::shared_ptr<SGD<T>>, std::shared_ptr<Adam<T>>>;
+
+// Mini-batches of the rows of x and y. With shuffle, every epoch visits the
+// rows in a new order drawn from (seed, epoch); the last batch may be short.
+template<typename T>
+class TensorDataLoader {
+public:
+    TensorDataLoader(std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> y, int batch_size,
+                     bool shuffle = true, uint64_t seed = 0)
+        : x(std::move(x)), y(std::move(y)), batch_size(batch_size), shuffle(shuffle), seed(seed) {
+        if (this->x->ndim < 1 || this->y->ndim < 1 || this->x->shape[0] != this->y->shape[0]) {
+            throw std::invalid_argument("ERROR: x and y must have the same number of rows.");
+        }
+        if (batch_size < 1) throw std::invalid_argument("ERROR: batch_size must be positive.");
+        rows = this->x->shape[0];
+        order.resize(rows);
+        std::iota(order.begin(), order.end(), 0);
+    }
+
+    int num_batches() const { return (rows + batch_size - 1) / batch_size; }
+
+    void start_epoch(int epoch) {
+        if (!shuffle) return;
+        std::iota(order.begin(), order.end(), 0);
+        std::mt19937_64 engine(seed * 0x9E3779B97F4A7C15ull + static_cast<uint64_t>(epoch));
+        std::shuffle(order.begin(), order.end(), engine);
+    }
+
+    std::pair<std::shared_ptr<Tensor<T>>, std::shared_ptr<Tensor<T>>> batch(int index) const {
+        int first = index * batch_size;
+        int count = std::min(batch_size, rows - first);
+        return {gather(*x, first, count), gather(*y, first, count)};
+    }
+
+private:
+    std::shared_ptr<Tensor<T>> x, y;
+    int batch_size;
+    bool shuffle;
+    uint64_t seed;
+    int rows = 0;
+    std::vector<int> order;
+
+    std::shared_ptr<Tensor<T>> gather(const Tensor<T>& source, int first, int count) const {
+        TensorShape shape(source.shape);
+        shape[0] = count;
+        auto result = std::make_shared<Tensor<T>>(shape, false);
+        size_t row = static_cast<size_t>(source.size / rows);
+        const T* src = source.data.get();
+        T* dst = result->data.get();
+        for (int k = 0; k < count; ++k) {
+            std::copy(src + order[first + k] * row, src + (order[first + k] + 1) * row, dst + k * row);
+        }
+        return result;
+    }
+};
+
+struct TrainerProgress {
+    int epoch = 0;
+    long long step = 0;     // steps completed so far, over all epochs
+    double loss = 0.0;      // mean loss of the steps since the previous callback
+    double seconds = 0.0;
+};
+
+using TrainerCallback = std::function<void(const TrainerProgress&)>;
+
+struct TrainerReport {
+    long long steps = 0;
+    double seconds = 0.0;
+    double steps_per_second = 0.0;
+    double final_loss = 0.0;
+    std::vector<double> epoch_losses;   // mean loss of each epoch
+};
+
+// Runs whole epochs of zero_grad, forward, loss, backward and optimizer step
+// without leaving C++. Each step runs in a StepArenaScope, so its temporaries
+// are released together once the optimizer has stepped. The callback, if any,
+// runs every log_every steps.
+template<typename T>
+class Trainer {
+public:
+    Trainer(std::shared_ptr<TrainerModel<T>> model, TrainerLoss<T> loss, TrainerOptimizer<T> optimizer)
+        : model(std::move(model)), loss_fn(std::move(loss)), optimizer(std::move(optimizer)) {
+        if (this->model->empty()) throw std::invalid_argument("ERROR: The trainer's model has no stages.");
+    }
+
+    TrainerReport fit(TensorDataLoader<T>& data, int epochs, long long log_every = 0, const TrainerCallback& callback = nullptr) {
+        if (epochs < 0) throw std::invalid_argument("ERROR: epochs must be non-negative.");
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = [&] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+
+        TrainerReport report;
+        double window_loss = 0.0;
+        long long window_steps = 0;
+        int batches = data.num_batches();
+        for (int epoch = 0; epoch < epochs; ++epoch) {
+            data.start_epoch(epoch);
+            double epoch_loss = 0.0;
+            for (int b = 0; b < batches; ++b) {
+                double value = step(data, b);
+                epoch_loss += value;
+                window_loss += value;
+                ++window_steps;
+                ++report.steps;
+                if (callback && log_every > 0 && report.steps % log_every == 0) {
+                    callback(TrainerProgress{epoch, report.steps, window_loss / window_steps, elapsed()});
+                    window_loss = 0.0;
+                    window_steps = 0;
+                }
+            }
+            report.epoch_losses.push_back(batches > 0 ? epoch_loss / batches : 0.0);
+        }
+
+        report.seconds = elapsed();
+        report.steps_per_second = report.seconds > 0 ? report.steps / report.seconds : 0.0;
+        if (!report.epoch_losses.empty()) report.final_loss = report.epoch_losses.back();
+        return report;
+    }
+
+private:
+    std::shared_ptr<TrainerModel<T>> model;
+    TrainerLoss<T> loss_fn;
+    TrainerOptimizer<T> optimizer;
+
+    double step(const TensorDataLoader<T>& data, int index) {
+        StepArenaScope arena;
+        std::visit([](auto& opt) { opt->zero_grad(); }, optimizer);
+        auto [x, y] = data.batch(index);
+        auto loss = loss_fn(y, model->forward(x));
+        loss->backward();
+        std::visit([](auto& opt) { opt->step(); }, optimizer);
+        return static_cast<double>(loss->data[0]);
+    }
+};
+
+#endif
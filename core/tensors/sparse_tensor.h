@@ -0,0 +1,199 @@
+#ifndef SPARSE_TENSOR_H
+#define SPARSE_TENSOR_H
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "tensor.h"
+#include "tensor_memory.h"
+#include "utils/parallel.h"
+
+// 2D sparse matrix in CSR form: the column indices and values of row i are
+// col_idx / values[row_ptr[i] .. row_ptr[i + 1]), sorted by column with no
+// duplicates. Storage is proportional to the number of non-zeros and is
+// reported to MemoryStats like a dense tensor's buffer. Sparse tensors are
+// constants: they never require grad.
+template<typename T>
+class SparseTensor {
+public:
+    int rows, cols;
+    std::vector<int> row_ptr;
+    std::vector<int> col_idx;
+    std::vector<T> values;
+
+    MemoryOpSlot* alloc_op = nullptr;
+    MemoryCategory alloc_category = MemoryCategory::Activation;
+    long long alloc_bytes = 0;
+
+    SparseTensor(int rows, int cols, std::vector<int> row_ptr, std::vector<int> col_idx, std::vector<T> values)
+        : rows(rows), cols(cols), row_ptr(std::move(row_ptr)), col_idx(std::move(col_idx)), values(std::move(values)) {
+        validate();
+        alloc_op = MemoryScope::current_op();
+        alloc_category = MemoryScope::current_category();
+        alloc_bytes = static_cast<long long>(this->row_ptr.size() + this->col_idx.size()) * sizeof(int) +
+                      static_cast<long long>(this->values.size()) * sizeof(T);
+        MemoryStats::instance().record_alloc(alloc_op, alloc_category, alloc_bytes);
+    }
+
+    ~SparseTensor() {
+        MemoryStats::instance().record_free(alloc_op, alloc_category, alloc_bytes);
+    }
+
+    SparseTensor(const SparseTensor&) = delete;
+    SparseTensor& operator=(const SparseTensor&) = delete;
+
+    int nnz() const { return static_cast<int>(values.size()); }
+    std::vector<int> shape() const { return {rows, cols}; }
+
+    void validate() const {
+        if (rows <= 0 || cols <= 0) throw std::invalid_argument("ERROR: Dimension must be positive.");
+        if (row_ptr.size() != static_cast<size_t>(rows) + 1 || row_ptr.front() != 0) {
+            throw std::invalid_argument("ERROR: row_ptr must have rows + 1 entries starting at 0.");
+        }
+        if (col_idx.size() != values.size() || row_ptr.back() != static_cast<int>(values.size())) {
+            throw std::invalid_argument("ERROR: col_idx and values must both have row_ptr[rows] entries.");
+        }
+        for (int i = 0; i < rows; ++i) {
+            if (row_ptr[i] > row_ptr[i + 1]) throw std::invalid_argument("ERROR: row_ptr must be non-decreasing.");
+            for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+                if (col_idx[k] < 0 || col_idx[k] >= cols) throw std::out_of_range("ERROR: Column index out of range.");
+                if (k > row_ptr[i] && col_idx[k] <= col_idx[k - 1]) {
+                    throw std::invalid_argument("ERROR: Column indices must be sorted and unique within a row.");
+                }
+            }
+        }
+    }
+
+    // Builds CSR from coordinate triplets in any order; duplicates are summed.
+    static std::shared_ptr<SparseTensor<T>> from_coo(int rows, int cols,
+                                                     const std::vector<int>& row_indices,
+                                                     const std::vector<int>& col_indices,
+                                                     const std::vector<T>& coo_values) {
+        size_t n = coo_values.size();
+        if (row_indices.size() != n || col_indices.size() != n) {
+            throw std::invalid_argument("ERROR: COO indices and values must have the same length.");
+        }
+        for (size_t k = 0; k < n; ++k) {
+            if (row_indices[k] < 0 || row_indices[k] >= rows || col_indices[k] < 0 || col_indices[k] >= cols) {
+                throw std::out_of_range("ERROR: COO index out of range.");
+            }
+        }
+
+        // counting sort by row, then sort each row by column
+        std::vector<int> counts(rows + 1, 0);
+        for (size_t k = 0; k < n; ++k) ++counts[row_indices[k] + 1];
+        std::partial_sum(counts.begin(), counts.end(), counts.begin());
+        std::vector<int> order(n);
+        std::vector<int> fill(counts.begin(), counts.end() - 1);
+        for (size_t k = 0; k < n; ++k) order[fill[row_indices[k]]++] = static_cast<int>(k);
+
+        std::vector<int> row_ptr(rows + 1, 0);
+        std::vector<int> col_idx;
+        std::vector<T> values;
+        col_idx.reserve(n);
+        values.reserve(n);
+        for (int i = 0; i < rows; ++i) {
+            std::stable_sort(order.begin() + counts[i], order.begin() + counts[i + 1],
+                             [&](int a, int b) { return col_indices[a] < col_indices[b]; });
+            for (int k = counts[i]; k < counts[i + 1]; ++k) {
+                int col = col_indices[order[k]];
+                if (static_cast<int>(col_idx.size()) > row_ptr[i] && col_idx.back() == col) {
+                    values.back() += coo_values[order[k]];
+                } else {
+                    col_idx.push_back(col);
+                    values.push_back(coo_values[order[k]]);
+                }
+            }
+            row_ptr[i + 1] = static_cast<int>(col_idx.size());
+        }
+        return std::make_shared<SparseTensor<T>>(rows, cols, std::move(row_ptr), std::move(col_idx), std::move(values));
+    }
+
+    // Non-zeros of a dense 2D tensor.
+    static std::shared_ptr<SparseTensor<T>> from_dense(const Tensor<T>& dense) {
+        if (dense.ndim != 2) throw std::invalid_argument("ERROR: Only 2D tensors can be converted to sparse.");
+        int r = dense.shape[0];
+        int c = dense.shape[1];
+        std::vector<int> row_ptr(r + 1, 0);
+        std::vector<int> col_idx;
+        std::vector<T> values;
+        for (int i = 0; i < r; ++i) {
+            for (int j = 0; j < c; ++j) {
+                T v = dense.data[i * c + j];
+                if (v != static_cast<T>(0)) {
+                    col_idx.push_back(j);
+                    values.push_back(v);
+                }
+            }
+            row_ptr[i + 1] = static_cast<int>(col_idx.size());
+        }
+        return std::make_shared<SparseTensor<T>>(r, c, std::move(row_ptr), std::move(col_idx), std::move(values));
+    }
+
+    std::shared_ptr<Tensor<T>> to_dense() const {
+        MemoryScope scope("sparse_to_dense");
+        auto result = std::make_shared<Tensor<T>>(std::vector<int>{rows, cols}, false);
+        std::fill(result->data.get(), result->data.get() + result->size, static_cast<T>(0));
+        for (int i = 0; i < rows; ++i) {
+            for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) result->data[i * cols + col_idx[k]] = values[k];
+        }
+        return result;
+    }
+
+    // CSR of the transpose (equivalently, the CSC form of this matrix).
+    std::shared_ptr<SparseTensor<T>> transposed() const {
+        std::vector<int> t_ptr(cols + 1, 0);
+        for (int c : col_idx) ++t_ptr[c + 1];
+        std::partial_sum(t_ptr.begin(), t_ptr.end(), t_ptr.begin());
+
+        std::vector<int> t_idx(values.size());
+        std::vector<T> t_values(values.size());
+        std::vector<int> fill(t_ptr.begin(), t_ptr.end() - 1);
+        for (int i = 0; i < rows; ++i) {
+            for (int k = row_ptr[i]; k < row_ptr[i + 1]; ++k) {
+                int dst = fill[col_idx[k]]++;
+                t_idx[dst] = i;
+                t_values[dst] = values[k];
+            }
+        }
+        return std::make_shared<SparseTensor<T>>(cols, rows, std::move(t_ptr), std::move(t_idx), std::move(t_values));
+    }
+};
+
+// C[M x N] (+)= A[M x K] * B[K x N] for sparse A and row-major dense B. Rows of
+// C are independent, so they are split across threads in chunks of roughly
+// equal work; the cost is O(nnz * N) regardless of K.
+template<typename T>
+void spmm_kernel(const SparseTensor<T>& A, const T* B, int N, T* C, bool accumulate = false) {
+    int work_per_row = std::max(1, (A.nnz() / A.rows) * N);
+    int grain = std::max(1, 32768 / work_per_row);
+    parallel_for(0, A.rows, grain, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            T* c_row = C + static_cast<size_t>(i) * N;
+            if (!accumulate) std::fill(c_row, c_row + N, static_cast<T>(0));
+            for (int k = A.row_ptr[i]; k < A.row_ptr[i + 1]; ++k) {
+                const T a = A.values[k];
+                const T* b_row = B + static_cast<size_t>(A.col_idx[k]) * N;
+                for (int j = 0; j < N; ++j) c_row[j] += a * b_row[j];
+            }
+        }
+    });
+}
+
+template<typename T>
+std::string sparse_tensor_repr(const SparseTensor<T>& t) {
+    std::string dtype_name;
+    if (std::is_same<T, int>::value) dtype_name = "int32";
+    else if (std::is_same<T, float>::value) dtype_name = "float32";
+    else if (std::is_same<T, double>::value) dtype_name = "float64";
+    else dtype_name = "unknown";
+
+    return "<SparseTensor dtype=" + dtype_name + " shape=(" + std::to_string(t.rows) + ", " +
+           std::to_string(t.cols) + ") nnz=" + std::to_string(t.nnz()) + ">";
+}
+
+#endif
@@ -2,40 +2,112 @@
 #define TENSOR_H
 
 #include <vector>
+#include <atomic>
 #include <stdexcept>
 #include <numeric>
 #include <functional>
 #include <type_traits>
 #include <memory>
 #include <algorithm>
+#include <unordered_set>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include "tensor_memory.h"
+#include "tensor_shape.h"
+#include "tensor_arena.h"
+#include "autograd/grad_mode.h"
+#include "autograd/backward_callbacks.h"
 
 template<typename T>
 class Tensor;
 
+template<typename T>
+struct SparseGrad;
+
+// Frees a tensor buffer. A view (see the aliasing constructor) does not own its
+// buffer: its deleter only holds a reference that keeps the owner alive.
+// Buffers from allocate_storage go back through step_free.
+template<typename T>
+struct StorageDeleter {
+    std::shared_ptr<const void> owner;
+    bool step_allocated = false;
+
+    StorageDeleter() = default;
+    StorageDeleter(std::default_delete<T[]>) {}
+    explicit StorageDeleter(std::shared_ptr<const void> storage_owner) : owner(std::move(storage_owner)) {}
+
+    void operator()(T* ptr) const {
+        if (owner) return;
+        if (step_allocated) {
+            step_free(ptr);
+        } else {
+            delete[] ptr;
+        }
+    }
+};
+
+// Zero-filled buffer of n elements. Parameters always come from the heap; other
+// buffers come from the step arena while one is active on this thread.
+template<typename T>
+std::unique_ptr<T[], StorageDeleter<T>> allocate_storage(size_t n, bool persistent) {
+    static_assert(std::is_trivially_copyable_v<T>, "tensor elements must be trivially copyable");
+    size_t bytes = n * sizeof(T);
+    T* ptr = static_cast<T*>(persistent ? step_alloc_heap(bytes) : step_alloc(bytes));
+    std::fill(ptr, ptr + n, T{});
+    StorageDeleter<T> deleter;
+    deleter.step_allocated = true;
+    return std::unique_ptr<T[], StorageDeleter<T>>(ptr, std::move(deleter));
+}
+
+// Backward nodes are allocated from the step arena when one is active.
 template<typename T>
 struct Function {
     virtual void backward(std::shared_ptr<Tensor<T>> grad) = 0;
     virtual ~Function() = default;
+    // True for nodes that read their output's values in backward (exp, tanh,
+    // ...); such an output must keep its buffer while the graph is alive.
+    virtual bool reads_output() const { return false; }
+
+    static void* operator new(size_t bytes) { return step_alloc(bytes); }
+    static void operator delete(void* ptr) { step_free(ptr); }
 };
 
 template<typename T>
 class Tensor : public std::enable_shared_from_this<Tensor<T>> {
 public:
-    std::unique_ptr<T[]> data;
-    std::vector<int> shape;
+    std::unique_ptr<T[], StorageDeleter<T>> data;
+    TensorShape shape;
     int ndim;
     int size;
-    std::vector<int> stride;
+    TensorShape stride;
     bool requires_grad;
+    bool graph_released = false;
 
     std::shared_ptr<Tensor<T>> grad;
-    std::vector<std::shared_ptr<Tensor<T>>> parents;
+    std::shared_ptr<SparseGrad<T>> sparse_grad;
+    // Forward-mode tangent; a tensor that has one is a dual tensor (see
+    // autograd/forward_ad.h).
+    std::shared_ptr<Tensor<T>> tangent;
+    std::vector<std::shared_ptr<Tensor<T>>, StepAllocator<std::shared_ptr<Tensor<T>>>> parents;
     std::unique_ptr<Function<T>> grad_fn;
+    // Run by backward on a leaf once every contribution to its gradient has
+    // been accumulated, in the order in which backward reaches the leaves.
+    std::vector<std::function<void(Tensor<T>&)>> grad_ready_hooks;
 
-    static std::vector<int> compute_stride(const std::vector<int>& shape, const int ndim) {
-        std::vector<int> stride(ndim);
+    // Incremented whenever the values are overwritten in place (set_data,
+    // optimizer steps, collectives), so caches derived from them can tell
+    // that they are stale.
+    std::atomic<unsigned long long> version{0};
+    // Owner of the buffer this tensor views, if any: writes counted on it
+    // (e.g. an optimizer step over a flat parameter buffer) count here too.
+    std::shared_ptr<const Tensor<T>> version_base;
+
+    MemoryOpSlot* alloc_op = nullptr;
+    MemoryCategory alloc_category = MemoryCategory::Activation;
+    long long alloc_bytes = 0;
+
+    static TensorShape compute_stride(const TensorShape& shape, const int ndim) {
+        TensorShape stride(shape);
         int acc = 1;
         for (int i = ndim - 1; i >= 0; --i) {
             stride[i] = acc;
@@ -50,29 +122,64 @@ public:
         if(new_size != this->size) {
             throw std::runtime_error("ERROR: Reshape size mismatch.");
         }
-        auto result = std::make_shared<Tensor<T>>(new_shape, this->requires_grad);
+        MemoryScope scope("reshape");
+        auto result = std::make_shared<Tensor<T>>(new_shape, GradMode::resolve(this->requires_grad));
         std::copy(this->data.get(), this->data.get() + this->size, result->data.get());
+        if (tangent) result->tangent = tangent->reshape(new_shape);
         return result;
     }
 
-    Tensor(const std::vector<int>& shape, bool req_grad = false)
+    Tensor(const TensorShape& shape, bool req_grad = false)
         : shape(shape), ndim(shape.size()), requires_grad(req_grad), grad(nullptr) {
         if (ndim < 1) throw std::invalid_argument("ERROR: Invalid shape.");
         size = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
         if (size <= 0) throw std::invalid_argument("ERROR: Dimension must be positive.");
         stride = compute_stride(shape, ndim);
-        data = std::make_unique<T[]>(size);
+        data = allocate_storage<T>(size, MemoryScope::current_category() == MemoryCategory::Parameter);
+        record_allocation();
     }
 
-    Tensor(const std::vector<T>& data_vec, const std::vector<int>& shape, bool req_grad = false)
+    Tensor(const std::vector<T>& data_vec, const TensorShape& shape, bool req_grad = false)
         : shape(shape), ndim(shape.size()), requires_grad(req_grad), grad(nullptr) {
         if (ndim < 1) throw std::invalid_argument("ERROR: Invalid shape.");
         size = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
         if (size <= 0) throw std::invalid_argument("ERROR: Dimension must be positive.");
         if (data_vec.size() != static_cast<size_t>(size)) throw std::invalid_argument("ERROR: Data size does not match shape size.");
         stride = compute_stride(shape, ndim);
-        data = std::make_unique<T[]>(size);
+        data = allocate_storage<T>(size, MemoryScope::current_category() == MemoryCategory::Parameter);
         std::copy(data_vec.begin(), data_vec.end(), data.get());
+        record_allocation();
+    }
+
+    // A view of base's buffer with its own gradient and graph, so several
+    // threads can each build a graph over the same parameter values. Writes go
+    // to the shared buffer. Views are not counted as allocations.
+    Tensor(const std::shared_ptr<Tensor<T>>& base, bool req_grad)
+        : data(base->data.get(), StorageDeleter<T>(base)), shape(base->shape), ndim(base->ndim), size(base->size),
+          stride(base->stride), requires_grad(req_grad), grad(nullptr) {}
+
+    // A node with a shape and a place in the graph but no values (see
+    // gradient_edge in autograd/gradient_edge.h).
+    struct GradientSinkTag {};
+    Tensor(const TensorShape& shape, GradientSinkTag)
+        : shape(shape), ndim(shape.size()), requires_grad(true), grad(nullptr) {
+        size = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
+        stride = compute_stride(shape, ndim);
+    }
+
+    // A view of `shape` consecutive elements of base's buffer from offset on.
+    Tensor(const std::shared_ptr<Tensor<T>>& base, size_t offset, const TensorShape& shape, bool req_grad)
+        : data(base->data.get() + offset, StorageDeleter<T>(base)), shape(shape), ndim(shape.size()),
+          requires_grad(req_grad), grad(nullptr), version_base(base) {
+        size = std::accumulate(shape.begin(), shape.end(), 1, std::multiplies<int>());
+        if (ndim < 1 || size <= 0 || offset + size > static_cast<size_t>(base->size)) {
+            throw std::invalid_argument("ERROR: View does not fit in its base tensor.");
+        }
+        stride = compute_stride(shape, ndim);
+    }
+
+    ~Tensor() {
+        release_allocation();
     }
 
     Tensor(const Tensor&) = delete;
@@ -86,12 +193,22 @@ public:
           stride(std::move(other.stride)),
           requires_grad(other.requires_grad),
           grad(std::move(other.grad)),
+          sparse_grad(std::move(other.sparse_grad)),
+          tangent(std::move(other.tangent)),
           parents(std::move(other.parents)),
-          grad_fn(std::move(other.grad_fn)) {
+          grad_fn(std::move(other.grad_fn)),
+          grad_ready_hooks(std::move(other.grad_ready_hooks)),
+          version(other.version.load(std::memory_order_relaxed)),
+          version_base(std::move(other.version_base)),
+          alloc_op(other.alloc_op),
+          alloc_category(other.alloc_category),
+          alloc_bytes(other.alloc_bytes) {
+        other.alloc_bytes = 0;
     }
 
     Tensor& operator=(Tensor&& other) noexcept {
         if (this != &other) {
+            release_allocation();
             data = std::move(other.data);
             shape = std::move(other.shape);
             ndim = other.ndim;
@@ -99,36 +216,147 @@ public:
             stride = std::move(other.stride);
             requires_grad = other.requires_grad;
             grad = std::move(other.grad);
+            sparse_grad = std::move(other.sparse_grad);
+            tangent = std::move(other.tangent);
             parents = std::move(other.parents);
             grad_fn = std::move(other.grad_fn);
+            grad_ready_hooks = std::move(other.grad_ready_hooks);
+            version_base = std::move(other.version_base);
+            bump_version();
+            alloc_op = other.alloc_op;
+            alloc_category = other.alloc_category;
+            alloc_bytes = other.alloc_bytes;
+            other.alloc_bytes = 0;
         }
         return *this;
     }
+
+    void record_allocation() {
+        alloc_op = MemoryScope::current_op();
+        alloc_category = MemoryScope::current_category();
+        alloc_bytes = static_cast<long long>(size) * sizeof(T);
+        MemoryStats::instance().record_alloc(alloc_op, alloc_category, alloc_bytes);
+    }
+
+    void release_allocation() {
+        if (alloc_bytes == 0) return;
+        MemoryStats::instance().record_free(alloc_op, alloc_category, alloc_bytes);
+        alloc_bytes = 0;
+    }
     
     void set_data(const Tensor<T>& other) {
         if (this->size != other.size) {
             throw std::runtime_error("ERROR: set_data requires tensors of the same size.");
         }
         std::copy(other.data.get(), other.data.get() + other.size, this->data.get());
+        bump_version();
+    }
+
+    unsigned long long data_version() const {
+        unsigned long long v = version.load(std::memory_order_acquire);
+        return version_base ? v + version_base->data_version() : v;
+    }
+    void bump_version() { version.fetch_add(1, std::memory_order_release); }
+
+    // Nodes reachable through `parents`, ordered so that every node comes after
+    // all of the nodes that consume it. The tensor itself is not included.
+    std::vector<std::shared_ptr<Tensor<T>>> graph_order() {
+        std::vector<std::shared_ptr<Tensor<T>>> order;
+        std::unordered_set<const Tensor<T>*> visited;
+        std::vector<std::pair<std::shared_ptr<Tensor<T>>, size_t>> stack;
+
+        auto visit = [&](const std::shared_ptr<Tensor<T>>& node) {
+            if (!node->requires_grad) return;
+            if (visited.count(node.get())) return;
+            if (node->graph_released) {
+                throw std::runtime_error("ERROR: Trying to backward through a graph that has already been freed. "
+                                         "Pass retain_graph=True to the first backward call.");
+            }
+            visited.insert(node.get());
+            stack.push_back({node, 0});
+        };
+
+        for (auto& parent : parents) {
+            visit(parent);
+            while (!stack.empty()) {
+                auto& top = stack.back();
+                if (top.second < top.first->parents.size()) {
+                    auto child = top.first->parents[top.second++];
+                    visit(child);
+                } else {
+                    order.push_back(top.first);
+                    stack.pop_back();
+                }
+            }
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
     }
 
-    void backward() {
+    void release_graph() {
+        grad_fn.reset();
+        parents.clear();
+        graph_released = true;
+    }
+
+    void backward(bool retain_graph = false) {
         if (!requires_grad) {
             return;
         }
+        if (graph_released) {
+            throw std::runtime_error("ERROR: Trying to backward through a graph that has already been freed. "
+                                     "Pass retain_graph=True to the first backward call.");
+        }
+        NoGradGuard no_grad;
+        MemoryScope scope("backward", MemoryCategory::Gradient);
+        BackwardPass pass;
+
+        auto order = graph_order();
+        for (auto& node : order) {
+            if (node->grad_fn) node->grad = nullptr;
+        }
         if (grad == nullptr) {
+            StepArenaBypass heap;
             std::vector<T> ones_data(size, static_cast<T>(1));
             grad = std::make_shared<Tensor<T>>(ones_data, shape, false);
         }
+
         if (grad_fn) {
             grad_fn->backward(grad);
+            if (!retain_graph) release_graph();
+        }
+        for (auto& node : order) {
+            if (node->grad_fn) {
+                if (node->grad) node->grad_fn->backward(node->grad);
+                if (!retain_graph) node->release_graph();
+            } else {
+                // every consumer of a leaf precedes it in order, so its gradient is final here
+                for (auto& hook : node->grad_ready_hooks) hook(*node);
+                if (node->grad) node->grad->move_out_of_step_arena();
+            }
+            node.reset();
         }
+        pass.finish();
+    }
+
+    // Copies a buffer that lives in the step arena to the heap. Leaf gradients
+    // outlive the step, and would otherwise keep their arena chunk pinned.
+    void move_out_of_step_arena() {
+        if (!data.get_deleter().step_allocated || !step_in_arena(data.get())) return;
+        auto heap = allocate_storage<T>(size, true);
+        std::copy(data.get(), data.get() + size, heap.get());
+        data = std::move(heap);
+    }
+
+    void register_grad_ready_hook(std::function<void(Tensor<T>&)> hook) {
+        grad_ready_hooks.push_back(std::move(hook));
     }
 
     void zero_grad() {
         if (grad != nullptr) {
             std::fill(grad->data.get(), grad->data.get() + grad->size, static_cast<T>(0));
         }
+        sparse_grad.reset();
     }
 };
 
@@ -139,26 +367,6 @@ std::vector<T> to_vector(const Tensor<T>& tensor) {
     return data_vec;
 }
 
-template<typename T>
-pybind11::list to_nested(const Tensor<T>& tensor, int dim=0, int offset=0) {
-    pybind11::list nested_list;
-    if (dim == tensor.ndim - 1) {
-        for (int i = 0; i < tensor.shape[dim]; ++i)
-            nested_list.append(tensor.data[offset + i]);
-    } else {
-        int step = 1;
-        for (int i = dim+1; i < tensor.ndim; ++i) step *= tensor.shape[i];
-        for (int i = 0; i < tensor.shape[dim]; ++i)
-            nested_list.append(to_nested(tensor, dim+1, offset + i*step));
-    }
-    return nested_list;
-}
-
-template<typename T>
-pybind11::list to_nested_wrapper(const Tensor<T>& tensor) {
-    return to_nested(tensor, 0, 0);
-}
-
 template<typename T>
 std::string tensor_repr(const Tensor<T>& t) {
     std::string shape_str = "(";
@@ -192,7 +400,8 @@ pybind11::object getitem(std::shared_ptr<Tensor<T>> t, pybind11::object idx) {
             int size = std::accumulate(new_shape.begin(), new_shape.end(), 1, std::multiplies<int>());
             std::vector<T> new_data(size);
             std::copy(t->data.get() + i * step, t->data.get() + (i + 1) * step, new_data.begin());
-            return pybind11::cast(std::make_shared<Tensor<T>>(new_data, new_shape, t->requires_grad));
+            MemoryScope scope("getitem");
+            return pybind11::cast(std::make_shared<Tensor<T>>(new_data, new_shape, GradMode::resolve(t->requires_grad)));
         }
     }
     throw std::invalid_argument("Invalid index type for tensor");
@@ -0,0 +1,215 @@
+#ifndef TENSOR_ARENA_H
+#define TENSOR_ARENA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Bump allocator for the short-lived allocations of a training step: tensor
+// buffers, backward nodes and parent lists. While a StepArenaScope is active
+// on a thread, step_alloc carves blocks out of that thread's chunks. With no
+// scope it falls back to the heap, so every caller frees with step_free.
+//
+// Each block starts with a 16-byte header naming its chunk. A chunk counts its
+// live blocks plus one reference held by the arena, and frees (from any
+// thread) only decrement that count. When the outermost scope closes the arena
+// rewinds, in one pass, every chunk whose blocks have all been freed. A block
+// still alive then pins its whole chunk (CHUNK_BYTES) until it is released, so
+// results that usually outlive the step (losses, the seed gradient of
+// backward, sparse parameter gradients) are allocated outside the arena with
+// StepArenaBypass.
+
+class StepArena {
+public:
+    static constexpr size_t ALIGN = 16;
+    static constexpr size_t HEADER = 16;
+    static constexpr size_t CHUNK_BYTES = size_t(1) << 20;
+
+    struct Chunk {
+        std::atomic<long> refs{1};
+        size_t capacity = 0;
+        size_t used = 0;
+
+        char* base() { return reinterpret_cast<char*>(this) + chunk_header_bytes(); }
+    };
+
+    struct alignas(ALIGN) BlockHeader {
+        Chunk* chunk;   // null for heap blocks
+    };
+    static_assert(sizeof(BlockHeader) == HEADER, "block header must keep payloads 16-byte aligned");
+
+    struct Stats {
+        long long chunks = 0;
+        long long reserved_bytes = 0;
+        long long allocations = 0;
+        long long resets = 0;
+    };
+
+    StepArena() = default;
+    StepArena(const StepArena&) = delete;
+    StepArena& operator=(const StepArena&) = delete;
+
+    ~StepArena() {
+        for (Chunk* chunk : chunks) release(chunk);
+    }
+
+    void* allocate(size_t bytes) {
+        size_t need = HEADER + round_up(bytes);
+        if (!current || current->used + need > current->capacity) current = next_chunk(need);
+        char* block = current->base() + current->used;
+        current->used += need;
+        current->refs.fetch_add(1, std::memory_order_relaxed);
+        reinterpret_cast<BlockHeader*>(block)->chunk = current;
+        ++stats.allocations;
+        return block + HEADER;
+    }
+
+    // Rewinds every chunk that no longer holds a live block.
+    void reset() {
+        for (Chunk* chunk : chunks) {
+            if (chunk->refs.load(std::memory_order_acquire) == 1) chunk->used = 0;
+        }
+        current = nullptr;
+        ++stats.resets;
+    }
+
+    Stats get_stats() const { return stats; }
+
+    static void release(Chunk* chunk) {
+        if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) ::operator delete(chunk);
+    }
+
+    static size_t round_up(size_t bytes) { return (bytes + ALIGN - 1) / ALIGN * ALIGN; }
+
+    static constexpr size_t chunk_header_bytes() { return (sizeof(Chunk) + ALIGN - 1) / ALIGN * ALIGN; }
+
+    // Scope nesting depth on the owning thread.
+    int depth = 0;
+
+private:
+    std::vector<Chunk*> chunks;
+    Chunk* current = nullptr;
+    Stats stats;
+
+    // A chunk with no live blocks is rewound and reused; otherwise a new one
+    // is added, at least large enough for the request.
+    Chunk* next_chunk(size_t need) {
+        for (Chunk* chunk : chunks) {
+            if (chunk != current && chunk->capacity >= need && chunk->refs.load(std::memory_order_acquire) == 1) {
+                chunk->used = 0;
+                return chunk;
+            }
+        }
+        size_t capacity = std::max(CHUNK_BYTES, need);
+        void* memory = ::operator new(chunk_header_bytes() + capacity);
+        Chunk* chunk = new (memory) Chunk();
+        chunk->capacity = capacity;
+        chunks.push_back(chunk);
+        ++stats.chunks;
+        stats.reserved_bytes += static_cast<long long>(capacity);
+        return chunk;
+    }
+};
+
+inline StepArena& thread_step_arena() {
+    thread_local StepArena arena;
+    return arena;
+}
+
+inline StepArena*& active_step_arena() {
+    thread_local StepArena* arena = nullptr;
+    return arena;
+}
+
+// From this thread's arena while a scope is active, from the heap otherwise.
+inline void* step_alloc(size_t bytes) {
+    if (StepArena* arena = active_step_arena()) return arena->allocate(bytes);
+    char* block = static_cast<char*>(::operator new(StepArena::HEADER + bytes));
+    reinterpret_cast<StepArena::BlockHeader*>(block)->chunk = nullptr;
+    return block + StepArena::HEADER;
+}
+
+// Always from the heap, for memory that outlives the step (parameters).
+inline void* step_alloc_heap(size_t bytes) {
+    char* block = static_cast<char*>(::operator new(StepArena::HEADER + bytes));
+    reinterpret_cast<StepArena::BlockHeader*>(block)->chunk = nullptr;
+    return block + StepArena::HEADER;
+}
+
+inline StepArena::BlockHeader* step_header(void* ptr) {
+    return reinterpret_cast<StepArena::BlockHeader*>(static_cast<char*>(ptr) - StepArena::HEADER);
+}
+
+inline void step_free(void* ptr) {
+    if (!ptr) return;
+    StepArena::BlockHeader* header = step_header(ptr);
+    if (header->chunk) {
+        StepArena::release(header->chunk);
+    } else {
+        ::operator delete(header);
+    }
+}
+
+inline bool step_in_arena(void* ptr) {
+    return ptr && step_header(ptr)->chunk != nullptr;
+}
+
+// Routes this thread's step allocations to its arena. The outermost scope
+// resets the arena on exit, after backward and the optimizer step have run.
+class StepArenaScope {
+public:
+    StepArenaScope() { enter(); }
+    ~StepArenaScope() { exit(); }
+    StepArenaScope(const StepArenaScope&) = delete;
+    StepArenaScope& operator=(const StepArenaScope&) = delete;
+
+    static void enter() {
+        StepArena& arena = thread_step_arena();
+        if (arena.depth++ == 0) active_step_arena() = &arena;
+    }
+
+    static void exit() {
+        StepArena& arena = thread_step_arena();
+        if (arena.depth == 0) return;
+        if (--arena.depth == 0) {
+            active_step_arena() = nullptr;
+            arena.reset();
+        }
+    }
+};
+
+// Sends this thread's step allocations to the heap while alive, for the few
+// results of a step that are usually kept after it.
+class StepArenaBypass {
+public:
+    StepArenaBypass() : saved(active_step_arena()) { active_step_arena() = nullptr; }
+    ~StepArenaBypass() { active_step_arena() = saved; }
+    StepArenaBypass(const StepArenaBypass&) = delete;
+    StepArenaBypass& operator=(const StepArenaBypass&) = delete;
+
+private:
+    StepArena* saved;
+};
+
+// std allocator over step_alloc, for containers owned by graph nodes.
+template<typename U>
+struct StepAllocator {
+    using value_type = U;
+
+    StepAllocator() = default;
+    template<typename V>
+    StepAllocator(const StepAllocator<V>&) {}
+
+    U* allocate(size_t n) { return static_cast<U*>(step_alloc(n * sizeof(U))); }
+    void deallocate(U* ptr, size_t) { step_free(ptr); }
+
+    template<typename V>
+    bool operator==(const StepAllocator<V>&) const { return true; }
+    template<typename V>
+    bool operator!=(const StepAllocator<V>&) const { return false; }
+};
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef TENSOR_ATTENTION_H
+#define TENSOR_ATTENTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "tensor_gemm.h"
+#include "vec_math.h"
+#include "utils/parallel.h"
+
+// Fused attention kernels for one (batch, head) slice: q [L x D], k [S x D],
+// v [S x Dv], out [L x Dv]. Keys are visited in tiles and the softmax is
+// computed online: each query row keeps a running max m and running sum l, and
+// when a new tile raises the max the partial output and sum are rescaled by
+// exp(m_old - m_new). Only a [ATTN_BLOCK_Q x ATTN_BLOCK_K] tile of scores exists
+// at any time, so memory is linear in the sequence length. Forward saves the
+// per-row logsumexp m + log(l); backward rebuilds each probability tile from it
+// instead of storing the L x S matrix.
+
+constexpr int ATTN_BLOCK_Q = 32;
+constexpr int ATTN_BLOCK_K = 64;
+
+struct AttentionGeometry {
+    int q_len, k_len, head_dim, value_dim;
+    bool causal;
+    double scale;
+};
+
+// Scores of a query tile against a key tile, scaled and masked in place.
+// Entries hidden by the causal mask or an infinite additive mask are -inf.
+template<typename T>
+void attention_scores(const T* q, const T* k, const T* mask, const AttentionGeometry& g,
+                      int q0, int bq, int k0, int bk, T* scores) {
+    gemm(false, true, bq, bk, g.head_dim, q + static_cast<size_t>(q0) * g.head_dim, g.head_dim,
+         k + static_cast<size_t>(k0) * g.head_dim, g.head_dim, scores, bk);
+    const T scale = static_cast<T>(g.scale);
+    for (int i = 0; i < bq; ++i) {
+        T* row = scores + i * bk;
+        for (int j = 0; j < bk; ++j) {
+            row[j] *= scale;
+            if (mask) row[j] += mask[static_cast<size_t>(q0 + i) * g.k_len + k0 + j];
+            if (g.causal && k0 + j > q0 + i) row[j] = -std::numeric_limits<T>::infinity();
+        }
+    }
+}
+
+template<typename T>
+void attention_forward_head(const T* q, const T* k, const T* v, const T* mask,
+                            const AttentionGeometry& g, T* out, T* lse) {
+    const T neg_inf = -std::numeric_limits<T>::infinity();
+    std::vector<T> scores(ATTN_BLOCK_Q * ATTN_BLOCK_K);
+    std::vector<T> row_max(ATTN_BLOCK_Q), row_sum(ATTN_BLOCK_Q);
+
+    for (int q0 = 0; q0 < g.q_len; q0 += ATTN_BLOCK_Q) {
+        int bq = std::min(ATTN_BLOCK_Q, g.q_len - q0);
+        T* o = out + static_cast<size_t>(q0) * g.value_dim;
+        std::fill(o, o + static_cast<size_t>(bq) * g.value_dim, static_cast<T>(0));
+        std::fill(row_max.begin(), row_max.end(), neg_inf);
+        std::fill(row_sum.begin(), row_sum.end(), static_cast<T>(0));
+
+        // with a causal mask, keys past the last query of the tile are never visible
+        int k_end = g.causal ? std::min(g.k_len, q0 + bq) : g.k_len;
+        for (int k0 = 0; k0 < k_end; k0 += ATTN_BLOCK_K) {
+            int bk = std::min(ATTN_BLOCK_K, k_end - k0);
+            attention_scores(q, k, mask, g, q0, bq, k0, bk, scores.data());
+
+            for (int i = 0; i < bq; ++i) {
+                T* row = scores.data() + i * bk;
+                T tile_max = *std::max_element(row, row + bk);
+                T new_max = std::max(row_max[i], tile_max);
+                if (new_max == neg_inf) {
+                    std::fill(row, row + bk, static_cast<T>(0));
+                    continue;
+                }
+                T correction = vec_exp_scalar(row_max[i] - new_max);
+                T tile_sum = 0;
+                for (int j = 0; j < bk; ++j) {
+                    row[j] = vec_exp_scalar(row[j] - new_max);
+                    tile_sum += row[j];
+                }
+                row_sum[i] = row_sum[i] * correction + tile_sum;
+                row_max[i] = new_max;
+                if (correction != static_cast<T>(1)) {
+                    T* o_row = o + static_cast<size_t>(i) * g.value_dim;
+                    for (int d = 0; d < g.value_dim; ++d) o_row[d] *= correction;
+                }
+            }
+            gemm(false, false, bq, g.value_dim, bk, scores.data(), bk,
+                 v + static_cast<size_t>(k0) * g.value_dim, g.value_dim, o, g.value_dim, true);
+        }
+
+        for (int i = 0; i < bq; ++i) {
+            T* o_row = o + static_cast<size_t>(i) * g.value_dim;
+            if (row_sum[i] > static_cast<T>(0)) {
+                T inv = static_cast<T>(1) / row_sum[i];
+                for (int d = 0; d < g.value_dim; ++d) o_row[d] *= inv;
+                lse[q0 + i] = row_max[i] + std::log(row_sum[i]);
+            } else {
+                // every key is masked out: the row attends to nothing
+                lse[q0 + i] = neg_inf;
+            }
+        }
+    }
+}
+
+// Accumulates dq, dk, dv for one head. With P = exp(S - lse) and
+// delta_i = sum_d dO[i, d] * O[i, d]:
+//   dV += P^T dO,  dS = P * (dO V^T - delta),  dQ += scale * dS K,  dK += scale * dS^T Q.
+template<typename T>
+void attention_backward_head(const T* q, const T* k, const T* v, const T* mask,
+                             const T* out, const T* grad_out, const T* lse,
+                             const AttentionGeometry& g, T* dq, T* dk, T* dv) {
+    const T neg_inf = -std::numeric_limits<T>::infinity();
+    const T scale = static_cast<T>(g.scale);
+    std::vector<T> probs(ATTN_BLOCK_Q * ATTN_BLOCK_K), dprobs(ATTN_BLOCK_Q * ATTN_BLOCK_K);
+    std::vector<T> delta(g.q_len);
+
+    for (int i = 0; i < g.q_len; ++i) {
+        const T* o_row = out + static_cast<size_t>(i) * g.value_dim;
+        const T* go_row = grad_out + static_cast<size_t>(i) * g.value_dim;
+        T acc = 0;
+        for (int d = 0; d < g.value_dim; ++d) acc += o_row[d] * go_row[d];
+        delta[i] = acc;
+    }
+
+    for (int q0 = 0; q0 < g.q_len; q0 += ATTN_BLOCK_Q) {
+        int bq = std::min(ATTN_BLOCK_Q, g.q_len - q0);
+        int k_end = g.causal ? std::min(g.k_len, q0 + bq) : g.k_len;
+        const T* go = grad_out + static_cast<size_t>(q0) * g.value_dim;
+
+        for (int k0 = 0; k0 < k_end; k0 += ATTN_BLOCK_K) {
+            int bk = std::min(ATTN_BLOCK_K, k_end - k0);
+            attention_scores(q, k, mask, g, q0, bq, k0, bk, probs.data());
+            for (int i = 0; i < bq; ++i) {
+                T row_lse = lse[q0 + i];
+                T* row = probs.data() + i * bk;
+                for (int j = 0; j < bk; ++j) {
+                    row[j] = (row_lse == neg_inf || row[j] == neg_inf) ? static_cast<T>(0) : vec_exp_scalar(row[j] - row_lse);
+                }
+            }
+
+            if (dv) {
+                gemm(true, false, bk, g.value_dim, bq, probs.data(), bk, go, g.value_dim,
+                     dv + static_cast<size_t>(k0) * g.value_dim, g.value_dim, true);
+            }
+
+            gemm(false, true, bq, bk, g.value_dim, go, g.value_dim,
+                 v + static_cast<size_t>(k0) * g.value_dim, g.value_dim, dprobs.data(), bk);
+            for (int i = 0; i < bq; ++i) {
+                T* p_row = probs.data() + i * bk;
+                T* dp_row = dprobs.data() + i * bk;
+                for (int j = 0; j < bk; ++j) dp_row[j] = p_row[j] * (dp_row[j] - delta[q0 + i]) * scale;
+            }
+
+            if (dq) {
+                gemm(false, false, bq, g.head_dim, bk, dprobs.data(), bk,
+                     k + static_cast<size_t>(k0) * g.head_dim, g.head_dim,
+                     dq + static_cast<size_t>(q0) * g.head_dim, g.head_dim, true);
+            }
+            if (dk) {
+                gemm(true, false, bk, g.head_dim, bq, dprobs.data(), bk,
+                     q + static_cast<size_t>(q0) * g.head_dim, g.head_dim,
+                     dk + static_cast<size_t>(k0) * g.head_dim, g.head_dim, true);
+            }
+        }
+    }
+}
+
+#endif
@@ -49,7 +49,7 @@ Tensor<T> expand_tensor(const Tensor<T>& tensor, const std::vector<int>& target_
             temp_i /= current_dim_size;
             original_index += coord * broadcast_strides[j];
         }
-        result.data[original_index] = tensor.data[i];
+        result.data[i] = tensor.data[original_index];
     }
 
     return result;
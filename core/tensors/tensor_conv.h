@@ -0,0 +1,199 @@
+#ifndef TENSOR_CONV_H
+#define TENSOR_CONV_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "tensor_gemm.h"
+#include "tensor_im2col.h"
+
+// Raw NCHW kernels shared by the conv/pool forward functions and their backward
+// nodes. Every routine works on a single image and a single group; geometry
+// channels are the channels of that group.
+//
+// NCHW is used because each (image, group) input slice is then a row-major
+// [channels x H*W] matrix, and the convolution output W[oc x C*KH*KW] *
+// col[C*KH*KW x OH*OW] lands directly in NCHW order without any transposition.
+// 1x1 convolutions need no unrolling at all in this layout.
+
+enum class ConvKernel { Im2col, Pointwise, Depthwise };
+
+inline ConvKernel select_conv_kernel(const Conv2dGeometry& g, int out_channels) {
+    if (g.kernel_h == 1 && g.kernel_w == 1 && g.stride == 1 && g.padding == 0) {
+        return ConvKernel::Pointwise;
+    }
+    if (g.channels == 1 && out_channels == 1) {
+        return ConvKernel::Depthwise;
+    }
+    return ConvKernel::Im2col;
+}
+
+template<typename T>
+void conv2d_forward_group(const T* input, const T* weight, T* output,
+                          const Conv2dGeometry& g, int out_channels, ConvKernel kernel) {
+    int pixels = g.out_pixels();
+
+    if (kernel == ConvKernel::Pointwise) {
+        gemm(false, false, out_channels, pixels, g.channels,
+             weight, g.channels, input, g.height * g.width, output, pixels);
+        return;
+    }
+
+    if (kernel == ConvKernel::Depthwise) {
+        for (int oy = 0; oy < g.out_h; ++oy) {
+            for (int ox = 0; ox < g.out_w; ++ox) {
+                T acc = static_cast<T>(0);
+                for (int ky = 0; ky < g.kernel_h; ++ky) {
+                    int iy = oy * g.stride - g.padding + ky * g.dilation;
+                    if (iy < 0 || iy >= g.height) continue;
+                    for (int kx = 0; kx < g.kernel_w; ++kx) {
+                        int ix = ox * g.stride - g.padding + kx * g.dilation;
+                        if (ix < 0 || ix >= g.width) continue;
+                        acc += weight[ky * g.kernel_w + kx] * input[iy * g.width + ix];
+                    }
+                }
+                output[oy * g.out_w + ox] = acc;
+            }
+        }
+        return;
+    }
+
+    int rows = g.col_rows();
+    int tile = im2col_tile_size<T>(g);
+    thread_local std::vector<T> col;
+    col.resize(static_cast<size_t>(rows) * tile);
+
+    for (int first = 0; first < pixels; first += tile) {
+        int count = std::min(tile, pixels - first);
+        im2col_tile(input, g, first, count, col.data());
+        gemm(false, false, out_channels, count, rows,
+             weight, rows, col.data(), count, output + first, pixels);
+    }
+}
+
+// Accumulates into grad_input and grad_weight; either may be null to skip it.
+template<typename T>
+void conv2d_backward_group(const T* input, const T* weight, const T* grad_output,
+                           T* grad_input, T* grad_weight,
+                           const Conv2dGeometry& g, int out_channels, ConvKernel kernel) {
+    int pixels = g.out_pixels();
+
+    if (kernel == ConvKernel::Pointwise) {
+        int plane = g.height * g.width;
+        if (grad_weight) {
+            gemm(false, true, out_channels, g.channels, pixels,
+                 grad_output, pixels, input, plane, grad_weight, g.channels, true);
+        }
+        if (grad_input) {
+            gemm(true, false, g.channels, pixels, out_channels,
+                 weight, g.channels, grad_output, pixels, grad_input, plane, true);
+        }
+        return;
+    }
+
+    if (kernel == ConvKernel::Depthwise) {
+        for (int oy = 0; oy < g.out_h; ++oy) {
+            for (int ox = 0; ox < g.out_w; ++ox) {
+                T go = grad_output[oy * g.out_w + ox];
+                for (int ky = 0; ky < g.kernel_h; ++ky) {
+                    int iy = oy * g.stride - g.padding + ky * g.dilation;
+                    if (iy < 0 || iy >= g.height) continue;
+                    for (int kx = 0; kx < g.kernel_w; ++kx) {
+                        int ix = ox * g.stride - g.padding + kx * g.dilation;
+                        if (ix < 0 || ix >= g.width) continue;
+                        if (grad_weight) grad_weight[ky * g.kernel_w + kx] += go * input[iy * g.width + ix];
+                        if (grad_input) grad_input[iy * g.width + ix] += go * weight[ky * g.kernel_w + kx];
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    int rows = g.col_rows();
+    int tile = im2col_tile_size<T>(g);
+    thread_local std::vector<T> col;
+    col.resize(static_cast<size_t>(rows) * tile);
+
+    for (int first = 0; first < pixels; first += tile) {
+        int count = std::min(tile, pixels - first);
+        if (grad_weight) {
+            im2col_tile(input, g, first, count, col.data());
+            gemm(false, true, out_channels, rows, count,
+                 grad_output + first, pixels, col.data(), count, grad_weight, rows, true);
+        }
+        if (grad_input) {
+            gemm(true, false, rows, count, out_channels,
+                 weight, rows, grad_output + first, pixels, col.data(), count);
+            col2im_tile(col.data(), g, first, count, grad_input);
+        }
+    }
+}
+
+// Pooling works on one [H x W] plane; max pooling records the flat input index
+// of each maximum so backward does not need the input.
+template<typename T>
+void max_pool2d_plane(const T* input, T* output, int* indices, const Conv2dGeometry& g) {
+    for (int oy = 0; oy < g.out_h; ++oy) {
+        for (int ox = 0; ox < g.out_w; ++ox) {
+            T best = std::numeric_limits<T>::lowest();
+            int best_idx = -1;
+            for (int ky = 0; ky < g.kernel_h; ++ky) {
+                int iy = oy * g.stride - g.padding + ky * g.dilation;
+                if (iy < 0 || iy >= g.height) continue;
+                for (int kx = 0; kx < g.kernel_w; ++kx) {
+                    int ix = ox * g.stride - g.padding + kx * g.dilation;
+                    if (ix < 0 || ix >= g.width) continue;
+                    int idx = iy * g.width + ix;
+                    if (best_idx < 0 || input[idx] > best) {
+                        best = input[idx];
+                        best_idx = idx;
+                    }
+                }
+            }
+            output[oy * g.out_w + ox] = best_idx < 0 ? static_cast<T>(0) : best;
+            indices[oy * g.out_w + ox] = best_idx;
+        }
+    }
+}
+
+template<typename T>
+void avg_pool2d_plane(const T* input, T* output, const Conv2dGeometry& g) {
+    T window = static_cast<T>(g.kernel_h * g.kernel_w);
+    for (int oy = 0; oy < g.out_h; ++oy) {
+        for (int ox = 0; ox < g.out_w; ++ox) {
+            T acc = static_cast<T>(0);
+            for (int ky = 0; ky < g.kernel_h; ++ky) {
+                int iy = oy * g.stride - g.padding + ky * g.dilation;
+                if (iy < 0 || iy >= g.height) continue;
+                for (int kx = 0; kx < g.kernel_w; ++kx) {
+                    int ix = ox * g.stride - g.padding + kx * g.dilation;
+                    if (ix < 0 || ix >= g.width) continue;
+                    acc += input[iy * g.width + ix];
+                }
+            }
+            output[oy * g.out_w + ox] = acc / window;
+        }
+    }
+}
+
+template<typename T>
+void avg_pool2d_plane_backward(const T* grad_output, T* grad_input, const Conv2dGeometry& g) {
+    T window = static_cast<T>(g.kernel_h * g.kernel_w);
+    for (int oy = 0; oy < g.out_h; ++oy) {
+        for (int ox = 0; ox < g.out_w; ++ox) {
+            T go = grad_output[oy * g.out_w + ox] / window;
+            for (int ky = 0; ky < g.kernel_h; ++ky) {
+                int iy = oy * g.stride - g.padding + ky * g.dilation;
+                if (iy < 0 || iy >= g.height) continue;
+                for (int kx = 0; kx < g.kernel_w; ++kx) {
+                    int ix = ox * g.stride - g.padding + kx * g.dilation;
+                    if (ix < 0 || ix >= g.width) continue;
+                    grad_input[iy * g.width + ix] += go;
+                }
+            }
+        }
+    }
+}
+
+#endif
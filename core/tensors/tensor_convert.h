@@ -0,0 +1,347 @@
+#ifndef TENSOR_CONVERT_H
+#define TENSOR_CONVERT_H
+
+#include <Python.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "tensor.h"
+
+// Bulk conversion between Python data and tensors through the CPython API.
+// Nested lists/tuples are walked once: the shape is taken from the first path
+// down to a scalar and every other sequence is checked against it while its
+// values are copied. Objects exposing the buffer protocol (array.array,
+// bytes, memoryview, ...) are copied straight from their memory. Readback
+// builds preallocated lists instead of appending element by element.
+// All functions expect the GIL to be held.
+
+using AnyTensor = std::variant<std::shared_ptr<Tensor<float>>, std::shared_ptr<Tensor<double>>, std::shared_ptr<Tensor<int>>>;
+
+// Owns a new reference and drops it on scope exit.
+struct PyRef {
+    PyObject* obj;
+    explicit PyRef(PyObject* o) : obj(o) {}
+    ~PyRef() { Py_XDECREF(obj); }
+    PyRef(const PyRef&) = delete;
+    PyRef& operator=(const PyRef&) = delete;
+};
+
+// Raised as TypeError by the bindings.
+struct ConversionTypeError : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+class NestedParser {
+public:
+    std::vector<int> shape;
+    std::vector<double> values;
+    bool has_float = false;
+
+    void parse(PyObject* obj) { walk(obj, 0); }
+
+private:
+    int ndim = -1;   // fixed once the first scalar is reached; all dims are known then
+    void fix_ndim(int depth) {
+        ndim = depth;
+        size_t total = 1;
+        for (int dim : shape) total *= dim;
+        values.reserve(total);
+    }
+
+    static bool is_sequence(PyObject* obj) {
+        return PyList_Check(obj) || PyTuple_Check(obj);
+    }
+
+    void walk(PyObject* obj, int depth) {
+        // scalars are read by their parent at the innermost level, so one
+        // reached here sits shallower than the first
+        if (!is_sequence(obj)) throw std::invalid_argument("ERROR: All elements in a dimension must have the same shape.");
+
+        Py_ssize_t n = PySequence_Fast_GET_SIZE(obj);
+        if (n == 0) throw std::invalid_argument("ERROR: Data cannot contain empty lists.");
+        if (n > std::numeric_limits<int>::max()) throw std::invalid_argument("ERROR: Dimension is too large.");
+        if (depth == static_cast<int>(shape.size())) {
+            if (ndim >= 0) throw std::invalid_argument("ERROR: All elements in a dimension must have the same shape.");
+            shape.push_back(static_cast<int>(n));
+        } else if (shape[depth] != n) {
+            throw std::invalid_argument("ERROR: All elements in a dimension must have the same shape.");
+        }
+
+        PyObject** items = PySequence_Fast_ITEMS(obj);
+        if (ndim < 0 && !is_sequence(items[0])) fix_ndim(depth + 1);
+        if (depth + 1 == ndim) {
+            // innermost level: no recursion per element
+            for (Py_ssize_t i = 0; i < n; ++i) {
+                if (is_sequence(items[i])) throw std::invalid_argument("ERROR: All elements in a dimension must have the same shape.");
+                values.push_back(scalar(items[i]));
+            }
+            return;
+        }
+        for (Py_ssize_t i = 0; i < n; ++i) walk(items[i], depth + 1);
+    }
+
+    double scalar(PyObject* obj) {
+        if (PyFloat_Check(obj)) {
+            has_float = true;
+            return PyFloat_AS_DOUBLE(obj);
+        }
+        if (PyLong_Check(obj)) {
+            int overflow = 0;
+            long long v = PyLong_AsLongLongAndOverflow(obj, &overflow);
+            if (overflow) throw std::overflow_error("ERROR: Integer is too large for a tensor.");
+            return static_cast<double>(v);
+        }
+        throw ConversionTypeError("ERROR: Unsupported data type '" + std::string(Py_TYPE(obj)->tp_name) +
+                                  "'. Only int and float are supported.");
+    }
+};
+
+inline int checked_int32(double v) {
+    if (v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) {
+        throw std::overflow_error("ERROR: Value out of range for int32.");
+    }
+    return static_cast<int>(v);
+}
+
+template<typename T>
+std::shared_ptr<Tensor<T>> tensor_from_values(const std::vector<double>& values, const std::vector<int>& shape, bool requires_grad) {
+    MemoryScope scope("tensor");
+    auto result = std::make_shared<Tensor<T>>(shape, requires_grad);
+    T* out = result->data.get();
+    if constexpr (std::is_same_v<T, int>) {
+        for (size_t i = 0; i < values.size(); ++i) out[i] = checked_int32(values[i]);
+    } else {
+        for (size_t i = 0; i < values.size(); ++i) out[i] = static_cast<T>(values[i]);
+    }
+    return result;
+}
+
+inline std::pair<AnyTensor, std::string> make_any_tensor(const std::string& dtype, const std::vector<double>& values,
+                                                         const std::vector<int>& shape, bool requires_grad) {
+    if (dtype == "float32" || dtype == "float") return {tensor_from_values<float>(values, shape, requires_grad), "float32"};
+    if (dtype == "float64" || dtype == "double") return {tensor_from_values<double>(values, shape, requires_grad), "float64"};
+    if (dtype == "int32" || dtype == "int") return {tensor_from_values<int>(values, shape, requires_grad), "int32"};
+    throw ConversionTypeError("ERROR: Unsupported data type '" + dtype + "'.");
+}
+
+// Reads element i (in C order) of a buffer of the given struct format as double.
+struct BufferReader {
+    char code;
+    std::string dtype;   // dtype the format maps to when none is requested
+
+    static BufferReader for_format(const char* format) {
+        std::string f = format ? format : "B";
+        size_t pos = 0;
+        if (!f.empty() && (f[0] == '@' || f[0] == '=' || f[0] == '<')) pos = 1;
+        if (!f.empty() && (f[0] == '>' || f[0] == '!')) {
+            throw ConversionTypeError("ERROR: Big-endian buffers are not supported.");
+        }
+        if (f.size() != pos + 1) throw ConversionTypeError("ERROR: Unsupported buffer format '" + f + "'.");
+        char c = f[pos];
+        switch (c) {
+            case 'f': return {c, "float32"};
+            case 'd': return {c, "float64"};
+            case 'b': case 'B': case 'h': case 'H': case 'i': case 'I':
+            case 'l': case 'L': case 'q': case 'Q': case '?':
+                return {c, "int32"};
+        }
+        throw ConversionTypeError("ERROR: Unsupported buffer format '" + f + "'.");
+    }
+
+    double read(const char* p) const {
+        switch (code) {
+            case 'f': return load<float>(p);
+            case 'd': return load<double>(p);
+            case 'b': return load<signed char>(p);
+            case 'B': return load<unsigned char>(p);
+            case 'h': return load<short>(p);
+            case 'H': return load<unsigned short>(p);
+            case 'i': return load<int>(p);
+            case 'I': return load<unsigned int>(p);
+            case 'l': return static_cast<double>(load<long>(p));
+            case 'L': return static_cast<double>(load<unsigned long>(p));
+            case 'q': return static_cast<double>(load<long long>(p));
+            case 'Q': return static_cast<double>(load<unsigned long long>(p));
+            case '?': return load<bool>(p) ? 1.0 : 0.0;
+        }
+        return 0.0;
+    }
+
+    template<typename V>
+    static double load(const char* p) {
+        V v;
+        std::memcpy(&v, p, sizeof(V));
+        return static_cast<double>(v);
+    }
+};
+
+template<typename T>
+std::shared_ptr<Tensor<T>> tensor_from_buffer(const Py_buffer& view, const BufferReader& reader,
+                                              const std::vector<int>& shape, bool requires_grad) {
+    MemoryScope scope("tensor");
+    auto result = std::make_shared<Tensor<T>>(shape, requires_grad);
+    T* out = result->data.get();
+    int ndim = view.ndim;
+    const char* base = static_cast<const char*>(view.buf);
+    auto store = [&](size_t i, const char* p) {
+        double v = reader.read(p);
+        if constexpr (std::is_same_v<T, int>) out[i] = checked_int32(v);
+        else out[i] = static_cast<T>(v);
+    };
+
+    if (ndim <= 1) {
+        Py_ssize_t step = view.strides ? view.strides[0] : view.itemsize;
+        if (reader.code == 'f' && std::is_same_v<T, float> && step == static_cast<Py_ssize_t>(sizeof(float))) {
+            std::memcpy(out, base, static_cast<size_t>(result->size) * sizeof(float));
+        } else if (reader.code == 'd' && std::is_same_v<T, double> && step == static_cast<Py_ssize_t>(sizeof(double))) {
+            std::memcpy(out, base, static_cast<size_t>(result->size) * sizeof(double));
+        } else {
+            for (int i = 0; i < result->size; ++i) store(i, base + i * step);
+        }
+        return result;
+    }
+
+    // N-d, possibly strided: walk the index like an odometer
+    std::vector<Py_ssize_t> index(ndim, 0);
+    for (int i = 0; i < result->size; ++i) {
+        Py_ssize_t offset = 0;
+        for (int d = 0; d < ndim; ++d) offset += index[d] * view.strides[d];
+        store(i, base + offset);
+        for (int d = ndim - 1; d >= 0; --d) {
+            if (++index[d] < view.shape[d]) break;
+            index[d] = 0;
+        }
+    }
+    return result;
+}
+
+// Builds a tensor from nested lists/tuples of numbers or from any object with
+// the buffer protocol. An empty dtype is detected: any float in a list makes
+// float32, otherwise int32; buffers keep their element type ('d' -> float64).
+// A non-empty shape reshapes the flat data and must match its element count.
+// Returns the tensor and its dtype name.
+inline std::pair<AnyTensor, std::string> tensor_from_data(PyObject* data, std::string dtype,
+                                                          std::vector<int> shape, bool requires_grad) {
+    bool is_sequence = PyList_Check(data) || PyTuple_Check(data);
+    if (!is_sequence && PyObject_CheckBuffer(data)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(data, &view, PyBUF_RECORDS_RO) != 0) {
+            PyErr_Clear();
+            throw ConversionTypeError("ERROR: Cannot read the buffer of a '" + std::string(Py_TYPE(data)->tp_name) + "'.");
+        }
+        struct Release {
+            Py_buffer* v;
+            ~Release() { PyBuffer_Release(v); }
+        } release{&view};
+
+        BufferReader reader = BufferReader::for_format(view.format);
+        std::vector<int> buffer_shape;
+        for (int d = 0; d < view.ndim; ++d) buffer_shape.push_back(static_cast<int>(view.shape[d]));
+        if (view.ndim == 0) buffer_shape.push_back(1);
+        long long count = view.itemsize > 0 ? view.len / view.itemsize : 0;
+        if (count == 0) throw std::invalid_argument("ERROR: Data cannot be empty.");
+        if (!shape.empty()) {
+            long long expected = 1;
+            for (int dim : shape) expected *= dim;
+            if (expected != count) {
+                throw std::invalid_argument("ERROR: Shape requires " + std::to_string(expected) +
+                                            " elements, but got " + std::to_string(count) + ".");
+            }
+            if (view.ndim > 1) throw std::invalid_argument("ERROR: Cannot provide an explicit shape for a multi-dimensional buffer.");
+            buffer_shape = shape;
+        }
+        if (dtype.empty()) dtype = reader.dtype;
+        if (dtype == "float32" || dtype == "float") return {tensor_from_buffer<float>(view, reader, buffer_shape, requires_grad), "float32"};
+        if (dtype == "float64" || dtype == "double") return {tensor_from_buffer<double>(view, reader, buffer_shape, requires_grad), "float64"};
+        if (dtype == "int32" || dtype == "int") {
+            if (reader.code == 'f' || reader.code == 'd') throw ConversionTypeError("ERROR: Cannot convert float data to int32.");
+            return {tensor_from_buffer<int>(view, reader, buffer_shape, requires_grad), "int32"};
+        }
+        throw ConversionTypeError("ERROR: Unsupported data type '" + dtype + "'.");
+    }
+
+    PyRef fast(is_sequence ? (Py_INCREF(data), data) : PySequence_Fast(data, ""));
+    if (!fast.obj) {
+        PyErr_Clear();
+        throw ConversionTypeError("ERROR: Data must be a list, a tuple or an object with the buffer protocol.");
+    }
+    if (PySequence_Fast_GET_SIZE(fast.obj) == 0) throw std::invalid_argument("ERROR: Data must be a non-empty list.");
+
+    NestedParser parser;
+    parser.parse(fast.obj);
+    if (!shape.empty()) {
+        if (parser.shape.size() != 1) throw std::invalid_argument("ERROR: Cannot provide an explicit shape for a nested list.");
+        long long expected = 1;
+        for (int dim : shape) expected *= dim;
+        if (expected != static_cast<long long>(parser.values.size())) {
+            throw std::invalid_argument("ERROR: Shape requires " + std::to_string(expected) +
+                                        " elements, but got " + std::to_string(parser.values.size()) + ".");
+        }
+        parser.shape = shape;
+    }
+    if (dtype.empty()) dtype = parser.has_float ? "float32" : "int32";
+    if ((dtype == "int32" || dtype == "int") && parser.has_float) {
+        throw ConversionTypeError("ERROR: Cannot convert float data to int32.");
+    }
+    return make_any_tensor(dtype, parser.values, parser.shape, requires_grad);
+}
+
+template<typename T>
+PyObject* py_scalar(T value) {
+    if constexpr (std::is_floating_point_v<T>) return PyFloat_FromDouble(static_cast<double>(value));
+    else return PyLong_FromLong(static_cast<long>(value));
+}
+
+// New reference to a list of n preallocated slots filled from data.
+template<typename T>
+PyObject* py_flat_list(const T* data, int n) {
+    PyObject* list = PyList_New(n);
+    if (!list) return nullptr;
+    for (int i = 0; i < n; ++i) {
+        PyObject* item = py_scalar(data[i]);
+        if (!item) {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+template<typename T>
+PyObject* py_nested_list(const Tensor<T>& tensor, int dim, const T* data) {
+    if (dim == tensor.ndim - 1) return py_flat_list(data, tensor.shape[dim]);
+    PyObject* list = PyList_New(tensor.shape[dim]);
+    if (!list) return nullptr;
+    for (int i = 0; i < tensor.shape[dim]; ++i) {
+        PyObject* item = py_nested_list(tensor, dim + 1, data + static_cast<size_t>(i) * tensor.stride[dim]);
+        if (!item) {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SET_ITEM(list, i, item);
+    }
+    return list;
+}
+
+template<typename T>
+pybind11::list to_nested(const Tensor<T>& tensor) {
+    PyObject* list = py_nested_list(tensor, 0, tensor.data.get());
+    if (!list) throw std::bad_alloc();
+    return pybind11::reinterpret_steal<pybind11::list>(list);
+}
+
+template<typename T>
+pybind11::list to_flat_list(const Tensor<T>& tensor) {
+    PyObject* list = py_flat_list(tensor.data.get(), tensor.size);
+    if (!list) throw std::bad_alloc();
+    return pybind11::reinterpret_steal<pybind11::list>(list);
+}
+
+#endif
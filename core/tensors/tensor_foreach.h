@@ -0,0 +1,195 @@
+#ifndef TENSOR_FOREACH_H
+#define TENSOR_FOREACH_H
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "tensors/tensor.h"
+#include "tensors/tensor_sparse_grad.h"
+#include "utils/parallel.h"
+
+// Multi-tensor ("foreach") kernels: one pass over a list of tensors instead of
+// one kernel call per tensor. Tensors that lie back to back in memory, such as
+// the views of a FlatParameters buffer, are merged first, so a flat layout is
+// processed as a single span. The concatenated elements are then cut into
+// blocks of FOREACH_BLOCK, so many small tensors share a block, and the blocks
+// are spread over the threads. Lists of up to FOREACH_SERIAL elements in total
+// run on the calling thread.
+
+constexpr size_t FOREACH_BLOCK = 16384;
+constexpr size_t FOREACH_SERIAL = 4 * FOREACH_BLOCK;
+constexpr int FOREACH_LANES = 8;
+
+// a[0, n) and, for binary kernels, b[0, n).
+template<typename T>
+struct ForeachSpan {
+    T* a;
+    const T* b;
+    size_t n;
+};
+
+template<typename T>
+std::vector<ForeachSpan<T>> foreach_spans(const std::vector<Tensor<T>*>& as, const std::vector<const Tensor<T>*>& bs = {}) {
+    if (!bs.empty() && bs.size() != as.size()) {
+        throw std::invalid_argument("ERROR: foreach operands must have the same number of tensors.");
+    }
+    std::vector<ForeachSpan<T>> spans;
+    for (size_t k = 0; k < as.size(); ++k) {
+        T* a = as[k]->data.get();
+        const T* b = bs.empty() ? nullptr : bs[k]->data.get();
+        size_t n = static_cast<size_t>(as[k]->size);
+        if (b && bs[k]->size != as[k]->size) {
+            throw std::invalid_argument("ERROR: foreach operands must have matching sizes.");
+        }
+        if (!spans.empty()) {
+            ForeachSpan<T>& last = spans.back();
+            if (last.a + last.n == a && (!b || last.b + last.n == b)) {
+                last.n += n;
+                continue;
+            }
+        }
+        spans.push_back({a, b, n});
+    }
+    return spans;
+}
+
+template<typename T>
+size_t foreach_total(const std::vector<ForeachSpan<T>>& spans) {
+    size_t total = 0;
+    for (const auto& span : spans) total += span.n;
+    return total;
+}
+
+// Number of blocks foreach_blocks uses; a serial call is one block.
+template<typename T>
+size_t foreach_block_count(const std::vector<ForeachSpan<T>>& spans) {
+    size_t total = foreach_total(spans);
+    return total <= FOREACH_SERIAL ? 1 : (total + FOREACH_BLOCK - 1) / FOREACH_BLOCK;
+}
+
+// Calls fn(span, begin, end, block) for every piece of a span that falls in a
+// block, in order within each block. Blocks run in parallel; the block index
+// lets reductions keep one partial per block, accumulated over its pieces.
+template<typename T, typename F>
+void foreach_blocks(const std::vector<ForeachSpan<T>>& spans, F&& fn) {
+    size_t total = foreach_total(spans);
+    if (total <= FOREACH_SERIAL) {
+        for (const auto& span : spans) fn(span, 0, span.n, 0);
+        return;
+    }
+    // first[s]: position of span s in the concatenation
+    std::vector<size_t> first(spans.size() + 1, 0);
+    for (size_t s = 0; s < spans.size(); ++s) first[s + 1] = first[s] + spans[s].n;
+    int blocks = static_cast<int>((total + FOREACH_BLOCK - 1) / FOREACH_BLOCK);
+    int grain = static_cast<int>(FOREACH_SERIAL / FOREACH_BLOCK);
+    parallel_for(0, blocks, grain, [&](int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            size_t lo = static_cast<size_t>(k) * FOREACH_BLOCK;
+            size_t hi = std::min(total, lo + FOREACH_BLOCK);
+            size_t s = static_cast<size_t>(std::upper_bound(first.begin(), first.end(), lo) - first.begin()) - 1;
+            for (; s < spans.size() && first[s] < hi; ++s) {
+                size_t piece_begin = std::max(lo, first[s]) - first[s];
+                size_t piece_end = std::min(hi, first[s + 1]) - first[s];
+                if (piece_begin < piece_end) fn(spans[s], piece_begin, piece_end, static_cast<size_t>(k));
+            }
+        }
+    });
+}
+
+// Sum of squares in double, over independent lanes so the loop vectorizes.
+// Partials are added in block order, so the result does not depend on the
+// number of threads.
+template<typename T>
+double foreach_sum_squares(const std::vector<ForeachSpan<T>>& spans) {
+    std::vector<double> partial(foreach_block_count(spans), 0.0);
+    foreach_blocks(spans, [&](const ForeachSpan<T>& span, size_t begin, size_t end, size_t block) {
+        const T* x = span.a + begin;
+        size_t n = end - begin;
+        double acc[FOREACH_LANES] = {};
+        size_t i = 0;
+        for (; i + FOREACH_LANES <= n; i += FOREACH_LANES) {
+            for (int l = 0; l < FOREACH_LANES; ++l) acc[l] += static_cast<double>(x[i + l]) * static_cast<double>(x[i + l]);
+        }
+        for (; i < n; ++i) acc[0] += static_cast<double>(x[i]) * static_cast<double>(x[i]);
+        double total = 0.0;
+        for (int l = 0; l < FOREACH_LANES; ++l) total += acc[l];
+        partial[block] += total;
+    });
+    double total = 0.0;
+    for (double p : partial) total += p;
+    return total;
+}
+
+template<typename T>
+std::vector<Tensor<T>*> foreach_raw(const std::vector<std::shared_ptr<Tensor<T>>>& tensors) {
+    std::vector<Tensor<T>*> raw;
+    raw.reserve(tensors.size());
+    for (const auto& t : tensors) raw.push_back(t.get());
+    return raw;
+}
+
+// Global L2 norm of all the tensors together.
+template<typename T>
+double foreach_norm(const std::vector<std::shared_ptr<Tensor<T>>>& tensors) {
+    return std::sqrt(foreach_sum_squares(foreach_spans(foreach_raw(tensors))));
+}
+
+template<typename T>
+void foreach_scale(const std::vector<std::shared_ptr<Tensor<T>>>& tensors, T alpha) {
+    foreach_blocks(foreach_spans(foreach_raw(tensors)), [alpha](const ForeachSpan<T>& span, size_t begin, size_t end, size_t) {
+        T* x = span.a;
+        for (size_t i = begin; i < end; ++i) x[i] *= alpha;
+    });
+    for (const auto& t : tensors) t->bump_version();
+}
+
+template<typename T>
+void foreach_zero(const std::vector<std::shared_ptr<Tensor<T>>>& tensors) {
+    foreach_blocks(foreach_spans(foreach_raw(tensors)), [](const ForeachSpan<T>& span, size_t begin, size_t end, size_t) {
+        std::fill(span.a + begin, span.a + end, static_cast<T>(0));
+    });
+    for (const auto& t : tensors) t->bump_version();
+}
+
+// ys[k] += alpha * xs[k] for every k.
+template<typename T>
+void foreach_axpy(const std::vector<std::shared_ptr<Tensor<T>>>& ys, const std::vector<std::shared_ptr<Tensor<T>>>& xs, T alpha) {
+    std::vector<const Tensor<T>*> raw_xs;
+    for (const auto& x : xs) raw_xs.push_back(x.get());
+    foreach_blocks(foreach_spans(foreach_raw(ys), raw_xs), [alpha](const ForeachSpan<T>& span, size_t begin, size_t end, size_t) {
+        T* y = span.a;
+        const T* x = span.b;
+        for (size_t i = begin; i < end; ++i) y[i] += alpha * x[i];
+    });
+    for (const auto& t : ys) t->bump_version();
+}
+
+// The dense gradients and sparse gradient rows of params.
+template<typename T>
+std::vector<std::shared_ptr<Tensor<T>>> foreach_grads(const std::vector<std::shared_ptr<Tensor<T>>>& params) {
+    std::vector<std::shared_ptr<Tensor<T>>> grads;
+    for (const auto& p : params) {
+        if (p->grad) grads.push_back(p->grad);
+        if (p->sparse_grad) grads.push_back(p->sparse_grad->values);
+    }
+    return grads;
+}
+
+template<typename T>
+double grad_norm(const std::vector<std::shared_ptr<Tensor<T>>>& params) {
+    return foreach_norm(foreach_grads(params));
+}
+
+// Rescales the gradients so that their global L2 norm is at most max_norm,
+// and returns the norm they had before.
+template<typename T>
+double clip_grad_norm(const std::vector<std::shared_ptr<Tensor<T>>>& params, double max_norm) {
+    auto grads = foreach_grads(params);
+    double norm = foreach_norm(grads);
+    if (norm > max_norm) foreach_scale(grads, static_cast<T>(max_norm / (norm + 1e-6)));
+    return norm;
+}
+
+#endif
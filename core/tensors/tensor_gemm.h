@@ -0,0 +1,142 @@
+#ifndef TENSOR_GEMM_H
+#define TENSOR_GEMM_H
+
+#include <algorithm>
+#include <vector>
+
+// Cache-blocked matrix multiply on raw row-major buffers:
+//   C[M x N] (+)= op(A)[M x K] * op(B)[K x N]
+// where op(X) is X or its transpose. Blocks of A and B are packed into
+// contiguous panels so the inner loop streams through memory with unit stride.
+
+constexpr int GEMM_MC = 64;
+constexpr int GEMM_KC = 128;
+constexpr int GEMM_NC = 256;
+
+template<typename T>
+void gemm_pack_a(bool trans_a, const T* A, int lda, int row, int depth, int mc, int kc, T* packed) {
+    for (int i = 0; i < mc; ++i) {
+        for (int p = 0; p < kc; ++p) {
+            packed[i * kc + p] = trans_a ? A[(depth + p) * lda + row + i] : A[(row + i) * lda + depth + p];
+        }
+    }
+}
+
+template<typename T>
+void gemm_pack_b(bool trans_b, const T* B, int ldb, int depth, int col, int kc, int nc, T* packed) {
+    for (int p = 0; p < kc; ++p) {
+        T* dst = packed + p * nc;
+        if (trans_b) {
+            for (int j = 0; j < nc; ++j) dst[j] = B[(col + j) * ldb + depth + p];
+        } else {
+            std::copy(B + (depth + p) * ldb + col, B + (depth + p) * ldb + col + nc, dst);
+        }
+    }
+}
+
+// Multiplies a packed [mc x kc] block of A with a packed [kc x nc] panel of B,
+// four rows at a time so each loaded row of B is reused four times.
+template<typename T>
+void gemm_block(int mc, int nc, int kc, const T* a_pack, const T* b_pack, T* C, int ldc) {
+    int i = 0;
+    for (; i + 4 <= mc; i += 4) {
+        T* c0 = C + (i + 0) * ldc;
+        T* c1 = C + (i + 1) * ldc;
+        T* c2 = C + (i + 2) * ldc;
+        T* c3 = C + (i + 3) * ldc;
+        for (int p = 0; p < kc; ++p) {
+            const T a0 = a_pack[(i + 0) * kc + p];
+            const T a1 = a_pack[(i + 1) * kc + p];
+            const T a2 = a_pack[(i + 2) * kc + p];
+            const T a3 = a_pack[(i + 3) * kc + p];
+            const T* b_row = b_pack + p * nc;
+            for (int j = 0; j < nc; ++j) {
+                const T b = b_row[j];
+                c0[j] += a0 * b;
+                c1[j] += a1 * b;
+                c2[j] += a2 * b;
+                c3[j] += a3 * b;
+            }
+        }
+    }
+    for (; i < mc; ++i) {
+        T* c_row = C + i * ldc;
+        for (int p = 0; p < kc; ++p) {
+            const T a = a_pack[i * kc + p];
+            const T* b_row = b_pack + p * nc;
+            for (int j = 0; j < nc; ++j) c_row[j] += a * b_row[j];
+        }
+    }
+}
+
+template<typename T>
+void gemm(bool trans_a, bool trans_b, int M, int N, int K,
+          const T* A, int lda, const T* B, int ldb,
+          T* C, int ldc, bool accumulate = false) {
+    if (!accumulate) {
+        for (int i = 0; i < M; ++i) std::fill(C + i * ldc, C + i * ldc + N, static_cast<T>(0));
+    }
+    if (M == 0 || N == 0 || K == 0) return;
+
+    thread_local std::vector<T> a_pack;
+    thread_local std::vector<T> b_pack;
+    a_pack.resize(GEMM_MC * GEMM_KC);
+    b_pack.resize(GEMM_KC * GEMM_NC);
+
+    for (int jc = 0; jc < N; jc += GEMM_NC) {
+        int nc = std::min(GEMM_NC, N - jc);
+        for (int pc = 0; pc < K; pc += GEMM_KC) {
+            int kc = std::min(GEMM_KC, K - pc);
+            gemm_pack_b(trans_b, B, ldb, pc, jc, kc, nc, b_pack.data());
+            for (int ic = 0; ic < M; ic += GEMM_MC) {
+                int mc = std::min(GEMM_MC, M - ic);
+                gemm_pack_a(trans_a, A, lda, ic, pc, mc, kc, a_pack.data());
+                gemm_block(mc, nc, kc, a_pack.data(), b_pack.data(), C + ic * ldc + jc, ldc);
+            }
+        }
+    }
+}
+
+// Packs all of op(B) [K x N] into the panels gemm_prepacked_b reads: for each
+// column panel of GEMM_NC columns, each depth block of GEMM_KC rows, one
+// contiguous [kc x nc] block. Needs K * N elements of storage.
+template<typename T>
+void gemm_pack_b_panels(bool trans_b, const T* B, int ldb, int K, int N, T* packed) {
+    for (int jc = 0; jc < N; jc += GEMM_NC) {
+        int nc = std::min(GEMM_NC, N - jc);
+        for (int pc = 0; pc < K; pc += GEMM_KC) {
+            int kc = std::min(GEMM_KC, K - pc);
+            gemm_pack_b(trans_b, B, ldb, pc, jc, kc, nc, packed);
+            packed += static_cast<size_t>(kc) * nc;
+        }
+    }
+}
+
+// gemm with B already packed by gemm_pack_b_panels, for an operand that is
+// multiplied many times (a layer's weights) and should not be repacked.
+template<typename T>
+void gemm_prepacked_b(bool trans_a, int M, int N, int K, const T* A, int lda,
+                      const T* b_panels, T* C, int ldc, bool accumulate = false) {
+    if (!accumulate) {
+        for (int i = 0; i < M; ++i) std::fill(C + i * ldc, C + i * ldc + N, static_cast<T>(0));
+    }
+    if (M == 0 || N == 0 || K == 0) return;
+
+    thread_local std::vector<T> a_pack;
+    a_pack.resize(GEMM_MC * GEMM_KC);
+
+    for (int jc = 0; jc < N; jc += GEMM_NC) {
+        int nc = std::min(GEMM_NC, N - jc);
+        for (int pc = 0; pc < K; pc += GEMM_KC) {
+            int kc = std::min(GEMM_KC, K - pc);
+            for (int ic = 0; ic < M; ic += GEMM_MC) {
+                int mc = std::min(GEMM_MC, M - ic);
+                gemm_pack_a(trans_a, A, lda, ic, pc, mc, kc, a_pack.data());
+                gemm_block(mc, nc, kc, a_pack.data(), b_panels, C + ic * ldc + jc, ldc);
+            }
+            b_panels += static_cast<size_t>(kc) * nc;
+        }
+    }
+}
+
+#endif
@@ -1,86 +1,186 @@
 #ifndef TENSOR_MATH_H
 #define TENSOR_MATH_H
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
 #include "tensor.h"
+#include "vec_math.h"
+#include "utils/parallel.h"
+#include "autograd/autograd_math.h"
+#include "autograd/forward_ad.h"
+
+// Converts the input to T_output and runs kernel(in, out, n) over parallel
+// chunks. Gradients only flow when input and output share a type: integer
+// tensors produce a float result that is not part of the graph. For a dual
+// input, tangent(x, y, tx, ty, n) runs on every block right after kernel.
+template<typename T_input, typename T_output, typename Kernel, typename TangentKernel>
+std::shared_ptr<Tensor<T_output>> unary_math(const std::shared_ptr<Tensor<T_input>>& tensor, Kernel kernel, TangentKernel tangent) {
+    constexpr bool same_type = std::is_same_v<T_input, T_output>;
+    auto result = std::make_shared<Tensor<T_output>>(tensor->shape, GradMode::resolve(same_type && tensor->requires_grad));
+    const T_input* in = tensor->data.get();
+    T_output* out = result->data.get();
+
+    if constexpr (same_type) {
+        result->tangent = unary_tangent(*tensor);
+        const T_output* t_in = result->tangent ? tensor->tangent->data.get() : nullptr;
+        T_output* t_out = result->tangent ? result->tangent->data.get() : nullptr;
+        dual_blocks(tensor->size, VEC_MATH_GRAIN, t_out != nullptr,
+                    [&](int b, int n) { kernel(in + b, out + b, n); },
+                    [&](int b, int n) { tangent(in + b, out + b, t_in + b, t_out + b, n); });
+    } else {
+        parallel_for(0, tensor->size, VEC_MATH_GRAIN, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) out[i] = static_cast<T_output>(in[i]);
+            kernel(out + begin, out + begin, end - begin);
+        });
+    }
+    return result;
+}
 
+// Domain check as a single OR reduction over the input instead of a branch per
+// element; skipped entirely in MathMode fast mode.
 template<typename T_input, typename T_output>
-std::shared_ptr<Tensor<T_output>> tensor_sqrt(const std::shared_ptr<Tensor<T_input>>& tensor) {
-    auto result = std::make_shared<Tensor<T_output>>(tensor->shape, tensor->requires_grad);
+bool any_below_domain(const Tensor<T_input>& tensor, bool allow_zero) {
+    if (MathMode::is_fast()) return false;
+    const T_input* data = tensor.data.get();
+    int zero_outside = allow_zero ? 0 : 1;
+    int outside = 0;
+    for (int i = 0; i < tensor.size; ++i) {
+        T_output value = static_cast<T_output>(data[i]);
+        outside |= static_cast<int>(value < 0) | (static_cast<int>(value == 0) & zero_outside);
+    }
+    return outside != 0;
+}
 
-    for (int i = 0; i < tensor->size; ++i) {
-        T_output value = static_cast<T_output>(tensor->data[i]);
-        if (value < 0) {
-            throw std::runtime_error("ERROR: Cannot compute the square root of a negative number.");
+template<typename T_input, typename T_output>
+std::shared_ptr<Tensor<T_output>> tensor_sqrt(const std::shared_ptr<Tensor<T_input>>& tensor) {
+    MemoryScope scope("sqrt");
+    if (any_below_domain<T_input, T_output>(*tensor, true)) {
+        throw std::runtime_error("ERROR: Cannot compute the square root of a negative number.");
+    }
+    auto result = unary_math<T_input, T_output>(tensor, [](const T_output* x, T_output* y, int n) {
+        for (int i = 0; i < n; ++i) y[i] = std::sqrt(x[i]);
+    }, [](const T_output*, const T_output* y, const T_output* tx, T_output* ty, int n) {
+        for (int i = 0; i < n; ++i) ty[i] = tx[i] / (static_cast<T_output>(2) * y[i]);
+    });
+
+    if constexpr (std::is_same_v<T_input, T_output>) {
+        if (result->requires_grad) {
+            result->parents.push_back(tensor);
+            result->grad_fn = std::make_unique<SqrtBackward<T_output>>(tensor, result);
         }
-        result->data[i] = std::sqrt(value);
     }
     return result;
 }
 
 template<typename T_input, typename T_output>
 std::shared_ptr<Tensor<T_output>> tensor_log(const std::shared_ptr<Tensor<T_input>>& tensor) {
-    auto result = std::make_shared<Tensor<T_output>>(tensor->shape, tensor->requires_grad);
-
-    for (int i = 0; i < tensor->size; ++i) {
-        T_output value = static_cast<T_output>(tensor->data[i]);
-        if (value <= 0) {
-            throw std::runtime_error("ERROR: Cannot compute the log of a non-positive number.");
+    MemoryScope scope("log");
+    if (any_below_domain<T_input, T_output>(*tensor, false)) {
+        throw std::runtime_error("ERROR: Cannot compute the log of a non-positive number.");
+    }
+    auto result = unary_math<T_input, T_output>(tensor, vec_log<T_output>,
+        [](const T_output* x, const T_output*, const T_output* tx, T_output* ty, int n) {
+            for (int i = 0; i < n; ++i) ty[i] = tx[i] / x[i];
+        });
+
+    if constexpr (std::is_same_v<T_input, T_output>) {
+        if (result->requires_grad) {
+            result->parents.push_back(tensor);
+            result->grad_fn = std::make_unique<LogBackward<T_output>>(tensor);
         }
-        result->data[i] = std::log(value);
     }
     return result;
 }
 
 template<typename T_input, typename T_output>
 std::shared_ptr<Tensor<T_output>> tensor_exp(const std::shared_ptr<Tensor<T_input>>& tensor) {
-    auto result = std::make_shared<Tensor<T_output>>(tensor->shape, tensor->requires_grad);
-
-    for (int i = 0; i < tensor->size; ++i) {
-        result->data[i] = std::exp(static_cast<T_output>(tensor->data[i]));
+    MemoryScope scope("exp");
+    auto result = unary_math<T_input, T_output>(tensor, vec_exp<T_output>,
+        [](const T_output*, const T_output* y, const T_output* tx, T_output* ty, int n) {
+            for (int i = 0; i < n; ++i) ty[i] = y[i] * tx[i];
+        });
+
+    if constexpr (std::is_same_v<T_input, T_output>) {
+        if (result->requires_grad) {
+            result->parents.push_back(tensor);
+            result->grad_fn = std::make_unique<ExpBackward<T_output>>(tensor, result);
+        }
     }
     return result;
 }
 
 template<typename T_input, typename T_output>
 std::shared_ptr<Tensor<T_output>> tensor_pow(const std::shared_ptr<Tensor<T_input>>& tensor, float exponent) {
-    auto result = std::make_shared<Tensor<T_output>>(tensor->shape, tensor->requires_grad);
-
-    for (int i = 0; i < tensor->size; ++i) {
-        result->data[i] = std::pow(static_cast<T_output>(tensor->data[i]), exponent);
+    MemoryScope scope("pow");
+    const T_output p = static_cast<T_output>(exponent);
+    auto result = unary_math<T_input, T_output>(tensor, [p](const T_output* x, T_output* y, int n) {
+        for (int i = 0; i < n; ++i) y[i] = std::pow(x[i], p);
+    }, [p](const T_output* x, const T_output*, const T_output* tx, T_output* ty, int n) {
+        for (int i = 0; i < n; ++i) ty[i] = p * std::pow(x[i], p - static_cast<T_output>(1)) * tx[i];
+    });
+
+    if constexpr (std::is_same_v<T_input, T_output>) {
+        if (result->requires_grad) {
+            result->parents.push_back(tensor);
+            result->grad_fn = std::make_unique<PowBackward<T_output>>(tensor, exponent);
+        }
     }
     return result;
 }
 
 template<typename T_input, typename T_output>
 std::shared_ptr<Tensor<T_output>> tensor_sin(const std::shared_ptr<Tensor<T_input>>& tensor) {
-    auto result = std::make_shared<Tensor<T_output>>(tensor->shape, tensor->requires_grad);
-
-    for (int i = 0; i < tensor->size; ++i) {
-        result->data[i] = std::sin(static_cast<T_output>(tensor->data[i]));
+    MemoryScope scope("sin");
+    auto result = unary_math<T_input, T_output>(tensor, vec_sin<T_output>,
+        [](const T_output* x, const T_output*, const T_output* tx, T_output* ty, int n) {
+            vec_cos(x, ty, n);
+            for (int i = 0; i < n; ++i) ty[i] *= tx[i];
+        });
+
+    if constexpr (std::is_same_v<T_input, T_output>) {
+        if (result->requires_grad) {
+            result->parents.push_back(tensor);
+            result->grad_fn = std::make_unique<SinBackward<T_output>>(tensor);
+        }
     }
     return result;
 }
 
 template<typename T_input, typename T_output>
 std::shared_ptr<Tensor<T_output>> tensor_cos(const std::shared_ptr<Tensor<T_input>>& tensor) {
-    auto result = std::make_shared<Tensor<T_output>>(tensor->shape, tensor->requires_grad);
-
-    for (int i = 0; i < tensor->size; ++i) {
-        result->data[i] = std::cos(static_cast<T_output>(tensor->data[i]));
+    MemoryScope scope("cos");
+    auto result = unary_math<T_input, T_output>(tensor, vec_cos<T_output>,
+        [](const T_output* x, const T_output*, const T_output* tx, T_output* ty, int n) {
+            vec_sin(x, ty, n);
+            for (int i = 0; i < n; ++i) ty[i] *= -tx[i];
+        });
+
+    if constexpr (std::is_same_v<T_input, T_output>) {
+        if (result->requires_grad) {
+            result->parents.push_back(tensor);
+            result->grad_fn = std::make_unique<CosBackward<T_output>>(tensor);
+        }
     }
     return result;
 }
 
 template<typename T_input, typename T_output>
 std::shared_ptr<Tensor<T_output>> tensor_tan(const std::shared_ptr<Tensor<T_input>>& tensor) {
-    auto result = std::make_shared<Tensor<T_output>>(tensor->shape, tensor->requires_grad);
-
-    for (int i = 0; i < tensor->size; ++i) {
-        result->data[i] = std::tan(static_cast<T_output>(tensor->data[i]));
+    MemoryScope scope("tan");
+    auto result = unary_math<T_input, T_output>(tensor, vec_tan<T_output>,
+        [](const T_output*, const T_output* y, const T_output* tx, T_output* ty, int n) {
+            for (int i = 0; i < n; ++i) ty[i] = (static_cast<T_output>(1) + y[i] * y[i]) * tx[i];
+        });
+
+    if constexpr (std::is_same_v<T_input, T_output>) {
+        if (result->requires_grad) {
+            result->parents.push_back(tensor);
+            result->grad_fn = std::make_unique<TanBackward<T_output>>(tensor, result);
+        }
     }
     return result;
 }
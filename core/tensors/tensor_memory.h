@@ -0,0 +1,204 @@
+#ifndef TENSOR_MEMORY_H
+#define TENSOR_MEMORY_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+enum class MemoryCategory { Activation = 0, Gradient = 1, Parameter = 2 };
+
+struct MemoryCounter {
+    long long current_bytes = 0;
+    long long peak_bytes = 0;
+    long long live_tensors = 0;
+
+    void add(long long bytes) {
+        current_bytes += bytes;
+        live_tensors += 1;
+        if (current_bytes > peak_bytes) peak_bytes = current_bytes;
+    }
+
+    void remove(long long bytes) {
+        current_bytes -= bytes;
+        live_tensors -= 1;
+    }
+};
+
+// Lock-free version of MemoryCounter, updated by every allocation and release.
+struct AtomicMemoryCounter {
+    std::atomic<long long> current_bytes{0};
+    std::atomic<long long> peak_bytes{0};
+    std::atomic<long long> live_tensors{0};
+
+    void add(long long bytes) {
+        long long current = current_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        live_tensors.fetch_add(1, std::memory_order_relaxed);
+        long long peak = peak_bytes.load(std::memory_order_relaxed);
+        while (current > peak && !peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+    }
+
+    void remove(long long bytes) {
+        current_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        live_tensors.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void reset_peak() {
+        peak_bytes.store(current_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    MemoryCounter load() const {
+        MemoryCounter counter;
+        counter.current_bytes = current_bytes.load(std::memory_order_relaxed);
+        counter.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+        counter.live_tensors = live_tensors.load(std::memory_order_relaxed);
+        return counter;
+    }
+};
+
+// Counter of one op name. Slots are created once per name and never freed, so
+// tensors can keep a pointer to the slot they were allocated under.
+struct MemoryOpSlot {
+    std::string name;
+    AtomicMemoryCounter counter;
+
+    explicit MemoryOpSlot(std::string name) : name(std::move(name)) {}
+};
+
+struct MemorySnapshot {
+    MemoryCounter total;
+    std::array<MemoryCounter, 3> categories;
+    std::map<std::string, MemoryCounter> by_op;
+};
+
+// Global counters for the bytes held by tensor buffers. Every Tensor reports its
+// allocation here on construction and its release on destruction. Recording
+// only touches atomics; the mutex guards the table of op slots and is taken
+// when a thread meets an op name for the first time and when reading.
+class MemoryStats {
+public:
+    static MemoryStats& instance() {
+        // intentionally leaked: tensors owned by Python can outlive C++ static destructors
+        static MemoryStats* stats = new MemoryStats();
+        return *stats;
+    }
+
+    // Slot for an op name. Each thread keeps a small direct-mapped cache keyed
+    // by the name's address, so the table is normally searched once per thread
+    // and name.
+    MemoryOpSlot* intern(const char* op) {
+        struct Entry { const char* name; MemoryOpSlot* slot; };
+        thread_local Entry cache[64] = {};
+        // literals can sit a few bytes apart, so hash every bit of the address
+        std::uint64_t hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(op)) * 0x9E3779B97F4A7C15ull;
+        Entry& entry = cache[hash >> 58];
+        if (entry.name == op) return entry.slot;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& slot = by_op[op];
+        if (!slot) slot = std::make_unique<MemoryOpSlot>(op);
+        entry = {op, slot.get()};
+        return slot.get();
+    }
+
+    void record_alloc(MemoryOpSlot* op, MemoryCategory category, long long bytes) {
+        total.add(bytes);
+        categories[static_cast<int>(category)].add(bytes);
+        op->counter.add(bytes);
+    }
+
+    void record_free(MemoryOpSlot* op, MemoryCategory category, long long bytes) {
+        total.remove(bytes);
+        categories[static_cast<int>(category)].remove(bytes);
+        op->counter.remove(bytes);
+    }
+
+    void reset_peak() {
+        std::lock_guard<std::mutex> lock(mutex);
+        total.reset_peak();
+        for (auto& counter : categories) counter.reset_peak();
+        for (auto& entry : by_op) entry.second->counter.reset_peak();
+    }
+
+    MemorySnapshot snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        MemorySnapshot result;
+        result.total = total.load();
+        for (size_t i = 0; i < categories.size(); ++i) result.categories[i] = categories[i].load();
+        for (const auto& entry : by_op) result.by_op[entry.first] = entry.second->counter.load();
+        return result;
+    }
+
+private:
+    MemoryStats() = default;
+
+    std::mutex mutex;
+    AtomicMemoryCounter total;
+    std::array<AtomicMemoryCounter, 3> categories;
+    std::map<std::string, std::unique_ptr<MemoryOpSlot>> by_op;
+};
+
+// Tags every tensor allocated while the scope is alive with the given op name
+// (and optionally category). Scopes nest, so the innermost op gets the credit.
+// The name must outlive the process (a string literal): slots are cached by
+// its address.
+class MemoryScope {
+public:
+    static MemoryOpSlot* default_op() {
+        static MemoryOpSlot* op = MemoryStats::instance().intern("tensor");
+        return op;
+    }
+
+    // Null until the thread opens its first scope, meaning default_op().
+    static MemoryOpSlot*& current_slot() {
+        thread_local MemoryOpSlot* op = nullptr;
+        return op;
+    }
+
+    static MemoryOpSlot* current_op() {
+        MemoryOpSlot* op = current_slot();
+        return op ? op : default_op();
+    }
+
+    static MemoryCategory& current_category() {
+        thread_local MemoryCategory category = MemoryCategory::Activation;
+        return category;
+    }
+
+    explicit MemoryScope(const char* op)
+        : prev_op(current_slot()), prev_category(current_category()) {
+        current_slot() = MemoryStats::instance().intern(op);
+    }
+
+    MemoryScope(const char* op, MemoryCategory category)
+        : prev_op(current_slot()), prev_category(current_category()) {
+        current_slot() = MemoryStats::instance().intern(op);
+        current_category() = category;
+    }
+
+    ~MemoryScope() {
+        current_slot() = prev_op;
+        current_category() = prev_category;
+    }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryOpSlot* prev_op;
+    MemoryCategory prev_category;
+};
+
+inline const char* memory_category_name(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::Activation: return "activations";
+        case MemoryCategory::Gradient: return "gradients";
+        case MemoryCategory::Parameter: return "parameters";
+    }
+    return "unknown";
+}
+
+#endif
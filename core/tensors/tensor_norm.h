@@ -0,0 +1,176 @@
+#ifndef TENSOR_NORM_H
+#define TENSOR_NORM_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "utils/parallel.h"
+
+// Raw kernels for the normalization layers. Statistics are gathered in a single
+// pass with Welford's update, which stays accurate when the mean is large
+// compared to the spread (the naive E[x^2] - E[x]^2 cancels catastrophically).
+// The forward pass saves only mean and 1/sqrt(var + eps) per group; backward
+// recomputes x_hat from them instead of keeping a normalized copy of the input.
+
+template<typename T>
+struct Welford {
+    T mean = 0;
+    T m2 = 0;
+    int count = 0;
+
+    void add(T x) {
+        ++count;
+        T delta = x - mean;
+        mean += delta / static_cast<T>(count);
+        m2 += delta * (x - mean);
+    }
+
+    T variance() const { return count > 0 ? m2 / static_cast<T>(count) : static_cast<T>(0); }
+};
+
+// Normalizes each of `rows` contiguous rows of length `dim`. gamma and beta
+// are per-column and may be null.
+template<typename T>
+void layer_norm_forward(const T* x, const T* gamma, const T* beta, T* y,
+                        T* mean, T* inv_std, int rows, int dim, T eps) {
+    parallel_for(0, rows, std::max(1, 16384 / dim), [&](int begin, int end) {
+        for (int r = begin; r < end; ++r) {
+            const T* xr = x + static_cast<size_t>(r) * dim;
+            T* yr = y + static_cast<size_t>(r) * dim;
+            Welford<T> w;
+            for (int j = 0; j < dim; ++j) w.add(xr[j]);
+            T m = w.mean;
+            T s = static_cast<T>(1) / std::sqrt(w.variance() + eps);
+            mean[r] = m;
+            inv_std[r] = s;
+            for (int j = 0; j < dim; ++j) {
+                T v = (xr[j] - m) * s;
+                if (gamma) v = v * gamma[j] + beta[j];
+                yr[j] = v;
+            }
+        }
+    });
+}
+
+// dx = inv_std / D * (D * g - sum(g) - x_hat * sum(g * x_hat)), g = dy * gamma.
+// Any of dx, dgamma, dbeta may be null; dgamma and dbeta are accumulated.
+template<typename T>
+void layer_norm_backward(const T* x, const T* gamma, const T* dy, const T* mean, const T* inv_std,
+                         T* dx, T* dgamma, T* dbeta, int rows, int dim) {
+    if (dx) {
+        parallel_for(0, rows, std::max(1, 16384 / dim), [&](int begin, int end) {
+            for (int r = begin; r < end; ++r) {
+                const T* xr = x + static_cast<size_t>(r) * dim;
+                const T* dyr = dy + static_cast<size_t>(r) * dim;
+                T* dxr = dx + static_cast<size_t>(r) * dim;
+                T m = mean[r];
+                T s = inv_std[r];
+                T sum_g = 0;
+                T sum_g_xhat = 0;
+                for (int j = 0; j < dim; ++j) {
+                    T g = gamma ? dyr[j] * gamma[j] : dyr[j];
+                    sum_g += g;
+                    sum_g_xhat += g * (xr[j] - m) * s;
+                }
+                T scale = s / static_cast<T>(dim);
+                for (int j = 0; j < dim; ++j) {
+                    T g = gamma ? dyr[j] * gamma[j] : dyr[j];
+                    T xhat = (xr[j] - m) * s;
+                    dxr[j] += scale * (static_cast<T>(dim) * g - sum_g - xhat * sum_g_xhat);
+                }
+            }
+        });
+    }
+    if (dgamma || dbeta) {
+        // columns are independent, so split them across threads; each thread
+        // walks the rows of its own column block
+        parallel_for(0, dim, 64, [&](int begin, int end) {
+            for (int r = 0; r < rows; ++r) {
+                const T* xr = x + static_cast<size_t>(r) * dim;
+                const T* dyr = dy + static_cast<size_t>(r) * dim;
+                T m = mean[r];
+                T s = inv_std[r];
+                for (int j = begin; j < end; ++j) {
+                    if (dgamma) dgamma[j] += dyr[j] * (xr[j] - m) * s;
+                    if (dbeta) dbeta[j] += dyr[j];
+                }
+            }
+        });
+    }
+}
+
+// Per-channel statistics of an [N, C, L] tensor (L = 1 for [N, C]).
+template<typename T>
+void batch_norm_stats(const T* x, T* mean, T* var, int batch, int channels, int length) {
+    parallel_for(0, channels, 1, [&](int begin, int end) {
+        for (int c = begin; c < end; ++c) {
+            Welford<T> w;
+            for (int n = 0; n < batch; ++n) {
+                const T* xc = x + (static_cast<size_t>(n) * channels + c) * length;
+                for (int l = 0; l < length; ++l) w.add(xc[l]);
+            }
+            mean[c] = w.mean;
+            var[c] = w.variance();
+        }
+    });
+}
+
+template<typename T>
+void batch_norm_apply(const T* x, const T* gamma, const T* beta, const T* mean, const T* inv_std,
+                      T* y, int batch, int channels, int length) {
+    parallel_for(0, batch * channels, std::max(1, 16384 / length), [&](int begin, int end) {
+        for (int p = begin; p < end; ++p) {
+            int c = p % channels;
+            T scale = gamma ? gamma[c] * inv_std[c] : inv_std[c];
+            T shift = (beta ? beta[c] : static_cast<T>(0)) - mean[c] * scale;
+            const T* xp = x + static_cast<size_t>(p) * length;
+            T* yp = y + static_cast<size_t>(p) * length;
+            for (int l = 0; l < length; ++l) yp[l] = xp[l] * scale + shift;
+        }
+    });
+}
+
+// In training mode the statistics depend on x and dx carries the same two
+// correction terms as layer norm, summed over the N * L values of a channel.
+// In eval mode the statistics are constants and dx = dy * gamma * inv_std.
+template<typename T>
+void batch_norm_backward(const T* x, const T* gamma, const T* dy, const T* mean, const T* inv_std,
+                         T* dx, T* dgamma, T* dbeta, int batch, int channels, int length, bool training) {
+    int count = batch * length;
+    parallel_for(0, channels, 1, [&](int begin, int end) {
+        for (int c = begin; c < end; ++c) {
+            T m = mean[c];
+            T s = inv_std[c];
+            T sum_dy = 0;
+            T sum_dy_xhat = 0;
+            for (int n = 0; n < batch; ++n) {
+                size_t offset = (static_cast<size_t>(n) * channels + c) * length;
+                for (int l = 0; l < length; ++l) {
+                    sum_dy += dy[offset + l];
+                    sum_dy_xhat += dy[offset + l] * (x[offset + l] - m) * s;
+                }
+            }
+            if (dgamma) dgamma[c] += sum_dy_xhat;
+            if (dbeta) dbeta[c] += sum_dy;
+            if (!dx) continue;
+
+            T g = gamma ? gamma[c] : static_cast<T>(1);
+            T scale = g * s;
+            T mean_dy = sum_dy / static_cast<T>(count);
+            T mean_dy_xhat = sum_dy_xhat / static_cast<T>(count);
+            for (int n = 0; n < batch; ++n) {
+                size_t offset = (static_cast<size_t>(n) * channels + c) * length;
+                for (int l = 0; l < length; ++l) {
+                    if (training) {
+                        T xhat = (x[offset + l] - m) * s;
+                        dx[offset + l] += scale * (dy[offset + l] - mean_dy - xhat * mean_dy_xhat);
+                    } else {
+                        dx[offset + l] += scale * dy[offset + l];
+                    }
+                }
+            }
+        }
+    });
+}
+
+#endif
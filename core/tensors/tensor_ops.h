@@ -7,7 +7,10 @@
 #include <cmath>
 #include "tensor.h"
 #include "tensor_broadcast.h"
+#include "tensor_gemm.h"
+#include "tensor_precision.h"
 #include "autograd/autograd_ops.h"
+#include "autograd/forward_ad.h"
 
 template<typename T>
 void check_tensor_validity(const std::shared_ptr<Tensor<T>>& a, const std::shared_ptr<Tensor<T>>& b) {
@@ -23,12 +26,19 @@ void check_tensor_validity(const std::shared_ptr<Tensor<T>>& a, const std::share
 
 template<typename T>
 std::shared_ptr<Tensor<T>> tensor_add(const std::shared_ptr<Tensor<T>>& a, const std::shared_ptr<Tensor<T>>& b) {
+    MemoryScope scope("add");
     auto [a_broadcasted, b_broadcasted] = broadcast(*a, *b);
     auto result_data = std::vector<T>(a_broadcasted.size);
-    for (int i = 0; i < a_broadcasted.size; ++i) {
-        result_data[i] = a_broadcasted.data[i] + b_broadcasted.data[i];
-    }
-    auto result = std::make_shared<Tensor<T>>(result_data, a_broadcasted.shape, a->requires_grad || b->requires_grad);
+    auto dual = binary_tangents(*a, *b, a_broadcasted.shape);
+    const T* ta = dual ? dual->a.data.get() : nullptr;
+    const T* tb = dual ? dual->b.data.get() : nullptr;
+    T* t = dual ? dual->out->data.get() : nullptr;
+    dual_loop(a_broadcasted.size, dual.has_value(),
+              [&](int i) { result_data[i] = a_broadcasted.data[i] + b_broadcasted.data[i]; },
+              [&](int i) { t[i] = ta[i] + tb[i]; });
+    auto result = std::make_shared<Tensor<T>>(result_data, a_broadcasted.shape, GradMode::resolve(a->requires_grad || b->requires_grad));
+    if (dual) result->tangent = dual->out;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a, b};
         result->grad_fn = std::make_unique<AddBackward<T>>(a, b);
@@ -38,12 +48,19 @@ std::shared_ptr<Tensor<T>> tensor_add(const std::shared_ptr<Tensor<T>>& a, const
 
 template<typename T>
 std::shared_ptr<Tensor<T>> tensor_sub(const std::shared_ptr<Tensor<T>>& a, const std::shared_ptr<Tensor<T>>& b) {
+    MemoryScope scope("sub");
     auto [a_broadcasted, b_broadcasted] = broadcast(*a, *b);
     auto result_data = std::vector<T>(a_broadcasted.size);
-    for (int i = 0; i < a_broadcasted.size; ++i) {
-        result_data[i] = a_broadcasted.data[i] - b_broadcasted.data[i];
-    }
-    auto result = std::make_shared<Tensor<T>>(result_data, a_broadcasted.shape, a->requires_grad || b->requires_grad);
+    auto dual = binary_tangents(*a, *b, a_broadcasted.shape);
+    const T* ta = dual ? dual->a.data.get() : nullptr;
+    const T* tb = dual ? dual->b.data.get() : nullptr;
+    T* t = dual ? dual->out->data.get() : nullptr;
+    dual_loop(a_broadcasted.size, dual.has_value(),
+              [&](int i) { result_data[i] = a_broadcasted.data[i] - b_broadcasted.data[i]; },
+              [&](int i) { t[i] = ta[i] - tb[i]; });
+    auto result = std::make_shared<Tensor<T>>(result_data, a_broadcasted.shape, GradMode::resolve(a->requires_grad || b->requires_grad));
+    if (dual) result->tangent = dual->out;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a, b};
         result->grad_fn = std::make_unique<SubBackward<T>>(a, b);
@@ -53,12 +70,19 @@ std::shared_ptr<Tensor<T>> tensor_sub(const std::shared_ptr<Tensor<T>>& a, const
 
 template<typename T>
 std::shared_ptr<Tensor<T>> tensor_mul(const std::shared_ptr<Tensor<T>>& a, const std::shared_ptr<Tensor<T>>& b) {
+    MemoryScope scope("mul");
     auto [a_broadcasted, b_broadcasted] = broadcast(*a, *b);
     auto result_data = std::vector<T>(a_broadcasted.size);
-    for (int i = 0; i < a_broadcasted.size; ++i) {
-        result_data[i] = a_broadcasted.data[i] * b_broadcasted.data[i];
-    }
-    auto result = std::make_shared<Tensor<T>>(result_data, a_broadcasted.shape, a->requires_grad || b->requires_grad);
+    auto dual = binary_tangents(*a, *b, a_broadcasted.shape);
+    const T* ta = dual ? dual->a.data.get() : nullptr;
+    const T* tb = dual ? dual->b.data.get() : nullptr;
+    T* t = dual ? dual->out->data.get() : nullptr;
+    dual_loop(a_broadcasted.size, dual.has_value(),
+              [&](int i) { result_data[i] = a_broadcasted.data[i] * b_broadcasted.data[i]; },
+              [&](int i) { t[i] = ta[i] * b_broadcasted.data[i] + a_broadcasted.data[i] * tb[i]; });
+    auto result = std::make_shared<Tensor<T>>(result_data, a_broadcasted.shape, GradMode::resolve(a->requires_grad || b->requires_grad));
+    if (dual) result->tangent = dual->out;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a, b};
         result->grad_fn = std::make_unique<MulBackward<T>>(a, b);
@@ -68,13 +92,22 @@ std::shared_ptr<Tensor<T>> tensor_mul(const std::shared_ptr<Tensor<T>>& a, const
 
 template<typename T>
 std::shared_ptr<Tensor<T>> tensor_div(const std::shared_ptr<Tensor<T>>& a, const std::shared_ptr<Tensor<T>>& b) {
+    MemoryScope scope("div");
     auto [a_broadcasted, b_broadcasted] = broadcast(*a, *b);
     auto result_data = std::vector<T>(a_broadcasted.size);
-    for (int i = 0; i < a_broadcasted.size; ++i) {
-        if (b_broadcasted.data[i] == static_cast<T>(0)) throw std::runtime_error("ERROR: Division by zero");
-        result_data[i] = a_broadcasted.data[i] / b_broadcasted.data[i];
-    }
-    auto result = std::make_shared<Tensor<T>>(result_data, a_broadcasted.shape, a->requires_grad || b->requires_grad);
+    auto dual = binary_tangents(*a, *b, a_broadcasted.shape);
+    const T* ta = dual ? dual->a.data.get() : nullptr;
+    const T* tb = dual ? dual->b.data.get() : nullptr;
+    T* t = dual ? dual->out->data.get() : nullptr;
+    dual_loop(a_broadcasted.size, dual.has_value(),
+              [&](int i) {
+                  if (b_broadcasted.data[i] == static_cast<T>(0)) throw std::runtime_error("ERROR: Division by zero");
+                  result_data[i] = a_broadcasted.data[i] / b_broadcasted.data[i];
+              },
+              [&](int i) { t[i] = (ta[i] - result_data[i] * tb[i]) / b_broadcasted.data[i]; });
+    auto result = std::make_shared<Tensor<T>>(result_data, a_broadcasted.shape, GradMode::resolve(a->requires_grad || b->requires_grad));
+    if (dual) result->tangent = dual->out;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a, b};
         result->grad_fn = std::make_unique<DivBackward<T>>(a, b);
@@ -84,9 +117,17 @@ std::shared_ptr<Tensor<T>> tensor_div(const std::shared_ptr<Tensor<T>>& a, const
 
 template<typename T, typename U>
 std::shared_ptr<Tensor<T>> tensor_scalar_add(const std::shared_ptr<Tensor<T>>& a, U scalar) {
+    MemoryScope scope("scalar_add");
     auto result_data = std::vector<T>(a->size);
-    for (int i = 0; i < a->size; ++i) result_data[i] = a->data[i] + static_cast<T>(scalar);
-    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, a->requires_grad);
+    auto tangent = unary_tangent(*a);
+    const T* ta = tangent ? a->tangent->data.get() : nullptr;
+    T* t = tangent ? tangent->data.get() : nullptr;
+    dual_loop(a->size, tangent != nullptr,
+              [&](int i) { result_data[i] = a->data[i] + static_cast<T>(scalar); },
+              [&](int i) { t[i] = ta[i]; });
+    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, GradMode::resolve(a->requires_grad));
+    result->tangent = tangent;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a};
         result->grad_fn = std::make_unique<AddScalarBackward<T>>(a);
@@ -96,9 +137,17 @@ std::shared_ptr<Tensor<T>> tensor_scalar_add(const std::shared_ptr<Tensor<T>>& a
 
 template<typename T, typename U>
 std::shared_ptr<Tensor<T>> tensor_scalar_sub(const std::shared_ptr<Tensor<T>>& a, U scalar) {
+    MemoryScope scope("scalar_sub");
     auto result_data = std::vector<T>(a->size);
-    for (int i = 0; i < a->size; ++i) result_data[i] = a->data[i] - static_cast<T>(scalar);
-    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, a->requires_grad);
+    auto tangent = unary_tangent(*a);
+    const T* ta = tangent ? a->tangent->data.get() : nullptr;
+    T* t = tangent ? tangent->data.get() : nullptr;
+    dual_loop(a->size, tangent != nullptr,
+              [&](int i) { result_data[i] = a->data[i] - static_cast<T>(scalar); },
+              [&](int i) { t[i] = ta[i]; });
+    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, GradMode::resolve(a->requires_grad));
+    result->tangent = tangent;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a};
         result->grad_fn = std::make_unique<SubScalarBackward<T>>(a);
@@ -108,9 +157,17 @@ std::shared_ptr<Tensor<T>> tensor_scalar_sub(const std::shared_ptr<Tensor<T>>& a
 
 template<typename T, typename U>
 std::shared_ptr<Tensor<T>> scalar_tensor_sub(U scalar, const std::shared_ptr<Tensor<T>>& a) {
+    MemoryScope scope("scalar_sub");
     auto result_data = std::vector<T>(a->size);
-    for (int i = 0; i < a->size; ++i) result_data[i] = static_cast<T>(scalar) - a->data[i];
-    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, a->requires_grad);
+    auto tangent = unary_tangent(*a);
+    const T* ta = tangent ? a->tangent->data.get() : nullptr;
+    T* t = tangent ? tangent->data.get() : nullptr;
+    dual_loop(a->size, tangent != nullptr,
+              [&](int i) { result_data[i] = static_cast<T>(scalar) - a->data[i]; },
+              [&](int i) { t[i] = -ta[i]; });
+    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, GradMode::resolve(a->requires_grad));
+    result->tangent = tangent;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a};
         result->grad_fn = std::make_unique<ScalarTensorSubBackward<T, U>>(a);
@@ -120,9 +177,17 @@ std::shared_ptr<Tensor<T>> scalar_tensor_sub(U scalar, const std::shared_ptr<Ten
 
 template<typename T, typename U>
 std::shared_ptr<Tensor<T>> tensor_scalar_mul(const std::shared_ptr<Tensor<T>>& a, U scalar) {
+    MemoryScope scope("scalar_mul");
     auto result_data = std::vector<T>(a->size);
-    for (int i = 0; i < a->size; ++i) result_data[i] = a->data[i] * static_cast<T>(scalar);
-    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, a->requires_grad);
+    auto tangent = unary_tangent(*a);
+    const T* ta = tangent ? a->tangent->data.get() : nullptr;
+    T* t = tangent ? tangent->data.get() : nullptr;
+    dual_loop(a->size, tangent != nullptr,
+              [&](int i) { result_data[i] = a->data[i] * static_cast<T>(scalar); },
+              [&](int i) { t[i] = ta[i] * static_cast<T>(scalar); });
+    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, GradMode::resolve(a->requires_grad));
+    result->tangent = tangent;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a};
         result->grad_fn = std::make_unique<MulScalarBackward<T, U>>(a, scalar);
@@ -132,10 +197,18 @@ std::shared_ptr<Tensor<T>> tensor_scalar_mul(const std::shared_ptr<Tensor<T>>& a
 
 template<typename T, typename U>
 std::shared_ptr<Tensor<T>> tensor_scalar_div(const std::shared_ptr<Tensor<T>>& a, U scalar) {
+    MemoryScope scope("scalar_div");
     if (static_cast<T>(scalar) == 0) throw std::runtime_error("ERROR: Division by zero");
     auto result_data = std::vector<T>(a->size);
-    for (int i = 0; i < a->size; ++i) result_data[i] = a->data[i] / static_cast<T>(scalar);
-    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, a->requires_grad);
+    auto tangent = unary_tangent(*a);
+    const T* ta = tangent ? a->tangent->data.get() : nullptr;
+    T* t = tangent ? tangent->data.get() : nullptr;
+    dual_loop(a->size, tangent != nullptr,
+              [&](int i) { result_data[i] = a->data[i] / static_cast<T>(scalar); },
+              [&](int i) { t[i] = ta[i] / static_cast<T>(scalar); });
+    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, GradMode::resolve(a->requires_grad));
+    result->tangent = tangent;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a};
         result->grad_fn = std::make_unique<DivScalarBackward<T, U>>(a, scalar);
@@ -145,12 +218,20 @@ std::shared_ptr<Tensor<T>> tensor_scalar_div(const std::shared_ptr<Tensor<T>>& a
 
 template<typename T, typename U>
 std::shared_ptr<Tensor<T>> scalar_tensor_div(U scalar, const std::shared_ptr<Tensor<T>>& a) {
+    MemoryScope scope("scalar_div");
     auto result_data = std::vector<T>(a->size);
-    for (int i = 0; i < a->size; ++i) {
-        if (a->data[i] == static_cast<T>(0)) throw std::runtime_error("ERROR: Division by zero");
-        result_data[i] = static_cast<T>(scalar) / a->data[i];
-    }
-    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, a->requires_grad);
+    auto tangent = unary_tangent(*a);
+    const T* ta = tangent ? a->tangent->data.get() : nullptr;
+    T* t = tangent ? tangent->data.get() : nullptr;
+    dual_loop(a->size, tangent != nullptr,
+              [&](int i) {
+                  if (a->data[i] == static_cast<T>(0)) throw std::runtime_error("ERROR: Division by zero");
+                  result_data[i] = static_cast<T>(scalar) / a->data[i];
+              },
+              [&](int i) { t[i] = -result_data[i] * ta[i] / a->data[i]; });
+    auto result = std::make_shared<Tensor<T>>(result_data, a->shape, GradMode::resolve(a->requires_grad));
+    result->tangent = tangent;
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a};
         result->grad_fn = std::make_unique<ScalarTensorDivBackward<T, U>>(scalar, a);
@@ -160,17 +241,22 @@ std::shared_ptr<Tensor<T>> scalar_tensor_div(U scalar, const std::shared_ptr<Ten
 
 template<typename T>
 std::shared_ptr<Tensor<T>> transpose(const std::shared_ptr<Tensor<T>>& a) {
+    MemoryScope scope("transpose");
     if (a->ndim != 2) throw std::invalid_argument("ERROR: Transpose is only for 2D tensors.");
     
     std::vector<int> new_shape = {a->shape[1], a->shape[0]};
-    auto result = std::make_shared<Tensor<T>>(new_shape, a->requires_grad);
+    auto result = std::make_shared<Tensor<T>>(new_shape, GradMode::resolve(a->requires_grad));
+    const T* ta = a->tangent ? a->tangent->data.get() : nullptr;
+    if (ta) result->tangent = std::make_shared<Tensor<T>>(new_shape, false);
+    T* t = ta ? result->tangent->data.get() : nullptr;
 
     for (int i = 0; i < a->shape[0]; i++) {
         for (int j = 0; j < a->shape[1]; j++) {
             result->data[j * result->stride[0] + i] = a->data[i * a->stride[0] + j];
+            if (t) t[j * result->stride[0] + i] = ta[i * a->stride[0] + j];
         }
     }
-    if (a->requires_grad) {
+    if (result->requires_grad) {
         result->parents = {a};
         result->grad_fn = std::make_unique<TransposeBackward<T>>(a);
     }
@@ -180,18 +266,31 @@ std::shared_ptr<Tensor<T>> transpose(const std::shared_ptr<Tensor<T>>& a) {
 
 template<typename T>
 std::shared_ptr<Tensor<T>> mat_mul(const std::shared_ptr<Tensor<T>>& a, const std::shared_ptr<Tensor<T>>& b) {
+    MemoryScope scope("mat_mul");
     if (a->ndim != 2 || b->ndim != 2) throw std::invalid_argument("ERROR: Both tensors must be 2D matrices");
     if (a->shape[1] != b->shape[0]) throw std::invalid_argument("ERROR: Shapes are not valid to multiply");
-    auto result = std::make_shared<Tensor<T>>(std::vector<int>{a->shape[0], b->shape[1]}, a->requires_grad || b->requires_grad);
-    for (int i = 0; i < a->shape[0]; i++) {
-        for (int j = 0; j < b->shape[1]; j++) {
-            T sum_val = 0;
-            for (int r = 0; r < a->shape[1]; r++) {
-                sum_val += a->data[i * a->stride[0] + r] * b->data[r * b->stride[0] + j];
-            }
-            result->data[i * result->stride[0] + j] = sum_val;
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{a->shape[0], b->shape[1]}, GradMode::resolve(a->requires_grad || b->requires_grad));
+    std::vector<T> a_scratch, b_scratch;
+    const T* a_data = autocast_operand(*a, a_scratch);
+    const T* b_data = autocast_operand(*b, b_scratch);
+    int m = a->shape[0], n = b->shape[1], k = a->shape[1];
+    gemm(false, false, m, n, k, a_data, a->stride[0], b_data, b->stride[0], result->data.get(), result->stride[0]);
+    if (a->tangent || b->tangent) {
+        result->tangent = std::make_shared<Tensor<T>>(result->shape, false);
+        T* t = result->tangent->data.get();
+        int ldt = result->tangent->stride[0];
+        if (a->tangent) {
+            std::vector<T> scratch;
+            gemm(false, false, m, n, k, autocast_operand(*a->tangent, scratch), a->tangent->stride[0],
+                 b_data, b->stride[0], t, ldt, true);
+        }
+        if (b->tangent) {
+            std::vector<T> scratch;
+            gemm(false, false, m, n, k, a_data, a->stride[0],
+                 autocast_operand(*b->tangent, scratch), b->tangent->stride[0], t, ldt, true);
         }
     }
+    autocast_output(*result);
     if (result->requires_grad) {
         result->parents = {a, b};
         result->grad_fn = std::make_unique<MatMulBackward<T>>(a, b);
@@ -0,0 +1,150 @@
+#ifndef TENSOR_PRECISION_H
+#define TENSOR_PRECISION_H
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "tensor.h"
+#include "utils/parallel.h"
+
+// Reduced precision is emulated on float32 storage: values are rounded to the
+// nearest bfloat16 / float16 number (ties to even) and kept as float. This
+// reproduces the numerics of low-precision training (lost mantissa bits, float16
+// overflow to inf above 65504 and underflow below 2^-24) without a separate
+// storage type, so every kernel keeps working unchanged.
+enum class Precision { Float32 = 0, BFloat16 = 1, Float16 = 2 };
+
+inline Precision precision_from_string(const std::string& name) {
+    if (name == "float32") return Precision::Float32;
+    if (name == "bfloat16") return Precision::BFloat16;
+    if (name == "float16") return Precision::Float16;
+    throw std::invalid_argument("ERROR: Unknown precision '" + name + "'. Use float32, bfloat16 or float16.");
+}
+
+inline std::string precision_name(Precision precision) {
+    switch (precision) {
+        case Precision::BFloat16: return "bfloat16";
+        case Precision::Float16: return "float16";
+        default: return "float32";
+    }
+}
+
+inline float round_to_bfloat16(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    uint32_t rounded = (bits + 0x7FFFu + ((bits >> 16) & 1u)) & 0xFFFF0000u;
+    // NaN payloads could round into inf, so NaN is passed through
+    uint32_t out = (bits & 0x7FFFFFFFu) > 0x7F800000u ? bits : rounded;
+    float y;
+    std::memcpy(&y, &out, sizeof(y));
+    return y;
+}
+
+inline float round_to_float16(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    uint32_t sign = bits & 0x80000000u;
+    uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    // normal float16 range: keep 10 mantissa bits
+    uint32_t normal_bits = (magnitude + 0xFFFu + ((magnitude >> 13) & 1u)) & 0xFFFFE000u;
+    float normal;
+    std::memcpy(&normal, &normal_bits, sizeof(normal));
+    // subnormal range: multiples of 2^-24, rounded by adding a value whose ulp is 2^-24
+    float ax;
+    std::memcpy(&ax, &magnitude, sizeof(ax));
+    float subnormal = (ax + 0.5f) - 0.5f;
+
+    float y = ax < 6.103515625e-05f ? subnormal : normal;
+    y = y > 65504.0f ? std::numeric_limits<float>::infinity() : y;
+    y = magnitude > 0x7F800000u ? ax : y;
+    uint32_t out;
+    std::memcpy(&out, &y, sizeof(out));
+    out |= sign;
+    std::memcpy(&y, &out, sizeof(y));
+    return y;
+}
+
+template<typename T>
+void round_to_precision(T* data, int n, Precision precision) {
+    if (precision == Precision::Float32) return;
+    parallel_for(0, n, 32768, [&](int begin, int end) {
+        if (precision == Precision::BFloat16) {
+            for (int i = begin; i < end; ++i) data[i] = static_cast<T>(round_to_bfloat16(static_cast<float>(data[i])));
+        } else {
+            for (int i = begin; i < end; ++i) data[i] = static_cast<T>(round_to_float16(static_cast<float>(data[i])));
+        }
+    });
+}
+
+// Thread-local autocast region. Inside it, float32 matmuls round their operands
+// and every eligible op (matmul, Linear, elementwise arithmetic and activations)
+// rounds its output to the autocast precision. Reductions, losses and softmax
+// are left in float32. Gradients are always computed in float32. Tangents follow
+// the primal: a matmul rounds its operand tangents and every rounded output has
+// its tangent rounded too.
+class Autocast {
+public:
+    static bool is_enabled() { return state().precision != Precision::Float32; }
+    static Precision precision() { return state().precision; }
+    static void set_precision(Precision precision) { state().precision = precision; }
+
+private:
+    struct State {
+        Precision precision = Precision::Float32;
+    };
+
+    static State& state() {
+        thread_local State s;
+        return s;
+    }
+};
+
+class AutocastGuard {
+public:
+    explicit AutocastGuard(Precision precision) : prev(Autocast::precision()) {
+        Autocast::set_precision(precision);
+    }
+
+    ~AutocastGuard() {
+        Autocast::set_precision(prev);
+    }
+
+    AutocastGuard(const AutocastGuard&) = delete;
+    AutocastGuard& operator=(const AutocastGuard&) = delete;
+
+private:
+    Precision prev;
+};
+
+// Only float32 tensors take part in autocast; float64 and int32 are untouched.
+template<typename T>
+void autocast_output(Tensor<T>& tensor) {
+    if constexpr (std::is_same_v<T, float>) {
+        if (Autocast::is_enabled()) {
+            round_to_precision(tensor.data.get(), tensor.size, Autocast::precision());
+            if (tensor.tangent) round_to_precision(tensor.tangent->data.get(), tensor.tangent->size, Autocast::precision());
+        }
+    }
+}
+
+// Returns the data of an operand as the autocast precision sees it: the tensor's
+// own buffer outside autocast, otherwise a rounded copy held in scratch.
+template<typename T>
+const T* autocast_operand(const Tensor<T>& tensor, std::vector<T>& scratch) {
+    if constexpr (std::is_same_v<T, float>) {
+        if (Autocast::is_enabled()) {
+            scratch.assign(tensor.data.get(), tensor.data.get() + tensor.size);
+            round_to_precision(scratch.data(), tensor.size, Autocast::precision());
+            return scratch.data();
+        }
+    }
+    return tensor.data.get();
+}
+
+#endif
@@ -12,6 +12,7 @@
 
 template<typename T>
 std::shared_ptr<Tensor<T>> sum(const std::shared_ptr<Tensor<T>>& tensor, int axis = -1) {
+    MemoryScope scope("sum");
     if (axis < -1 || axis >= tensor->ndim) {
         throw std::invalid_argument("ERROR: Invalid axis for sum operation.");
     }
@@ -21,7 +22,7 @@ std::shared_ptr<Tensor<T>> sum(const std::shared_ptr<Tensor<T>>& tensor, int axi
         for (int i = 0; i < tensor->size; ++i) {
             total_sum += tensor->data[i];
         }
-        auto result = std::make_shared<Tensor<T>>(std::vector<T>{total_sum}, std::vector<int>{1}, tensor->requires_grad);
+        auto result = std::make_shared<Tensor<T>>(std::vector<T>{total_sum}, std::vector<int>{1}, GradMode::resolve(tensor->requires_grad));
         if (result->requires_grad) {
             result->parents = {tensor};
             result->grad_fn = std::make_unique<SumBackward<T>>(tensor, axis);
@@ -39,7 +40,7 @@ std::shared_ptr<Tensor<T>> sum(const std::shared_ptr<Tensor<T>>& tensor, int axi
         result_shape.push_back(1);
     }
 
-    auto result = std::make_shared<Tensor<T>>(result_shape, tensor->requires_grad);
+    auto result = std::make_shared<Tensor<T>>(result_shape, GradMode::resolve(tensor->requires_grad));
     std::fill(result->data.get(), result->data.get() + result->size, static_cast<T>(0));
 
     for(int i = 0; i < tensor->size; ++i) {
@@ -66,11 +67,14 @@ std::shared_ptr<Tensor<T>> sum(const std::shared_ptr<Tensor<T>>& tensor, int axi
 
 template<typename T>
 std::shared_ptr<Tensor<T>> mean(const std::shared_ptr<Tensor<T>>& tensor, int axis = -1) {
+    MemoryScope scope("mean");
+    // reductions stay in float32 inside an autocast region
+    AutocastGuard full_precision(Precision::Float32);
     auto sum_res = sum(tensor, axis);
     int n = (axis == -1) ? tensor->size : tensor->shape[axis];
     auto result = tensor_scalar_div(sum_res, static_cast<T>(n));
     
-    if (tensor->requires_grad) {
+    if (result->requires_grad) {
         result->parents = {tensor};
         result->grad_fn = std::make_unique<MeanBackward<T>>(tensor, axis);
     }
@@ -79,6 +83,7 @@ std::shared_ptr<Tensor<T>> mean(const std::shared_ptr<Tensor<T>>& tensor, int ax
 
 template<typename T>
 std::shared_ptr<Tensor<T>> max(const std::shared_ptr<Tensor<T>>& tensor, int axis = -1) {
+    MemoryScope scope("max");
     if (axis < -1 || axis >= tensor->ndim) {
         throw std::invalid_argument("ERROR: Invalid axis for max operation.");
     }
@@ -92,8 +97,8 @@ std::shared_ptr<Tensor<T>> max(const std::shared_ptr<Tensor<T>>& tensor, int axi
                 max_idx = i;
             }
         }
-        auto result = std::make_shared<Tensor<T>>(std::vector<T>{max_val}, std::vector<int>{1}, tensor->requires_grad);
-        if (tensor->requires_grad) {
+        auto result = std::make_shared<Tensor<T>>(std::vector<T>{max_val}, std::vector<int>{1}, GradMode::resolve(tensor->requires_grad));
+        if (result->requires_grad) {
             result->parents = {tensor};
             result->grad_fn = std::make_unique<MaxBackward<T>>(tensor, std::vector<int>{max_idx});
         }
@@ -108,7 +113,7 @@ std::shared_ptr<Tensor<T>> max(const std::shared_ptr<Tensor<T>>& tensor, int axi
     }
     if (result_shape.empty()) result_shape.push_back(1);
     
-    auto result = std::make_shared<Tensor<T>>(result_shape, tensor->requires_grad);
+    auto result = std::make_shared<Tensor<T>>(result_shape, GradMode::resolve(tensor->requires_grad));
     std::vector<int> max_indices(result->size);
     std::fill(result->data.get(), result->data.get() + result->size, std::numeric_limits<T>::lowest());
 
@@ -131,7 +136,7 @@ std::shared_ptr<Tensor<T>> max(const std::shared_ptr<Tensor<T>>& tensor, int axi
         throw std::runtime_error("ERROR: Max operation for axis other than 0 or -1 is not implemented.");
     }
 
-    if (tensor->requires_grad) {
+    if (result->requires_grad) {
         result->parents = {tensor};
         result->grad_fn = std::make_unique<MaxBackward<T>>(tensor, max_indices);
     }
@@ -140,6 +145,7 @@ std::shared_ptr<Tensor<T>> max(const std::shared_ptr<Tensor<T>>& tensor, int axi
 
 template<typename T>
 std::shared_ptr<Tensor<T>> min(const std::shared_ptr<Tensor<T>>& tensor, int axis = -1) {
+    MemoryScope scope("min");
     if (axis < -1 || axis >= tensor->ndim) {
         throw std::invalid_argument("ERROR: Invalid axis for min operation.");
     }
@@ -153,8 +159,8 @@ std::shared_ptr<Tensor<T>> min(const std::shared_ptr<Tensor<T>>& tensor, int axi
                 min_idx = i;
             }
         }
-        auto result = std::make_shared<Tensor<T>>(std::vector<T>{min_val}, std::vector<int>{1}, tensor->requires_grad);
-        if (tensor->requires_grad) {
+        auto result = std::make_shared<Tensor<T>>(std::vector<T>{min_val}, std::vector<int>{1}, GradMode::resolve(tensor->requires_grad));
+        if (result->requires_grad) {
             result->parents = {tensor};
             result->grad_fn = std::make_unique<MinBackward<T>>(tensor, std::vector<int>{min_idx});
         }
@@ -169,7 +175,7 @@ std::shared_ptr<Tensor<T>> min(const std::shared_ptr<Tensor<T>>& tensor, int axi
     }
     if (result_shape.empty()) result_shape.push_back(1);
 
-    auto result = std::make_shared<Tensor<T>>(result_shape, tensor->requires_grad);
+    auto result = std::make_shared<Tensor<T>>(result_shape, GradMode::resolve(tensor->requires_grad));
     std::vector<int> min_indices(result->size);
     std::fill(result->data.get(), result->data.get() + result->size, std::numeric_limits<T>::max());
 
@@ -192,7 +198,7 @@ std::shared_ptr<Tensor<T>> min(const std::shared_ptr<Tensor<T>>& tensor, int axi
         throw std::runtime_error("ERROR: Min operation for axis other than 0 or -1 is not implemented.");
     }
 
-    if (tensor->requires_grad) {
+    if (result->requires_grad) {
         result->parents = {tensor};
         result->grad_fn = std::make_unique<MinBackward<T>>(tensor, min_indices);
     }
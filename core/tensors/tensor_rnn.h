@@ -0,0 +1,255 @@
+#ifndef TENSOR_RNN_H
+#define TENSOR_RNN_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "tensor_gemm.h"
+#include "vec_math.h"
+#include "utils/parallel.h"
+
+// Sequence-level LSTM and GRU kernels on raw buffers. Sequences are laid out
+// [steps, batch, features] so that the inputs of all timesteps form a single
+// [steps * batch, input] matrix: the input-to-hidden projection of the whole
+// sequence is one GEMM before the recurrence starts, and each timestep only
+// multiplies the previous hidden state by the concatenated recurrent weights.
+// The gate nonlinearities and the state update are then applied in one fused
+// elementwise pass.
+//
+// Weights are stacked by gate: LSTM uses [i, f, g, o] (4H rows), GRU [r, z, n]
+// (3H rows). In backward, the pre-activation gradients of every timestep are
+// kept so that the weight gradients are again one GEMM each over the whole
+// sequence instead of one per step.
+
+template<typename T>
+inline T rnn_sigmoid(T x) {
+    return vec_sigmoid_scalar(x);
+}
+
+// Column sums of a row-major [rows x cols] matrix, accumulated into out.
+template<typename T>
+void rnn_column_sum(const T* m, int rows, int cols, T* out) {
+    parallel_for(0, cols, 64, [&](int begin, int end) {
+        for (int r = 0; r < rows; ++r) {
+            const T* row = m + static_cast<size_t>(r) * cols;
+            for (int j = begin; j < end; ++j) out[j] += row[j];
+        }
+    });
+}
+
+// h and c are [(steps + 1) x batch x hidden] with h[0], c[0] holding the
+// initial state; gates receives the activated gates of every step.
+template<typename T>
+void lstm_forward(const T* x, const T* w_ih, const T* w_hh, const T* bias,
+                  int steps, int batch, int input, int hidden,
+                  T* gates, T* h, T* c) {
+    int G = 4 * hidden;
+    int state = batch * hidden;
+    gemm(false, true, steps * batch, G, input, x, input, w_ih, input, gates, G);
+
+    for (int t = 0; t < steps; ++t) {
+        T* gt = gates + static_cast<size_t>(t) * batch * G;
+        const T* h_prev = h + static_cast<size_t>(t) * state;
+        const T* c_prev = c + static_cast<size_t>(t) * state;
+        T* h_next = h + static_cast<size_t>(t + 1) * state;
+        T* c_next = c + static_cast<size_t>(t + 1) * state;
+
+        gemm(false, true, batch, G, hidden, h_prev, hidden, w_hh, hidden, gt, G, true);
+
+        parallel_for(0, batch, std::max(1, 4096 / hidden), [&](int begin, int end) {
+            for (int b = begin; b < end; ++b) {
+                T* row = gt + static_cast<size_t>(b) * G;
+                for (int j = 0; j < hidden; ++j) {
+                    T i = row[j], f = row[hidden + j], g = row[2 * hidden + j], o = row[3 * hidden + j];
+                    if (bias) {
+                        i += bias[j];
+                        f += bias[hidden + j];
+                        g += bias[2 * hidden + j];
+                        o += bias[3 * hidden + j];
+                    }
+                    i = rnn_sigmoid(i);
+                    f = rnn_sigmoid(f);
+                    g = vec_tanh_scalar(g);
+                    o = rnn_sigmoid(o);
+                    row[j] = i;
+                    row[hidden + j] = f;
+                    row[2 * hidden + j] = g;
+                    row[3 * hidden + j] = o;
+
+                    int s = b * hidden + j;
+                    T cell = f * c_prev[s] + i * g;
+                    c_next[s] = cell;
+                    h_next[s] = o * vec_tanh_scalar(cell);
+                }
+            }
+        });
+    }
+}
+
+// grad_output is [steps x batch x hidden] when every step was returned, or
+// [batch x hidden] for the last step only. All outputs are accumulated and
+// may be null.
+template<typename T>
+void lstm_backward(const T* x, const T* w_ih, const T* w_hh, const T* gates, const T* h, const T* c,
+                   const T* grad_output, bool sequences,
+                   int steps, int batch, int input, int hidden,
+                   T* dx, T* dh0, T* dc0, T* dw_ih, T* dw_hh, T* dbias) {
+    int G = 4 * hidden;
+    int state = batch * hidden;
+    std::vector<T> dgates(static_cast<size_t>(steps) * batch * G);
+    std::vector<T> dh_next(state, static_cast<T>(0));
+    std::vector<T> dc_next(state, static_cast<T>(0));
+
+    for (int t = steps - 1; t >= 0; --t) {
+        const T* gt = gates + static_cast<size_t>(t) * batch * G;
+        const T* c_prev = c + static_cast<size_t>(t) * state;
+        const T* c_cur = c + static_cast<size_t>(t + 1) * state;
+        const T* go = sequences ? grad_output + static_cast<size_t>(t) * state
+                                : (t == steps - 1 ? grad_output : nullptr);
+        T* dgt = dgates.data() + static_cast<size_t>(t) * batch * G;
+
+        parallel_for(0, batch, std::max(1, 4096 / hidden), [&](int begin, int end) {
+            for (int b = begin; b < end; ++b) {
+                const T* row = gt + static_cast<size_t>(b) * G;
+                T* drow = dgt + static_cast<size_t>(b) * G;
+                for (int j = 0; j < hidden; ++j) {
+                    int s = b * hidden + j;
+                    T i = row[j], f = row[hidden + j], g = row[2 * hidden + j], o = row[3 * hidden + j];
+                    T dh = dh_next[s] + (go ? go[s] : static_cast<T>(0));
+                    T tc = vec_tanh_scalar(c_cur[s]);
+                    T dc = dc_next[s] + dh * o * (1 - tc * tc);
+
+                    drow[j] = dc * g * i * (1 - i);
+                    drow[hidden + j] = dc * c_prev[s] * f * (1 - f);
+                    drow[2 * hidden + j] = dc * i * (1 - g * g);
+                    drow[3 * hidden + j] = dh * tc * o * (1 - o);
+                    dc_next[s] = dc * f;
+                }
+            }
+        });
+
+        gemm(false, false, batch, hidden, G, dgt, G, w_hh, hidden, dh_next.data(), hidden);
+    }
+
+    if (dh0) for (int s = 0; s < state; ++s) dh0[s] += dh_next[s];
+    if (dc0) for (int s = 0; s < state; ++s) dc0[s] += dc_next[s];
+
+    int rows = steps * batch;
+    if (dw_ih) gemm(true, false, G, input, rows, dgates.data(), G, x, input, dw_ih, input, true);
+    if (dw_hh) gemm(true, false, G, hidden, rows, dgates.data(), G, h, hidden, dw_hh, hidden, true);
+    if (dbias) rnn_column_sum(dgates.data(), rows, G, dbias);
+    if (dx) gemm(false, false, rows, input, G, dgates.data(), G, w_ih, input, dx, input, true);
+}
+
+// h is [(steps + 1) x batch x hidden] with h[0] the initial state. gates
+// receives the activated r, z, n of every step and hn the recurrent part of the
+// candidate, W_hn h + b_hn, which backward needs because r multiplies it.
+template<typename T>
+void gru_forward(const T* x, const T* w_ih, const T* w_hh, const T* b_ih, const T* b_hh,
+                 int steps, int batch, int input, int hidden,
+                 T* gates, T* hn, T* h) {
+    int G = 3 * hidden;
+    int state = batch * hidden;
+    gemm(false, true, steps * batch, G, input, x, input, w_ih, input, gates, G);
+    std::vector<T> hw(static_cast<size_t>(batch) * G);
+
+    for (int t = 0; t < steps; ++t) {
+        T* gt = gates + static_cast<size_t>(t) * batch * G;
+        T* hnt = hn + static_cast<size_t>(t) * state;
+        const T* h_prev = h + static_cast<size_t>(t) * state;
+        T* h_next = h + static_cast<size_t>(t + 1) * state;
+
+        gemm(false, true, batch, G, hidden, h_prev, hidden, w_hh, hidden, hw.data(), G);
+
+        parallel_for(0, batch, std::max(1, 4096 / hidden), [&](int begin, int end) {
+            for (int b = begin; b < end; ++b) {
+                T* row = gt + static_cast<size_t>(b) * G;
+                const T* hrow = hw.data() + static_cast<size_t>(b) * G;
+                for (int j = 0; j < hidden; ++j) {
+                    T xr = row[j], xz = row[hidden + j], xn = row[2 * hidden + j];
+                    T hr = hrow[j], hz = hrow[hidden + j], hnv = hrow[2 * hidden + j];
+                    if (b_ih) {
+                        xr += b_ih[j];
+                        xz += b_ih[hidden + j];
+                        xn += b_ih[2 * hidden + j];
+                    }
+                    if (b_hh) {
+                        hr += b_hh[j];
+                        hz += b_hh[hidden + j];
+                        hnv += b_hh[2 * hidden + j];
+                    }
+                    T r = rnn_sigmoid(xr + hr);
+                    T z = rnn_sigmoid(xz + hz);
+                    T n = vec_tanh_scalar(xn + r * hnv);
+                    row[j] = r;
+                    row[hidden + j] = z;
+                    row[2 * hidden + j] = n;
+
+                    int s = b * hidden + j;
+                    hnt[s] = hnv;
+                    h_next[s] = (1 - z) * n + z * h_prev[s];
+                }
+            }
+        });
+    }
+}
+
+template<typename T>
+void gru_backward(const T* x, const T* w_ih, const T* w_hh, const T* gates, const T* hn, const T* h,
+                  const T* grad_output, bool sequences,
+                  int steps, int batch, int input, int hidden,
+                  T* dx, T* dh0, T* dw_ih, T* dw_hh, T* db_ih, T* db_hh) {
+    int G = 3 * hidden;
+    int state = batch * hidden;
+    std::vector<T> dx_pre(static_cast<size_t>(steps) * batch * G);
+    std::vector<T> dh_pre(static_cast<size_t>(steps) * batch * G);
+    std::vector<T> dh_next(state, static_cast<T>(0));
+
+    for (int t = steps - 1; t >= 0; --t) {
+        const T* gt = gates + static_cast<size_t>(t) * batch * G;
+        const T* hnt = hn + static_cast<size_t>(t) * state;
+        const T* h_prev = h + static_cast<size_t>(t) * state;
+        const T* go = sequences ? grad_output + static_cast<size_t>(t) * state
+                                : (t == steps - 1 ? grad_output : nullptr);
+        T* dxt = dx_pre.data() + static_cast<size_t>(t) * batch * G;
+        T* dht = dh_pre.data() + static_cast<size_t>(t) * batch * G;
+
+        parallel_for(0, batch, std::max(1, 4096 / hidden), [&](int begin, int end) {
+            for (int b = begin; b < end; ++b) {
+                const T* row = gt + static_cast<size_t>(b) * G;
+                T* dxrow = dxt + static_cast<size_t>(b) * G;
+                T* dhrow = dht + static_cast<size_t>(b) * G;
+                for (int j = 0; j < hidden; ++j) {
+                    int s = b * hidden + j;
+                    T r = row[j], z = row[hidden + j], n = row[2 * hidden + j];
+                    T dh = dh_next[s] + (go ? go[s] : static_cast<T>(0));
+
+                    T dn = dh * (1 - z) * (1 - n * n);
+                    T dz = dh * (h_prev[s] - n) * z * (1 - z);
+                    T dr = dn * hnt[s] * r * (1 - r);
+
+                    dxrow[j] = dr;
+                    dxrow[hidden + j] = dz;
+                    dxrow[2 * hidden + j] = dn;
+                    dhrow[j] = dr;
+                    dhrow[hidden + j] = dz;
+                    dhrow[2 * hidden + j] = dn * r;
+                    dh_next[s] = dh * z;
+                }
+            }
+        });
+
+        gemm(false, false, batch, hidden, G, dht, G, w_hh, hidden, dh_next.data(), hidden, true);
+    }
+
+    if (dh0) for (int s = 0; s < state; ++s) dh0[s] += dh_next[s];
+
+    int rows = steps * batch;
+    if (dw_ih) gemm(true, false, G, input, rows, dx_pre.data(), G, x, input, dw_ih, input, true);
+    if (dw_hh) gemm(true, false, G, hidden, rows, dh_pre.data(), G, h, hidden, dw_hh, hidden, true);
+    if (db_ih) rnn_column_sum(dx_pre.data(), rows, G, db_ih);
+    if (db_hh) rnn_column_sum(dh_pre.data(), rows, G, db_hh);
+    if (dx) gemm(false, false, rows, input, G, dx_pre.data(), G, w_ih, input, dx, input, true);
+}
+
+#endif
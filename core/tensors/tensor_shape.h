@@ -0,0 +1,77 @@
+#ifndef TENSOR_SHAPE_H
+#define TENSOR_SHAPE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+// Dimensions of a tensor (or its strides). Up to INLINE_RANK values are stored
+// in the object itself, so creating a tensor does not allocate for its shape;
+// higher ranks spill to the heap. Converts to and from std::vector<int>.
+class TensorShape {
+public:
+    static constexpr int INLINE_RANK = 6;
+
+    TensorShape() = default;
+    TensorShape(std::initializer_list<int> dims) { assign(dims.begin(), dims.size()); }
+    TensorShape(const std::vector<int>& dims) { assign(dims.data(), dims.size()); }
+
+    TensorShape(const TensorShape& other) { assign(other.data(), other.size()); }
+    TensorShape& operator=(const TensorShape& other) {
+        if (this != &other) assign(other.data(), other.size());
+        return *this;
+    }
+
+    size_t size() const { return static_cast<size_t>(rank); }
+    bool empty() const { return rank == 0; }
+
+    int* data() { return rank > INLINE_RANK ? spill.data() : dims; }
+    const int* data() const { return rank > INLINE_RANK ? spill.data() : dims; }
+    int* begin() { return data(); }
+    int* end() { return data() + rank; }
+    const int* begin() const { return data(); }
+    const int* end() const { return data() + rank; }
+
+    int& operator[](size_t i) { return data()[i]; }
+    const int& operator[](size_t i) const { return data()[i]; }
+    int& front() { return data()[0]; }
+    int front() const { return data()[0]; }
+    int& back() { return data()[rank - 1]; }
+    int back() const { return data()[rank - 1]; }
+
+    void push_back(int dim) {
+        if (rank < INLINE_RANK) {
+            dims[rank++] = dim;
+            return;
+        }
+        if (rank == INLINE_RANK) spill.assign(dims, dims + INLINE_RANK);
+        spill.push_back(dim);
+        ++rank;
+    }
+
+    std::vector<int> to_vector() const { return std::vector<int>(begin(), end()); }
+    operator std::vector<int>() const { return to_vector(); }
+
+    friend bool operator==(const TensorShape& a, const TensorShape& b) {
+        return a.rank == b.rank && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const TensorShape& a, const TensorShape& b) { return !(a == b); }
+
+private:
+    int rank = 0;
+    int dims[INLINE_RANK] = {};
+    std::vector<int> spill;   // all dimensions when rank > INLINE_RANK
+
+    void assign(const int* values, size_t count) {
+        rank = static_cast<int>(count);
+        if (rank > INLINE_RANK) {
+            spill.assign(values, values + count);
+        } else {
+            spill.clear();
+            std::copy(values, values + count, dims);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef TENSOR_SPARSE_GRAD_H
+#define TENSOR_SPARSE_GRAD_H
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+#include "tensor.h"
+#include "utils/parallel.h"
+
+// Row-sparse gradient of a 2D parameter: values[k] is the gradient of row
+// indices[k]. Indices are kept sorted and unique, so every row of the
+// parameter appears at most once and rows can be updated in parallel.
+template<typename T>
+struct SparseGrad {
+    std::vector<int> indices;
+    std::shared_ptr<Tensor<T>> values;
+
+    int nnz() const { return static_cast<int>(indices.size()); }
+};
+
+// Sums the rows that share an index. rows is a row-major [indices.size() x dim]
+// buffer. Positions are grouped by a parallel stable sort of the indices, then
+// each unique index is reduced independently across threads; duplicates are
+// summed in input order, so the result does not depend on the thread count.
+template<typename T>
+std::shared_ptr<SparseGrad<T>> coalesce_rows(const std::vector<int>& indices, const T* rows, int dim) {
+    int n = static_cast<int>(indices.size());
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    parallel_stable_sort(order, [&](int a, int b) { return indices[a] < indices[b]; });
+
+    std::vector<int> starts;
+    for (int i = 0; i < n; ++i) {
+        if (i == 0 || indices[order[i]] != indices[order[i - 1]]) starts.push_back(i);
+    }
+    int unique = static_cast<int>(starts.size());
+    starts.push_back(n);
+
+    auto result = std::make_shared<SparseGrad<T>>();
+    result->indices.resize(unique);
+    result->values = std::make_shared<Tensor<T>>(std::vector<int>{std::max(1, unique), dim}, false);
+
+    int grain = std::max(1, 16384 / std::max(1, dim));
+    parallel_for(0, unique, grain, [&](int begin, int end) {
+        for (int u = begin; u < end; ++u) {
+            result->indices[u] = indices[order[starts[u]]];
+            T* dst = result->values->data.get() + static_cast<size_t>(u) * dim;
+            std::fill(dst, dst + dim, static_cast<T>(0));
+            for (int k = starts[u]; k < starts[u + 1]; ++k) {
+                const T* src = rows + static_cast<size_t>(order[k]) * dim;
+                for (int j = 0; j < dim; ++j) dst[j] += src[j];
+            }
+        }
+    });
+    return result;
+}
+
+// Adds rows to param.sparse_grad, merging with any gradient already there. The
+// gradient outlives the step, so it is built on the heap, not in the arena.
+template<typename T>
+void accumulate_sparse_grad(Tensor<T>& param, const std::vector<int>& indices, const T* rows, int dim) {
+    StepArenaBypass heap;
+    if (!param.sparse_grad || param.sparse_grad->nnz() == 0) {
+        param.sparse_grad = coalesce_rows(indices, rows, dim);
+        return;
+    }
+
+    const SparseGrad<T>& old = *param.sparse_grad;
+    std::vector<int> merged_indices(old.indices);
+    merged_indices.insert(merged_indices.end(), indices.begin(), indices.end());
+
+    std::vector<T> merged_rows(merged_indices.size() * static_cast<size_t>(dim));
+    size_t old_count = static_cast<size_t>(old.nnz()) * dim;
+    std::copy(old.values->data.get(), old.values->data.get() + old_count, merged_rows.begin());
+    std::copy(rows, rows + indices.size() * static_cast<size_t>(dim), merged_rows.begin() + old_count);
+
+    param.sparse_grad = coalesce_rows(merged_indices, merged_rows.data(), dim);
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef TENSOR_SPARSE_OPS_H
+#define TENSOR_SPARSE_OPS_H
+
+#include <memory>
+#include <stdexcept>
+#include "tensor.h"
+#include "sparse_tensor.h"
+#include "tensor_gemm.h"
+#include "autograd/autograd_sparse.h"
+
+// Sparse [M x K] times dense [K x N]. Only the dense operand receives a gradient.
+template<typename T>
+std::shared_ptr<Tensor<T>> spmm(const std::shared_ptr<SparseTensor<T>>& a, const std::shared_ptr<Tensor<T>>& b) {
+    MemoryScope scope("spmm");
+    if (b->ndim != 2) throw std::invalid_argument("ERROR: spmm expects a 2D dense operand.");
+    if (a->cols != b->shape[0]) throw std::invalid_argument("ERROR: Shapes are not valid to multiply");
+
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{a->rows, b->shape[1]}, GradMode::resolve(b->requires_grad));
+    spmm_kernel(*a, b->data.get(), b->shape[1], result->data.get());
+
+    if (result->requires_grad) {
+        result->parents = {b};
+        result->grad_fn = std::make_unique<SpMMBackward<T>>(a, b);
+    }
+    return result;
+}
+
+// C[M x N] = A[M x K] * B for sparse A and a [K x N] B packed by
+// gemm_pack_b_panels: row k of the column panel starting at jc is the
+// contiguous run of nc values at jc * K + k * nc.
+template<typename T>
+void spmm_packed_kernel(const SparseTensor<T>& A, const T* b_panels, int N, T* C) {
+    int K = A.cols;
+    int work_per_row = std::max(1, (A.nnz() / std::max(1, A.rows)) * N);
+    int grain = std::max(1, 32768 / work_per_row);
+    parallel_for(0, A.rows, grain, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            T* c_row = C + static_cast<size_t>(i) * N;
+            std::fill(c_row, c_row + N, static_cast<T>(0));
+            for (int jc = 0; jc < N; jc += GEMM_NC) {
+                int nc = std::min(GEMM_NC, N - jc);
+                const T* panel = b_panels + static_cast<size_t>(jc) * K;
+                for (int k = A.row_ptr[i]; k < A.row_ptr[i + 1]; ++k) {
+                    const T a = A.values[k];
+                    const T* b_row = panel + static_cast<size_t>(A.col_idx[k]) * nc;
+                    for (int j = 0; j < nc; ++j) c_row[jc + j] += a * b_row[j];
+                }
+            }
+        }
+    });
+}
+
+// Sparse [M x K] times W^T for a dense W [N x K], as a Linear layer applies
+// its weights. w_panels is W^T packed by gemm_pack_b_panels (the layer's
+// weight cache), so no transposed copy of W is built. Only W receives a
+// gradient.
+template<typename T>
+std::shared_ptr<Tensor<T>> spmm_transposed(const std::shared_ptr<SparseTensor<T>>& a, const std::shared_ptr<Tensor<T>>& w,
+                                           const T* w_panels) {
+    MemoryScope scope("spmm");
+    if (w->ndim != 2) throw std::invalid_argument("ERROR: spmm expects a 2D dense operand.");
+    if (a->cols != w->shape[1]) throw std::invalid_argument("ERROR: Shapes are not valid to multiply");
+
+    auto result = std::make_shared<Tensor<T>>(std::vector<int>{a->rows, w->shape[0]}, GradMode::resolve(w->requires_grad));
+    spmm_packed_kernel(*a, w_panels, w->shape[0], result->data.get());
+
+    if (result->requires_grad) {
+        result->parents = {w};
+        result->grad_fn = std::make_unique<SpMMTransposedBackward<T>>(a, w);
+    }
+    return result;
+}
+
+#endif
@@ -6,5 +6,8 @@
 #include "tensor_math.h"
 #include "tensor_broadcast.h"
 #include "tensors/tensor_reductions.h"
+#include "sparse_tensor.h"
+#include "tensor_sparse_ops.h"
+#include "tensor_foreach.h"
 
 #endif
\ No newline at end of file
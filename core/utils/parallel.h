@@ -0,0 +1,232 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <new>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// Number of threads used by parallel_for; defaults to the hardware concurrency.
+// Atomic because it may be changed while other threads are running kernels.
+inline std::atomic<int>& parallel_num_threads() {
+    static std::atomic<int> threads{static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+    return threads;
+}
+
+inline int get_num_threads() {
+    return parallel_num_threads().load(std::memory_order_relaxed);
+}
+
+inline void set_num_threads(int threads) {
+    parallel_num_threads().store(std::max(1, threads), std::memory_order_relaxed);
+}
+
+inline bool& in_parallel_region() {
+    thread_local bool inside = false;
+    return inside;
+}
+
+// Persistent workers for parallel_for. A call publishes one job of `tasks`
+// indices; the caller and the woken workers claim indices from a shared
+// counter until none are left. One job runs at a time: a parallel_for that
+// finds the pool busy (another thread's kernel) runs inline instead of waiting.
+// A forked child (multiprocessing "fork", DDP ranks) inherits none of the
+// workers and possibly locked mutexes, so it starts over with an empty pool.
+class ThreadPool {
+public:
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    // Calls task(i) for every i in [0, tasks) using up to `threads` threads,
+    // including the caller. Returns false, without running anything, if the
+    // pool is already running a job.
+    template<typename F>
+    bool try_run(int tasks, int threads, F& task) {
+        std::unique_lock<std::mutex> busy(run_mutex_, std::try_to_lock);
+        if (!busy.owns_lock()) return false;
+
+        Job job;
+        job.call = [](void* context, int index) { (*static_cast<F*>(context))(index); };
+        job.context = &task;
+        job.tasks = tasks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (static_cast<int>(workers_.size()) < threads - 1) workers_.emplace_back([this] { worker_loop(); });
+            job_ = &job;
+            ++generation_;
+        }
+        wake_.notify_all();
+        work(job);
+
+        // Every index is claimed; wait for the workers still running one.
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = nullptr;
+        done_.wait(lock, [this] { return users_ == 0; });
+        return true;
+    }
+
+private:
+    struct Job {
+        void (*call)(void*, int) = nullptr;
+        void* context = nullptr;
+        int tasks = 0;
+        std::atomic<int> next{0};
+    };
+
+    ThreadPool() {
+#ifndef _WIN32
+        pthread_atfork(nullptr, nullptr, [] { instance().reset_after_fork(); });
+#endif
+    }
+
+    // Runs in the child of fork, which has only the forking thread. The
+    // workers' std::thread objects refer to threads that do not exist there and
+    // the mutexes may have been held by one of them, so all of them are
+    // replaced without running their destructors.
+    void reset_after_fork() {
+        new (&run_mutex_) std::mutex();
+        new (&mutex_) std::mutex();
+        new (&wake_) std::condition_variable();
+        new (&done_) std::condition_variable();
+        new (&workers_) std::vector<std::thread>();
+        job_ = nullptr;
+        users_ = 0;
+        stop_ = false;
+    }
+
+    static void work(Job& job) {
+        for (int index = job.next.fetch_add(1); index < job.tasks; index = job.next.fetch_add(1)) {
+            job.call(job.context, index);
+        }
+    }
+
+    void worker_loop() {
+        unsigned long long seen = 0;
+        while (true) {
+            Job* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || (job_ && generation_ != seen); });
+                if (stop_) return;
+                seen = generation_;
+                job = job_;
+                ++users_;
+            }
+            work(*job);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--users_ == 0) done_.notify_all();
+            }
+        }
+    }
+
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::vector<std::thread> workers_;
+    Job* job_ = nullptr;
+    unsigned long long generation_ = 0;
+    int users_ = 0;
+    bool stop_ = false;
+};
+
+// Splits [begin, end) into contiguous chunks of at least `grain` items and calls
+// fn(chunk_begin, chunk_end) for each one on the thread pool, the caller taking
+// chunks too. Ranges too small to split, calls nested inside another
+// parallel_for, and calls made while the pool is busy run inline. The first
+// exception thrown by any chunk is rethrown.
+template<typename F>
+void parallel_for(int begin, int end, int grain, F&& fn) {
+    int range = end - begin;
+    if (range <= 0) return;
+
+    int threads = std::min(get_num_threads(), (range + std::max(1, grain) - 1) / std::max(1, grain));
+    if (threads <= 1 || in_parallel_region()) {
+        fn(begin, end);
+        return;
+    }
+
+    int chunk = (range + threads - 1) / threads;
+    std::vector<std::exception_ptr> errors(threads);
+    auto run_chunk = [&](int t) {
+        int chunk_begin = begin + t * chunk;
+        int chunk_end = std::min(end, chunk_begin + chunk);
+        if (chunk_begin >= chunk_end) return;
+        bool was_inside = in_parallel_region();
+        in_parallel_region() = true;
+        try {
+            fn(chunk_begin, chunk_end);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+        in_parallel_region() = was_inside;
+    };
+
+    if (!ThreadPool::instance().try_run(threads, threads, run_chunk)) {
+        fn(begin, end);
+        return;
+    }
+
+    for (auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+// Stable sort that sorts contiguous pieces in parallel and then merges them
+// pairwise. Ties keep their input order, so the result is the same as
+// std::stable_sort for any thread count.
+template<typename T, typename Less>
+void parallel_stable_sort(std::vector<T>& values, Less less, int grain = 4096) {
+    int n = static_cast<int>(values.size());
+    int pieces = std::min(get_num_threads(), n / std::max(1, grain));
+    if (pieces <= 1 || in_parallel_region()) {
+        std::stable_sort(values.begin(), values.end(), less);
+        return;
+    }
+
+    std::vector<int> bounds(pieces + 1);
+    for (int p = 0; p <= pieces; ++p) bounds[p] = static_cast<int>(static_cast<long long>(n) * p / pieces);
+    parallel_for(0, pieces, 1, [&](int first, int last) {
+        for (int p = first; p < last; ++p) std::stable_sort(values.begin() + bounds[p], values.begin() + bounds[p + 1], less);
+    });
+
+    std::vector<T> merged(values.size());
+    for (int width = 1; width < pieces; width *= 2) {
+        int merges = (pieces + 2 * width - 1) / (2 * width);
+        parallel_for(0, merges, 1, [&](int first, int last) {
+            for (int m = first; m < last; ++m) {
+                int lo = bounds[m * 2 * width];
+                int mid = bounds[std::min(pieces, m * 2 * width + width)];
+                int hi = bounds[std::min(pieces, m * 2 * width + 2 * width)];
+                std::merge(values.begin() + lo, values.begin() + mid, values.begin() + mid, values.begin() + hi,
+                           merged.begin() + lo, less);
+            }
+        });
+        values.swap(merged);
+    }
+}
+
+#endif
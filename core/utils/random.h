@@ -0,0 +1,288 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "tensors/vec_math.h"
+#include "utils/parallel.h"
+
+// Counter-based random numbers (Philox4x32-10, Salmon et al. 2011). Block b of
+// a draw is the bijection of the 128-bit counter (offset + b, stream) under the
+// 64-bit seed, so any element can be computed on its own: fills split their
+// range over threads and still produce the same bits for every thread count.
+//
+// The global generator hands out disjoint counter ranges. manual_seed(s)
+// makes every later draw reproducible. Each draw is a PhiloxState, which is
+// all an op needs to regenerate its numbers later (dropout masks in backward).
+
+struct PhiloxState {
+    uint64_t seed = 0;
+    uint64_t stream = 0;
+    uint64_t offset = 0;   // first block of the draw
+};
+
+constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+constexpr int PHILOX_ROUNDS = 10;
+
+// Blocks generated together; the rounds run lane-wise over them so the
+// compiler can vectorize the 32x32->64 multiplies.
+constexpr int PHILOX_BATCH = 8;
+// Batches per parallel task (about VEC_MATH_GRAIN floats).
+constexpr int PHILOX_GRAIN = VEC_MATH_GRAIN / (4 * PHILOX_BATCH);
+
+// words[w][j] = word w of block state.offset + first + j
+inline void philox_batch(const PhiloxState& state, uint64_t first, uint32_t (&words)[4][PHILOX_BATCH]) {
+    uint32_t c0[PHILOX_BATCH], c1[PHILOX_BATCH];
+    for (int j = 0; j < PHILOX_BATCH; ++j) {
+        uint64_t counter = state.offset + first + static_cast<uint64_t>(j);
+        c0[j] = static_cast<uint32_t>(counter);
+        c1[j] = static_cast<uint32_t>(counter >> 32);
+    }
+    uint32_t c2 = static_cast<uint32_t>(state.stream);
+    uint32_t c3 = static_cast<uint32_t>(state.stream >> 32);
+    uint32_t k0 = static_cast<uint32_t>(state.seed);
+    uint32_t k1 = static_cast<uint32_t>(state.seed >> 32);
+
+    uint32_t x0[PHILOX_BATCH], x1[PHILOX_BATCH], x2[PHILOX_BATCH], x3[PHILOX_BATCH];
+    for (int j = 0; j < PHILOX_BATCH; ++j) {
+        x0[j] = c0[j];
+        x1[j] = c1[j];
+        x2[j] = c2;
+        x3[j] = c3;
+    }
+    for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+        for (int j = 0; j < PHILOX_BATCH; ++j) {
+            uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * x0[j];
+            uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * x2[j];
+            uint32_t y0 = static_cast<uint32_t>(p1 >> 32) ^ x1[j] ^ k0;
+            uint32_t y2 = static_cast<uint32_t>(p0 >> 32) ^ x3[j] ^ k1;
+            x1[j] = static_cast<uint32_t>(p1);
+            x3[j] = static_cast<uint32_t>(p0);
+            x0[j] = y0;
+            x2[j] = y2;
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    for (int j = 0; j < PHILOX_BATCH; ++j) {
+        words[0][j] = x0[j];
+        words[1][j] = x1[j];
+        words[2][j] = x2[j];
+        words[3][j] = x3[j];
+    }
+}
+
+// Calls fn(first_block, words) for every batch covering `blocks` blocks of the
+// draw, in parallel. fn must only write the elements of its own batch.
+template<typename F>
+void philox_for_each_batch(const PhiloxState& state, size_t blocks, F&& fn) {
+    int batches = static_cast<int>((blocks + PHILOX_BATCH - 1) / PHILOX_BATCH);
+    parallel_for(0, batches, PHILOX_GRAIN, [&](int begin, int end) {
+        uint32_t words[4][PHILOX_BATCH];
+        for (int batch = begin; batch < end; ++batch) {
+            uint64_t first = static_cast<uint64_t>(batch) * PHILOX_BATCH;
+            philox_batch(state, first, words);
+            fn(first, words);
+        }
+    });
+}
+
+// Fills out[0, n) with K values per block: transform(words, values) turns a
+// batch of blocks into values[k][j], element (first + j) * K + k.
+template<typename T, int K, typename Transform>
+void philox_fill(const PhiloxState& state, T* out, size_t n, Transform transform) {
+    philox_for_each_batch(state, (n + K - 1) / K, [&](uint64_t first, const uint32_t (&words)[4][PHILOX_BATCH]) {
+        T values[K][PHILOX_BATCH];
+        transform(words, values);
+        size_t base = static_cast<size_t>(first) * K;
+        size_t count = std::min(n - base, static_cast<size_t>(K * PHILOX_BATCH));
+        for (size_t i = 0; i < count; ++i) out[base + i] = values[i % K][i / K];
+    });
+}
+
+// Uniform in [0, 1) from 24 bits (float) or 53 bits (two words, double).
+inline float philox_unit_float(uint32_t w) {
+    return static_cast<float>(w >> 8) * (1.0f / 16777216.0f);
+}
+
+inline double philox_unit_double(uint32_t hi, uint32_t lo) {
+    uint64_t bits = ((static_cast<uint64_t>(hi) << 32) | lo) >> 11;
+    return static_cast<double>(bits) * (1.0 / 9007199254740992.0);
+}
+
+// Blocks a draw of n values of T consumes.
+template<typename T>
+size_t philox_blocks(size_t n) {
+    constexpr size_t per_block = sizeof(T) == sizeof(double) ? 2 : 4;
+    return (n + per_block - 1) / per_block;
+}
+
+template<typename T>
+void philox_uniform(const PhiloxState& state, T* out, size_t n, T low, T high) {
+    T range = high - low;
+    if constexpr (sizeof(T) == sizeof(double)) {
+        philox_fill<T, 2>(state, out, n, [&](const uint32_t (&w)[4][PHILOX_BATCH], T (&v)[2][PHILOX_BATCH]) {
+            for (int j = 0; j < PHILOX_BATCH; ++j) {
+                v[0][j] = low + range * static_cast<T>(philox_unit_double(w[0][j], w[1][j]));
+                v[1][j] = low + range * static_cast<T>(philox_unit_double(w[2][j], w[3][j]));
+            }
+        });
+    } else {
+        philox_fill<T, 4>(state, out, n, [&](const uint32_t (&w)[4][PHILOX_BATCH], T (&v)[4][PHILOX_BATCH]) {
+            for (int k = 0; k < 4; ++k)
+                for (int j = 0; j < PHILOX_BATCH; ++j) v[k][j] = low + range * static_cast<T>(philox_unit_float(w[k][j]));
+        });
+    }
+}
+
+// Box-Muller with the polynomial log/sincos of vec_math, so results do not
+// depend on the platform's libm: z = sqrt(-2 log u1) (cos, sin)(2 pi u2) with
+// u1 in (0, 1]. The log and sincos loops vectorize; std::sqrt (which may set
+// errno) is kept in a loop of its own so it does not block them.
+template<typename T>
+void philox_box_muller(const T (&u1)[PHILOX_BATCH], const T (&u2)[PHILOX_BATCH], T mean, T std_dev,
+                       T (&z0)[PHILOX_BATCH], T (&z1)[PHILOX_BATCH]) {
+    constexpr T two_pi = static_cast<T>(6.283185307179586);
+    T r[PHILOX_BATCH];
+    for (int j = 0; j < PHILOX_BATCH; ++j) r[j] = static_cast<T>(-2) * vec_log_scalar(u1[j]);
+    for (int j = 0; j < PHILOX_BATCH; ++j) r[j] = std_dev * std::sqrt(r[j]);
+    for (int j = 0; j < PHILOX_BATCH; ++j) {
+        T s, c;
+        vec_sincos_scalar(two_pi * u2[j], s, c);
+        z0[j] = mean + r[j] * c;
+        z1[j] = mean + r[j] * s;
+    }
+}
+
+template<typename T>
+void philox_normal(const PhiloxState& state, T* out, size_t n, T mean, T std_dev) {
+    if constexpr (sizeof(T) == sizeof(double)) {
+        philox_fill<T, 2>(state, out, n, [&](const uint32_t (&w)[4][PHILOX_BATCH], T (&v)[2][PHILOX_BATCH]) {
+            T u1[PHILOX_BATCH], u2[PHILOX_BATCH];
+            for (int j = 0; j < PHILOX_BATCH; ++j) {
+                u1[j] = static_cast<T>(1) - static_cast<T>(philox_unit_double(w[0][j], w[1][j]));
+                u2[j] = static_cast<T>(philox_unit_double(w[2][j], w[3][j]));
+            }
+            philox_box_muller(u1, u2, mean, std_dev, v[0], v[1]);
+        });
+    } else {
+        philox_fill<T, 4>(state, out, n, [&](const uint32_t (&w)[4][PHILOX_BATCH], T (&v)[4][PHILOX_BATCH]) {
+            for (int pair = 0; pair < 2; ++pair) {
+                T u1[PHILOX_BATCH], u2[PHILOX_BATCH];
+                for (int j = 0; j < PHILOX_BATCH; ++j) {
+                    u1[j] = static_cast<T>(1) - static_cast<T>(philox_unit_float(w[2 * pair][j]));
+                    u2[j] = static_cast<T>(philox_unit_float(w[2 * pair + 1][j]));
+                }
+                philox_box_muller(u1, u2, mean, std_dev, v[2 * pair], v[2 * pair + 1]);
+            }
+        });
+    }
+}
+
+// The process-wide generator. Draws reserve consecutive counter ranges; a
+// RandomStreamGuard on the current thread redirects them to a private stream
+// instead (checkpoint uses one to replay a segment's draws in backward).
+class RandomGenerator {
+    static constexpr uint64_t DEFAULT_SEED = 0x853C49E6748FEA9Bull;
+
+    std::mutex mutex;
+    uint64_t seed = DEFAULT_SEED;
+    uint64_t offset = 0;
+    uint64_t next_stream = 1;   // stream 0 is the shared one
+
+    static PhiloxState*& thread_stream() {
+        thread_local PhiloxState* stream = nullptr;
+        return stream;
+    }
+
+    friend class RandomStreamGuard;
+
+public:
+    static RandomGenerator& global() {
+        static RandomGenerator generator;
+        return generator;
+    }
+
+    void manual_seed(uint64_t value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seed = value;
+        offset = 0;
+        next_stream = 1;
+    }
+
+    uint64_t initial_seed() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return seed;
+    }
+
+    // Counter range for a draw of `blocks` blocks.
+    PhiloxState reserve(size_t blocks) {
+        if (PhiloxState* stream = thread_stream()) {
+            PhiloxState state = *stream;
+            stream->offset += blocks;
+            return state;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        PhiloxState state{seed, 0, offset};
+        offset += blocks;
+        return state;
+    }
+
+    // Start of a fresh stream that no other draw touches. Inside a private
+    // stream the child is derived from that stream's next block, so replaying
+    // the parent stream forks the same children; the top bit keeps derived
+    // streams apart from the numbered ones.
+    PhiloxState fork_stream() {
+        if (PhiloxState* stream = thread_stream()) {
+            uint32_t words[4][PHILOX_BATCH];
+            philox_batch(*stream, 0, words);
+            stream->offset += 1;
+            uint64_t id = (static_cast<uint64_t>(words[1][0]) << 32) | words[0][0];
+            return PhiloxState{stream->seed, id | (1ull << 63), 0};
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        return PhiloxState{seed, next_stream++, 0};
+    }
+
+    static bool in_private_stream() { return thread_stream() != nullptr; }
+};
+
+// While alive, draws on this thread come from `start` onwards.
+class RandomStreamGuard {
+    PhiloxState state;
+    PhiloxState* previous;
+
+public:
+    explicit RandomStreamGuard(const PhiloxState& start) : state(start), previous(RandomGenerator::thread_stream()) {
+        RandomGenerator::thread_stream() = &state;
+    }
+    ~RandomStreamGuard() { RandomGenerator::thread_stream() = previous; }
+    RandomStreamGuard(const RandomStreamGuard&) = delete;
+    RandomStreamGuard& operator=(const RandomStreamGuard&) = delete;
+};
+
+inline void manual_seed(uint64_t seed) {
+    RandomGenerator::global().manual_seed(seed);
+}
+
+inline uint64_t initial_seed() {
+    return RandomGenerator::global().initial_seed();
+}
+
+template<typename T>
+void random_uniform(T* out, size_t n, T low, T high) {
+    philox_uniform(RandomGenerator::global().reserve(philox_blocks<T>(n)), out, n, low, high);
+}
+
+template<typename T>
+void random_normal(T* out, size_t n, T mean, T std_dev) {
+    philox_normal(RandomGenerator::global().reserve(philox_blocks<T>(n)), out, n, mean, std_dev);
+}
+
+#endif
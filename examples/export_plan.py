@@ -0,0 +1,50 @@
+import os
+import random
+import tempfile
+import time
+import minitensor as mt
+from minitensor.layers import Linear, BatchNorm1d, LayerNorm
+from minitensor.activations import ReLU, Softmax
+from minitensor.model import Sequential
+
+# Exports a classifier to an inference plan: the batch norms are folded into
+# the neighbouring Linear weights, activations are fused into the layer before
+# them and all intermediate results live in two preallocated buffers. The plan
+# is then timed against the Python Sequential and saved for the standalone
+# runner:  ./build/run_plan <file> --bench 1000
+
+FEATURES, HIDDEN, CLASSES, BATCH, CALLS = 128, 256, 10, 32, 200
+random.seed(0)
+model = Sequential(
+    Linear(FEATURES, HIDDEN, dtype='float32'),
+    BatchNorm1d(HIDDEN),
+    ReLU(),
+    Linear(HIDDEN, HIDDEN, dtype='float32'),
+    LayerNorm(HIDDEN),
+    ReLU(),
+    Linear(HIDDEN, CLASSES, dtype='float32'),
+    Softmax(),
+).eval()
+x = mt.tensor([[random.uniform(-1, 1) for _ in range(FEATURES)] for _ in range(BATCH)], dtype='float32')
+
+plan = mt.export(model, x)
+print(plan.summary())
+print(f"folded {plan.folded_norms} batch norm(s), fused {plan.fused_activations} activation(s)")
+
+def timed(fn):
+    fn(x)
+    start = time.perf_counter()
+    for _ in range(CALLS):
+        fn(x)
+    return (time.perf_counter() - start) / CALLS * 1e6
+
+with mt.no_grad():
+    eager = timed(model)
+exported = timed(plan.run)
+print(f"Sequential {eager:8.1f} us/batch   plan {exported:8.1f} us/batch   speedup {eager / exported:4.2f}x")
+
+path = os.path.join(tempfile.gettempdir(), "classifier.plan")
+plan.save(path)
+reloaded = mt.ExportedPlan.load(path)
+difference = max(abs(a - b) for a, b in zip(reloaded.run(x).listed, plan.run(x).listed))
+print(f"saved to {path} ({os.path.getsize(path)} bytes), reloaded difference {difference}")
\ No newline at end of file
@@ -0,0 +1,42 @@
+import os
+import random
+import minitensor as mt
+from minitensor.layers import Linear
+from minitensor.activations import Tanh
+from minitensor.losses import MSE
+from minitensor.model import Sequential
+from minitensor.optims import Hogwild
+
+# Trains the same regression MLP with lock-free Hogwild SGD on 1, 2, 4, ...
+# threads and reports throughput and the full-dataset loss, against the
+# single-threaded run as the baseline. Every run takes the same total number of
+# steps, so the loss column shows what the racy updates cost in convergence.
+
+random.seed(0)
+ROWS, FEATURES, HIDDEN, TOTAL_STEPS = 4096, 64, 128, 8000
+weights = [random.gauss(0, 1) for _ in range(FEATURES)]
+rows = [[random.gauss(0, 1) for _ in range(FEATURES)] for _ in range(ROWS)]
+X = mt.tensor(rows, dtype='float32')
+y = mt.tensor([[sum(w * v for w, v in zip(weights, row)) / FEATURES] for row in rows], dtype='float32')
+
+def make_model():
+    return Sequential(
+        Linear(FEATURES, HIDDEN, dtype='float32'),
+        Tanh(),
+        Linear(HIDDEN, 1, dtype='float32'),
+    )
+
+def full_loss(model):
+    with mt.no_grad():
+        return MSE()(y, model(X)).nested[0]
+
+baseline = None
+workers = 1
+while workers <= max(4, os.cpu_count() or 1):
+    model = make_model()
+    trainer = Hogwild(model, lr=0.02, num_workers=workers, loss="mse", batch_size=32)
+    report = trainer.fit(X, y, steps_per_worker=TOTAL_STEPS // workers)
+    baseline = baseline or report["steps_per_second"]
+    print(f"{workers:2d} threads  {report['steps_per_second']:9.0f} steps/s  "
+          f"speedup {report['steps_per_second'] / baseline:5.2f}x  loss {full_loss(model):.6f}")
+    workers *= 2
\ No newline at end of file
@@ -0,0 +1,70 @@
+import random
+import threading
+import time
+import minitensor as mt
+from minitensor.layers import Linear
+from minitensor.activations import ReLU, Softmax
+from minitensor.model import Sequential
+from minitensor import InferenceEngine
+
+# Load generator for the dynamic-batching engine. CLIENTS Python threads each
+# send single-row requests back to back, first straight through the model (one
+# tiny forward per request) and then through an InferenceEngine that groups
+# concurrent requests into batched forwards. Prints throughput, latency
+# percentiles and how the requests were batched.
+
+FEATURES, HIDDEN, CLASSES = 256, 512, 10
+CLIENTS, REQUESTS_PER_CLIENT = 32, 100
+random.seed(0)
+model = Sequential(
+    Linear(FEATURES, HIDDEN, dtype='float32'),
+    ReLU(),
+    Linear(HIDDEN, HIDDEN, dtype='float32'),
+    ReLU(),
+    Linear(HIDDEN, CLASSES, dtype='float32'),
+    Softmax(),
+).eval()
+requests = [[random.uniform(-1, 1) for _ in range(FEATURES)] for _ in range(CLIENTS)]
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p / 100 * len(values)))]
+
+def run_clients(handle):
+    latencies = []
+    lock = threading.Lock()
+
+    def client(row):
+        local = []
+        for _ in range(REQUESTS_PER_CLIENT):
+            start = time.perf_counter()
+            handle(row)
+            local.append((time.perf_counter() - start) * 1e6)
+        with lock:
+            latencies.extend(local)
+
+    threads = [threading.Thread(target=client, args=(row,)) for row in requests]
+    start = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return len(latencies) / (time.perf_counter() - start), latencies
+
+def unbatched(row):
+    with mt.no_grad():
+        return model(mt.tensor([row], dtype='float32')).listed
+
+throughput, latencies = run_clients(unbatched)
+print(f"unbatched   {throughput:9.0f} req/s  p50 {percentile(latencies, 50):8.0f} us  "
+      f"p99 {percentile(latencies, 99):8.0f} us")
+
+for max_batch, max_latency_ms in ((8, 1.0), (32, 2.0), (64, 5.0)):
+    with InferenceEngine(model, max_batch_size=max_batch, max_latency_ms=max_latency_ms) as engine:
+        throughput, latencies = run_clients(engine.infer)
+        stats = engine.stats()
+    print(f"batch<={max_batch:<3d} {throughput:9.0f} req/s  p50 {percentile(latencies, 50):8.0f} us  "
+          f"p99 {percentile(latencies, 99):8.0f} us  (engine p50 {stats['p50_us']:.0f} us, "
+          f"p99 {stats['p99_us']:.0f} us)")
+    histogram = {size: count for size, count in enumerate(stats['batch_sizes']) if count}
+    print(f"            mean batch {stats['mean_batch_size']:.1f}, batch sizes {histogram}")
\ No newline at end of file
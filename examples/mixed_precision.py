@@ -0,0 +1,59 @@
+import random
+import time
+import minitensor as mt
+from minitensor.layers import Linear
+from minitensor.activations import ReLU
+from minitensor.losses import MSE
+from minitensor.model import Sequential
+from minitensor.optims import SGD
+from minitensor.amp import autocast, MasterWeightOptimizer, GradScaler
+
+# Trains the same MLP in float32 and under bfloat16 / float16 autocast with
+# float32 master weights and dynamic loss scaling, and reports throughput and
+# final loss. Reduced precision is emulated by rounding float32 values, so the
+# autocast runs show the numerical effect, not a hardware speedup.
+
+random.seed(0)
+BATCH, FEATURES, HIDDEN, STEPS = 256, 64, 256, 200
+
+X = mt.tensor([[random.uniform(-1, 1) for _ in range(FEATURES)] for _ in range(BATCH)], dtype='float32')
+y = mt.tensor([[sum(row[:8]) / 8.0] for row in X.nested], dtype='float32')
+
+def make_model():
+    return Sequential(
+        Linear(FEATURES, HIDDEN, dtype='float32'),
+        ReLU(),
+        Linear(HIDDEN, HIDDEN, dtype='float32'),
+        ReLU(),
+        Linear(HIDDEN, 1, dtype='float32'),
+    )
+
+def train(dtype=None):
+    model = make_model()
+    loss_fn = MSE()
+    params = list(model.parameters())
+    if dtype is None:
+        optimizer = SGD(params, lr=0.01)
+        scaler = GradScaler(enabled=False)
+    else:
+        optimizer = MasterWeightOptimizer(params, SGD, dtype=dtype, lr=0.01)
+        scaler = GradScaler(enabled=(dtype == 'float16'))
+
+    start = time.perf_counter()
+    for _ in range(STEPS):
+        optimizer.zero_grad()
+        with autocast(dtype or 'bfloat16', enabled=dtype is not None):
+            prediction = model(X)
+        loss = loss_fn(y, prediction)
+        scaler.scale(loss).backward()
+        scaler.step(optimizer)
+        scaler.update()
+    elapsed = time.perf_counter() - start
+    return STEPS * BATCH / elapsed, loss.nested[0], scaler.skipped_steps
+
+baseline, base_loss, _ = train()
+print(f"float32   {baseline:10.0f} samples/s  loss {base_loss:.6f}")
+for dtype in ('bfloat16', 'float16'):
+    throughput, loss, skipped = train(dtype)
+    print(f"{dtype:9s} {throughput:10.0f} samples/s  loss {loss:.6f}  "
+          f"speedup {throughput / baseline:.2f}x  skipped steps {skipped}")
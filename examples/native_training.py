@@ -0,0 +1,38 @@
+import time
+import minitensor as mt
+from minitensor.layers import Linear
+from minitensor.activations import Sigmoid
+from minitensor.losses import BCE
+from minitensor.model import Sequential
+from minitensor.optims import SGD
+
+# The binary classification model of binary_classification.py, trained once
+# with the Python loop (one call into C++ per op) and once with Trainer, which
+# runs every epoch in C++ and only calls back into Python to log.
+
+raw_X = [i for i in range(100)]
+X_train = mt.tensor([[x / 99] for x in raw_X], dtype='float32')
+y_train = mt.tensor([[1.0 if x >= 50 else 0.0] for x in raw_X], dtype='float32')
+EPOCHS = 2000
+
+def make_model():
+    mt.manual_seed(0)
+    return Sequential(Linear(input_features=1, output_features=1, dtype='float32'), Sigmoid())
+
+model = make_model()
+optimizer = SGD(list(model.parameters()), lr=0.5)
+loss_fn = BCE()
+start = time.perf_counter()
+for epoch in range(EPOCHS):
+    optimizer.zero_grad()
+    loss = loss_fn(y_train, model(X_train))
+    loss.backward()
+    optimizer.step()
+python_seconds = time.perf_counter() - start
+print(f"Python loop: {python_seconds / EPOCHS * 1e6:8.1f} us/step  loss {loss.nested[0]:.6f}")
+
+model = make_model()
+trainer = mt.Trainer(model, BCE(), SGD(list(model.parameters()), lr=0.5))
+report = trainer.fit(X_train, y_train, epochs=EPOCHS, batch_size=100, shuffle=False, log_every=500,
+                     callback=lambda p: print(f"  step {p.step:5d}  loss {p.loss:.6f}"))
+print(f"Trainer:     {report['seconds'] / report['steps'] * 1e6:8.1f} us/step  loss {report['final_loss']:.6f}")
\ No newline at end of file
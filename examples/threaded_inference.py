@@ -0,0 +1,44 @@
+import os
+import random
+import threading
+import time
+import minitensor as mt
+from minitensor.layers import Linear
+from minitensor.activations import ReLU
+from minitensor.model import Sequential
+
+# Serves the same model from 1, 2, 4, ... Python threads. The C++ kernels run
+# without the GIL, so throughput grows with the number of threads until the
+# cores are busy. Each op is kept single-threaded inside C++ so the scaling
+# comes from the Python threads alone.
+
+BATCH, FEATURES, HIDDEN, REQUESTS = 64, 512, 1024, 64
+random.seed(0)
+model = Sequential(
+    Linear(FEATURES, HIDDEN, dtype='float32'),
+    ReLU(),
+    Linear(HIDDEN, HIDDEN, dtype='float32'),
+    ReLU(),
+    Linear(HIDDEN, 10, dtype='float32'),
+).eval()
+batch = mt.tensor([[random.uniform(-1, 1) for _ in range(FEATURES)] for _ in range(BATCH)], dtype='float32')
+
+def serve(count):
+    with mt.no_grad():
+        for _ in range(count):
+            model(batch)
+
+mt.set_num_threads(1)
+baseline = None
+threads = 1
+while threads <= max(4, os.cpu_count() or 1):
+    workers = [threading.Thread(target=serve, args=(REQUESTS // threads,)) for _ in range(threads)]
+    start = time.perf_counter()
+    for worker in workers:
+        worker.start()
+    for worker in workers:
+        worker.join()
+    throughput = REQUESTS * BATCH / (time.perf_counter() - start)
+    baseline = baseline or throughput
+    print(f"{threads:2d} threads  {throughput:10.0f} samples/s  speedup {throughput / baseline:5.2f}x")
+    threads *= 2
\ No newline at end of file
@@ -4,7 +4,21 @@ from . import activations
 from . import losses
 from . import optims
 from .model import Module
+from .autograd import no_grad, is_grad_enabled, checkpoint, make_dual, jvp
+from .memory import memory_stats, reset_peak_memory_stats, step_arena, step_arena_stats
+from .parallel import get_num_threads, set_num_threads
+from .random import manual_seed, initial_seed
+from . import sparse
+from . import amp
+from . import distributed
+from .inference import InferenceEngine
+from .trainer import Trainer
+from .flat_params import FlatParameters
+from .foreach import grad_norm, clip_grad_norm, foreach_norm, foreach_scale, foreach_zero, foreach_axpy
+from .export import export, ExportedPlan
+from .attention import scaled_dot_product_attention
 from .tensor_math import (
     sqrt, log, exp, pow,
-    sin, cos, tan
+    sin, cos, tan,
+    is_fast_math, set_fast_math, fast_math
 )
\ No newline at end of file
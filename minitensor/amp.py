@@ -0,0 +1,124 @@
+from contextlib import contextmanager
+from typing import List
+from minitensor import Tensor
+from minitensor.backend import mtc, get_backend_of
+from minitensor.optims.sgd import SGD
+
+_PRECISIONS = ("bfloat16", "float16")
+
+@contextmanager
+def autocast(dtype: str = "bfloat16", enabled: bool = True):
+    """Runs matmul, Linear, elementwise ops and activations of float32 tensors in
+    reduced precision. Reductions, losses and softmax stay in float32.
+
+    Reduced precision is emulated: values are rounded to bfloat16 / float16 and
+    kept in float32 storage, so this reproduces the numerics, not the speed."""
+    if dtype not in _PRECISIONS:
+        raise ValueError(f"ERROR: autocast dtype must be one of {_PRECISIONS}, got '{dtype}'.")
+    previous = mtc.get_autocast()
+    mtc.set_autocast(dtype if enabled else "float32")
+    try:
+        yield
+    finally:
+        mtc.set_autocast(previous)
+
+def get_autocast_dtype() -> str:
+    return mtc.get_autocast()
+
+class MasterWeightOptimizer:
+    """Keeps float32 master copies of `params` and trains them with
+    `optimizer_cls(master_params, **kwargs)`. The model parameters hold values
+    rounded to `dtype`; after each step the updated masters are rounded back
+    into them."""
+
+    def __init__(self, params: List[Tensor], optimizer_cls=SGD, dtype: str = "bfloat16", **kwargs):
+        if dtype not in _PRECISIONS:
+            raise ValueError(f"ERROR: dtype must be one of {_PRECISIONS}, got '{dtype}'.")
+        self.params = list(params)
+        raw_params = [p._tensor if isinstance(p, Tensor) else p for p in self.params]
+        backend = get_backend_of(raw_params[0])
+        if not hasattr(backend, "MasterWeights"):
+            raise TypeError("ERROR: Master weights require floating point parameters.")
+
+        self.dtype = dtype
+        self._master = backend.MasterWeights(raw_params, dtype)
+        self.master_params = self._master.master_parameters()
+        self.optimizer = optimizer_cls(self.master_params, **kwargs)
+
+    @property
+    def lr(self) -> float:
+        return self.optimizer.lr
+
+    @lr.setter
+    def lr(self, value: float):
+        self.optimizer.lr = value
+
+    def step(self, inv_scale: float = 1.0) -> bool:
+        """Unscales the model gradients into the masters and updates them.
+        Returns False, without updating anything, when a gradient overflowed."""
+        if not self._master.unscale_grads(inv_scale):
+            return False
+        self.optimizer.step()
+        self._master.copy_to_model()
+        return True
+
+    def zero_grad(self):
+        self._master.zero_grad()
+
+class GradScaler:
+    """Dynamic loss scaling. The loss is multiplied by `scale` before backward so
+    small gradients survive float16; a step whose gradients overflow is skipped
+    and the scale is cut by `backoff_factor`, and after `growth_interval`
+    overflow-free steps it grows by `growth_factor`.
+
+        scaler.scale(loss).backward()
+        scaler.step(optimizer)
+        scaler.update()
+    """
+
+    def __init__(self, init_scale: float = 65536.0, growth_factor: float = 2.0,
+                 backoff_factor: float = 0.5, growth_interval: int = 2000, enabled: bool = True):
+        self._scale = float(init_scale)
+        self.growth_factor = growth_factor
+        self.backoff_factor = backoff_factor
+        self.growth_interval = growth_interval
+        self.enabled = enabled
+        self._growth_tracker = 0
+        self._found_inf = False
+        self.skipped_steps = 0
+
+    def get_scale(self) -> float:
+        return self._scale if self.enabled else 1.0
+
+    def scale(self, loss: Tensor) -> Tensor:
+        if not self.enabled:
+            return loss
+        return loss * self._scale
+
+    def step(self, optimizer) -> bool:
+        inv_scale = 1.0 / self.get_scale()
+        if isinstance(optimizer, MasterWeightOptimizer):
+            stepped = optimizer.step(inv_scale)
+        else:
+            raw_params = optimizer._raw_params
+            stepped = get_backend_of(raw_params[0]).unscale_grads(raw_params, inv_scale)
+            if stepped:
+                optimizer.step()
+
+        self._found_inf = not stepped
+        if not stepped:
+            self.skipped_steps += 1
+        return stepped
+
+    def update(self):
+        if not self.enabled:
+            return
+        if self._found_inf:
+            self._scale *= self.backoff_factor
+            self._growth_tracker = 0
+        else:
+            self._growth_tracker += 1
+            if self._growth_tracker >= self.growth_interval:
+                self._scale *= self.growth_factor
+                self._growth_tracker = 0
+        self._found_inf = False
\ No newline at end of file
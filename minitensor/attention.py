@@ -0,0 +1,26 @@
+from typing import Optional
+from minitensor.backend import get_backend
+from minitensor import Tensor
+
+def scaled_dot_product_attention(query: Tensor, key: Tensor, value: Tensor,
+                                 mask: Optional[Tensor] = None, causal: bool = False,
+                                 scale: Optional[float] = None) -> Tensor:
+    """softmax(query @ key^T * scale + mask) @ value over the last two dimensions.
+
+    query is [..., L, D], key [..., S, D] and value [..., S, Dv]. mask is an additive
+    [L, S] tensor (use -inf to hide a position); causal hides keys after each query.
+    The L x S score matrix is never stored, so memory grows linearly with L and S.
+    """
+    for t in (key, value, mask):
+        if t is not None and t.dtype != query.dtype:
+            raise TypeError("ERROR: Attention inputs must have the same dtype.")
+
+    backend = get_backend(query.dtype)
+
+    result = backend.scaled_dot_product_attention(
+        query._tensor, key._tensor, value._tensor,
+        mask._tensor if mask is not None else None,
+        causal, scale if scale is not None else 0.0
+    )
+
+    return Tensor._new_tensor(result, query.dtype)
\ No newline at end of file
@@ -0,0 +1,63 @@
+from contextlib import contextmanager
+from minitensor.backend import mtc, get_backend
+from minitensor.tensor import Tensor
+
+def is_grad_enabled() -> bool:
+    return mtc.is_grad_enabled()
+
+@contextmanager
+def no_grad():
+    previous = mtc.is_grad_enabled()
+    mtc.set_grad_enabled(False)
+    try:
+        yield
+    finally:
+        mtc.set_grad_enabled(previous)
+
+def checkpoint(segment, x: Tensor) -> Tensor:
+    backend = get_backend(x.dtype)
+    dtype = x.dtype
+
+    def run_segment(raw_input):
+        return segment(Tensor._new_tensor(raw_input, dtype))._tensor
+
+    result = backend.checkpoint(run_segment, x._tensor)
+    return Tensor._new_tensor(result, dtype)
+
+def make_dual(primal: Tensor, tangent: Tensor) -> Tensor:
+    """A tensor with primal's values that carries `tangent` through every op
+    with a forward-mode rule; read the result's tangent with `.tangent`."""
+    backend = get_backend(primal.dtype)
+    if not hasattr(backend, "make_dual"):
+        raise TypeError("ERROR: Forward-mode differentiation requires floating point tensors.")
+    return Tensor._new_tensor(backend.make_dual(primal._tensor, tangent._tensor), primal.dtype)
+
+def jvp(fn, primals, tangents):
+    """Evaluates fn(*primals) and its Jacobian-vector product with `tangents`
+    in one forward pass, without building a graph. primals and tangents are a
+    Tensor or matching sequences of Tensors; returns (outputs, output tangents)
+    shaped like fn's result."""
+    if isinstance(primals, Tensor):
+        primals, tangents = (primals,), (tangents,)
+    primals, tangents = tuple(primals), tuple(tangents)
+    if not primals:
+        raise ValueError("ERROR: jvp needs at least one primal.")
+    dtype = primals[0].dtype
+    backend = get_backend(dtype)
+    if not hasattr(backend, "jvp"):
+        raise TypeError("ERROR: Forward-mode differentiation requires floating point tensors.")
+
+    single_output = False
+
+    def run(raw_duals):
+        nonlocal single_output
+        result = fn(*(Tensor._new_tensor(raw, dtype) for raw in raw_duals))
+        single_output = isinstance(result, Tensor)
+        return [out._tensor for out in ((result,) if single_output else result)]
+
+    raw_outputs, raw_tangents = backend.jvp(run, [p._tensor for p in primals], [t._tensor for t in tangents])
+    outputs = tuple(Tensor._new_tensor(raw, dtype) for raw in raw_outputs)
+    output_tangents = tuple(Tensor._new_tensor(raw, dtype) for raw in raw_tangents)
+    if single_output:
+        return outputs[0], output_tangents[0]
+    return outputs, output_tangents
\ No newline at end of file
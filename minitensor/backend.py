@@ -16,4 +16,14 @@ def is_dtype_valid(dtype: str):
 
 def get_backend(dtype: str):
     if is_dtype_valid(dtype):
-        return DTYPE_BACKENDS[dtype]
\ No newline at end of file
+        return DTYPE_BACKENDS[dtype]
+
+def get_backend_of(raw_tensor):
+    for backend in (mtc.float32, mtc.float64, mtc.int32):
+        if isinstance(raw_tensor, backend.Tensor):
+            return backend
+    raise TypeError("ERROR: Unsupported tensor type.")
+
+def get_dtype_of(raw_tensor):
+    backend = get_backend_of(raw_tensor)
+    return next(dtype for dtype, b in DTYPE_BACKENDS.items() if b is backend)
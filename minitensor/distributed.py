@@ -0,0 +1,110 @@
+import multiprocessing
+import os
+import uuid
+from typing import Callable, Generator
+from minitensor import Tensor
+from minitensor.backend import mtc, get_backend_of
+from minitensor.model import Module
+
+_comm = None
+
+def init_process_group(rank: int, world_size: int, name: str, capacity_mb: float = 4.0, timeout: float = 300.0):
+    """Joins the group of `world_size` local processes sharing the segment `name`.
+    Blocks until every rank has joined."""
+    global _comm
+    if _comm is not None:
+        raise RuntimeError("ERROR: The process group is already initialized.")
+    _comm = mtc.ShmCommunicator(name, rank, world_size, int(capacity_mb * (1 << 20)), timeout)
+    return _comm
+
+def destroy_process_group():
+    global _comm
+    _comm = None
+
+def is_initialized() -> bool:
+    return _comm is not None
+
+def _group():
+    if _comm is None:
+        raise RuntimeError("ERROR: Call init_process_group first.")
+    return _comm
+
+def get_rank() -> int:
+    return _group().rank
+
+def get_world_size() -> int:
+    return _group().world_size
+
+def barrier():
+    _group().barrier()
+
+def all_reduce(tensor: Tensor, average: bool = False) -> Tensor:
+    """Sums `tensor` over all ranks in place (or averages it)."""
+    raw = tensor._tensor if isinstance(tensor, Tensor) else tensor
+    get_backend_of(raw).all_reduce(_group(), raw, average)
+    return tensor
+
+def broadcast(tensor: Tensor, root: int = 0) -> Tensor:
+    raw = tensor._tensor if isinstance(tensor, Tensor) else tensor
+    get_backend_of(raw).broadcast(_group(), raw, root)
+    return tensor
+
+def _worker(fn, rank, world_size, name, args):
+    init_process_group(rank, world_size, name)
+    try:
+        fn(rank, world_size, *args)
+    finally:
+        destroy_process_group()
+
+def spawn(fn: Callable, world_size: int, args: tuple = ()):
+    """Runs fn(rank, world_size, *args) in `world_size` forked processes that
+    are already joined to one process group, and waits for all of them."""
+    name = f"/minitensor_{os.getpid()}_{uuid.uuid4().hex[:8]}"
+    context = multiprocessing.get_context("fork")
+    processes = [context.Process(target=_worker, args=(fn, rank, world_size, name, args))
+                 for rank in range(world_size)]
+    for process in processes:
+        process.start()
+    for process in processes:
+        process.join()
+
+    failed = [rank for rank, process in enumerate(processes) if process.exitcode != 0]
+    if failed:
+        raise RuntimeError(f"ERROR: Ranks {failed} exited with an error.")
+
+class DistributedDataParallel(Module):
+    """Data-parallel wrapper for a Module. Parameters are copied from rank 0 on
+    construction; during backward, gradients are averaged across ranks bucket by
+    bucket while the rest of backward is still running, so after backward every
+    rank holds the same gradients and an ordinary optimizer keeps the replicas in
+    sync. Each rank should feed its own shard of the batch."""
+
+    def __init__(self, module: Module, bucket_cap_mb: float = 25.0, comm=None):
+        self.module = module
+        self.comm = comm or _group()
+        raw_params = [p._tensor if isinstance(p, Tensor) else p for p in module.parameters()]
+        if not raw_params:
+            raise ValueError("ERROR: DistributedDataParallel got a module without parameters.")
+        backend = get_backend_of(raw_params[0])
+        if not hasattr(backend, "GradReducer"):
+            raise TypeError("ERROR: DistributedDataParallel requires floating point parameters.")
+
+        self._reducer = backend.GradReducer(self.comm, raw_params, int(bucket_cap_mb * (1 << 20)))
+        self._reducer.broadcast_parameters()
+
+    @property
+    def training(self) -> bool:
+        return self.module.training
+
+    def train(self, mode: bool = True):
+        self.module.train(mode)
+        return self
+
+    def forward(self, *args) -> Tensor:
+        return self.module(*args)
+
+    def parameters(self) -> Generator[Tensor, None, None]:
+        yield from self.module.parameters()
+
+    def __repr__(self):
+        return f"DistributedDataParallel({self.module!r})"
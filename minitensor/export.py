@@ -0,0 +1,95 @@
+import threading
+from minitensor import Tensor
+from minitensor.backend import mtc, get_backend
+from minitensor.autograd import no_grad
+from minitensor.stages import model_stages
+
+class ExportedPlan:
+    """A model compiled into a float32 inference plan. `run` executes it in C++
+    without going through the Python layers; `save` writes the file that the
+    standalone `run_plan` program (tools/run_plan.cpp) loads."""
+
+    def __init__(self, plan, dtype: str = "float32", folded_norms: int = 0, fused_activations: int = 0):
+        self.plan = plan
+        self.dtype = dtype
+        self.backend = get_backend(dtype)
+        self.folded_norms = folded_norms
+        self.fused_activations = fused_activations
+        self._local = threading.local()
+
+    @classmethod
+    def load(cls, path: str, dtype: str = "float32"):
+        return cls(mtc.InferencePlan.load(path), dtype)
+
+    def save(self, path: str):
+        self.plan.save(path)
+
+    def to_bytes(self) -> bytes:
+        return self.plan.to_bytes()
+
+    @property
+    def input_features(self) -> int:
+        return self.plan.input_features
+
+    @property
+    def output_features(self) -> int:
+        return self.plan.output_features
+
+    def run(self, x: Tensor) -> Tensor:
+        # a runner owns its scratch buffers, so every thread gets its own
+        runner = getattr(self._local, "runner", None)
+        if runner is None:
+            runner = self._local.runner = mtc.PlanRunner(self.plan)
+        result = self.backend.run_plan(runner, x._tensor)
+        return Tensor._new_tensor(result, self.dtype)
+
+    def __call__(self, x: Tensor) -> Tensor:
+        return self.run(x)
+
+    def summary(self) -> str:
+        return self.plan.summary()
+
+    def __repr__(self):
+        return (f"ExportedPlan(input_features={self.input_features}, output_features={self.output_features}, "
+                f"steps={self.plan.num_steps}, arena_bytes={self.plan.arena_bytes})")
+
+def export(model, example_input: Tensor, path: str = None, check: bool = True) -> ExportedPlan:
+    """Compiles a Sequential of Linear, BatchNorm1d (eval mode), LayerNorm,
+    Dropout (skipped) and activation modules (or a single Linear) into an
+    ExportedPlan.
+
+    Batch norms next to a Linear are folded into its weights, activations are
+    fused into the step before them, and intermediate results share two
+    preallocated buffers sized for example_input's batch; larger batches run
+    in chunks of that size. With `check`, the plan's output on example_input
+    is compared against the model's. Writes the plan to `path` if given."""
+    if len(example_input.shape) != 2:
+        raise ValueError("ERROR: example_input must have shape [batch, features].")
+    backend = get_backend(example_input.dtype)
+    if not hasattr(backend, "PlanBuilder"):
+        raise TypeError("ERROR: export requires a floating point model.")
+
+    builder = backend.PlanBuilder(example_input.shape[1])
+    for kind, arg in model_stages(model, "export"):
+        if kind == "linear":
+            builder.add_linear(arg._linear)
+        elif kind == "activation":
+            builder.add_activation(arg)
+        elif kind == "batch_norm":
+            builder.add_batch_norm(arg._norm)
+        elif kind == "layer_norm":
+            builder.add_layer_norm(arg._norm)
+
+    exported = ExportedPlan(builder.build(example_input.shape[0]), example_input.dtype,
+                            builder.folded_norms, builder.fused_activations)
+    if check:
+        with no_grad():
+            expected = model(example_input).listed
+        actual = exported.run(example_input).listed
+        scale = max([1.0] + [abs(v) for v in expected])
+        error = max(abs(a - e) for a, e in zip(actual, expected))
+        if error > 1e-3 * scale:
+            raise RuntimeError(f"ERROR: Exported plan differs from the model by {error:.3g}.")
+    if path is not None:
+        exported.save(path)
+    return exported
\ No newline at end of file
@@ -0,0 +1,67 @@
+from minitensor import Tensor
+from minitensor.backend import get_backend_of, get_dtype_of
+
+class FlatParameters:
+    """Moves the parameters of a module (or a list of parameters) into one
+    contiguous buffer. Each parameter and its gradient become views into the
+    flat buffers, so the model trains as before, and `parameter` (the whole
+    buffer, whose grad is the whole gradient) can be handed to an optimizer to
+    update every parameter in one pass:
+
+        flat = FlatParameters(model)
+        optimizer = SGD([flat.parameter], lr=0.1)
+
+    Gradient norms, clipping, checkpoints and all-reduce are then single-buffer
+    operations. Replacing a parameter's grad (rather than zeroing it) detaches
+    it from the flat gradient."""
+
+    def __init__(self, params):
+        if hasattr(params, "parameters"):
+            params = params.parameters()
+        params = list(params)
+        raw = [p._tensor if isinstance(p, Tensor) else p for p in params]
+        if not raw:
+            raise ValueError("ERROR: FlatParameters got an empty parameter list.")
+        self.backend = get_backend_of(raw[0])
+        if not hasattr(self.backend, "FlatParameters"):
+            raise TypeError("ERROR: FlatParameters requires floating point parameters.")
+        self.dtype = get_dtype_of(raw[0])
+        self._flat = self.backend.FlatParameters(raw)
+
+    @property
+    def parameter(self) -> Tensor:
+        return Tensor._new_tensor(self._flat.flat, self.dtype, True)
+
+    def __len__(self) -> int:
+        return self._flat.size
+
+    def grad_norm(self) -> float:
+        return self._flat.grad_norm()
+
+    def clip_grad_norm(self, max_norm: float) -> float:
+        """Scales the gradient so that its L2 norm is at most `max_norm`;
+        returns the norm before clipping."""
+        return self._flat.clip_grad_norm(max_norm)
+
+    def scale_grad(self, alpha: float):
+        self._flat.scale_grad(alpha)
+
+    def zero_grad(self):
+        self._flat.zero_grad()
+
+    def all_reduce_grad(self, average: bool = True):
+        """Averages (or sums) the whole gradient over the process group in a
+        single collective."""
+        from minitensor.distributed import _group
+        self._flat.all_reduce_grad(_group(), average)
+
+    def broadcast(self, root: int = 0):
+        from minitensor.distributed import _group
+        self._flat.broadcast(_group(), root)
+
+    def save(self, path: str):
+        self._flat.save(path)
+
+    def load(self, path: str):
+        """Loads a file written by save() for parameters of the same sizes."""
+        self._flat.load(path)
\ No newline at end of file
@@ -0,0 +1,46 @@
+from typing import Iterable, List
+from minitensor import Tensor
+from minitensor.backend import get_backend_of
+
+# Multi-tensor kernels: each call makes one parallel pass over all the tensors
+# instead of one C++ call per tensor. Tensors stored back to back (see
+# FlatParameters) are processed as a single buffer.
+
+def _raw(tensors: Iterable) -> List:
+    raw = [t._tensor if isinstance(t, Tensor) else t for t in tensors]
+    if not raw:
+        raise ValueError("ERROR: foreach operations need at least one tensor.")
+    backend = get_backend_of(raw[0])
+    if not hasattr(backend, "foreach_norm"):
+        raise TypeError("ERROR: foreach operations require floating point tensors.")
+    return raw, backend
+
+def foreach_norm(tensors: Iterable[Tensor]) -> float:
+    """Global L2 norm of all the tensors together."""
+    raw, backend = _raw(tensors)
+    return backend.foreach_norm(raw)
+
+def foreach_scale(tensors: Iterable[Tensor], alpha: float):
+    raw, backend = _raw(tensors)
+    backend.foreach_scale(raw, alpha)
+
+def foreach_zero(tensors: Iterable[Tensor]):
+    raw, backend = _raw(tensors)
+    backend.foreach_zero(raw)
+
+def foreach_axpy(ys: Iterable[Tensor], xs: Iterable[Tensor], alpha: float):
+    """ys[k] += alpha * xs[k] for every k."""
+    raw_ys, backend = _raw(ys)
+    raw_xs, _ = _raw(xs)
+    backend.foreach_axpy(raw_ys, raw_xs, alpha)
+
+def grad_norm(params: Iterable[Tensor]) -> float:
+    """Global L2 norm of the parameters' gradients."""
+    raw, backend = _raw(params)
+    return backend.grad_norm(raw)
+
+def clip_grad_norm(params: Iterable[Tensor], max_norm: float) -> float:
+    """Scales the gradients so that their global L2 norm is at most
+    `max_norm`; returns the norm before clipping."""
+    raw, backend = _raw(params)
+    return backend.clip_grad_norm(raw, max_norm)
\ No newline at end of file
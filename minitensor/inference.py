@@ -0,0 +1,83 @@
+from typing import List, Sequence
+from minitensor import Tensor
+from minitensor.stages import model_stages
+
+def _build_model(model):
+    """Translates a Sequential of Linear layers and activations (or a single
+    Linear) into a C++ InferenceModel that shares the layers' weights."""
+    stages = list(model_stages(model, "InferenceEngine"))
+    linears = [arg for kind, arg in stages if kind == "linear"]
+    if not linears:
+        raise ValueError("ERROR: InferenceEngine needs at least one Linear layer.")
+    dtype, backend = linears[0].dtype, linears[0].backend
+    if not hasattr(backend, "BatchingEngine"):
+        raise TypeError("ERROR: InferenceEngine requires floating point layers.")
+    if any(linear.dtype != dtype for linear in linears):
+        raise TypeError("ERROR: All Linear layers must have the same dtype.")
+
+    compiled = backend.InferenceModel()
+    for kind, arg in stages:
+        if kind == "linear":
+            compiled.add_linear(arg._linear)
+        elif kind == "activation":
+            compiled.add_activation(arg)
+        elif kind != "dropout":
+            raise TypeError(f"ERROR: InferenceEngine supports Linear layers and activations, got {type(arg).__name__}.")
+    return compiled, dtype, backend
+
+class InferenceEngine:
+    """Serves single-row requests for an MLP from many threads at once.
+    Requests are queued and grouped into batches: a batch runs as soon as it
+    holds `max_batch_size` rows or its oldest row has waited `max_latency_ms`,
+    and each caller gets back its own output row. Calls release the GIL while
+    they wait, so Python threads can submit concurrently.
+
+    The engine reads the model's weights in place; updating them while the
+    engine is serving is a data race."""
+
+    def __init__(self, model, max_batch_size: int = 32, max_latency_ms: float = 2.0, num_workers: int = 1):
+        self.model = model
+        self._model, self.dtype, self.backend = _build_model(model)
+        self._engine = self.backend.BatchingEngine(self._model, max_batch_size, max_latency_ms, num_workers)
+
+    @property
+    def input_features(self) -> int:
+        return self._model.input_features
+
+    @property
+    def output_features(self) -> int:
+        return self._model.output_features
+
+    def infer(self, row) -> List[float]:
+        """Runs one request and blocks until its batch has been computed."""
+        if isinstance(row, Tensor):
+            row = row.listed
+        return self._engine.infer(row)
+
+    def infer_many(self, rows: Sequence) -> List[List[float]]:
+        """Submits every row as its own request and waits for all of them."""
+        if isinstance(rows, Tensor):
+            rows = rows.nested
+        return self._engine.infer_many(rows)
+
+    def stats(self) -> dict:
+        """Request and batch counts, latency percentiles in microseconds and
+        `batch_sizes`, where batch_sizes[b] counts the batches of b rows."""
+        return self._engine.stats()
+
+    def reset_stats(self):
+        self._engine.reset_stats()
+
+    def close(self):
+        """Finishes the queued requests and stops the workers."""
+        self._engine.shutdown()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def __repr__(self):
+        return (f"InferenceEngine(max_batch_size={self._engine.max_batch_size}, "
+                f"max_latency_ms={self._engine.max_latency_ms})")
\ No newline at end of file
@@ -1 +1,8 @@
-from .linear import Linear
\ No newline at end of file
+from .linear import Linear
+from .conv2d import Conv2d
+from .pooling import MaxPool2d, AvgPool2d
+from .embedding import Embedding
+from .normalization import LayerNorm, BatchNorm1d
+from .recurrent import LSTM, GRU
+from .dropout import Dropout
+from .ensemble_linear import EnsembleLinear
\ No newline at end of file
@@ -0,0 +1,74 @@
+from typing import Generator, Optional
+from minitensor.backend import get_backend
+from minitensor import Tensor
+from minitensor.model import Module
+
+class Conv2d(Module):
+    def __init__(self,
+        in_channels: int,
+        out_channels: int,
+        kernel_size: int,
+        stride: int = 1,
+        padding: int = 0,
+        dilation: int = 1,
+        groups: int = 1,
+        activation: Optional[str] = None,
+        dtype: str = "float32",
+        weight_init = None,
+        bias_init = None
+        ):
+
+        self.in_channels = in_channels
+        self.out_channels = out_channels
+        self.kernel_size = kernel_size
+        self.activation = activation
+        self.dtype = dtype
+
+        self.backend = get_backend(self.dtype)
+
+        self.activation_fn = None
+        if self.activation == "tanh":
+            self.activation_fn = self.backend.tanh
+
+        elif self.activation == "relu":
+            self.activation_fn = self.backend.relu
+
+        if weight_init is None:
+            if 'float' in self.dtype or 'double' in self.dtype:
+                weight_init = self.backend.HeNormal()
+            else:
+                weight_init = self.backend.Constant(1)
+
+        if bias_init is None:
+            bias_init = self.backend.Constant(0.0 if 'float' in self.dtype or 'double' in self.dtype else 0)
+
+        self._conv = self.backend.Conv2d(in_channels, out_channels, kernel_size,
+                                         stride, padding, dilation, groups, weight_init, bias_init)
+
+        self._params = self._conv.parameters()
+
+    def forward(self, x: Tensor) -> Tensor:
+        result = self._conv.forward(x._tensor)
+
+        if self.activation_fn:
+            result = self.activation_fn(result)
+
+        return Tensor._new_tensor(result, self.dtype, x.requires_grad)
+
+    @property
+    def weight(self) -> Tensor:
+        return self._params[0]
+
+    @property
+    def bias(self) -> Tensor:
+        return self._params[1]
+
+    def parameters(self) -> Generator[Tensor, None, None]:
+        yield from self._params
+
+    def __repr__(self):
+        base_repr = repr(self._conv)
+        if self.activation:
+            return f"{base_repr[:-1]}, activation='{self.activation}')"
+        else:
+            return base_repr
@@ -0,0 +1,28 @@
+from minitensor.backend import get_backend
+from minitensor import Tensor
+from minitensor.model import Module
+
+class Dropout(Module):
+    def __init__(self, p: float = 0.5, dtype: str = "float32"):
+        if 'float' not in dtype and 'double' not in dtype:
+            raise TypeError("ERROR: Dropout requires a floating point dtype.")
+
+        self.p = p
+        self.dtype = dtype
+
+        self.backend = get_backend(self.dtype)
+
+        self._dropout = self.backend.Dropout(p)
+
+    def train(self, mode: bool = True):
+        super().train(mode)
+        self._dropout.training = mode
+        return self
+
+    def forward(self, x: Tensor) -> Tensor:
+        result = self._dropout.forward(x._tensor)
+
+        return Tensor._new_tensor(result, self.dtype, x.requires_grad)
+
+    def __repr__(self):
+        return repr(self._dropout)
\ No newline at end of file
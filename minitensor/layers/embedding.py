@@ -0,0 +1,50 @@
+from typing import Generator, List, Union
+from minitensor.backend import get_backend
+from minitensor import Tensor, tensor
+from minitensor.model import Module
+
+class Embedding(Module):
+    def __init__(self,
+        num_embeddings: int,
+        embedding_dim: int,
+        sparse: bool = True,
+        dtype: str = "float32",
+        weight_init = None
+        ):
+
+        if 'float' not in dtype and 'double' not in dtype:
+            raise TypeError("ERROR: Embedding requires a floating point dtype.")
+
+        self.num_embeddings = num_embeddings
+        self.embedding_dim = embedding_dim
+        self.sparse = sparse
+        self.dtype = dtype
+
+        self.backend = get_backend(self.dtype)
+
+        if weight_init is None:
+            weight_init = self.backend.HeNormal()
+
+        self._embedding = self.backend.Embedding(num_embeddings, embedding_dim, sparse, weight_init)
+
+        self._params = self._embedding.parameters()
+
+    def forward(self, indices: Union[Tensor, List[int]]) -> Tensor:
+        if not isinstance(indices, Tensor):
+            indices = tensor(indices, dtype="int32")
+        if indices.dtype not in ("int32", "int"):
+            raise TypeError("ERROR: Embedding indices must be an int32 tensor.")
+
+        result = self._embedding.forward(indices._tensor)
+
+        return Tensor._new_tensor(result, self.dtype)
+
+    @property
+    def weight(self) -> Tensor:
+        return self._params[0]
+
+    def parameters(self) -> Generator[Tensor, None, None]:
+        yield from self._params
+
+    def __repr__(self):
+        return repr(self._embedding)
@@ -0,0 +1,98 @@
+from typing import Generator, List, Optional
+from minitensor.backend import get_backend
+from minitensor import Tensor
+from minitensor.model import Module
+from minitensor.layers.linear import Linear
+
+class EnsembleLinear(Module):
+    """`num_models` independent Linear layers of the same shape, stacked so
+    that one forward, one backward node and one optimizer step cover all of
+    them. The input is [num_models, batch, in] (a batch per model) or
+    [batch, in] (the same batch for every model); the output is
+    [num_models, batch, out]. Activations work on the stacked output as is.
+
+    A mean loss over the stacked output averages the models' losses; multiply
+    it by num_models to give every model the gradient it would get alone."""
+
+    def __init__(self,
+        num_models: int,
+        input_features: int,
+        output_features: int,
+        activation: Optional[str] = None,
+        dtype: str = "float32",
+        weight_init = None,
+        bias_init = None
+        ):
+
+        if 'float' not in dtype and 'double' not in dtype:
+            raise TypeError("ERROR: EnsembleLinear requires a floating point dtype.")
+
+        self.num_models = num_models
+        self.input_f = input_features
+        self.output_f = output_features
+        self.activation = activation
+        self.dtype = dtype
+
+        self.backend = get_backend(self.dtype)
+
+        self.activation_fn = None
+        if self.activation == "tanh":
+            self.activation_fn = self.backend.tanh
+
+        elif self.activation == "relu":
+            self.activation_fn = self.backend.relu
+
+        if weight_init is None:
+            weight_init = self.backend.HeNormal()
+
+        if bias_init is None:
+            bias_init = self.backend.Constant(0.0)
+
+        self._ensemble = self.backend.EnsembleLinear(num_models, input_features, output_features, weight_init, bias_init)
+
+        self._params = self._ensemble.parameters()
+
+    @classmethod
+    def stack(cls, layers: List[Linear]) -> "EnsembleLinear":
+        """Builds an ensemble whose members start as copies of `layers`."""
+        if not layers:
+            raise ValueError("ERROR: EnsembleLinear.stack needs at least one Linear layer.")
+        first = layers[0]
+        ensemble = cls(len(layers), first.input_f, first.output_f, first.activation, first.dtype)
+        for index, layer in enumerate(layers):
+            if layer.dtype != first.dtype or layer.activation != first.activation:
+                raise TypeError("ERROR: Stacked Linear layers must share dtype and activation.")
+            ensemble._ensemble.load_member(index, layer._linear)
+        return ensemble
+
+    def member(self, index: int) -> Linear:
+        """Returns a standalone Linear with a copy of model `index`."""
+        layer = Linear(self.input_f, self.output_f, self.activation, self.dtype)
+        self._ensemble.store_member(index, layer._linear)
+        return layer
+
+    def forward(self, x: Tensor) -> Tensor:
+        result = self._ensemble.forward(x._tensor)
+
+        if self.activation_fn:
+            result = self.activation_fn(result)
+
+        return Tensor._new_tensor(result, self.dtype, x.requires_grad)
+
+    @property
+    def weight(self) -> Tensor:
+        return self._params[0]
+
+    @property
+    def bias(self) -> Tensor:
+        return self._params[1]
+
+    def parameters(self) -> Generator[Tensor, None, None]:
+        yield from self._params
+
+    def __repr__(self):
+        base_repr = repr(self._ensemble)
+        if self.activation:
+            return f"{base_repr[:-1]}, activation='{self.activation}')"
+        else:
+            return base_repr
\ No newline at end of file
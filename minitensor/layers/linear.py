@@ -2,6 +2,7 @@ from typing import Generator, Optional
 from minitensor.backend import get_backend
 from minitensor import Tensor
 from minitensor.model import Module
+from minitensor.sparse import SparseTensor
 
 class Linear(Module):
     def __init__(self,
@@ -41,7 +42,10 @@ class Linear(Module):
         self._params = self._linear.parameters()
 
     def forward(self, x: Tensor) -> Tensor:
-        result = self._linear.forward(x._tensor)
+        if isinstance(x, SparseTensor):
+            result = self._linear.forward(x._sparse)
+        else:
+            result = self._linear.forward(x._tensor)
 
         if self.activation_fn:
             result = self.activation_fn(result)
@@ -0,0 +1,80 @@
+from typing import Generator
+from minitensor.backend import get_backend
+from minitensor import Tensor
+from minitensor.model import Module
+
+class LayerNorm(Module):
+    def __init__(self,
+        normalized_shape: int,
+        eps: float = 1e-5,
+        elementwise_affine: bool = True,
+        dtype: str = "float32"
+        ):
+
+        if 'float' not in dtype and 'double' not in dtype:
+            raise TypeError("ERROR: LayerNorm requires a floating point dtype.")
+
+        self.normalized_shape = normalized_shape
+        self.dtype = dtype
+
+        self.backend = get_backend(self.dtype)
+
+        self._norm = self.backend.LayerNorm(normalized_shape, eps, elementwise_affine)
+
+        self._params = self._norm.parameters()
+
+    def forward(self, x: Tensor) -> Tensor:
+        result = self._norm.forward(x._tensor)
+
+        return Tensor._new_tensor(result, self.dtype)
+
+    def parameters(self) -> Generator[Tensor, None, None]:
+        yield from self._params
+
+    def __repr__(self):
+        return repr(self._norm)
+
+class BatchNorm1d(Module):
+    def __init__(self,
+        num_features: int,
+        eps: float = 1e-5,
+        momentum: float = 0.1,
+        affine: bool = True,
+        dtype: str = "float32"
+        ):
+
+        if 'float' not in dtype and 'double' not in dtype:
+            raise TypeError("ERROR: BatchNorm1d requires a floating point dtype.")
+
+        self.num_features = num_features
+        self.dtype = dtype
+
+        self.backend = get_backend(self.dtype)
+
+        self._norm = self.backend.BatchNorm1d(num_features, eps, momentum, affine)
+
+        self._params = self._norm.parameters()
+
+    def train(self, mode: bool = True):
+        super().train(mode)
+        self._norm.training = mode
+        return self
+
+    def forward(self, x: Tensor) -> Tensor:
+        result = self._norm.forward(x._tensor)
+
+        return Tensor._new_tensor(result, self.dtype)
+
+    @property
+    def running_mean(self) -> Tensor:
+        return Tensor._new_tensor(self._norm.running_mean, self.dtype, False)
+
+    @property
+    def running_var(self) -> Tensor:
+        return Tensor._new_tensor(self._norm.running_var, self.dtype, False)
+
+    def parameters(self) -> Generator[Tensor, None, None]:
+        yield from self._params
+
+    def __repr__(self):
+        return repr(self._norm)
\ No newline at end of file
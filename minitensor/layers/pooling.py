@@ -0,0 +1,36 @@
+from typing import Optional
+from minitensor.backend import get_backend
+from minitensor import Tensor
+from minitensor.model import Module
+
+class MaxPool2d(Module):
+    def __init__(self, kernel_size: int, stride: Optional[int] = None, padding: int = 0):
+        self.kernel_size = kernel_size
+        self.stride = stride if stride is not None else kernel_size
+        self.padding = padding
+
+    def forward(self, x: Tensor) -> Tensor:
+        backend = get_backend(x.dtype)
+
+        result = backend.max_pool2d(x._tensor, self.kernel_size, self.stride, self.padding)
+
+        return Tensor._new_tensor(result, x.dtype, x.requires_grad)
+
+    def __repr__(self) -> str:
+        return f"MaxPool2d(kernel_size={self.kernel_size}, stride={self.stride}, padding={self.padding})"
+
+class AvgPool2d(Module):
+    def __init__(self, kernel_size: int, stride: Optional[int] = None, padding: int = 0):
+        self.kernel_size = kernel_size
+        self.stride = stride if stride is not None else kernel_size
+        self.padding = padding
+
+    def forward(self, x: Tensor) -> Tensor:
+        backend = get_backend(x.dtype)
+
+        result = backend.avg_pool2d(x._tensor, self.kernel_size, self.stride, self.padding)
+
+        return Tensor._new_tensor(result, x.dtype, x.requires_grad)
+
+    def __repr__(self) -> str:
+        return f"AvgPool2d(kernel_size={self.kernel_size}, stride={self.stride}, padding={self.padding})"
\ No newline at end of file
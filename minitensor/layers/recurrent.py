@@ -0,0 +1,76 @@
+from typing import Generator, Optional, Tuple
+from minitensor.backend import get_backend
+from minitensor import Tensor
+from minitensor.model import Module
+
+class _Recurrent(Module):
+    _backend_cls = None
+
+    def __init__(self,
+        input_size: int,
+        hidden_size: int,
+        return_sequences: bool = True,
+        return_state: bool = False,
+        dtype: str = "float32",
+        weight_init = None,
+        bias_init = None
+        ):
+
+        if 'float' not in dtype and 'double' not in dtype:
+            raise TypeError("ERROR: Recurrent layers require a floating point dtype.")
+
+        self.input_size = input_size
+        self.hidden_size = hidden_size
+        self.return_sequences = return_sequences
+        self.return_state = return_state
+        self.dtype = dtype
+
+        self.backend = get_backend(self.dtype)
+
+        if weight_init is None:
+            weight_init = self.backend.XavierUniform()
+
+        if bias_init is None:
+            bias_init = self.backend.Constant(0.0)
+
+        self._rnn = getattr(self.backend, self._backend_cls)(input_size, hidden_size, weight_init, bias_init)
+
+        self._params = self._rnn.parameters()
+
+    def parameters(self) -> Generator[Tensor, None, None]:
+        yield from self._params
+
+    def __repr__(self):
+        return repr(self._rnn)
+
+class LSTM(_Recurrent):
+    """Input is [steps, batch, input_size]. Returns the hidden states of every step
+    ([steps, batch, hidden]) or of the last one ([batch, hidden]). With
+    return_state=True, also returns the detached final state (h_n, c_n)."""
+
+    _backend_cls = "LSTM"
+
+    def forward(self, x: Tensor, state: Optional[Tuple[Tensor, Tensor]] = None):
+        h0, c0 = (state[0]._tensor, state[1]._tensor) if state is not None else (None, None)
+
+        output, h_n, c_n = self._rnn.forward(x._tensor, h0, c0, self.return_sequences)
+
+        output = Tensor._new_tensor(output, self.dtype)
+        if self.return_state:
+            return output, (Tensor._new_tensor(h_n, self.dtype, False), Tensor._new_tensor(c_n, self.dtype, False))
+        return output
+
+class GRU(_Recurrent):
+    """Like LSTM, but the state is a single hidden tensor h_n."""
+
+    _backend_cls = "GRU"
+
+    def forward(self, x: Tensor, state: Optional[Tensor] = None):
+        h0 = state._tensor if state is not None else None
+
+        output, h_n, _ = self._rnn.forward(x._tensor, h0, self.return_sequences)
+
+        output = Tensor._new_tensor(output, self.dtype)
+        if self.return_state:
+            return output, Tensor._new_tensor(h_n, self.dtype, False)
+        return output
\ No newline at end of file
@@ -0,0 +1,22 @@
+from contextlib import contextmanager
+from minitensor.backend import mtc
+
+def memory_stats() -> dict:
+    return mtc.memory_stats()
+
+def reset_peak_memory_stats():
+    mtc.reset_peak_memory_stats()
+
+@contextmanager
+def step_arena():
+    """Allocates the step's temporaries (tensor buffers, autograd nodes) from a
+    per-thread bump arena that is rewound when the block exits. Parameters and
+    leaf gradients stay on the heap; tensors kept past the block stay valid."""
+    mtc.step_arena_enter()
+    try:
+        yield
+    finally:
+        mtc.step_arena_exit()
+
+def step_arena_stats() -> dict:
+    return mtc.step_arena_stats()
\ No newline at end of file
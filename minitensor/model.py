@@ -1,10 +1,20 @@
 from typing import Generator
 from .tensor import Tensor
+from .autograd import checkpoint, is_grad_enabled
 
 class Module:
+    training = True
+
     def forward(self, *args):
         raise NotImplementedError
 
+    def train(self, mode: bool = True):
+        self.training = mode
+        return self
+
+    def eval(self):
+        return self.train(False)
+
     def parameters(self) -> Generator[Tensor, None, None]:
         yield from ()
 
@@ -12,17 +22,39 @@ class Module:
         return self.forward(*args)
 
 class Sequential(Module):
-    def __init__(self, *layers):
+    def __init__(self, *layers, checkpoint_every: int = 0):
         if not all(isinstance(layer, Module) for layer in layers):
             raise TypeError("ERROR: All inputs to Sequential must be instances of Module (layers or activations).")
+        if checkpoint_every < 0:
+            raise ValueError("ERROR: checkpoint_every must be non-negative.")
         self.layers = layers
+        self.checkpoint_every = checkpoint_every
+
+        self._segments = []
+        if checkpoint_every > 0:
+            self._segments = [
+                Sequential(*layers[i:i + checkpoint_every])
+                for i in range(0, len(layers), checkpoint_every)
+            ]
 
     def forward(self, x: Tensor) -> Tensor:
+        if self._segments and is_grad_enabled():
+            out = x
+            for segment in self._segments:
+                out = checkpoint(segment, out)
+            return out
+
         out = x
         for layer in self.layers:
             out = layer(out)
         return out
         
+    def train(self, mode: bool = True):
+        super().train(mode)
+        for layer in self.layers:
+            layer.train(mode)
+        return self
+
     def parameters(self) -> Generator[Tensor, None, None]:
         for layer in self.layers:
             yield from layer.parameters()
\ No newline at end of file
@@ -1 +1,3 @@
-from .sgd import SGD
\ No newline at end of file
+from .sgd import SGD
+from .adam import Adam
+from .hogwild import Hogwild
\ No newline at end of file
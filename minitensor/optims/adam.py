@@ -0,0 +1,11 @@
+from typing import List, Tuple
+from minitensor import Tensor
+from minitensor.optims.optimizer import Optimizer
+
+class Adam(Optimizer):
+    def __init__(self, params: List[Tensor], lr: float = 0.001,
+                 betas: Tuple[float, float] = (0.9, 0.999), eps: float = 1e-8):
+        super().__init__(params)
+        if not hasattr(self.backend, "Adam"):
+            raise TypeError("ERROR: Adam requires floating point parameters.")
+        self._optim = self.backend.Adam(self._raw_params, lr, betas[0], betas[1], eps)
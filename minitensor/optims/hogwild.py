@@ -0,0 +1,62 @@
+import os
+from minitensor import Tensor
+from minitensor.stages import model_stages
+
+_ACTIVATIONS = ("relu", "tanh", "sigmoid")
+_LOSSES = ("mse", "mae", "bce")
+
+def _mlp_spec(model):
+    """Splits a Sequential of Linear layers and one repeated activation (or a
+    single Linear) into the raw layers and the activation name."""
+    stages = list(model_stages(model, "Hogwild"))
+    layers, activations = [], set()
+    for kind, arg in stages:
+        if kind == "linear":
+            layers.append(arg)
+        elif kind == "activation" and arg in _ACTIVATIONS:
+            activations.add(arg)
+        else:
+            name = arg if kind == "activation" else type(arg).__name__
+            raise TypeError(f"ERROR: Hogwild supports Linear layers and ReLU/Tanh/Sigmoid, got {name}.")
+    if not layers:
+        raise ValueError("ERROR: Hogwild needs at least one Linear layer.")
+    if stages[-1][0] == "activation":
+        raise ValueError("ERROR: Hogwild applies no activation after the last Linear layer.")
+    if len(activations) > 1:
+        raise ValueError("ERROR: Hogwild needs the same activation between all layers.")
+    return layers, activations.pop() if activations else "none"
+
+class Hogwild:
+    """Lock-free asynchronous SGD (Hogwild!) for an MLP. `num_workers` C++
+    threads share the model's parameters; each one trains on its own random
+    mini-batches with a thread-local graph and applies its updates to the
+    shared weights without locking. The activation follows every layer but the
+    last; for loss="bce" a sigmoid is applied to the output.
+
+    With num_workers=1 this is plain single-threaded SGD, the baseline to
+    compare throughput and convergence against."""
+
+    def __init__(self, model, lr: float = 0.01, num_workers: int = None,
+                 loss: str = "mse", batch_size: int = 32, seed: int = 0):
+        if loss not in _LOSSES:
+            raise ValueError(f"ERROR: loss must be one of {_LOSSES}, got '{loss}'.")
+        self.layers, self.activation = _mlp_spec(model)
+        self.dtype = self.layers[0].dtype
+        self.backend = self.layers[0].backend
+        if not hasattr(self.backend, "hogwild_train"):
+            raise TypeError("ERROR: Hogwild requires floating point layers.")
+        self.lr = lr
+        self.num_workers = num_workers or os.cpu_count() or 1
+        self.loss = loss
+        self.batch_size = batch_size
+        self.seed = seed
+
+    def fit(self, x: Tensor, y: Tensor, steps_per_worker: int) -> dict:
+        """Runs `steps_per_worker` steps on every worker and returns
+        steps, seconds, steps_per_second and the workers' mean final loss."""
+        report = self.backend.hogwild_train(
+            [layer._linear for layer in self.layers], x._tensor, y._tensor,
+            self.activation, self.loss, self.lr, self.num_workers,
+            self.batch_size, steps_per_worker, self.seed)
+        self.seed += 1
+        return report
\ No newline at end of file
@@ -0,0 +1,27 @@
+from typing import List
+from minitensor import Tensor
+from minitensor.backend import get_backend_of
+
+class Optimizer:
+    def __init__(self, params: List[Tensor]):
+        self.params = list(params)
+        if not self.params:
+            raise ValueError("ERROR: Optimizer got an empty parameter list.")
+
+        self._raw_params = [p._tensor if isinstance(p, Tensor) else p for p in self.params]
+        self.backend = get_backend_of(self._raw_params[0])
+        self._optim = None
+
+    @property
+    def lr(self) -> float:
+        return self._optim.lr
+
+    @lr.setter
+    def lr(self, value: float):
+        self._optim.lr = value
+
+    def step(self):
+        self._optim.step()
+
+    def zero_grad(self):
+        self._optim.zero_grad()
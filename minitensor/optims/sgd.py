@@ -1,18 +1,10 @@
 from typing import List
 from minitensor import Tensor
+from minitensor.optims.optimizer import Optimizer
 
-class SGD:
+class SGD(Optimizer):
     def __init__(self, params: List[Tensor], lr: float = 0.01):
-        self.params = params
-        self.lr = lr
-
-    def step(self):
-        for p in self.params:
-            if p.grad is not None:
-                updated_tensor = p - (self.lr * p.grad)
-                p.set_data(updated_tensor)
-
-    def zero_grad(self):
-        for p in self.params:
-            if p.grad is not None:
-                p.zero_grad()
\ No newline at end of file
+        super().__init__(params)
+        if not hasattr(self.backend, "SGD"):
+            raise TypeError("ERROR: SGD requires floating point parameters.")
+        self._optim = self.backend.SGD(self._raw_params, lr)
@@ -0,0 +1,7 @@
+from minitensor.backend import mtc
+
+def get_num_threads() -> int:
+    return mtc.get_num_threads()
+
+def set_num_threads(threads: int):
+    mtc.set_num_threads(threads)
\ No newline at end of file
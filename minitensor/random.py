@@ -0,0 +1,9 @@
+from minitensor.backend import mtc
+
+def manual_seed(seed: int):
+    """Seeds the global generator behind weight initialization and dropout.
+    Draws after the same seed are bit-identical for any number of threads."""
+    mtc.manual_seed(seed)
+
+def initial_seed() -> int:
+    return mtc.initial_seed()
\ No newline at end of file
@@ -0,0 +1,64 @@
+from typing import List, Optional, Sequence
+from minitensor.backend import get_backend
+from minitensor.tensor import Tensor
+
+def _infer_dtype(values: Sequence, dtype: Optional[str]) -> str:
+    if dtype is not None:
+        return dtype
+    if values and all(isinstance(v, int) for v in values):
+        return "int32"
+    return "float32"
+
+class SparseTensor:
+    """2D CSR matrix. Build it with sparse_coo_tensor, sparse_csr_tensor or to_sparse."""
+
+    def __init__(self, sparse, dtype: str):
+        self._sparse = sparse
+        self.dtype = dtype
+        self.backend = get_backend(dtype)
+
+    @property
+    def shape(self) -> tuple:
+        return tuple(self._sparse.shape)
+
+    @property
+    def nnz(self) -> int:
+        return self._sparse.nnz
+
+    @property
+    def requires_grad(self) -> bool:
+        return False
+
+    def to_dense(self) -> Tensor:
+        return Tensor._new_tensor(self._sparse.to_dense(), self.dtype, False)
+
+    def __matmul__(self, other: Tensor) -> Tensor:
+        return spmm(self, other)
+
+    def __repr__(self):
+        return repr(self._sparse)
+
+def sparse_coo_tensor(indices: List[List[int]], values: List, shape: Sequence[int], dtype: Optional[str] = None) -> SparseTensor:
+    if len(indices) != 2 or len(shape) != 2:
+        raise ValueError("ERROR: Only 2D sparse tensors are supported; indices must be [row_indices, col_indices].")
+    dtype = _infer_dtype(values, dtype)
+    backend = get_backend(dtype)
+    sparse = backend.SparseTensor.from_coo(shape[0], shape[1], list(indices[0]), list(indices[1]), list(values))
+    return SparseTensor(sparse, dtype)
+
+def sparse_csr_tensor(row_ptr: List[int], col_idx: List[int], values: List, shape: Sequence[int], dtype: Optional[str] = None) -> SparseTensor:
+    if len(shape) != 2:
+        raise ValueError("ERROR: Only 2D sparse tensors are supported.")
+    dtype = _infer_dtype(values, dtype)
+    backend = get_backend(dtype)
+    sparse = backend.SparseTensor.from_csr(shape[0], shape[1], list(row_ptr), list(col_idx), list(values))
+    return SparseTensor(sparse, dtype)
+
+def to_sparse(x: Tensor) -> SparseTensor:
+    return SparseTensor(x.backend.SparseTensor.from_dense(x._tensor), x.dtype)
+
+def spmm(a: SparseTensor, b: Tensor) -> Tensor:
+    if a.dtype != b.dtype:
+        raise TypeError("ERROR: spmm operands must have the same dtype.")
+    result = a.backend.spmm(a._sparse, b._tensor)
+    return Tensor._new_tensor(result, b.dtype, b.requires_grad)
\ No newline at end of file
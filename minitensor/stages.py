@@ -0,0 +1,33 @@
+from minitensor.layers.linear import Linear
+from minitensor.layers.dropout import Dropout
+from minitensor.layers.normalization import LayerNorm, BatchNorm1d
+from minitensor.activations import ReLU, Tanh, Sigmoid, Softmax
+from minitensor.model import Sequential
+
+_ACTIVATIONS = {ReLU: "relu", Tanh: "tanh", Sigmoid: "sigmoid", Softmax: "softmax"}
+
+def model_stages(model, consumer: str):
+    """Walks a Sequential (or a single layer) for the code that compiles it
+    into a C++ model, yielding one (kind, arg) pair per stage:
+    ("linear", layer), ("activation", name), ("dropout", layer),
+    ("layer_norm", layer) or ("batch_norm", layer). A Linear with an
+    activation is followed by that activation's stage. `consumer` names the
+    caller in error messages; each caller rejects the kinds it cannot run."""
+    modules = list(model.layers) if isinstance(model, Sequential) else [model]
+    for module in modules:
+        if isinstance(module, Linear):
+            yield "linear", module
+            if module.activation_fn is not None:
+                yield "activation", module.activation
+        elif isinstance(module, Dropout):
+            yield "dropout", module
+        elif isinstance(module, LayerNorm):
+            yield "layer_norm", module
+        elif isinstance(module, BatchNorm1d):
+            yield "batch_norm", module
+        elif type(module) in _ACTIVATIONS:
+            if isinstance(module, Softmax) and module.axis not in (-1, 1):
+                raise ValueError(f"ERROR: {consumer} only supports Softmax over the feature axis.")
+            yield "activation", _ACTIVATIONS[type(module)]
+        else:
+            raise TypeError(f"ERROR: {consumer} does not support {type(module).__name__}.")
\ No newline at end of file
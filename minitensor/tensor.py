@@ -1,24 +1,15 @@
 from typing import List
-import math
 
-from minitensor.backend import get_backend
+from minitensor.backend import mtc, get_backend
 
 class Tensor:
     def __init__(self, data: List, shape: List[int], dtype: str, requires_grad: bool = False):
-        if not data:
-            raise ValueError("ERROR: Data cannot be empty.")
-        elif not shape:
+        if not shape:
             raise ValueError("ERROR: Shape cannot be empty.")
 
-        first_el = data[0]
-        if not isinstance(first_el, (int, float)):
-            raise TypeError("ERROR: Unsupported data type. Only int, float and double are supported.")
-
-        self.dtype = dtype
-
         self.backend = get_backend(dtype)
 
-        self._tensor = self.backend.Tensor(data, shape, requires_grad)
+        self._tensor, self.dtype = mtc.tensor_from_data(data, dtype, list(shape), requires_grad)
 
     def sum(self, axis: int=-1):
         result = self.backend.sum(self._tensor, axis)
@@ -54,6 +45,13 @@ class Tensor:
             requires_grad = False 
             return self._new_tensor(self._tensor.grad, self.dtype, requires_grad)
         return None
+
+    @property
+    def tangent(self):
+        """Forward-mode tangent of a dual tensor (see make_dual), else None."""
+        if self._tensor.tangent:
+            return self._new_tensor(self._tensor.tangent, self.dtype)
+        return None
     
     def reshape(self, *new_shape):
         if len(new_shape) == 1 and isinstance(new_shape[0], (list, tuple)):
@@ -64,8 +62,8 @@ class Tensor:
         result = self._tensor.reshape(new_shape)
         return self._new_tensor(result, self.dtype, self.requires_grad)
 
-    def backward(self):
-        self._tensor.backward()
+    def backward(self, retain_graph: bool = False):
+        self._tensor.backward(retain_graph)
 
     def zero_grad(self):
         self._tensor.zero_grad()
@@ -78,6 +76,9 @@ class Tensor:
     def nested(self) -> list:
         return self._tensor.to_nested()
 
+    def tolist(self) -> list:
+        return self._tensor.tolist()
+
     def _requires_grad(self, other):
         if isinstance(other, Tensor):
             return self.requires_grad or other.requires_grad
@@ -169,54 +170,13 @@ class Tensor:
             return self._new_tensor(result, self.dtype, self.requires_grad)
         return result
 
-def _calculate_shape(data):
-    if not isinstance(data, list):
-        return []
-    shape = [len(data)]
-    if len(data) > 0:
-        sub_shape = _calculate_shape(data[0])
-        for item in data:
-            if _calculate_shape(item) != sub_shape:
-                raise ValueError("ERROR: All elements in a dimension must have the same shape.")
-        shape.extend(sub_shape)
-    return shape
-
-def _flatten_nested_list(data):
-    if not isinstance(data, list):
-        return [data]
-    flat_list = list()
-    for item in data:
-        flat_list.extend(_flatten_nested_list(item))
-    return flat_list
-
 def tensor(data, shape=None, dtype=None, requires_grad=False) -> Tensor:
-    if not isinstance(data, list) or not data:
+    """Builds a tensor from nested lists/tuples of numbers or from a buffer
+    (array.array, bytes, memoryview, ...), parsed in one pass in C++. Without
+    a dtype, lists holding any float become float32 and int32 otherwise;
+    buffers keep their element type."""
+    if isinstance(data, list) and not data:
         raise ValueError("ERROR: Data must be a non-empty list.")
-
-    calculated_shape = []
-    flat_data = []
-
-    if shape is not None:
-        if any(isinstance(i, list) for i in data):
-             raise ValueError("ERROR: Cannot provide an explicit shape for a nested list.")
-
-        expected_elements = math.prod(shape)
-        if len(data) != expected_elements:
-            raise ValueError(f"ERROR: Shape {shape} requires {expected_elements} elements, but got {len(data)}.")
-
-        flat_data = data
-        calculated_shape = shape
-    else:
-        calculated_shape = _calculate_shape(data)
-        flat_data = _flatten_nested_list(data)
-
-    if dtype is None:
-        first_el = flat_data[0]
-        if isinstance(first_el, int):
-            dtype = "int32"
-        elif isinstance(first_el, float):
-            dtype = "float32"
-        else:
-            raise TypeError("ERROR: Unsupported data type. Only int and float are supported.")
-
-    return Tensor(flat_data, calculated_shape, dtype, requires_grad)
\ No newline at end of file
+    shape = [] if shape is None else list(shape)
+    result, dtype = mtc.tensor_from_data(data, dtype or "", shape, requires_grad)
+    return Tensor._new_tensor(result, dtype, requires_grad)
\ No newline at end of file
@@ -1,6 +1,23 @@
-from minitensor.backend import get_backend
+from contextlib import contextmanager
+from minitensor.backend import mtc, get_backend
 from minitensor import Tensor
 
+def is_fast_math() -> bool:
+    return mtc.is_fast_math()
+
+def set_fast_math(enabled: bool):
+    """Skips the domain checks of sqrt and log: invalid inputs give NaN or -inf instead of raising."""
+    mtc.set_fast_math(enabled)
+
+@contextmanager
+def fast_math():
+    previous = mtc.is_fast_math()
+    mtc.set_fast_math(True)
+    try:
+        yield
+    finally:
+        mtc.set_fast_math(previous)
+
 def math_wrapper(func, *args):
     tensor = args[0]
 
@@ -12,7 +29,7 @@ def math_wrapper(func, *args):
 
     output_dtype = 'float32' if 'int' in tensor.dtype else tensor.dtype
 
-    return Tensor._new_tensor(result, output_dtype, tensor.requires_grad)
+    return Tensor._new_tensor(result, output_dtype)
 
 def sqrt(tensor: Tensor) -> Tensor:
     backend = get_backend(tensor.dtype)
@@ -0,0 +1,66 @@
+from typing import Callable, Optional
+from minitensor import Tensor
+from minitensor.losses import MSE, MAE, BCE
+from minitensor.random import initial_seed
+from minitensor.stages import model_stages
+
+_LOSSES = {MSE: "mse", MAE: "mae", BCE: "bce"}
+
+def _build_model(model):
+    """Translates a Sequential (or a single layer) into a C++ TrainerModel
+    that shares the layers' parameters."""
+    stages = list(model_stages(model, "Trainer"))
+    layers = [arg for kind, arg in stages if kind != "activation"]
+    if not layers:
+        raise ValueError("ERROR: Trainer needs at least one layer.")
+    dtype, backend = layers[0].dtype, layers[0].backend
+    if not hasattr(backend, "TrainerModel"):
+        raise TypeError("ERROR: Trainer requires floating point layers.")
+    if any(layer.dtype != dtype for layer in layers):
+        raise TypeError("ERROR: All layers must have the same dtype.")
+
+    compiled = backend.TrainerModel()
+    for kind, arg in stages:
+        if kind == "linear":
+            compiled.add_linear(arg._linear)
+        elif kind == "activation":
+            compiled.add_activation(arg)
+        elif kind == "dropout":
+            compiled.add_dropout(arg._dropout)
+        elif kind == "layer_norm":
+            compiled.add_layer_norm(arg._norm)
+        elif kind == "batch_norm":
+            compiled.add_batch_norm(arg._norm)
+    return compiled, dtype, backend
+
+class Trainer:
+    """Runs whole training epochs in C++: every step (zero_grad, forward,
+    loss, backward, optimizer step) happens without returning to Python, so
+    a small model pays no per-step interpreter cost. `loss` is an MSE, MAE or
+    BCE instance (or "mse", "mae", "bce") and `optimizer` an SGD or Adam over
+    the model's parameters. Training updates the model in place."""
+
+    def __init__(self, model, loss, optimizer):
+        self.model = model
+        self._model, self.dtype, self.backend = _build_model(model)
+        self.loss = _LOSSES.get(type(loss), loss)
+        if self.loss not in _LOSSES.values():
+            raise ValueError(f"ERROR: loss must be MSE, MAE or BCE, got {loss!r}.")
+        self.optimizer = optimizer
+
+    def fit(self, x: Tensor, y: Tensor, epochs: int, batch_size: int = 32, shuffle: bool = True,
+            log_every: int = 0, callback: Optional[Callable] = None, seed: Optional[int] = None) -> dict:
+        """Trains for `epochs` passes over the rows of x and y in mini-batches
+        of `batch_size`, reshuffled every epoch when `shuffle` is set (the
+        order depends on `seed`, by default the global seed). Every `log_every`
+        steps `callback` gets a TrainerProgress with epoch, step, the mean loss
+        since the previous call and the elapsed seconds.
+
+        Returns steps, seconds, steps_per_second, final_loss and epoch_losses."""
+        if x.dtype != self.dtype or y.dtype != self.dtype:
+            raise TypeError(f"ERROR: Trainer expects {self.dtype} data.")
+        if callback is not None and log_every <= 0:
+            raise ValueError("ERROR: A callback needs log_every > 0.")
+        seed = initial_seed() if seed is None else seed
+        return self.backend.train(self._model, self.loss, self.optimizer._optim, x._tensor, y._tensor,
+                                  epochs, batch_size, shuffle, seed, log_every, callback)
\ No newline at end of file
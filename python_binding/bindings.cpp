@@ -2,15 +2,32 @@
 #include <variant>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/functional.h>
 #include <pybind11/operators.h>
 #include "tensors/tensors.h"
+#include "tensors/tensor_convert.h"
 #include "losses/losses.h"
 #include "nn/activations/activations.h"
 #include "nn/layers/layers.h"
 #include "nn/initializers/initializers.h"
+#include "autograd/grad_mode.h"
+#include "autograd/checkpoint.h"
+#include "autograd/forward_ad.h"
+#include "optims/optims.h"
+#include "distributed/distributed.h"
+#include "inference/inference.h"
+#include "export/export.h"
+#include "utils/parallel.h"
+#include "utils/random.h"
 
 namespace py = pybind11;
 
+// Kernels run without the GIL so Python threads can compute concurrently. Only
+// bindings that neither build nor touch Python objects may use it; backward
+// (grad-ready hooks), checkpoint (reruns the segment) and jvp (calls fn) call
+// back into Python and keep it.
+using release_gil = py::call_guard<py::gil_scoped_release>;
+
 template<typename T>
 void define_bindings_for_type(py::module_& m, const std::string& type_name) {
      auto m_type = m.def_submodule(type_name.c_str());
@@ -24,55 +41,89 @@ void define_bindings_for_type(py::module_& m, const std::string& type_name) {
                return std::make_shared<Tensor<T>>(shape, req_grad);
           }), py::arg("shape"), py::arg("requires_grad") = false)
 
-          .def_readwrite("shape", &Tensor<T>::shape)
+          .def_property("shape",
+               [](const Tensor<T>& t) { return t.shape.to_vector(); },
+               [](Tensor<T>& t, const std::vector<int>& shape) { t.shape = shape; })
           .def_readwrite("requires_grad", &Tensor<T>::requires_grad)
           .def_readwrite("grad", &Tensor<T>::grad)
+          .def_readwrite("tangent", &Tensor<T>::tangent)
+          .def_property_readonly("sparse_grad", [](const Tensor<T>& t) -> py::object {
+               if (!t.sparse_grad) return py::none();
+               return py::make_tuple(t.sparse_grad->indices, t.sparse_grad->values);
+          })
 
-          .def("backward", &Tensor<T>::backward)
-          .def("zero_grad", &Tensor<T>::zero_grad) 
-          .def("to_vector", &to_vector<T>)
-          .def("to_nested", &to_nested_wrapper<T>)
-          .def("set_data", &Tensor<T>::set_data, py::arg("other"))
+          .def("backward", &Tensor<T>::backward, py::arg("retain_graph") = false)
+          .def("zero_grad", &Tensor<T>::zero_grad, release_gil())
+          .def("to_vector", &to_flat_list<T>)
+          .def("to_nested", &to_nested<T>)
+          .def("tolist", &to_nested<T>)
+          .def("set_data", &Tensor<T>::set_data, py::arg("other"), release_gil())
           .def("reshape", [](std::shared_ptr<Tensor<T>> t, const std::vector<int>& new_shape) {
                return t->reshape(new_shape);
-          }, py::arg("new_shape"))
+          }, py::arg("new_shape"), release_gil())
 
 
           .def("__repr__", &tensor_repr<T>)
 
-          .def("__matmul__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return mat_mul(a, b); })
-          .def("__add__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return tensor_add(a, b); })
-          .def("__sub__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return tensor_sub(a, b); })
-          .def("__mul__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return tensor_mul(a, b); })
-          .def("__truediv__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return tensor_div(a, b); })
+          .def("__matmul__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return mat_mul(a, b); }, release_gil())
+          .def("__add__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return tensor_add(a, b); }, release_gil())
+          .def("__sub__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return tensor_sub(a, b); }, release_gil())
+          .def("__mul__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return tensor_mul(a, b); }, release_gil())
+          .def("__truediv__", [](std::shared_ptr<Tensor<T>> a, std::shared_ptr<Tensor<T>> b) { return tensor_div(a, b); }, release_gil())
 
-          .def("__add__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_add(a, scalar); })
-          .def("__sub__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_sub(a, scalar); })
-          .def("__mul__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_mul(a, scalar); })
-          .def("__truediv__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_div(a, scalar); })
+          .def("__add__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_add(a, scalar); }, release_gil())
+          .def("__sub__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_sub(a, scalar); }, release_gil())
+          .def("__mul__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_mul(a, scalar); }, release_gil())
+          .def("__truediv__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_div(a, scalar); }, release_gil())
           
-          .def("__radd__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_add(a, scalar); })
-          .def("__rsub__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return scalar_tensor_sub(scalar, a); })
-          .def("__rmul__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_mul(a, scalar); })
-          .def("__rtruediv__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return scalar_tensor_div(scalar, a); })
+          .def("__radd__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_add(a, scalar); }, release_gil())
+          .def("__rsub__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return scalar_tensor_sub(scalar, a); }, release_gil())
+          .def("__rmul__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return tensor_scalar_mul(a, scalar); }, release_gil())
+          .def("__rtruediv__", [](std::shared_ptr<Tensor<T>> a, T scalar) { return scalar_tensor_div(scalar, a); }, release_gil())
 
           .def("__getitem__", [](std::shared_ptr<Tensor<T>> t, py::object idx) { return getitem<T>(t, idx); });
 
-     m_type.def("mse_loss", &mse_loss<T>);
-     m_type.def("mae_loss", &mae_loss<T>);
-     m_type.def("bce_loss", &bce_loss<T>);
-     m_type.def("relu", &relu<T>);
-     m_type.def("sum", &sum<T>, py::arg("tensor"), py::arg("axis") = -1);
-     m_type.def("mean", &mean<T>, py::arg("tensor"), py::arg("axis") = -1);
-     m_type.def("max", &max<T>, py::arg("tensor"), py::arg("axis") = -1);
-     m_type.def("min", &min<T>, py::arg("tensor"), py::arg("axis") = -1);
+     py::class_<SparseTensor<T>, std::shared_ptr<SparseTensor<T>>>(m_type, "SparseTensor")
+          .def_static("from_coo", &SparseTensor<T>::from_coo,
+                      py::arg("rows"), py::arg("cols"), py::arg("row_indices"), py::arg("col_indices"), py::arg("values"))
+          .def_static("from_csr", [](int rows, int cols, std::vector<int> row_ptr, std::vector<int> col_idx, std::vector<T> values) {
+               return std::make_shared<SparseTensor<T>>(rows, cols, std::move(row_ptr), std::move(col_idx), std::move(values));
+          }, py::arg("rows"), py::arg("cols"), py::arg("row_ptr"), py::arg("col_idx"), py::arg("values"))
+          .def_static("from_dense", [](std::shared_ptr<Tensor<T>> dense) { return SparseTensor<T>::from_dense(*dense); }, release_gil())
+          .def_property_readonly("shape", &SparseTensor<T>::shape)
+          .def_property_readonly("nnz", &SparseTensor<T>::nnz)
+          .def_readonly("row_ptr", &SparseTensor<T>::row_ptr)
+          .def_readonly("col_idx", &SparseTensor<T>::col_idx)
+          .def_readonly("values", &SparseTensor<T>::values)
+          .def("to_dense", &SparseTensor<T>::to_dense, release_gil())
+          .def("__repr__", &sparse_tensor_repr<T>)
+          .def("__matmul__", [](std::shared_ptr<SparseTensor<T>> a, std::shared_ptr<Tensor<T>> b) { return spmm(a, b); }, release_gil());
+     m_type.def("spmm", &spmm<T>, py::arg("sparse"), py::arg("dense"), release_gil());
+
+     m_type.def("mse_loss", &mse_loss<T>, release_gil());
+     m_type.def("mae_loss", &mae_loss<T>, release_gil());
+     m_type.def("bce_loss", &bce_loss<T>, release_gil());
+     m_type.def("relu", &relu<T>, release_gil());
+     m_type.def("sum", &sum<T>, py::arg("tensor"), py::arg("axis") = -1, release_gil());
+     m_type.def("mean", &mean<T>, py::arg("tensor"), py::arg("axis") = -1, release_gil());
+     m_type.def("max", &max<T>, py::arg("tensor"), py::arg("axis") = -1, release_gil());
+     m_type.def("min", &min<T>, py::arg("tensor"), py::arg("axis") = -1, release_gil());
+     m_type.def("checkpoint", &checkpoint<T>, py::arg("segment"), py::arg("input"));
+
+     py::class_<SGD<T>, std::shared_ptr<SGD<T>>>(m_type, "SGD")
+          .def(py::init<const std::vector<std::shared_ptr<Tensor<T>>>&, T>(), py::arg("params"), py::arg("lr"))
+          .def_readwrite("lr", &SGD<T>::lr)
+          .def("step", &SGD<T>::step, release_gil())
+          .def("zero_grad", &SGD<T>::zero_grad, release_gil());
 
      py::class_<Constant_Val<T>, std::shared_ptr<Constant_Val<T>>>(m_type, "Constant").def(py::init<T>());
 
      if constexpr (std::is_floating_point_v<T>) {
-          m_type.def("tanh", &tanh_fn<T>);
-          m_type.def("sigmoid", &sigmoid<T>);
-          m_type.def("softmax", &softmax<T>, py::arg("tensor"), py::arg("axis") = -1);
+          m_type.def("tanh", &tanh_fn<T>, release_gil());
+          m_type.def("sigmoid", &sigmoid<T>, release_gil());
+          m_type.def("softmax", &softmax<T>, py::arg("tensor"), py::arg("axis") = -1, release_gil());
+          m_type.def("make_dual", &make_dual<T>, py::arg("primal"), py::arg("tangent"));
+          m_type.def("jvp", &jvp<T>, py::arg("fn"), py::arg("primals"), py::arg("tangents"));
           py::class_<HeNormal<T>, std::shared_ptr<HeNormal<T>>>(m_type, "HeNormal").def(py::init<>());
           py::class_<XavierUniform<T>, std::shared_ptr<XavierUniform<T>>>(m_type, "XavierUniform").def(py::init<>());
      }
@@ -85,6 +136,7 @@ void define_bindings_for_type(py::module_& m, const std::string& type_name) {
     py::class_<Initializer>(m_type, "Initializer");
 
      auto linear_cls = py::class_<Linear<T>, std::shared_ptr<Linear<T>>>(m_type, "Linear");
+     auto conv2d_cls = py::class_<Conv2d<T>, std::shared_ptr<Conv2d<T>>>(m_type, "Conv2d");
      
      if constexpr (std::is_floating_point_v<T>) {
           linear_cls.def(py::init([](int in, int out, Initializer w_init, Initializer b_init) {
@@ -93,13 +145,297 @@ void define_bindings_for_type(py::module_& m, const std::string& type_name) {
              py::arg("weight_init") = std::make_shared<HeNormal<T>>(),
              py::arg("bias_init") = std::make_shared<Constant_Val<T>>(0.0f));
 
-          m_type.def("sqrt", &tensor_sqrt<T, T>);
-          m_type.def("log", &tensor_log<T, T>);
-          m_type.def("exp", &tensor_exp<T, T>);
-          m_type.def("pow", &tensor_pow<T, T>);
-          m_type.def("sin", &tensor_sin<T, T>);
-          m_type.def("cos", &tensor_cos<T, T>);
-          m_type.def("tan", &tensor_tan<T, T>);
+          conv2d_cls.def(py::init([](int in, int out, int kernel, int stride, int padding, int dilation, int groups,
+                                     Initializer w_init, Initializer b_init) {
+               return std::make_shared<Conv2d<T>>(in, out, kernel, stride, padding, dilation, groups, w_init, b_init);
+          }), py::arg("in_channels"), py::arg("out_channels"), py::arg("kernel_size"),
+             py::arg("stride") = 1, py::arg("padding") = 0, py::arg("dilation") = 1, py::arg("groups") = 1,
+             py::arg("weight_init") = std::make_shared<HeNormal<T>>(),
+             py::arg("bias_init") = std::make_shared<Constant_Val<T>>(0.0f));
+
+          py::class_<Embedding<T>, std::shared_ptr<Embedding<T>>>(m_type, "Embedding")
+               .def(py::init([](int num, int dim, bool sparse, Initializer w_init) {
+                    return std::make_shared<Embedding<T>>(num, dim, sparse, w_init);
+               }), py::arg("num_embeddings"), py::arg("embedding_dim"), py::arg("sparse") = true,
+                  py::arg("weight_init") = std::make_shared<HeNormal<T>>())
+               .def("forward", &Embedding<T>::forward, release_gil())
+               .def("parameters", &Embedding<T>::parameters)
+               .def("__repr__", &embedding_repr<T>)
+               .def("__call__", &Embedding<T>::forward, release_gil());
+          m_type.def("embedding", &embedding<T>, py::arg("weight"), py::arg("indices"), py::arg("sparse") = true, release_gil());
+
+          py::class_<EnsembleLinear<T>, std::shared_ptr<EnsembleLinear<T>>>(m_type, "EnsembleLinear")
+               .def(py::init([](int num_models, int in, int out, Initializer w_init, Initializer b_init) {
+                    return std::make_shared<EnsembleLinear<T>>(num_models, in, out, w_init, b_init);
+               }), py::arg("num_models"), py::arg("input_features"), py::arg("output_features"),
+                  py::arg("weight_init") = std::make_shared<HeNormal<T>>(),
+                  py::arg("bias_init") = std::make_shared<Constant_Val<T>>(0.0f))
+               .def_property_readonly("num_models", &EnsembleLinear<T>::num_models)
+               .def("forward", &EnsembleLinear<T>::forward, release_gil())
+               .def("parameters", &EnsembleLinear<T>::parameters)
+               .def("load_member", &EnsembleLinear<T>::load_member, py::arg("index"), py::arg("layer"))
+               .def("store_member", &EnsembleLinear<T>::store_member, py::arg("index"), py::arg("layer"))
+               .def("__repr__", &ensemble_linear_repr<T>)
+               .def("__call__", &EnsembleLinear<T>::forward, release_gil());
+          m_type.def("ensemble_linear", &ensemble_linear<T>, py::arg("input"), py::arg("weight"), py::arg("bias"), release_gil());
+
+          py::class_<LayerNorm<T>, std::shared_ptr<LayerNorm<T>>>(m_type, "LayerNorm")
+               .def(py::init<int, T, bool>(), py::arg("normalized_shape"), py::arg("eps") = static_cast<T>(1e-5),
+                    py::arg("elementwise_affine") = true)
+               .def("forward", &LayerNorm<T>::forward, release_gil())
+               .def("parameters", &LayerNorm<T>::parameters)
+               .def("__repr__", &layer_norm_repr<T>)
+               .def("__call__", &LayerNorm<T>::forward, release_gil());
+
+          py::class_<BatchNorm1d<T>, std::shared_ptr<BatchNorm1d<T>>>(m_type, "BatchNorm1d")
+               .def(py::init<int, T, T, bool>(), py::arg("num_features"), py::arg("eps") = static_cast<T>(1e-5),
+                    py::arg("momentum") = static_cast<T>(0.1), py::arg("affine") = true)
+               .def_readwrite("training", &BatchNorm1d<T>::training)
+               .def_readonly("running_mean", &BatchNorm1d<T>::running_mean)
+               .def_readonly("running_var", &BatchNorm1d<T>::running_var)
+               .def("forward", &BatchNorm1d<T>::forward, release_gil())
+               .def("parameters", &BatchNorm1d<T>::parameters)
+               .def("__repr__", &batch_norm1d_repr<T>)
+               .def("__call__", &BatchNorm1d<T>::forward, release_gil());
+
+          m_type.def("layer_norm", &layer_norm<T>, py::arg("input"), py::arg("weight"), py::arg("bias"),
+                     py::arg("eps") = static_cast<T>(1e-5), release_gil());
+          m_type.def("batch_norm", &batch_norm<T>, py::arg("input"), py::arg("running_mean"), py::arg("running_var"),
+                     py::arg("weight"), py::arg("bias"), py::arg("training"),
+                     py::arg("momentum") = static_cast<T>(0.1), py::arg("eps") = static_cast<T>(1e-5), release_gil());
+
+          py::class_<Dropout<T>, std::shared_ptr<Dropout<T>>>(m_type, "Dropout")
+               .def(py::init<double>(), py::arg("p") = 0.5)
+               .def_readwrite("p", &Dropout<T>::p)
+               .def_readwrite("training", &Dropout<T>::training)
+               .def("forward", &Dropout<T>::forward, release_gil())
+               .def("parameters", &Dropout<T>::parameters)
+               .def("__repr__", &dropout_repr<T>)
+               .def("__call__", &Dropout<T>::forward, release_gil());
+          m_type.def("dropout", &dropout<T>, py::arg("input"), py::arg("p") = 0.5, py::arg("training") = true, release_gil());
+
+          using TensorPtr = std::shared_ptr<Tensor<T>>;
+          auto recurrent_tuple = [](const RecurrentOutput<T>& r) { return py::make_tuple(r.output, r.h_n, r.c_n); };
+
+          py::class_<LSTM<T>, std::shared_ptr<LSTM<T>>>(m_type, "LSTM")
+               .def(py::init([](int input_size, int hidden_size, Initializer w_init, Initializer b_init) {
+                    return std::make_shared<LSTM<T>>(input_size, hidden_size, w_init, b_init);
+               }), py::arg("input_size"), py::arg("hidden_size"),
+                  py::arg("weight_init") = std::make_shared<XavierUniform<T>>(),
+                  py::arg("bias_init") = std::make_shared<Constant_Val<T>>(0.0f))
+               .def("forward", [recurrent_tuple](LSTM<T>& layer, TensorPtr x, TensorPtr h0, TensorPtr c0, bool return_sequences) {
+                    RecurrentOutput<T> result;
+                    {
+                         py::gil_scoped_release release;
+                         result = layer.forward(x, h0, c0, return_sequences);
+                    }
+                    return recurrent_tuple(result);
+               }, py::arg("input"), py::arg("h0") = nullptr, py::arg("c0") = nullptr, py::arg("return_sequences") = true)
+               .def("parameters", &LSTM<T>::parameters)
+               .def("__repr__", &lstm_repr<T>);
+
+          py::class_<GRU<T>, std::shared_ptr<GRU<T>>>(m_type, "GRU")
+               .def(py::init([](int input_size, int hidden_size, Initializer w_init, Initializer b_init) {
+                    return std::make_shared<GRU<T>>(input_size, hidden_size, w_init, b_init);
+               }), py::arg("input_size"), py::arg("hidden_size"),
+                  py::arg("weight_init") = std::make_shared<XavierUniform<T>>(),
+                  py::arg("bias_init") = std::make_shared<Constant_Val<T>>(0.0f))
+               .def("forward", [recurrent_tuple](GRU<T>& layer, TensorPtr x, TensorPtr h0, bool return_sequences) {
+                    RecurrentOutput<T> result;
+                    {
+                         py::gil_scoped_release release;
+                         result = layer.forward(x, h0, return_sequences);
+                    }
+                    return recurrent_tuple(result);
+               }, py::arg("input"), py::arg("h0") = nullptr, py::arg("return_sequences") = true)
+               .def("parameters", &GRU<T>::parameters)
+               .def("__repr__", &gru_repr<T>);
+
+          m_type.def("scaled_dot_product_attention", &scaled_dot_product_attention<T>,
+                     py::arg("query"), py::arg("key"), py::arg("value"), py::arg("mask") = nullptr,
+                     py::arg("causal") = false, py::arg("scale") = 0.0, release_gil());
+
+          py::class_<MasterWeights<T>, std::shared_ptr<MasterWeights<T>>>(m_type, "MasterWeights")
+               .def(py::init([](const std::vector<std::shared_ptr<Tensor<T>>>& params, const std::string& precision) {
+                    return std::make_shared<MasterWeights<T>>(params, precision_from_string(precision));
+               }), py::arg("params"), py::arg("precision"))
+               .def("master_parameters", &MasterWeights<T>::master_parameters)
+               .def("unscale_grads", &MasterWeights<T>::unscale_grads, py::arg("inv_scale"), release_gil())
+               .def("copy_to_model", &MasterWeights<T>::copy_to_model, release_gil())
+               .def("zero_grad", &MasterWeights<T>::zero_grad, release_gil());
+          m_type.def("unscale_grads", &unscale_grads<T>, py::arg("params"), py::arg("inv_scale"), release_gil());
+
+          py::class_<GradReducer<T>, std::shared_ptr<GradReducer<T>>>(m_type, "GradReducer")
+               .def(py::init<std::shared_ptr<ShmCommunicator>, const std::vector<std::shared_ptr<Tensor<T>>>&, size_t>(),
+                    py::arg("comm"), py::arg("params"), py::arg("bucket_bytes") = 25 << 20)
+               .def("broadcast_parameters", &GradReducer<T>::broadcast_parameters, release_gil())
+               .def("finalize", &GradReducer<T>::finalize, release_gil())
+               .def_property_readonly("num_buckets", &GradReducer<T>::num_buckets);
+          m_type.def("all_reduce", [](ShmCommunicator& comm, const std::shared_ptr<Tensor<T>>& tensor, bool average) {
+               comm.all_reduce(tensor->data.get(), tensor->size, average);
+               tensor->bump_version();
+          }, py::arg("comm"), py::arg("tensor"), py::arg("average") = false, release_gil());
+          m_type.def("broadcast", [](ShmCommunicator& comm, const std::shared_ptr<Tensor<T>>& tensor, int root) {
+               comm.broadcast(tensor->data.get(), tensor->size, root);
+               tensor->bump_version();
+          }, py::arg("comm"), py::arg("tensor"), py::arg("root") = 0, release_gil());
+
+          using TensorList = std::vector<std::shared_ptr<Tensor<T>>>;
+          m_type.def("foreach_norm", &foreach_norm<T>, py::arg("tensors"), release_gil());
+          m_type.def("foreach_scale", &foreach_scale<T>, py::arg("tensors"), py::arg("alpha"), release_gil());
+          m_type.def("foreach_zero", &foreach_zero<T>, py::arg("tensors"), release_gil());
+          m_type.def("foreach_axpy", &foreach_axpy<T>, py::arg("ys"), py::arg("xs"), py::arg("alpha"), release_gil());
+          m_type.def("grad_norm", [](const TensorList& params) { return grad_norm(params); }, py::arg("params"), release_gil());
+          m_type.def("clip_grad_norm", [](const TensorList& params, double max_norm) { return clip_grad_norm(params, max_norm); },
+                     py::arg("params"), py::arg("max_norm"), release_gil());
+
+          py::class_<FlatParameters<T>, std::shared_ptr<FlatParameters<T>>>(m_type, "FlatParameters")
+               .def(py::init<const TensorList&>(), py::arg("params"))
+               .def_property_readonly("flat", &FlatParameters<T>::flat)
+               .def_property_readonly("size", &FlatParameters<T>::size)
+               .def("parameters", &FlatParameters<T>::parameters)
+               .def("grad_norm", &FlatParameters<T>::grad_norm, release_gil())
+               .def("clip_grad_norm", &FlatParameters<T>::clip_grad_norm, py::arg("max_norm"), release_gil())
+               .def("scale_grad", &FlatParameters<T>::scale_grad, py::arg("alpha"), release_gil())
+               .def("zero_grad", &FlatParameters<T>::zero_grad, release_gil())
+               .def("all_reduce_grad", &FlatParameters<T>::all_reduce_grad, py::arg("comm"), py::arg("average") = true, release_gil())
+               .def("broadcast", &FlatParameters<T>::broadcast, py::arg("comm"), py::arg("root") = 0, release_gil())
+               .def("save", &FlatParameters<T>::save, py::arg("path"), release_gil())
+               .def("load", &FlatParameters<T>::load, py::arg("path"), release_gil());
+
+          m_type.def("hogwild_train", [](const std::vector<std::shared_ptr<Linear<T>>>& layers,
+                                         std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> y,
+                                         const std::string& activation, const std::string& loss, T lr,
+                                         int num_workers, int batch_size, long long steps_per_worker, unsigned seed) {
+               HogwildSGD<T> optimizer(hogwild_mlp_parameters(layers), lr, num_workers);
+               auto step = hogwild_mlp_step(layers, x, y, activation, loss, batch_size, seed);
+               HogwildReport report;
+               {
+                    py::gil_scoped_release release;
+                    report = optimizer.run(step, steps_per_worker);
+               }
+               py::dict result;
+               result["steps"] = report.steps;
+               result["seconds"] = report.seconds;
+               result["steps_per_second"] = report.steps_per_second;
+               result["final_loss"] = report.final_loss;
+               return result;
+          }, py::arg("layers"), py::arg("x"), py::arg("y"), py::arg("activation"), py::arg("loss"), py::arg("lr"),
+             py::arg("num_workers"), py::arg("batch_size"), py::arg("steps_per_worker"), py::arg("seed") = 0);
+
+          py::class_<TrainerModel<T>, std::shared_ptr<TrainerModel<T>>>(m_type, "TrainerModel")
+               .def(py::init<>())
+               .def("add_linear", &TrainerModel<T>::add_linear, py::arg("layer"))
+               .def("add_activation", &TrainerModel<T>::add_activation, py::arg("name"))
+               .def("add_dropout", &TrainerModel<T>::add_dropout, py::arg("layer"))
+               .def("add_layer_norm", &TrainerModel<T>::add_layer_norm, py::arg("layer"))
+               .def("add_batch_norm", &TrainerModel<T>::add_batch_norm, py::arg("layer"))
+               .def("parameters", &TrainerModel<T>::parameters);
+
+          m_type.def("train", [](std::shared_ptr<TrainerModel<T>> model, const std::string& loss, TrainerOptimizer<T> optimizer,
+                                 std::shared_ptr<Tensor<T>> x, std::shared_ptr<Tensor<T>> y, int epochs, int batch_size,
+                                 bool shuffle, uint64_t seed, long long log_every, const TrainerCallback& callback) {
+               Trainer<T> trainer(std::move(model), trainer_loss<T>(loss), std::move(optimizer));
+               TensorDataLoader<T> data(std::move(x), std::move(y), batch_size, shuffle, seed);
+               TrainerReport report;
+               {
+                    // the callback takes the GIL back while it runs
+                    py::gil_scoped_release release;
+                    report = trainer.fit(data, epochs, log_every, callback);
+               }
+               py::dict result;
+               result["steps"] = report.steps;
+               result["seconds"] = report.seconds;
+               result["steps_per_second"] = report.steps_per_second;
+               result["final_loss"] = report.final_loss;
+               result["epoch_losses"] = report.epoch_losses;
+               return result;
+          }, py::arg("model"), py::arg("loss"), py::arg("optimizer"), py::arg("x"), py::arg("y"), py::arg("epochs"),
+             py::arg("batch_size") = 32, py::arg("shuffle") = true, py::arg("seed") = 0,
+             py::arg("log_every") = 0, py::arg("callback") = nullptr);
+
+          py::class_<InferenceModel<T>, std::shared_ptr<InferenceModel<T>>>(m_type, "InferenceModel")
+               .def(py::init<>())
+               .def("add_linear", &InferenceModel<T>::add_linear, py::arg("layer"))
+               .def("add_activation", &InferenceModel<T>::add_activation, py::arg("name"))
+               .def_property_readonly("input_features", &InferenceModel<T>::input_features)
+               .def_property_readonly("output_features", &InferenceModel<T>::output_features)
+               .def("forward", &InferenceModel<T>::forward, py::arg("input"), release_gil());
+
+          py::class_<BatchingEngine<T>, std::shared_ptr<BatchingEngine<T>>>(m_type, "BatchingEngine")
+               .def(py::init<std::shared_ptr<InferenceModel<T>>, int, double, int>(),
+                    py::arg("model"), py::arg("max_batch_size") = 32, py::arg("max_latency_ms") = 2.0,
+                    py::arg("num_workers") = 1)
+               .def("infer", &BatchingEngine<T>::infer, py::arg("row"), release_gil())
+               .def("infer_many", [](BatchingEngine<T>& engine, const std::vector<std::vector<T>>& rows) {
+                    std::vector<std::future<std::vector<T>>> futures;
+                    futures.reserve(rows.size());
+                    for (const auto& row : rows) futures.push_back(engine.submit(row));
+                    std::vector<std::vector<T>> results;
+                    results.reserve(rows.size());
+                    for (auto& future : futures) results.push_back(future.get());
+                    return results;
+               }, py::arg("rows"), release_gil())
+               .def("stats", [](const BatchingEngine<T>& engine) {
+                    InferenceStats s = engine.stats();
+                    py::dict result;
+                    result["requests"] = s.requests;
+                    result["batches"] = s.batches;
+                    result["mean_batch_size"] = s.mean_batch_size;
+                    result["requests_per_second"] = s.requests_per_second;
+                    result["mean_us"] = s.mean_us;
+                    result["p50_us"] = s.p50_us;
+                    result["p90_us"] = s.p90_us;
+                    result["p99_us"] = s.p99_us;
+                    result["max_us"] = s.max_us;
+                    result["batch_sizes"] = s.batch_sizes;
+                    return result;
+               })
+               .def("reset_stats", &BatchingEngine<T>::reset_stats)
+               .def("shutdown", &BatchingEngine<T>::shutdown, release_gil())
+               .def_property_readonly("max_batch_size", &BatchingEngine<T>::get_max_batch_size)
+               .def_property_readonly("max_latency_ms", &BatchingEngine<T>::get_max_latency_ms);
+
+          py::class_<PlanBuilder<T>>(m_type, "PlanBuilder")
+               .def(py::init<int>(), py::arg("input_features"))
+               .def("add_linear", &PlanBuilder<T>::add_linear, py::arg("layer"))
+               .def("add_batch_norm", &PlanBuilder<T>::add_batch_norm, py::arg("layer"))
+               .def("add_layer_norm", &PlanBuilder<T>::add_layer_norm, py::arg("layer"))
+               .def("add_activation", &PlanBuilder<T>::add_activation, py::arg("name"))
+               .def_property_readonly("folded_norms", &PlanBuilder<T>::folded_norms)
+               .def_property_readonly("fused_activations", &PlanBuilder<T>::fused_activations)
+               .def("build", [](const PlanBuilder<T>& builder, int max_batch) {
+                    return std::make_shared<InferencePlan>(builder.build(max_batch));
+               }, py::arg("max_batch"));
+          m_type.def("run_plan", [](PlanRunner& runner, const std::shared_ptr<Tensor<T>>& input) {
+               const InferencePlan& plan = runner.get_plan();
+               if (input->ndim != 2 || input->shape[1] != plan.input_features) {
+                    throw std::invalid_argument("ERROR: Plan input must have shape [batch, " + std::to_string(plan.input_features) + "].");
+               }
+               int rows = input->shape[0];
+               std::vector<float> x(input->data.get(), input->data.get() + input->size);
+               std::vector<float> y(static_cast<size_t>(rows) * plan.output_features);
+               runner.run(x.data(), rows, y.data());
+               auto result = std::make_shared<Tensor<T>>(std::vector<int>{rows, plan.output_features}, false);
+               std::copy(y.begin(), y.end(), result->data.get());
+               return result;
+          }, py::arg("runner"), py::arg("input"), release_gil());
+
+          py::class_<Adam<T>, std::shared_ptr<Adam<T>>>(m_type, "Adam")
+               .def(py::init<const std::vector<std::shared_ptr<Tensor<T>>>&, T, T, T, T>(),
+                    py::arg("params"), py::arg("lr"), py::arg("beta1"), py::arg("beta2"), py::arg("eps"))
+               .def_readwrite("lr", &Adam<T>::lr)
+               .def_readonly("step_count", &Adam<T>::step_count)
+               .def("step", &Adam<T>::step, release_gil())
+               .def("zero_grad", &Adam<T>::zero_grad, release_gil());
+
+          m_type.def("sqrt", &tensor_sqrt<T, T>, release_gil());
+          m_type.def("log", &tensor_log<T, T>, release_gil());
+          m_type.def("exp", &tensor_exp<T, T>, release_gil());
+          m_type.def("pow", &tensor_pow<T, T>, release_gil());
+          m_type.def("sin", &tensor_sin<T, T>, release_gil());
+          m_type.def("cos", &tensor_cos<T, T>, release_gil());
+          m_type.def("tan", &tensor_tan<T, T>, release_gil());
      } else {
           linear_cls.def(py::init([](int in, int out, Initializer w_init, Initializer b_init) {
                return std::make_shared<Linear<T>>(in, out, w_init, b_init);
@@ -107,19 +443,76 @@ void define_bindings_for_type(py::module_& m, const std::string& type_name) {
              py::arg("weight_init") = std::make_shared<Constant_Val<T>>(1),
              py::arg("bias_init") = std::make_shared<Constant_Val<T>>(0));
 
-          m_type.def("sqrt", &tensor_sqrt<T, float>);
-          m_type.def("log", &tensor_log<T, float>);
-          m_type.def("exp", &tensor_exp<T, float>);
-          m_type.def("pow", &tensor_pow<T, float>);
-          m_type.def("sin", &tensor_sin<T, float>);
-          m_type.def("cos", &tensor_cos<T, float>);
-          m_type.def("tan", &tensor_tan<T, float>);
+          conv2d_cls.def(py::init([](int in, int out, int kernel, int stride, int padding, int dilation, int groups,
+                                     Initializer w_init, Initializer b_init) {
+               return std::make_shared<Conv2d<T>>(in, out, kernel, stride, padding, dilation, groups, w_init, b_init);
+          }), py::arg("in_channels"), py::arg("out_channels"), py::arg("kernel_size"),
+             py::arg("stride") = 1, py::arg("padding") = 0, py::arg("dilation") = 1, py::arg("groups") = 1,
+             py::arg("weight_init") = std::make_shared<Constant_Val<T>>(1),
+             py::arg("bias_init") = std::make_shared<Constant_Val<T>>(0));
+
+          m_type.def("sqrt", &tensor_sqrt<T, float>, release_gil());
+          m_type.def("log", &tensor_log<T, float>, release_gil());
+          m_type.def("exp", &tensor_exp<T, float>, release_gil());
+          m_type.def("pow", &tensor_pow<T, float>, release_gil());
+          m_type.def("sin", &tensor_sin<T, float>, release_gil());
+          m_type.def("cos", &tensor_cos<T, float>, release_gil());
+          m_type.def("tan", &tensor_tan<T, float>, release_gil());
      }
 
-     linear_cls.def("forward", &Linear<T>::forward);
+     using DenseInput = const std::shared_ptr<Tensor<T>>&;
+     using SparseInput = const std::shared_ptr<SparseTensor<T>>&;
+     linear_cls.def("forward", py::overload_cast<DenseInput>(&Linear<T>::forward), release_gil());
+     linear_cls.def("forward", py::overload_cast<SparseInput>(&Linear<T>::forward), release_gil());
      linear_cls.def("parameters", &Linear<T>::parameters);
      linear_cls.def("__repr__", &linear_repr<T>);
-     linear_cls.def("__call__", &Linear<T>::forward);
+     linear_cls.def("__call__", py::overload_cast<DenseInput>(&Linear<T>::forward), release_gil());
+     linear_cls.def("__call__", py::overload_cast<SparseInput>(&Linear<T>::forward), release_gil());
+
+     conv2d_cls.def("forward", &Conv2d<T>::forward, release_gil());
+     conv2d_cls.def("parameters", &Conv2d<T>::parameters);
+     conv2d_cls.def("__repr__", &conv2d_repr<T>);
+     conv2d_cls.def("__call__", &Conv2d<T>::forward, release_gil());
+
+     m_type.def("conv2d", &conv2d<T>, py::arg("input"), py::arg("weight"), py::arg("bias"),
+                py::arg("stride") = 1, py::arg("padding") = 0, py::arg("dilation") = 1, py::arg("groups") = 1, release_gil());
+     m_type.def("max_pool2d", &max_pool2d<T>, py::arg("input"), py::arg("kernel_size"), py::arg("stride") = -1, py::arg("padding") = 0, release_gil());
+     m_type.def("avg_pool2d", &avg_pool2d<T>, py::arg("input"), py::arg("kernel_size"), py::arg("stride") = -1, py::arg("padding") = 0, release_gil());
+}
+
+py::dict memory_counter_dict(const MemoryCounter& counter) {
+     py::dict result;
+     result["current_bytes"] = counter.current_bytes;
+     result["peak_bytes"] = counter.peak_bytes;
+     result["live_tensors"] = counter.live_tensors;
+     return result;
+}
+
+py::dict memory_stats_dict() {
+     auto snapshot = MemoryStats::instance().snapshot();
+     py::dict result = memory_counter_dict(snapshot.total);
+
+     for (int i = 0; i < static_cast<int>(snapshot.categories.size()); ++i) {
+          auto category = static_cast<MemoryCategory>(i);
+          result[memory_category_name(category)] = memory_counter_dict(snapshot.categories[i]);
+     }
+
+     py::dict by_op;
+     for (const auto& entry : snapshot.by_op) {
+          by_op[py::str(entry.first)] = memory_counter_dict(entry.second);
+     }
+     result["by_op"] = by_op;
+     return result;
+}
+
+py::dict step_arena_stats_dict() {
+     auto stats = thread_step_arena().get_stats();
+     py::dict result;
+     result["chunks"] = stats.chunks;
+     result["reserved_bytes"] = stats.reserved_bytes;
+     result["allocations"] = stats.allocations;
+     result["resets"] = stats.resets;
+     return result;
 }
 
 PYBIND11_MODULE(minitensor_cpp, m) {
@@ -128,4 +521,76 @@ PYBIND11_MODULE(minitensor_cpp, m) {
      define_bindings_for_type<float>(m, "float32");
      define_bindings_for_type<double>(m, "float64");
      define_bindings_for_type<int>(m, "int32");
+
+     m.def("tensor_from_data", [](py::object data, const std::string& dtype, std::vector<int> shape, bool requires_grad) {
+          try {
+               return tensor_from_data(data.ptr(), dtype, std::move(shape), requires_grad);
+          } catch (const ConversionTypeError& e) {
+               throw py::type_error(e.what());
+          }
+     }, py::arg("data"), py::arg("dtype") = "", py::arg("shape") = std::vector<int>{}, py::arg("requires_grad") = false);
+
+     m.def("is_grad_enabled", &GradMode::is_enabled);
+     m.def("set_grad_enabled", &GradMode::set_enabled, py::arg("enabled"));
+
+     m.def("manual_seed", &manual_seed, py::arg("seed"));
+     m.def("initial_seed", &initial_seed);
+
+     py::class_<TrainerProgress>(m, "TrainerProgress")
+          .def_readonly("epoch", &TrainerProgress::epoch)
+          .def_readonly("step", &TrainerProgress::step)
+          .def_readonly("loss", &TrainerProgress::loss)
+          .def_readonly("seconds", &TrainerProgress::seconds)
+          .def("__repr__", [](const TrainerProgress& p) {
+               return "TrainerProgress(epoch=" + std::to_string(p.epoch) + ", step=" + std::to_string(p.step) +
+                      ", loss=" + std::to_string(p.loss) + ")";
+          });
+
+     m.def("get_num_threads", &get_num_threads);
+     m.def("set_num_threads", &set_num_threads, py::arg("threads"));
+
+     m.def("get_autocast", []() { return precision_name(Autocast::precision()); });
+     m.def("set_autocast", [](const std::string& precision) {
+          Autocast::set_precision(precision_from_string(precision));
+     }, py::arg("precision"));
+
+     m.def("is_fast_math", &MathMode::is_fast);
+     m.def("set_fast_math", &MathMode::set_fast, py::arg("enabled"));
+
+     py::class_<ShmCommunicator, std::shared_ptr<ShmCommunicator>>(m, "ShmCommunicator")
+          .def(py::init<const std::string&, int, int, size_t, double>(),
+               py::arg("name"), py::arg("rank"), py::arg("world_size"),
+               py::arg("capacity_bytes") = 4 << 20, py::arg("timeout") = 300.0, release_gil())
+          .def_property_readonly("rank", &ShmCommunicator::rank)
+          .def_property_readonly("world_size", &ShmCommunicator::world_size)
+          .def("barrier", &ShmCommunicator::barrier, release_gil());
+
+     py::class_<InferencePlan, std::shared_ptr<InferencePlan>>(m, "InferencePlan")
+          .def_static("load", [](const std::string& path) {
+               return std::make_shared<InferencePlan>(InferencePlan::load(path));
+          }, py::arg("path"))
+          .def_static("from_bytes", [](const py::bytes& data) {
+               return std::make_shared<InferencePlan>(InferencePlan::from_bytes(data));
+          }, py::arg("data"))
+          .def("save", &InferencePlan::save, py::arg("path"))
+          .def("to_bytes", [](const InferencePlan& plan) { return py::bytes(plan.to_bytes()); })
+          .def("summary", &InferencePlan::summary)
+          .def_readonly("input_features", &InferencePlan::input_features)
+          .def_readonly("output_features", &InferencePlan::output_features)
+          .def_readonly("max_batch", &InferencePlan::max_batch)
+          .def_property_readonly("num_steps", [](const InferencePlan& plan) { return plan.steps.size(); })
+          .def_property_readonly("arena_bytes", [](const InferencePlan& plan) { return plan.arena_floats() * sizeof(float); });
+
+     py::class_<PlanRunner, std::shared_ptr<PlanRunner>>(m, "PlanRunner")
+          .def(py::init([](const std::shared_ptr<InferencePlan>& plan) {
+               return std::make_shared<PlanRunner>(plan);
+          }), py::arg("plan"))
+          .def("run", py::overload_cast<const std::vector<float>&>(&PlanRunner::run), py::arg("input"), release_gil());
+
+     m.def("memory_stats", &memory_stats_dict);
+     m.def("reset_peak_memory_stats", []() { MemoryStats::instance().reset_peak(); });
+
+     m.def("step_arena_enter", &StepArenaScope::enter);
+     m.def("step_arena_exit", &StepArenaScope::exit);
+     m.def("step_arena_stats", &step_arena_stats_dict);
 }
\ No newline at end of file
@@ -1,3 +1,4 @@
+import sys
 from setuptools import setup
 from pybind11.setup_helpers import Pybind11Extension, build_ext
 import pybind11
@@ -11,6 +12,7 @@ ext_modules = [
             "core"
         ],
         cxx_std=17,
+        libraries=["rt"] if sys.platform.startswith("linux") else [],
     ),
 ]
 
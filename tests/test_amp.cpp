@@ -0,0 +1,101 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "losses/losses.h"
+#include "optims/optims.h"
+#include "optims/master_weights.h"
+
+using TensorPtr = std::shared_ptr<Tensor<float>>;
+
+static std::shared_ptr<Linear<float>> make_linear(int in, int out) {
+    auto linear = std::make_shared<Linear<float>>(in, out, std::make_shared<Constant_Val<float>>(0.0f),
+                                                 std::make_shared<Constant_Val<float>>(0.0f));
+    auto weight = linear->parameters()[0];
+    for (int i = 0; i < weight->size; ++i) weight->data[i] = 0.3f * std::sin(i * 0.7f);
+    return linear;
+}
+
+static TensorPtr filled(const std::vector<int>& shape, float scale) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<float> values(n);
+    for (int i = 0; i < n; ++i) values[i] = std::sin(i * scale);
+    return make_tensor<float>(values, shape);
+}
+
+TEST(rounding_matches_the_storage_formats) {
+    // 1 + 2^-8 is halfway between bfloat16 neighbours and ties to even
+    CHECK(round_to_bfloat16(1.0f + 1.0f / 256) == 1.0f);
+    CHECK(round_to_bfloat16(1.0f + 3.0f / 256) == 1.0f + 4.0f / 256);
+    CHECK(round_to_float16(1.0f + 1.0f / 4096) == 1.0f);
+    CHECK(round_to_float16(65504.0f) == 65504.0f);
+    CHECK(round_to_float16(65519.0f) == 65504.0f);
+    CHECK(std::isinf(round_to_float16(65520.0f)));
+    CHECK(round_to_float16(-std::ldexp(1.0f, -24)) == -std::ldexp(1.0f, -24));
+    CHECK(round_to_float16(std::ldexp(1.0f, -26)) == 0.0f);
+    CHECK(std::isnan(round_to_float16(std::numeric_limits<float>::quiet_NaN())));
+}
+
+TEST(autocast_rounds_matmul_outputs) {
+    auto a = make_tensor<float>({1.0f + 1.0f / 1024, 1.0f}, {1, 2});
+    auto b = make_tensor<float>({1.0f, 1.0f}, {2, 1});
+    CHECK(mat_mul(a, b)->data[0] == 2.0f + 1.0f / 1024);
+    AutocastGuard autocast(Precision::BFloat16);
+    CHECK(mat_mul(a, b)->data[0] == 2.0f);
+}
+
+TEST(unscale_reports_overflow) {
+    auto p = make_tensor<float>({1, 2}, {2}, true);
+    p->grad = make_tensor<float>({4, 8}, {2});
+    CHECK(unscale_grads<float>({p}, 0.25f));
+    check_values(*p->grad, {1, 2}, 0.0, "unscaled grad");
+    p->grad->data[1] = std::numeric_limits<float>::infinity();
+    CHECK(!unscale_grads<float>({p}, 0.25f));
+}
+
+TEST(master_weights_skip_overflowing_steps) {
+    auto model = make_linear(4, 2);
+    MasterWeights<float> masters(model->parameters(), Precision::Float16);
+    SGD<float> optimizer(masters.master_parameters(), 0.1f);
+    auto x = filled({8, 4}, 0.4f), target = filled({8, 2}, 0.9f);
+    auto before = to_vector(*model->parameters()[0]);
+
+    // a scale of 2^40 pushes the gradients past the float16 range
+    float scale = std::ldexp(1.0f, 40);
+    int skipped = 0;
+    bool stepped = false;
+    while (!stepped) {
+        masters.zero_grad();
+        tensor_scalar_mul(mse_loss(target, model->forward(x)), scale)->backward();
+        stepped = masters.unscale_grads(1.0f / scale);
+        if (stepped) {
+            optimizer.step();
+            masters.copy_to_model();
+        } else {
+            ++skipped;
+            auto master_grad = masters.master_parameters()[0]->grad;
+            CHECK(!master_grad || to_vector(*master_grad) == std::vector<float>(master_grad->size, 0.0f));
+            CHECK(to_vector(*model->parameters()[0]) == before);
+            scale *= 0.5f;
+        }
+    }
+    CHECK(skipped > 10);
+    CHECK(to_vector(*model->parameters()[0]) != before);
+
+    // the step that went through matches an unscaled float32 step, up to float16 rounding
+    auto reference = make_linear(4, 2);
+    for (auto& p : reference->parameters()) round_to_precision(p->data.get(), p->size, Precision::Float16);
+    mse_loss(target, reference->forward(x))->backward();
+    SGD<float>(reference->parameters(), 0.1f).step();
+    auto weight = model->parameters()[0];
+    for (int i = 0; i < weight->size; ++i) {
+        CHECK_NEAR(weight->data[i], reference->parameters()[0]->data[i], 2e-3);
+        CHECK(weight->data[i] == round_to_float16(weight->data[i]));
+    }
+}
+
+int main() { return run_tests(); }
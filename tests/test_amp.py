@@ -0,0 +1,61 @@
+import unittest
+from minitensor.amp import GradScaler, MasterWeightOptimizer
+
+class OverflowingOptimizer(MasterWeightOptimizer):
+    """Stands in for a MasterWeightOptimizer whose scaled gradients overflow
+    whenever the loss scale is above `limit`."""
+
+    def __init__(self, limit: float):
+        self.limit = limit
+        self.steps = 0
+
+    def step(self, inv_scale: float = 1.0) -> bool:
+        if 1.0 / inv_scale > self.limit:
+            return False
+        self.steps += 1
+        return True
+
+def train(scaler: GradScaler, optimizer: OverflowingOptimizer, iterations: int):
+    for _ in range(iterations):
+        scaler.step(optimizer)
+        scaler.update()
+
+class GradScalerTest(unittest.TestCase):
+    def test_overflowing_steps_are_skipped_and_back_off(self):
+        scaler = GradScaler(init_scale=2.0 ** 16)
+        optimizer = OverflowingOptimizer(limit=2.0 ** 10)
+        train(scaler, optimizer, 10)
+        self.assertEqual(scaler.skipped_steps, 6)
+        self.assertEqual(optimizer.steps, 4)
+        self.assertEqual(scaler.get_scale(), 2.0 ** 10)
+
+    def test_scale_grows_after_the_interval(self):
+        scaler = GradScaler(init_scale=4.0, growth_interval=3)
+        optimizer = OverflowingOptimizer(limit=float("inf"))
+        train(scaler, optimizer, 2)
+        self.assertEqual(scaler.get_scale(), 4.0)
+        train(scaler, optimizer, 1)
+        self.assertEqual(scaler.get_scale(), 8.0)
+        train(scaler, optimizer, 3)
+        self.assertEqual(scaler.get_scale(), 16.0)
+
+    def test_overflow_restarts_the_growth_interval(self):
+        scaler = GradScaler(init_scale=4.0, growth_interval=2)
+        optimizer = OverflowingOptimizer(limit=6.0)
+        train(scaler, optimizer, 2)
+        self.assertEqual(scaler.get_scale(), 8.0)
+        train(scaler, optimizer, 1)
+        self.assertEqual(scaler.get_scale(), 4.0)
+        train(scaler, optimizer, 1)
+        self.assertEqual(scaler.get_scale(), 4.0)
+        self.assertEqual(scaler.skipped_steps, 1)
+
+    def test_disabled_scaler_is_a_no_op(self):
+        scaler = GradScaler(init_scale=2.0 ** 16, enabled=False)
+        loss = object()
+        self.assertIs(scaler.scale(loss), loss)
+        train(scaler, OverflowingOptimizer(limit=2.0), 3)
+        self.assertEqual(scaler.get_scale(), 1.0)
+
+if __name__ == "__main__":
+    unittest.main()
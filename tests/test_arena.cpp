@@ -0,0 +1,87 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "losses/losses.h"
+#include "nn/activations/activations.h"
+#include "nn/layers/layers.h"
+
+template<typename T>
+static std::shared_ptr<Linear<T>> make_linear(int in, int out) {
+    return std::make_shared<Linear<T>>(in, out, std::make_shared<Constant_Val<T>>(static_cast<T>(0.05)),
+                                       std::make_shared<Constant_Val<T>>(static_cast<T>(0.1)));
+}
+
+static std::shared_ptr<Tensor<float>> filled(const std::vector<int>& shape, float scale, bool requires_grad) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<float> values(n);
+    for (int i = 0; i < n; ++i) values[i] = std::sin(i * scale);
+    return std::make_shared<Tensor<float>>(values, shape, requires_grad);
+}
+
+// One embedding + MLP step; returns the loss.
+static std::shared_ptr<Tensor<float>> embedding_step(const std::shared_ptr<Tensor<float>>& table,
+                                                     const std::shared_ptr<Linear<float>>& head, int step) {
+    std::vector<int> ids(32);
+    for (int i = 0; i < 32; ++i) ids[i] = (i * 7 + step * 13) % table->shape[0];
+    auto indices = std::make_shared<Tensor<int>>(ids, std::vector<int>{32}, false);
+    auto target = filled({32, 4}, 0.3f, false);
+    auto loss = mse_loss(target, head->forward(relu(embedding(table, indices, true))));
+    loss->backward();
+    return loss;
+}
+
+TEST(step_results_match_heap_allocation) {
+    std::vector<float> grads[2];
+    float losses[2];
+    for (int mode = 0; mode < 2; ++mode) {
+        auto l1 = make_linear<float>(16, 32), l2 = make_linear<float>(32, 4);
+        auto x = filled({8, 16}, 0.1f, false), t = filled({8, 4}, 0.7f, false);
+        std::shared_ptr<Tensor<float>> loss;
+        {
+            if (mode) StepArenaScope::enter();
+            loss = mse_loss(t, l2->forward(relu(l1->forward(x))));
+            loss->backward();
+            if (mode) StepArenaScope::exit();
+        }
+        losses[mode] = loss->data[0];
+        grads[mode] = to_vector(*l1->parameters()[0]->grad);
+    }
+    CHECK(losses[0] == losses[1]);
+    CHECK(grads[0] == grads[1]);
+}
+
+TEST(kept_results_live_on_the_heap) {
+    auto table = filled({100, 16}, 0.2f, true);
+    auto head = make_linear<float>(16, 4);
+    std::shared_ptr<Tensor<float>> loss;
+    {
+        StepArenaScope scope;
+        loss = embedding_step(table, head, 0);
+    }
+    CHECK(!step_in_arena(loss->data.get()));
+    CHECK(!step_in_arena(head->parameters()[0]->grad->data.get()));
+    CHECK(table->sparse_grad != nullptr);
+    if (table->sparse_grad) CHECK(!step_in_arena(table->sparse_grad->values->data.get()));
+}
+
+TEST(sparse_gradients_do_not_pin_arena_chunks) {
+    auto table = filled({1000, 64}, 0.2f, true);
+    auto head = make_linear<float>(64, 4);
+    std::vector<std::shared_ptr<Tensor<float>>> losses;
+    long long chunks_after_first = 0;
+    for (int step = 0; step < 20; ++step) {
+        {
+            StepArenaScope scope;
+            // the sparse gradient is kept across steps and merged with the next one
+            losses.push_back(embedding_step(table, head, step));
+        }
+        if (step == 0) chunks_after_first = thread_step_arena().get_stats().chunks;
+    }
+    CHECK(thread_step_arena().get_stats().chunks == chunks_after_first);
+    CHECK(table->sparse_grad->nnz() > 32);
+}
+
+int main() { return run_tests(); }
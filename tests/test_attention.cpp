@@ -0,0 +1,103 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static TensorPtr filled(const std::vector<int>& shape, double scale, double amplitude, bool requires_grad) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = amplitude * std::sin(i * scale + 0.1);
+    return make_tensor<double>(values, shape, requires_grad);
+}
+
+// softmax(q k^T * scale + mask) v with the whole score matrix, head by head.
+static std::vector<double> naive_attention(const Tensor<double>& q, const Tensor<double>& k, const Tensor<double>& v,
+                                           const Tensor<double>* mask, bool causal) {
+    int nd = q.ndim, L = q.shape[nd - 2], S = k.shape[nd - 2], D = q.shape[nd - 1], Dv = v.shape[nd - 1];
+    int heads = q.size / (L * D);
+    double scale = 1 / std::sqrt(static_cast<double>(D));
+    std::vector<double> out;
+    for (int h = 0; h < heads; ++h) {
+        for (int i = 0; i < L; ++i) {
+            std::vector<double> p(S);
+            double max_score = -std::numeric_limits<double>::infinity();
+            for (int j = 0; j < S; ++j) {
+                double s = 0;
+                for (int d = 0; d < D; ++d) s += q.data[(h * L + i) * D + d] * k.data[(h * S + j) * D + d];
+                s *= scale;
+                if (mask) s += mask->data[i * S + j];
+                if (causal && j > i) s = -std::numeric_limits<double>::infinity();
+                p[j] = s;
+                max_score = std::max(max_score, s);
+            }
+            double total = 0;
+            for (double& x : p) total += (x = std::exp(x - max_score));
+            for (int c = 0; c < Dv; ++c) {
+                double acc = 0;
+                for (int j = 0; j < S; ++j) acc += p[j] / total * v.data[(h * S + j) * Dv + c];
+                out.push_back(acc);
+            }
+        }
+    }
+    return out;
+}
+
+static TensorPtr weighted(const TensorPtr& y) {
+    std::vector<double> weights(y->size);
+    for (int i = 0; i < y->size; ++i) weights[i] = std::cos(i * 0.37);
+    return sum(tensor_mul(y, make_tensor<double>(weights, y->shape)));
+}
+
+// lengths span several query and key tiles, with partial tiles at the end
+const int L = 70, S = 150, D = 8, Dv = 5;
+
+TEST(attention_matches_full_softmax) {
+    auto q = filled({2, 3, L, D}, 0.31, 1.0, false);
+    auto k = filled({2, 3, S, D}, 0.17, 1.0, false);
+    auto v = filled({2, 3, S, Dv}, 0.23, 1.0, false);
+    auto mask = filled({L, S}, 0.05, 2.0, false);
+    for (int mode = 0; mode < 4; ++mode) {
+        auto m = mode & 1 ? mask : nullptr;
+        bool causal = mode & 2;
+        auto y = scaled_dot_product_attention(q, k, v, m, causal);
+        CHECK(y->shape == std::vector<int>({2, 3, L, Dv}));
+        check_values(*y, naive_attention(*q, *k, *v, m.get(), causal), 1e-12, "attention");
+    }
+}
+
+TEST(large_scores_do_not_overflow) {
+    auto q = filled({1, 40, D}, 0.31, 300.0, false);
+    auto k = filled({1, 100, D}, 0.17, 300.0, false);
+    auto v = filled({1, 100, Dv}, 0.23, 1.0, false);
+    auto y = scaled_dot_product_attention(q, k, v);
+    check_values(*y, naive_attention(*q, *k, *v, nullptr, false), 1e-9, "attention");
+}
+
+TEST(attention_gradients_match_finite_differences) {
+    // 40 queries and 80 keys cross one query tile and one key tile boundary
+    for (bool causal : {false, true}) {
+        auto q = filled({2, 40, 3}, 0.31, 1.0, true);
+        auto k = filled({2, 80, 3}, 0.17, 1.0, true);
+        auto v = filled({2, 80, 2}, 0.23, 1.0, true);
+        auto mask = filled({40, 80}, 0.05, 1.0, false);
+        auto loss = [&] { return weighted(scaled_dot_product_attention(q, k, v, mask, causal)); };
+        loss()->backward();
+        for (auto& t : {q, k, v}) check_values(*t->grad, numeric_grad(t, loss), 1e-8, "attention grad");
+    }
+}
+
+TEST(attention_checks_shapes) {
+    auto q = filled({2, 4, D}, 0.31, 1.0, false);
+    auto k = filled({2, 6, D}, 0.17, 1.0, false);
+    CHECK_THROWS(scaled_dot_product_attention(q, k, filled({2, 5, Dv}, 0.2, 1.0, false)));
+    CHECK_THROWS(scaled_dot_product_attention(q, filled({2, 6, D + 1}, 0.1, 1.0, false), filled({2, 6, Dv}, 0.2, 1.0, false)));
+    CHECK_THROWS(scaled_dot_product_attention(q, k, filled({2, 6, Dv}, 0.2, 1.0, false), filled({6, 4}, 0.1, 1.0, false)));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,38 @@
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+
+TEST(bias_add_with_batch_above_one) {
+    auto x = make_tensor<double>({1, 2, 3, 4, 5, 6}, {3, 2}, true);
+    auto bias = make_tensor<double>({10, 20}, {1, 2}, true);
+    auto y = tensor_add(x, bias);
+    check_values(*y, {11, 22, 13, 24, 15, 26}, 0.0, "x + bias");
+    sum(y)->backward();
+    check_values(*x->grad, {1, 1, 1, 1, 1, 1}, 0.0, "x.grad");
+    check_values(*bias->grad, {3, 3}, 0.0, "bias.grad");
+}
+
+TEST(bias_on_either_side) {
+    auto x = make_tensor<double>({1, 2, 3, 4, 5, 6}, {3, 2});
+    auto bias = make_tensor<double>({10, 20}, {2});
+    check_values(*tensor_add(bias, x), {11, 22, 13, 24, 15, 26}, 0.0, "bias + x");
+    check_values(*tensor_sub(x, bias), {-9, -18, -7, -16, -5, -14}, 0.0, "x - bias");
+}
+
+TEST(column_broadcast_in_mul_and_div) {
+    auto x = make_tensor<double>({1, 2, 3, 4, 5, 6}, {2, 3}, true);
+    auto scale = make_tensor<double>({2, 4}, {2, 1}, true);
+    check_values(*tensor_mul(x, scale), {2, 4, 6, 16, 20, 24}, 0.0, "x * scale");
+    check_values(*tensor_div(x, scale), {0.5, 1, 1.5, 1, 1.25, 1.5}, 1e-15, "x / scale");
+    sum(tensor_mul(x, scale))->backward();
+    check_values(*scale->grad, {6, 15}, 0.0, "scale.grad");
+}
+
+TEST(broadcast_on_both_operands) {
+    auto row = make_tensor<double>({1, 2, 3}, {1, 3});
+    auto col = make_tensor<double>({10, 20}, {2, 1});
+    check_values(*tensor_add(row, col), {11, 12, 13, 21, 22, 23}, 0.0, "row + col");
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,103 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/activations/activations.h"
+#include "nn/layers/layers.h"
+#include "optims/master_weights.h"
+#include "autograd/checkpoint.h"
+
+template<typename T>
+static std::shared_ptr<Linear<T>> make_linear(int in, int out, T w, T b) {
+    return std::make_shared<Linear<T>>(in, out, std::make_shared<Constant_Val<T>>(w), std::make_shared<Constant_Val<T>>(b));
+}
+
+static std::vector<double> inputs(int n) {
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = std::sin(i * 0.7);
+    return values;
+}
+
+TEST(no_grad_keeps_explicit_leaves_trainable) {
+    NoGradGuard no_grad;
+    auto leaf = std::make_shared<Tensor<double>>(std::vector<int>{2, 2}, true);
+    CHECK(leaf->requires_grad);
+    auto linear = make_linear<double>(3, 2, 0.5, 0.1);
+    for (auto& p : linear->parameters()) CHECK(p->requires_grad);
+    MasterWeights<float> masters({std::make_shared<Tensor<float>>(std::vector<int>{4}, true)}, Precision::BFloat16);
+    for (auto& m : masters.master_parameters()) CHECK(m->requires_grad);
+}
+
+TEST(no_grad_op_results_record_nothing) {
+    auto x = make_tensor<double>(inputs(6), {2, 3}, true);
+    auto linear = make_linear<double>(3, 2, 0.5, 0.1);
+    NoGradGuard no_grad;
+    auto y = relu(linear->forward(tensor_scalar_mul(x, 2.0)));
+    CHECK(!y->requires_grad);
+    CHECK(y->grad_fn == nullptr);
+    CHECK(y->parents.empty());
+}
+
+TEST(parameters_built_under_no_grad_train_afterwards) {
+    std::shared_ptr<Linear<double>> linear;
+    {
+        NoGradGuard no_grad;
+        linear = make_linear<double>(3, 2, 0.5, 0.1);
+    }
+    auto x = make_tensor<double>(inputs(6), {2, 3});
+    sum(linear->forward(x))->backward();
+    CHECK(linear->parameters()[0]->grad != nullptr);
+}
+
+TEST(checkpoint_matches_plain_backward) {
+    std::vector<double> grads[2], weight_grads[2], outputs[2];
+    for (int mode = 0; mode < 2; ++mode) {
+        auto l1 = make_linear<double>(3, 4, 0.3, 0.1), l2 = make_linear<double>(4, 2, -0.2, 0.05);
+        auto x = make_tensor<double>(inputs(12), {4, 3}, true);
+        Segment<double> segment = [&](std::shared_ptr<Tensor<double>> in) {
+            return tanh_fn(l2->forward(relu(l1->forward(in))));
+        };
+        auto y = mode ? checkpoint(segment, x) : segment(x);
+        sum(tensor_mul(y, y))->backward();
+        outputs[mode] = to_vector(*y);
+        grads[mode] = to_vector(*x->grad);
+        weight_grads[mode] = to_vector(*l1->parameters()[0]->grad);
+    }
+    CHECK(outputs[0] == outputs[1]);
+    for (size_t i = 0; i < grads[0].size(); ++i) CHECK_NEAR(grads[1][i], grads[0][i], 1e-12);
+    for (size_t i = 0; i < weight_grads[0].size(); ++i) CHECK_NEAR(weight_grads[1][i], weight_grads[0][i], 1e-12);
+}
+
+TEST(checkpoint_output_requires_grad_through_parameters) {
+    auto data = make_tensor<double>(inputs(6), {2, 3});
+    auto frozen = make_linear<double>(3, 2, 0.5, 0.1);
+    for (auto& p : frozen->parameters()) p->requires_grad = false;
+    auto trainable = make_linear<double>(3, 2, 0.5, 0.1);
+    auto a = checkpoint<double>([&](std::shared_ptr<Tensor<double>> in) { return relu(frozen->forward(in)); }, data);
+    auto b = checkpoint<double>([&](std::shared_ptr<Tensor<double>> in) { return relu(trainable->forward(in)); }, data);
+    CHECK(!a->requires_grad);
+    CHECK(b->requires_grad);
+    sum(b)->backward();
+    CHECK(trainable->parameters()[0]->grad != nullptr);
+}
+
+TEST(checkpoint_recompute_leaves_batch_norm_stats_alone) {
+    double mean[2], var[2], grad[2];
+    for (int mode = 0; mode < 2; ++mode) {
+        auto linear = make_linear<double>(3, 4, 0.3, 0.1);
+        auto bn = std::make_shared<BatchNorm1d<double>>(4, 1e-5, 0.1, true);
+        auto x = make_tensor<double>(inputs(24), {8, 3}, true);
+        Segment<double> segment = [&](std::shared_ptr<Tensor<double>> in) { return tanh_fn(bn->forward(linear->forward(in))); };
+        auto y = mode ? checkpoint(segment, x) : segment(x);
+        sum(y)->backward();
+        mean[mode] = bn->running_mean->data[1];
+        var[mode] = bn->running_var->data[1];
+        grad[mode] = x->grad->data[4];
+    }
+    CHECK(mean[0] == mean[1]);
+    CHECK(var[0] == var[1]);
+    CHECK_NEAR(grad[1], grad[0], 1e-12);
+}
+
+int main() { return run_tests(); }
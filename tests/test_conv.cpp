@@ -0,0 +1,148 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "utils/parallel.h"
+
+struct ConvCase { int batch, in_c, height, width, out_c, kernel, stride, padding, dilation, groups; };
+
+template<typename T>
+static std::shared_ptr<Tensor<T>> filled(const std::vector<int>& shape, double scale, bool requires_grad) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<T> values(n);
+    for (int i = 0; i < n; ++i) values[i] = static_cast<T>(std::sin(i * scale + 0.3));
+    return std::make_shared<Tensor<T>>(values, shape, requires_grad);
+}
+
+// Direct convolution and its gradients for sum(y * go).
+struct Reference { std::vector<double> out, grad_x, grad_w, grad_b; };
+
+template<typename T>
+static Reference direct_conv(const Tensor<T>& x, const Tensor<T>& w, const Tensor<T>& b, const std::vector<double>& go,
+                             const ConvCase& c, int out_h, int out_w) {
+    Reference r;
+    int cg = c.in_c / c.groups, og = c.out_c / c.groups;
+    r.out.assign(static_cast<size_t>(c.batch) * c.out_c * out_h * out_w, 0.0);
+    r.grad_x.assign(x.size, 0.0);
+    r.grad_w.assign(w.size, 0.0);
+    r.grad_b.assign(c.out_c, 0.0);
+    for (int n = 0; n < c.batch; ++n)
+    for (int oc = 0; oc < c.out_c; ++oc)
+    for (int oy = 0; oy < out_h; ++oy)
+    for (int ox = 0; ox < out_w; ++ox) {
+        int o = ((n * c.out_c + oc) * out_h + oy) * out_w + ox;
+        double acc = b.data[oc];
+        r.grad_b[oc] += go[o];
+        for (int ci = 0; ci < cg; ++ci)
+        for (int ky = 0; ky < c.kernel; ++ky)
+        for (int kx = 0; kx < c.kernel; ++kx) {
+            int iy = oy * c.stride - c.padding + ky * c.dilation;
+            int ix = ox * c.stride - c.padding + kx * c.dilation;
+            if (iy < 0 || iy >= c.height || ix < 0 || ix >= c.width) continue;
+            int xi = ((n * c.in_c + (oc / og) * cg + ci) * c.height + iy) * c.width + ix;
+            int wi = ((oc * cg + ci) * c.kernel + ky) * c.kernel + kx;
+            acc += static_cast<double>(w.data[wi]) * x.data[xi];
+            r.grad_x[xi] += go[o] * w.data[wi];
+            r.grad_w[wi] += go[o] * x.data[xi];
+        }
+        r.out[o] = acc;
+    }
+    return r;
+}
+
+template<typename T>
+static void check_against_direct(const ConvCase& c, double tol) {
+    auto x = filled<T>({c.batch, c.in_c, c.height, c.width}, 0.37, true);
+    auto w = filled<T>({c.out_c, c.in_c / c.groups, c.kernel, c.kernel}, 0.71, true);
+    auto b = filled<T>({c.out_c}, 1.3, true);
+    auto y = conv2d(x, w, b, c.stride, c.padding, c.dilation, c.groups);
+    std::vector<double> go(y->size);
+    for (int i = 0; i < y->size; ++i) go[i] = std::cos(i * 0.53);
+    std::vector<T> go_t(go.begin(), go.end());
+    sum(tensor_mul(y, std::make_shared<Tensor<T>>(go_t, y->shape, false)))->backward();
+
+    Reference r = direct_conv(*x, *w, *b, go, c, y->shape[2], y->shape[3]);
+    check_values(*y, r.out, tol, "conv2d output");
+    check_values(*x->grad, r.grad_x, tol, "input grad");
+    check_values(*w->grad, r.grad_w, tol, "weight grad");
+    check_values(*b->grad, r.grad_b, tol, "bias grad");
+}
+
+static const std::vector<ConvCase> cases = {
+    {2, 3, 7, 6, 4, 3, 1, 1, 1, 1},    // im2col
+    {3, 4, 9, 9, 6, 3, 2, 2, 2, 2},    // grouped, strided, dilated
+    {5, 6, 5, 4, 8, 1, 1, 0, 1, 2},    // pointwise
+    {4, 3, 6, 6, 3, 3, 1, 1, 1, 3},    // depthwise
+    {19, 2, 8, 8, 4, 3, 1, 1, 1, 1},   // more images than batch slices
+};
+
+TEST(conv2d_matches_direct_convolution_float) {
+    set_num_threads(4);
+    for (const auto& c : cases) check_against_direct<float>(c, 1e-4);
+}
+
+TEST(conv2d_matches_direct_convolution_double) {
+    set_num_threads(4);
+    for (const auto& c : cases) check_against_direct<double>(c, 1e-11);
+}
+
+TEST(conv2d_results_do_not_depend_on_thread_count) {
+    for (const auto& c : cases) {
+        std::vector<float> out[2], grad_x[2], grad_w[2], grad_b[2];
+        for (int run = 0; run < 2; ++run) {
+            set_num_threads(run ? 4 : 1);
+            auto x = filled<float>({c.batch, c.in_c, c.height, c.width}, 0.37, true);
+            auto w = filled<float>({c.out_c, c.in_c / c.groups, c.kernel, c.kernel}, 0.71, true);
+            auto b = filled<float>({c.out_c}, 1.3, true);
+            auto y = conv2d(x, w, b, c.stride, c.padding, c.dilation, c.groups);
+            sum(tensor_mul(y, y))->backward();
+            out[run] = to_vector(*y);
+            grad_x[run] = to_vector(*x->grad);
+            grad_w[run] = to_vector(*w->grad);
+            grad_b[run] = to_vector(*b->grad);
+        }
+        CHECK(out[0] == out[1]);
+        CHECK(grad_x[0] == grad_x[1]);
+        CHECK(grad_w[0] == grad_w[1]);
+        CHECK(grad_b[0] == grad_b[1]);
+    }
+}
+
+TEST(large_column_tiles_are_split_per_element_type) {
+    Conv2dGeometry g(64, 32, 32, 3, 3, 1, 1, 1);
+    CHECK(im2col_tile_size<float>(g) == 32768 / g.col_rows());
+    CHECK(im2col_tile_size<double>(g) == 16384 / g.col_rows());
+}
+
+TEST(max_pool_routes_gradient_to_the_maximum) {
+    std::vector<double> v(16);
+    for (int i = 0; i < 16; ++i) v[i] = i;
+    auto x = make_tensor<double>(v, {1, 1, 4, 4}, true);
+    auto y = max_pool2d(x, 2);
+    check_values(*y, {5, 7, 13, 15}, 0.0, "max_pool2d");
+    sum(y)->backward();
+    check_values(*x->grad, {0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 1}, 0.0, "x.grad");
+}
+
+TEST(max_pool_ignores_padding) {
+    std::vector<double> v(16);
+    for (int i = 0; i < 16; ++i) v[i] = -(i + 1);
+    auto x = make_tensor<double>(v, {1, 1, 4, 4});
+    check_values(*max_pool2d(x, 3, 2, 1), {-1, -2, -5, -6}, 0.0, "padded max_pool2d");
+}
+
+TEST(avg_pool_counts_padded_taps) {
+    std::vector<double> v(16);
+    for (int i = 0; i < 16; ++i) v[i] = i;
+    auto x = make_tensor<double>(v, {1, 1, 4, 4}, true);
+    check_values(*avg_pool2d(x, 2), {2.5, 4.5, 10.5, 12.5}, 0.0, "avg_pool2d");
+    auto y = avg_pool2d(x, 3, 2, 1);
+    CHECK_NEAR(y->data[0], (0 + 1 + 4 + 5) / 9.0, 1e-15);
+    sum(avg_pool2d(x, 2))->backward();
+    check_values(*x->grad, std::vector<double>(16, 0.25), 0.0, "x.grad");
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,111 @@
+#include <pybind11/embed.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "tensors/tensor_convert.h"
+
+// New reference to the value of a Python expression.
+static PyObject* eval(const std::string& expr) {
+    PyObject* globals = PyModule_GetDict(PyImport_AddModule("__main__"));
+    PyObject* result = PyRun_String(expr.c_str(), Py_eval_input, globals, globals);
+    if (!result) {
+        PyErr_Print();
+        throw std::runtime_error("ERROR: Cannot evaluate " + expr);
+    }
+    return result;
+}
+
+static std::pair<AnyTensor, std::string> convert(const std::string& expr, const std::string& dtype = "",
+                                                 std::vector<int> shape = {}) {
+    PyRef data(eval(expr));
+    return tensor_from_data(data.obj, dtype, std::move(shape), false);
+}
+
+template<typename T>
+static std::shared_ptr<Tensor<T>> convert_as(const std::string& expr, const std::string& dtype,
+                                             const std::string& expected_dtype, std::vector<int> shape = {}) {
+    auto result = convert(expr, dtype, std::move(shape));
+    CHECK(result.second == expected_dtype);
+    return std::get<std::shared_ptr<Tensor<T>>>(result.first);
+}
+
+// Python's == between a readback list and the list an expression evaluates to.
+static bool same_list(PyObject* list, const std::string& expected) {
+    PyRef actual(list), wanted(eval(expected));
+    return actual.obj && PyObject_RichCompareBool(actual.obj, wanted.obj, Py_EQ) == 1;
+}
+
+TEST(nested_lists_keep_shape_and_detect_dtype) {
+    auto f = convert_as<float>("[[1, 2.5, -3], [4, 5, 6]]", "", "float32");
+    CHECK(f->shape == std::vector<int>({2, 3}));
+    check_values(*f, {1, 2.5, -3, 4, 5, 6}, 0.0, "float32");
+    auto i = convert_as<int>("((1, 2), (3, 4), (5, 6))", "", "int32");
+    CHECK(i->shape == std::vector<int>({3, 2}));
+    check_values(*i, {1, 2, 3, 4, 5, 6}, 0.0, "int32");
+    auto d = convert_as<double>("[0.1, 0.2, 0.3, 0.4]", "float64", "float64", {2, 2});
+    CHECK(d->shape == std::vector<int>({2, 2}));
+    check_values(*d, {0.1, 0.2, 0.3, 0.4}, 0.0, "float64");
+    auto deep = convert_as<float>("[[[[7.0]]]]", "", "float32");
+    CHECK(deep->shape == std::vector<int>({1, 1, 1, 1}));
+}
+
+TEST(malformed_lists_are_rejected) {
+    for (const char* ragged : {"[[1, 2], [3]]", "[[1, 2], 3]", "[1, [2]]", "[[[1]], [2]]", "[[], []]", "[]"}) {
+        CHECK_THROWS(convert(ragged));
+    }
+    CHECK_THROWS(convert("[1, 'a']"));
+    CHECK_THROWS(convert("[1, None]"));
+    CHECK_THROWS(convert("[1.5, 2]", "int32"));
+    CHECK_THROWS(convert("[2 ** 40]", "int32"));
+    CHECK_THROWS(convert("[2 ** 80]"));
+    CHECK_THROWS(convert("[1, 2, 3]", "float32", {2, 2}));
+    CHECK_THROWS(convert("[[1, 2], [3, 4]]", "float32", {4}));
+    CHECK_THROWS(convert("[1, 2]", "complex"));
+    CHECK_THROWS(convert("42"));
+}
+
+TEST(buffers_are_copied_with_their_element_type) {
+    PyRun_SimpleString("import array");
+    auto f = convert_as<float>("array.array('f', [1.5, -2, 3])", "", "float32");
+    check_values(*f, {1.5, -2, 3}, 0.0, "float buffer");
+    auto d = convert_as<double>("array.array('d', [0.1, 0.2, 0.3, 0.4, 0.5, 0.6])", "", "float64", {3, 2});
+    CHECK(d->shape == std::vector<int>({3, 2}));
+    check_values(*d, {0.1, 0.2, 0.3, 0.4, 0.5, 0.6}, 0.0, "double buffer");
+    auto i = convert_as<int>("array.array('h', [-7, 8, 9])", "", "int32");
+    check_values(*i, {-7, 8, 9}, 0.0, "short buffer");
+    auto widened = convert_as<double>("array.array('B', [1, 255])", "float64", "float64");
+    check_values(*widened, {1, 255}, 0.0, "byte buffer");
+    CHECK_THROWS(convert("array.array('d', [1.0])", "int32"));
+    CHECK_THROWS(convert("array.array('d')"));
+    CHECK_THROWS(convert("array.array('u', 'ab')"));
+}
+
+TEST(strided_buffers_follow_their_strides) {
+    PyRun_SimpleString("import array");
+    auto step = convert_as<double>("memoryview(array.array('d', range(8)))[1::3]", "", "float64");
+    check_values(*step, {1, 4, 7}, 0.0, "1D strided");
+    // rows 0 and 2 of a 4 x 3 matrix
+    auto rows = convert_as<double>("memoryview(array.array('d', range(12))).cast('B').cast('d', [4, 3])[::2]",
+                                   "", "float64");
+    CHECK(rows->shape == std::vector<int>({2, 3}));
+    check_values(*rows, {0, 1, 2, 6, 7, 8}, 0.0, "2D strided");
+    CHECK_THROWS(convert("memoryview(array.array('d', range(12))).cast('B').cast('d', [4, 3])", "", {12}));
+}
+
+TEST(readback_builds_nested_and_flat_lists) {
+    auto f = convert_as<float>("[[1, 2.5, -3], [4, 5, 6]]", "", "float32");
+    CHECK(same_list(py_nested_list(*f, 0, f->data.get()), "[[1.0, 2.5, -3.0], [4.0, 5.0, 6.0]]"));
+    CHECK(same_list(py_flat_list(f->data.get(), f->size), "[1.0, 2.5, -3.0, 4.0, 5.0, 6.0]"));
+    auto i = convert_as<int>("[[[1, 2]], [[3, 4]]]", "", "int32");
+    CHECK(same_list(py_nested_list(*i, 0, i->data.get()), "[[[1, 2]], [[3, 4]]]"));
+    PyRef flat(py_flat_list(i->data.get(), i->size));
+    for (int k = 0; k < i->size; ++k) CHECK(PyLong_CheckExact(PyList_GET_ITEM(flat.obj, k)));
+}
+
+int main() {
+    pybind11::scoped_interpreter python;
+    return run_tests();
+}
@@ -0,0 +1,185 @@
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "nn/activations/activations.h"
+#include "optims/optims.h"
+#include "distributed/distributed.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+const int world = 3;
+
+// Runs rank(r) in `world` forked processes and returns how many of them failed.
+template<typename F>
+static int run_ranks(F rank) {
+    std::vector<pid_t> pids;
+    for (int r = 0; r < world; ++r) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            alarm(60);
+            int failures = 0;
+            try {
+                failures = rank(r);
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "rank %d: %s\n", r, e.what());
+                failures = 1;
+            }
+            _exit(failures == 0 ? 0 : 1);
+        }
+        pids.push_back(pid);
+    }
+    int failed = 0;
+    for (pid_t pid : pids) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        failed += !(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    return failed;
+}
+
+static std::string segment_name(const char* test) {
+    return "/minitensor_test_" + std::string(test) + "_" + std::to_string(getpid());
+}
+
+struct Model {
+    std::shared_ptr<Linear<double>> l1, l2;
+
+    Model() {
+        l1 = std::make_shared<Linear<double>>(4, 8, std::make_shared<Constant_Val<double>>(0.0),
+                                             std::make_shared<Constant_Val<double>>(0.1));
+        l2 = std::make_shared<Linear<double>>(8, 3, std::make_shared<Constant_Val<double>>(0.0),
+                                             std::make_shared<Constant_Val<double>>(0.1));
+        for (auto& p : parameters()) {
+            for (int i = 0; i < p->size; ++i) p->data[i] = 0.4 * std::sin(i * 0.9 + p->size);
+        }
+    }
+
+    std::vector<TensorPtr> parameters() {
+        auto params = l1->parameters();
+        for (auto& p : l2->parameters()) params.push_back(p);
+        return params;
+    }
+
+    // Rank 0 skips l2 when `uneven` is set, so l2 is not reached on that rank.
+    TensorPtr loss(int rank, bool uneven = false) {
+        std::vector<double> values(2 * 4);
+        for (int i = 0; i < 8; ++i) values[i] = std::sin(i + 3.0 * rank);
+        auto h = tanh_fn(l1->forward(make_tensor<double>(values, {2, 4})));
+        if (uneven && rank == 0) return sum(h);
+        return sum(tanh_fn(l2->forward(h)));
+    }
+};
+
+// Average over every rank's batch, computed in one process.
+static std::vector<std::vector<double>> reference_grads(Model& model, bool uneven) {
+    std::vector<std::vector<double>> grads;
+    for (auto& p : model.parameters()) p->zero_grad();
+    for (int r = 0; r < world; ++r) model.loss(r, uneven)->backward();
+    for (auto& p : model.parameters()) {
+        std::vector<double> g(p->size, 0.0);
+        if (p->grad) for (int i = 0; i < p->size; ++i) g[i] = p->grad->data[i] / world;
+        grads.push_back(g);
+    }
+    return grads;
+}
+
+TEST(all_reduce_and_broadcast_across_chunks) {
+    std::string name = segment_name("collectives");
+    CHECK(run_ranks([&](int rank) {
+        ShmCommunicator comm(name, rank, world, 1024);
+        std::vector<double> v(1000);
+        for (int i = 0; i < 1000; ++i) v[i] = i * 0.5 + rank;
+        comm.all_reduce(v.data(), v.size(), false);
+        int failures = 0;
+        for (int i = 0; i < 1000; ++i) failures += v[i] != world * i * 0.5 + world * (world - 1) / 2.0;
+        std::vector<float> b(300, rank == 0 ? 7.0f : 1.0f);
+        comm.broadcast(b.data(), b.size(), 0);
+        for (float x : b) failures += x != 7.0f;
+        return failures;
+    }) == 0);
+}
+
+TEST(ddp_gradients_match_single_process) {
+    std::string name = segment_name("grads");
+    CHECK(run_ranks([&](int rank) {
+        auto comm = std::make_shared<ShmCommunicator>(name, rank, world);
+        Model model, reference;
+        // replicas start different and are synchronised from rank 0
+        for (auto& p : model.parameters()) p->data[0] += rank;
+        // small buckets, so several are in flight during backward
+        GradReducer<double> reducer(comm, model.parameters(), 64);
+        reducer.broadcast_parameters();
+        SGD<double> optimizer(model.parameters(), 0.1);
+        // the reference holds the sum over ranks, not the average
+        SGD<double> reference_optimizer(reference.parameters(), 0.1 / world);
+
+        int failures = 0;
+        for (int step = 0; step < 3; ++step) {
+            optimizer.zero_grad();
+            model.loss(rank)->backward();
+            auto expected = reference_grads(reference, false);
+            auto params = model.parameters();
+            for (size_t k = 0; k < params.size(); ++k) {
+                for (int i = 0; i < params[k]->size; ++i) {
+                    failures += !(std::abs(params[k]->grad->data[i] - expected[k][i]) <= 1e-12);
+                }
+            }
+            optimizer.step();
+            reference_optimizer.step();
+        }
+        auto params = model.parameters(), expected = reference.parameters();
+        for (size_t k = 0; k < params.size(); ++k) {
+            for (int i = 0; i < params[k]->size; ++i) {
+                failures += !(std::abs(params[k]->data[i] - expected[k]->data[i]) <= 1e-12);
+            }
+        }
+        return failures;
+    }) == 0);
+}
+
+TEST(parameters_unused_on_one_rank_are_still_averaged) {
+    std::string name = segment_name("unused");
+    CHECK(run_ranks([&](int rank) {
+        auto comm = std::make_shared<ShmCommunicator>(name, rank, world);
+        Model model, reference;
+        GradReducer<double> reducer(comm, model.parameters(), 64);
+        model.loss(rank, true)->backward();
+        auto expected = reference_grads(reference, true);
+        auto params = model.parameters();
+        int failures = 0;
+        for (size_t k = 0; k < params.size(); ++k) {
+            for (int i = 0; i < params[k]->size; ++i) {
+                failures += !(std::abs(params[k]->grad->data[i] - expected[k][i]) <= 1e-12);
+            }
+        }
+        return failures;
+    }) == 0);
+}
+
+TEST(accumulated_micro_batches_are_averaged_once) {
+    std::string name = segment_name("accumulate");
+    CHECK(run_ranks([&](int rank) {
+        auto comm = std::make_shared<ShmCommunicator>(name, rank, world);
+        Model model, reference;
+        GradReducer<double> reducer(comm, model.parameters(), 64);
+        model.loss(rank)->backward();
+        model.loss(rank)->backward();
+        auto expected = reference_grads(reference, false);
+        auto params = model.parameters();
+        int failures = 0;
+        for (size_t k = 0; k < params.size(); ++k) {
+            for (int i = 0; i < params[k]->size; ++i) {
+                failures += !(std::abs(params[k]->grad->data[i] - 2 * expected[k][i]) <= 1e-12);
+            }
+        }
+        return failures;
+    }) == 0);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,105 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "optims/optims.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static TensorPtr table(int rows, int dim) {
+    std::vector<double> values(rows * dim);
+    for (int i = 0; i < rows * dim; ++i) values[i] = std::sin(i * 0.41);
+    return make_tensor<double>(values, {rows, dim}, true);
+}
+
+static std::shared_ptr<Tensor<int>> ids(const std::vector<int>& values) {
+    return std::make_shared<Tensor<int>>(values, std::vector<int>{static_cast<int>(values.size())}, false);
+}
+
+// sum(embedding(w, indices)^2) weighted by position, so duplicate rows get different gradients.
+static TensorPtr loss_of(const TensorPtr& w, const std::vector<int>& indices, bool sparse) {
+    auto e = embedding(w, ids(indices), sparse);
+    std::vector<double> weights(e->size);
+    for (int i = 0; i < e->size; ++i) weights[i] = 1.0 + 0.1 * i;
+    return sum(tensor_mul(tensor_mul(e, e), make_tensor<double>(weights, e->shape)));
+}
+
+static std::vector<double> densify(const Tensor<double>& w) {
+    std::vector<double> dense(w.size, 0.0);
+    int dim = w.shape[1];
+    const SparseGrad<double>& sg = *w.sparse_grad;
+    for (int k = 0; k < sg.nnz(); ++k) {
+        for (int j = 0; j < dim; ++j) dense[sg.indices[k] * dim + j] = sg.values->data[k * dim + j];
+    }
+    return dense;
+}
+
+const std::vector<int> batch = {4, 1, 4, 7, 1, 4};
+
+TEST(sparse_gradient_matches_dense_gradient) {
+    auto dense = table(10, 3), sparse = table(10, 3);
+    loss_of(dense, batch, false)->backward();
+    loss_of(sparse, batch, true)->backward();
+    CHECK(sparse->grad == nullptr);
+    CHECK(sparse->sparse_grad != nullptr);
+    CHECK(sparse->sparse_grad->indices == std::vector<int>({1, 4, 7}));
+    auto expected = densify(*sparse);
+    for (int i = 0; i < dense->size; ++i) CHECK_NEAR(expected[i], dense->grad->data[i], 1e-12);
+}
+
+TEST(sparse_gradients_of_two_passes_are_merged) {
+    auto dense = table(10, 3), sparse = table(10, 3);
+    loss_of(dense, batch, false)->backward();
+    loss_of(dense, {0, 7}, false)->backward();
+    loss_of(sparse, batch, true)->backward();
+    loss_of(sparse, {0, 7}, true)->backward();
+    CHECK(sparse->sparse_grad->indices == std::vector<int>({0, 1, 4, 7}));
+    auto expected = densify(*sparse);
+    for (int i = 0; i < dense->size; ++i) CHECK_NEAR(expected[i], dense->grad->data[i], 1e-12);
+}
+
+TEST(sparse_sgd_matches_dense_sgd) {
+    auto dense = table(10, 3), sparse = table(10, 3);
+    SGD<double> dense_opt({dense}, 0.1), sparse_opt({sparse}, 0.1);
+    for (int step = 0; step < 3; ++step) {
+        dense_opt.zero_grad();
+        sparse_opt.zero_grad();
+        loss_of(dense, batch, false)->backward();
+        loss_of(sparse, batch, true)->backward();
+        dense_opt.step();
+        sparse_opt.step();
+    }
+    for (int i = 0; i < dense->size; ++i) CHECK_NEAR(sparse->data[i], dense->data[i], 1e-12);
+}
+
+TEST(sparse_adam_only_moves_rows_in_the_batch) {
+    auto dense = table(10, 3), sparse = table(10, 3);
+    auto initial = to_vector(*sparse);
+    Adam<double> dense_opt({dense}, 0.01, 0.9, 0.999, 1e-8), sparse_opt({sparse}, 0.01, 0.9, 0.999, 1e-8);
+    loss_of(dense, batch, false)->backward();
+    loss_of(sparse, batch, true)->backward();
+    dense_opt.step();
+    sparse_opt.step();
+    // on the first step rows without gradient have zero moments in dense Adam too
+    for (int i = 0; i < dense->size; ++i) CHECK_NEAR(sparse->data[i], dense->data[i], 1e-12);
+
+    sparse_opt.zero_grad();
+    loss_of(sparse, {2}, true)->backward();
+    sparse_opt.step();
+    for (int row : {0, 3, 5, 6, 8, 9}) {
+        for (int j = 0; j < 3; ++j) CHECK(sparse->data[row * 3 + j] == initial[row * 3 + j]);
+    }
+    // lazy update: rows from the first batch keep their value on the second step
+    for (int j = 0; j < 3; ++j) CHECK(sparse->data[4 * 3 + j] == dense->data[4 * 3 + j]);
+    CHECK(sparse->data[2 * 3] != initial[2 * 3]);
+}
+
+TEST(embedding_rejects_out_of_range_indices) {
+    auto w = table(10, 3);
+    CHECK_THROWS(embedding(w, ids({3, 10})));
+    CHECK_THROWS(embedding(w, ids({-1})));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,144 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "nn/activations/activations.h"
+#include "losses/losses.h"
+#include "optims/optims.h"
+#include "utils/random.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static std::shared_ptr<Linear<double>> make_linear(int in, int out, int seed) {
+    auto linear = std::make_shared<Linear<double>>(in, out, std::make_shared<Constant_Val<double>>(0.0),
+                                                  std::make_shared<Constant_Val<double>>(0.0));
+    for (auto& p : linear->parameters()) {
+        for (int i = 0; i < p->size; ++i) p->data[i] = 0.5 * std::sin(i * 0.7 + seed * 1.9 + p->size);
+    }
+    return linear;
+}
+
+static TensorPtr filled(const std::vector<int>& shape, double scale, bool requires_grad = false) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = std::sin(i * scale + 0.2);
+    return make_tensor<double>(values, shape, requires_grad);
+}
+
+static TensorPtr weighted(const TensorPtr& y, int offset = 0) {
+    std::vector<double> weights(y->size);
+    for (int i = 0; i < y->size; ++i) weights[i] = std::cos((i + offset) * 0.37);
+    return sum(tensor_mul(y, make_tensor<double>(weights, y->shape)));
+}
+
+// Member m's block of a tensor stacked along its first dimension.
+static std::vector<double> slice(const Tensor<double>& t, int m) {
+    int per_member = t.size / t.shape[0];
+    return std::vector<double>(t.data.get() + m * per_member, t.data.get() + (m + 1) * per_member);
+}
+
+const int members = 5, rows = 7, in = 6, out = 4;
+
+struct Setup {
+    std::vector<std::shared_ptr<Linear<double>>> separate;
+    std::shared_ptr<EnsembleLinear<double>> ensemble;
+
+    Setup() {
+        ensemble = std::make_shared<EnsembleLinear<double>>(members, in, out, std::make_shared<Constant_Val<double>>(0.0),
+                                                            std::make_shared<Constant_Val<double>>(0.0));
+        for (int m = 0; m < members; ++m) {
+            separate.push_back(make_linear(in, out, m));
+            ensemble->load_member(m, *separate[m]);
+        }
+    }
+};
+
+TEST(ensemble_matches_separate_layers) {
+    Setup s;
+    auto x = filled({members, rows, in}, 0.31, true);
+    auto y = tanh_fn(s.ensemble->forward(x));
+    CHECK(y->shape == std::vector<int>({members, rows, out}));
+    weighted(y)->backward();
+
+    auto params = s.ensemble->parameters();
+    for (int m = 0; m < members; ++m) {
+        auto x_m = make_tensor<double>(slice(*x, m), {rows, in}, true);
+        auto y_m = tanh_fn(s.separate[m]->forward(x_m));
+        check_values(*y_m, slice(*y, m), 1e-12, "member output");
+        weighted(y_m, m * rows * out)->backward();
+        check_values(*x_m->grad, slice(*x->grad, m), 1e-12, "input grad");
+        check_values(*s.separate[m]->parameters()[0]->grad, slice(*params[0]->grad, m), 1e-12, "weight grad");
+        check_values(*s.separate[m]->parameters()[1]->grad, slice(*params[1]->grad, m), 1e-12, "bias grad");
+    }
+}
+
+TEST(shared_input_gradient_sums_over_members) {
+    Setup s;
+    auto x = filled({rows, in}, 0.31, true);
+    weighted(s.ensemble->forward(x))->backward();
+    std::vector<double> expected(rows * in, 0.0);
+    for (int m = 0; m < members; ++m) {
+        auto x_m = filled({rows, in}, 0.31, true);
+        weighted(s.separate[m]->forward(x_m), m * rows * out)->backward();
+        for (int i = 0; i < rows * in; ++i) expected[i] += x_m->grad->data[i];
+    }
+    check_values(*x->grad, expected, 1e-12, "shared input grad");
+}
+
+TEST(training_the_ensemble_trains_each_member) {
+    Setup s;
+    auto x = filled({members, rows, in}, 0.31);
+    auto target = filled({members, rows, out}, 0.53);
+    SGD<double> ensemble_sgd(s.ensemble->parameters(), 0.1);
+    for (int step = 0; step < 3; ++step) {
+        ensemble_sgd.zero_grad();
+        mse_loss(target, s.ensemble->forward(x))->backward();
+        ensemble_sgd.step();
+        for (int m = 0; m < members; ++m) {
+            SGD<double> sgd(s.separate[m]->parameters(), 0.1);
+            sgd.zero_grad();
+            auto y_m = s.separate[m]->forward(make_tensor<double>(slice(*x, m), {rows, in}));
+            // the ensemble's loss averages over all members, so each member's share is 1 / M
+            tensor_scalar_mul(mse_loss(make_tensor<double>(slice(*target, m), {rows, out}), y_m), 1.0 / members)->backward();
+            sgd.step();
+        }
+    }
+    for (int m = 0; m < members; ++m) {
+        auto stored = make_linear(in, out, 100);
+        s.ensemble->store_member(m, *stored);
+        for (int k = 0; k < 2; ++k) {
+            check_values(*stored->parameters()[k], to_vector(*s.separate[m]->parameters()[k]), 1e-12, "trained member");
+        }
+    }
+}
+
+TEST(members_are_initialized_like_separate_layers) {
+    auto he = std::make_shared<HeNormal<double>>();
+    auto xavier = std::make_shared<XavierUniform<double>>();
+    manual_seed(21);
+    EnsembleLinear<double> ensemble(3, in, out, he, xavier);
+    manual_seed(21);
+    for (int m = 0; m < 3; ++m) {
+        Linear<double> layer(in, out, he, xavier);
+        auto stored = make_linear(in, out, 0);
+        ensemble.store_member(m, *stored);
+        for (int k = 0; k < 2; ++k) CHECK(to_vector(*stored->parameters()[k]) == to_vector(*layer.parameters()[k]));
+    }
+}
+
+TEST(ensemble_checks_shapes_and_members) {
+    Setup s;
+    CHECK_THROWS(s.ensemble->forward(filled({members + 1, rows, in}, 0.3)));
+    CHECK_THROWS(s.ensemble->forward(filled({rows, in + 1}, 0.3)));
+    CHECK_THROWS(s.ensemble->forward(filled({in}, 0.3)));
+    CHECK_THROWS(s.ensemble->load_member(members, *s.separate[0]));
+    CHECK_THROWS(s.ensemble->store_member(-1, *s.separate[0]));
+    CHECK_THROWS(s.ensemble->load_member(0, *make_linear(in, out + 1, 0)));
+    CHECK_THROWS(EnsembleLinear<double>(0, in, out, std::make_shared<Constant_Val<double>>(0.0),
+                                        std::make_shared<Constant_Val<double>>(0.0)));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,132 @@
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "nn/activations/activations.h"
+#include "export/export.h"
+
+template<typename T>
+static void fill(Tensor<T>& t, double scale, double offset, double amplitude) {
+    for (int i = 0; i < t.size; ++i) t.data[i] = static_cast<T>(offset + amplitude * std::sin(i * scale + 0.3));
+}
+
+template<typename T>
+static std::shared_ptr<Linear<T>> make_linear(int in, int out) {
+    auto linear = std::make_shared<Linear<T>>(in, out, std::make_shared<Constant_Val<T>>(T(0)),
+                                              std::make_shared<Constant_Val<T>>(T(0)));
+    fill(*linear->parameters()[0], 0.7 + in, 0.0, 0.5);
+    fill(*linear->parameters()[1], 0.3, 0.0, 0.2);
+    return linear;
+}
+
+template<typename T>
+static std::shared_ptr<BatchNorm1d<T>> make_batch_norm(int c) {
+    auto bn = std::make_shared<BatchNorm1d<T>>(c, T(1e-5), T(0.1), true);
+    fill(*bn->running_mean, 0.9, 0.0, 0.5);
+    fill(*bn->running_var, 1.3, 1.0, 0.5);
+    fill(*bn->parameters()[0], 0.4, 1.0, 0.3);
+    fill(*bn->parameters()[1], 0.8, 0.0, 0.2);
+    bn->training = false;
+    return bn;
+}
+
+// Linear -> BN -> relu -> Linear -> LayerNorm -> tanh -> BN -> Linear -> softmax,
+// built both as a plan and as eager layers. Returns the eager output.
+template<typename T>
+static std::vector<double> build(PlanBuilder<T>& builder, const std::vector<float>& input, int rows) {
+    auto l1 = make_linear<T>(6, 16), l2 = make_linear<T>(16, 12), l3 = make_linear<T>(12, 4);
+    auto bn1 = make_batch_norm<T>(16), bn2 = make_batch_norm<T>(12);
+    auto ln = std::make_shared<LayerNorm<T>>(12, T(1e-5), true);
+    fill(*ln->parameters()[0], 0.6, 1.0, 0.2);
+    fill(*ln->parameters()[1], 0.2, 0.0, 0.1);
+
+    builder.add_linear(l1);
+    builder.add_batch_norm(bn1);
+    builder.add_activation("relu");
+    builder.add_linear(l2);
+    builder.add_layer_norm(ln);
+    builder.add_activation("tanh");
+    builder.add_batch_norm(bn2);
+    builder.add_linear(l3);
+    builder.add_activation("softmax");
+
+    auto x = make_tensor<T>(std::vector<T>(input.begin(), input.end()), {rows, 6});
+    auto h = relu(bn1->forward(l1->forward(x)));
+    h = l3->forward(bn2->forward(tanh_fn(ln->forward(l2->forward(h)))));
+    auto y = softmax(h);
+    return std::vector<double>(y->data.get(), y->data.get() + y->size);
+}
+
+static std::vector<float> inputs(int rows) {
+    std::vector<float> values(rows * 6);
+    for (int i = 0; i < rows * 6; ++i) values[i] = 1.5f * std::sin(i * 0.61f);
+    return values;
+}
+
+// 37 rows run as chunks of 8, with a partial chunk at the end
+const int rows = 37, max_batch = 8;
+
+TEST(plan_matches_eager_float) {
+    PlanBuilder<float> builder(6);
+    auto x = inputs(rows);
+    auto expected = build(builder, x, rows);
+    CHECK(builder.folded_norms() == 2);
+    CHECK(builder.fused_activations() == 2);
+    auto plan = std::make_shared<InferencePlan>(builder.build(max_batch));
+    CHECK(plan->steps.size() == 5);
+    CHECK(plan->buffer_widths.size() <= 2);
+    PlanRunner runner(plan);
+    auto y = runner.run(x);
+    CHECK(y.size() == expected.size());
+    for (size_t i = 0; i < y.size(); ++i) CHECK_NEAR(y[i], expected[i], 1e-5);
+}
+
+TEST(plan_matches_eager_double) {
+    PlanBuilder<double> builder(6);
+    auto x = inputs(rows);
+    auto expected = build(builder, x, rows);
+    PlanRunner runner(std::make_shared<InferencePlan>(builder.build(max_batch)));
+    auto y = runner.run(x);
+    for (size_t i = 0; i < y.size(); ++i) CHECK_NEAR(y[i], expected[i], 1e-5);
+}
+
+TEST(serialized_plan_gives_identical_output) {
+    PlanBuilder<float> builder(6);
+    auto x = inputs(rows);
+    build(builder, x, rows);
+    auto plan = builder.build(max_batch);
+    auto y = PlanRunner(std::make_shared<InferencePlan>(plan)).run(x);
+
+    auto bytes = plan.to_bytes();
+    CHECK(PlanRunner(std::make_shared<InferencePlan>(InferencePlan::from_bytes(bytes))).run(x) == y);
+    std::string path = "/tmp/minitensor_test_" + std::to_string(getpid()) + ".plan";
+    plan.save(path);
+    auto loaded = InferencePlan::load(path);
+    std::remove(path.c_str());
+    CHECK(PlanRunner(std::make_shared<InferencePlan>(loaded)).run(x) == y);
+
+    CHECK_THROWS(InferencePlan::from_bytes(bytes.substr(0, bytes.size() - 1)));
+    CHECK_THROWS(InferencePlan::from_bytes(bytes + "x"));
+    CHECK_THROWS(InferencePlan::from_bytes("NOTAPLAN" + bytes.substr(8)));
+}
+
+TEST(export_checks_layers) {
+    PlanBuilder<float> builder(6);
+    CHECK_THROWS(builder.build(4));
+    CHECK_THROWS(builder.add_linear(make_linear<float>(5, 3)));
+    auto bn = make_batch_norm<float>(6);
+    bn->training = true;
+    CHECK_THROWS(builder.add_batch_norm(bn));
+    CHECK_THROWS(builder.add_activation("gelu"));
+    builder.add_linear(make_linear<float>(6, 3));
+    CHECK_THROWS(builder.build(0));
+    PlanRunner runner(std::make_shared<InferencePlan>(builder.build(4)));
+    CHECK_THROWS(runner.run(std::vector<float>(7)));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,156 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "nn/activations/activations.h"
+#include "losses/losses.h"
+#include "optims/optims.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+// Sizes from one element to several foreach blocks, so blocks both share
+// tensors and split them.
+static std::vector<TensorPtr> tensor_list(double scale) {
+    std::vector<TensorPtr> tensors;
+    int k = 0;
+    for (int n : {1, 7, 16384, 3, 40000, 129, 25000, 2}) {
+        std::vector<double> values(n);
+        for (int i = 0; i < n; ++i) values[i] = std::sin(i * scale + k);
+        tensors.push_back(make_tensor<double>(values, {n}, true));
+        ++k;
+    }
+    return tensors;
+}
+
+static std::vector<double> flatten(const std::vector<TensorPtr>& tensors) {
+    std::vector<double> all;
+    for (auto& t : tensors) {
+        for (int i = 0; i < t->size; ++i) all.push_back(t->data[i]);
+    }
+    return all;
+}
+
+static std::shared_ptr<Linear<double>> make_linear(int in, int out) {
+    auto linear = std::make_shared<Linear<double>>(in, out, std::make_shared<Constant_Val<double>>(0.0),
+                                                  std::make_shared<Constant_Val<double>>(0.1));
+    auto weight = linear->parameters()[0];
+    for (int i = 0; i < weight->size; ++i) weight->data[i] = 0.4 * std::sin(i * 0.7 + in);
+    return linear;
+}
+
+TEST(foreach_kernels_match_elementwise_loops) {
+    auto xs = tensor_list(0.3), ys = tensor_list(0.8);
+    auto x = flatten(xs), y = flatten(ys);
+    long double sq = 0;
+    for (double v : x) sq += static_cast<long double>(v) * v;
+    CHECK_NEAR(foreach_norm(xs), std::sqrt(static_cast<double>(sq)), 1e-12);
+
+    foreach_axpy(ys, xs, 0.5);
+    for (size_t i = 0; i < y.size(); ++i) y[i] += 0.5 * x[i];
+    CHECK(flatten(ys) == y);
+    foreach_scale(xs, -3.0);
+    for (double& v : x) v *= -3.0;
+    CHECK(flatten(xs) == x);
+    auto version = xs[4]->data_version();
+    foreach_zero(xs);
+    CHECK(flatten(xs) == std::vector<double>(x.size(), 0.0));
+    CHECK(xs[4]->data_version() != version);
+    CHECK_THROWS(foreach_axpy(ys, std::vector<TensorPtr>(xs.begin(), xs.end() - 1), 1.0));
+}
+
+TEST(foreach_norm_does_not_depend_on_the_thread_count) {
+    auto xs = tensor_list(0.3);
+    int restore = get_num_threads();
+    set_num_threads(1);
+    double single = foreach_norm(xs);
+    set_num_threads(4);
+    double multi = foreach_norm(xs);
+    set_num_threads(restore);
+    CHECK(single == multi);
+}
+
+TEST(clip_grad_norm_rescales_only_large_gradients) {
+    auto params = tensor_list(0.3);
+    for (auto& p : params) p->grad = make_tensor<double>(to_vector(*p), p->shape);
+    double norm = grad_norm(params);
+    CHECK(clip_grad_norm(params, 2 * norm) == norm);
+    CHECK(grad_norm(params) == norm);
+    CHECK_NEAR(clip_grad_norm(params, 0.5 * norm), norm, 1e-12 * norm);
+    CHECK_NEAR(grad_norm(params), 0.5 * norm, 1e-6);
+}
+
+TEST(flattened_parameters_alias_one_buffer) {
+    auto l1 = make_linear(5, 7), l2 = make_linear(7, 3);
+    std::vector<TensorPtr> params = l1->parameters();
+    for (auto& p : l2->parameters()) params.push_back(p);
+    params.push_back(params[0]);   // duplicates are flattened once
+    auto before = flatten(std::vector<TensorPtr>(params.begin(), params.end() - 1));
+
+    FlatParameters<double> flat(params);
+    CHECK(flat.parameters().size() == 4);
+    CHECK(flatten(flat.parameters()) == before);
+    size_t previous_end = 0;
+    for (size_t k = 0; k < 4; ++k) {
+        size_t offset = flat.parameter_offsets()[k];
+        CHECK(offset % FlatParameters<double>::ALIGN_ELEMENTS == 0);
+        CHECK(params[k]->data.get() == flat.flat()->data.get() + offset);
+        CHECK(params[k]->grad->data.get() == flat.flat_grad()->data.get() + offset);
+        for (size_t i = previous_end; i < offset; ++i) CHECK(flat.flat()->data[i] == 0.0);
+        previous_end = offset + params[k]->size;
+    }
+    // the padding keeps the views apart, while the flat tensor is one span
+    CHECK(foreach_spans(foreach_raw(flat.parameters())).size() == 4);
+    CHECK(foreach_spans(foreach_raw(std::vector<TensorPtr>{flat.flat()})).size() == 1);
+
+    CHECK_THROWS(FlatParameters<double>({params[0]}));
+    CHECK_THROWS(FlatParameters<double>({}));
+}
+
+TEST(training_through_the_flat_buffer_matches_separate_parameters) {
+    auto x = make_tensor<double>({0.3, -0.2, 0.9, 0.1, -0.5, 0.7, 0.2, 0.4, -0.8, 0.6}, {2, 5});
+    auto target = make_tensor<double>({0.1, 0.2, 0.3, -0.1, -0.2, -0.3}, {2, 3});
+    auto f1 = make_linear(5, 7), f2 = make_linear(7, 3), r1 = make_linear(5, 7), r2 = make_linear(7, 3);
+    std::vector<TensorPtr> flat_params = f1->parameters(), reference = r1->parameters();
+    for (auto& p : f2->parameters()) flat_params.push_back(p);
+    for (auto& p : r2->parameters()) reference.push_back(p);
+
+    FlatParameters<double> flat(flat_params);
+    SGD<double> flat_sgd({flat.flat()}, 0.1), reference_sgd(reference, 0.1);
+    for (int step = 0; step < 3; ++step) {
+        flat.zero_grad();
+        reference_sgd.zero_grad();
+        mse_loss(target, f2->forward(tanh_fn(f1->forward(x))))->backward();
+        mse_loss(target, r2->forward(tanh_fn(r1->forward(x))))->backward();
+        CHECK_NEAR(flat.grad_norm(), grad_norm(reference), 1e-12);
+        CHECK_NEAR(flat.clip_grad_norm(0.5), clip_grad_norm(reference, 0.5), 1e-12);
+        flat_sgd.step();
+        reference_sgd.step();
+        for (size_t k = 0; k < reference.size(); ++k) {
+            check_values(*flat_params[k], to_vector(*reference[k]), 1e-12, "parameter");
+        }
+    }
+}
+
+TEST(flat_buffers_save_and_load_their_layout) {
+    auto l1 = make_linear(5, 7), l2 = make_linear(7, 3);
+    FlatParameters<double> flat(l1->parameters());
+    auto saved = to_vector(*flat.flat());
+    std::string path = "/tmp/minitensor_test_" + std::to_string(getpid()) + ".flat";
+    flat.save(path);
+    foreach_zero(std::vector<TensorPtr>{flat.flat()});
+    flat.load(path);
+    CHECK(to_vector(*flat.flat()) == saved);
+
+    FlatParameters<double> other(l2->parameters());
+    CHECK_THROWS(other.load(path));
+    std::remove(path.c_str());
+    CHECK_THROWS(flat.load(path));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,139 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "nn/activations/activations.h"
+#include "losses/losses.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+using Tensors = std::vector<TensorPtr>;
+
+static TensorPtr filled(const std::vector<int>& shape, double scale, double offset = 0.0, double amplitude = 1.0) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = offset + amplitude * std::sin(i * scale + 0.3);
+    return make_tensor<double>(values, shape);
+}
+
+// (f(x + h t) - f(x - h t)) / 2h for every output of fn.
+static std::vector<std::vector<double>> directional(const JvpFunction<double>& fn, const Tensors& primals,
+                                                    const Tensors& tangents, double h = 1e-6) {
+    auto shifted = [&](double sign) {
+        Tensors inputs;
+        for (size_t k = 0; k < primals.size(); ++k) {
+            auto x = make_tensor<double>(to_vector(*primals[k]), primals[k]->shape);
+            for (int i = 0; i < x->size; ++i) x->data[i] += sign * h * tangents[k]->data[i];
+            inputs.push_back(x);
+        }
+        NoGradGuard no_grad;
+        return fn(inputs);
+    };
+    auto plus = shifted(1), minus = shifted(-1);
+    std::vector<std::vector<double>> result;
+    for (size_t k = 0; k < plus.size(); ++k) {
+        std::vector<double> d(plus[k]->size);
+        for (int i = 0; i < plus[k]->size; ++i) d[i] = (plus[k]->data[i] - minus[k]->data[i]) / (2 * h);
+        result.push_back(d);
+    }
+    return result;
+}
+
+// jvp of fn at primals along sin-pattern tangents, against finite differences.
+static void check_jvp(const JvpFunction<double>& fn, const Tensors& primals, const char* what) {
+    Tensors tangents;
+    for (size_t k = 0; k < primals.size(); ++k) tangents.push_back(filled(primals[k]->shape, 0.77, 0.0, 1.0 + k));
+    auto [outputs, output_tangents] = jvp(fn, primals, tangents);
+    auto expected = directional(fn, primals, tangents);
+    CHECK(output_tangents.size() == expected.size());
+    for (size_t k = 0; k < outputs.size(); ++k) {
+        CHECK(outputs[k]->tangent == nullptr);
+        CHECK(output_tangents[k]->shape == outputs[k]->shape);
+        check_values(*output_tangents[k], expected[k], 1e-7, what);
+    }
+}
+
+TEST(elementwise_jvp_matches_finite_differences) {
+    auto a = filled({3, 4}, 0.41), b = filled({3, 4}, 0.93, 2.0), row = filled({1, 4}, 1.7, 1.5);
+    check_jvp([](const Tensors& x) { return Tensors{tensor_add(x[0], x[1])}; }, {a, b}, "add");
+    check_jvp([](const Tensors& x) { return Tensors{tensor_sub(x[0], x[1])}; }, {a, row}, "sub broadcast");
+    check_jvp([](const Tensors& x) { return Tensors{tensor_mul(x[0], x[1])}; }, {a, row}, "mul broadcast");
+    check_jvp([](const Tensors& x) { return Tensors{tensor_div(x[0], x[1])}; }, {a, b}, "div");
+    check_jvp([](const Tensors& x) {
+        return Tensors{tensor_scalar_add(x[0], 2.0), tensor_scalar_sub(x[0], 1.0), scalar_tensor_sub(3.0, x[0]),
+                       tensor_scalar_mul(x[0], -1.5), tensor_scalar_div(x[0], 4.0), scalar_tensor_div(2.0, x[1])};
+    }, {a, b}, "scalar ops");
+    check_jvp([](const Tensors& x) { return Tensors{transpose(x[0]), x[0]->reshape({4, 3})}; }, {a}, "layout");
+}
+
+TEST(math_and_activation_jvp_matches_finite_differences) {
+    auto x = filled({5, 6}, 0.37, 0.0, 1.2), positive = filled({5, 6}, 0.53, 2.0);
+    check_jvp([](const Tensors& t) {
+        return Tensors{tensor_exp<double, double>(t[0]), tensor_sin<double, double>(t[0]),
+                       tensor_cos<double, double>(t[0]), tensor_tan<double, double>(t[0])};
+    }, {x}, "exp/sin/cos/tan");
+    check_jvp([](const Tensors& t) {
+        return Tensors{tensor_log<double, double>(t[0]), tensor_sqrt<double, double>(t[0]),
+                       tensor_pow<double, double>(t[0], 2.5f)};
+    }, {positive}, "log/sqrt/pow");
+    check_jvp([](const Tensors& t) {
+        return Tensors{relu(t[0]), tanh_fn(t[0]), sigmoid(t[0]), softmax(t[0])};
+    }, {x}, "activations");
+}
+
+TEST(matmul_linear_and_loss_jvp_matches_finite_differences) {
+    auto x = filled({7, 5}, 0.31), w = filled({3, 5}, 0.71, 0.0, 0.5), b = filled({1, 3}, 1.3, 0.0, 0.2);
+    check_jvp([](const Tensors& t) { return Tensors{mat_mul(t[0], transpose(t[1]))}; }, {x, w}, "mat_mul");
+
+    // the fused Linear kernel, with tangents on input, weight and bias
+    check_jvp([](const Tensors& t) {
+        std::vector<double> packed(t[1]->size);
+        gemm_pack_b_panels(true, t[1]->data.get(), 5, 5, 3, packed.data());
+        return Tensors{linear(t[0], t[1], t[2], packed.data())};
+    }, {x, w, b}, "linear");
+    auto layer = std::make_shared<Linear<double>>(5, 3, std::make_shared<Constant_Val<double>>(0.2),
+                                                  std::make_shared<Constant_Val<double>>(0.1));
+    check_jvp([&](const Tensors& t) { return Tensors{tanh_fn(layer->forward(t[0]))}; }, {x}, "Linear layer");
+
+    auto y = filled({7, 3}, 0.23), p = filled({7, 3}, 0.61, 0.5, 0.3), labels = filled({7, 3}, 0.9, 0.5, 0.4);
+    check_jvp([](const Tensors& t) { return Tensors{mse_loss(t[0], t[1]), mae_loss(t[0], t[1])}; }, {y, p}, "mse/mae");
+    check_jvp([](const Tensors& t) { return Tensors{bce_loss(t[0], t[1])}; }, {labels, p}, "bce");
+}
+
+TEST(jvp_of_a_scalar_loss_is_the_gradient_dot_the_tangent) {
+    auto x = filled({4, 5}, 0.31, 0.0, 1.0), target = filled({4, 2}, 0.47);
+    auto l1 = std::make_shared<Linear<double>>(5, 6, std::make_shared<Constant_Val<double>>(0.1),
+                                               std::make_shared<Constant_Val<double>>(0.0));
+    auto l2 = std::make_shared<Linear<double>>(6, 2, std::make_shared<Constant_Val<double>>(-0.2),
+                                               std::make_shared<Constant_Val<double>>(0.05));
+    JvpFunction<double> loss = [&](const Tensors& t) {
+        return Tensors{mse_loss(target, l2->forward(sigmoid(l1->forward(t[0]))))};
+    };
+    auto tangent = filled({4, 5}, 0.77);
+    auto [outputs, tangents] = jvp(loss, {x}, {tangent});
+    CHECK(!outputs[0]->requires_grad);
+    CHECK(outputs[0]->grad_fn == nullptr);
+    CHECK(x->tangent == nullptr);
+
+    auto leaf = make_tensor<double>(to_vector(*x), x->shape, true);
+    loss({leaf})[0]->backward();
+    double dot = 0;
+    for (int i = 0; i < x->size; ++i) dot += leaf->grad->data[i] * tangent->data[i];
+    CHECK_NEAR(tangents[0]->data[0], dot, 1e-13);
+}
+
+TEST(jvp_reports_misuse) {
+    auto x = filled({2, 3}, 0.3);
+    JvpFunction<double> identity = [](const Tensors& t) { return Tensors{tensor_scalar_mul(t[0], 2.0)}; };
+    CHECK_THROWS(jvp(identity, {x}, {}));
+    CHECK_THROWS(jvp(identity, {x}, {filled({3, 2}, 0.1)}));
+    // sum has no forward rule
+    CHECK_THROWS(jvp<double>([](const Tensors& t) { return Tensors{sum(t[0])}; }, {x}, {filled({2, 3}, 0.1)}));
+    // an output that does not depend on the primals
+    auto constant = filled({2, 3}, 0.9);
+    CHECK_THROWS(jvp<double>([&](const Tensors&) { return Tensors{tanh_fn(constant)}; }, {x}, {filled({2, 3}, 0.1)}));
+}
+
+int main() { return run_tests(); }
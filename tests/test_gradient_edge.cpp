@@ -0,0 +1,68 @@
+#include <cmath>
+#include <memory>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/activations/activations.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+// A non-leaf copy of x, so the activations see an input with a grad_fn.
+static TensorPtr intermediate(const TensorPtr& x) {
+    return tensor_scalar_add(x, 0.0);
+}
+
+TEST(relu_input_keeps_its_gradient) {
+    auto x = make_tensor<double>({1.0, -1.0, 2.0}, {3}, true);
+    auto h = intermediate(x);
+    sum(tensor_add(relu(h), h), 0)->backward();
+    CHECK(h->grad != nullptr);
+    if (h->grad) check_values(*h->grad, {2.0, 1.0, 2.0}, 0.0, "h.grad");
+    check_values(*x->grad, {2.0, 1.0, 2.0}, 0.0, "x.grad");
+}
+
+TEST(relu_only_consumer_still_sets_input_gradient) {
+    auto x = make_tensor<double>({1.0, -1.0, 2.0}, {3}, true);
+    auto h = intermediate(x);
+    sum(relu(h), 0)->backward();
+    CHECK(h->grad != nullptr);
+    if (h->grad) check_values(*h->grad, {1.0, 0.0, 1.0}, 0.0, "h.grad");
+}
+
+TEST(tanh_and_sigmoid_inputs_keep_their_gradients) {
+    std::vector<double> v = {-1.5, 0.25, 2.0};
+    auto x = make_tensor<double>(v, {3}, true);
+    auto h = intermediate(x);
+    sum(tensor_add(tanh_fn(h), sigmoid(h)), 0)->backward();
+    std::vector<double> expected;
+    for (double a : v) {
+        double t = std::tanh(a), s = 1.0 / (1.0 + std::exp(-a));
+        expected.push_back(1 - t * t + s * (1 - s));
+    }
+    CHECK(h->grad != nullptr);
+    if (h->grad) check_values(*h->grad, expected, 1e-12, "h.grad");
+    check_values(*x->grad, expected, 1e-12, "x.grad");
+}
+
+TEST(repeated_backward_resets_intermediate_gradient) {
+    auto x = make_tensor<double>({1.0, -1.0}, {2}, true);
+    auto h = intermediate(x);
+    auto out = sum(tensor_add(relu(h), relu(h)), 0);
+    out->backward(true);
+    out->backward(true);
+    // non-leaf gradients are recomputed by each pass, leaf gradients accumulate
+    check_values(*h->grad, {2.0, 0.0}, 0.0, "h.grad");
+    check_values(*x->grad, {4.0, 0.0}, 0.0, "x.grad");
+}
+
+TEST(graph_does_not_keep_activation_input_alive) {
+    auto x = make_tensor<double>({1.0, -1.0, 2.0}, {3}, true);
+    auto h = intermediate(x);
+    std::weak_ptr<Tensor<double>> watch = h;
+    auto y = relu(h);
+    h.reset();
+    CHECK(watch.expired());
+    sum(y, 0)->backward();
+    check_values(*x->grad, {1.0, 0.0, 1.0}, 0.0, "x.grad");
+}
+
+int main() { return run_tests(); }
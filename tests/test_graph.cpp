@@ -0,0 +1,63 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/activations/activations.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+TEST(second_backward_on_a_freed_graph_throws) {
+    auto x = make_tensor<double>({1, 2, 3}, {3}, true);
+    auto loss = sum(tensor_mul(x, x));
+    loss->backward();
+    check_values(*x->grad, {2, 4, 6}, 0.0, "x.grad");
+    CHECK(loss->grad_fn == nullptr);
+    CHECK_THROWS(loss->backward());
+}
+
+TEST(retained_graph_accumulates_only_into_leaves) {
+    auto x = make_tensor<double>({1, 2, 3}, {3}, true);
+    auto h = tensor_scalar_mul(x, 3.0);
+    auto loss = sum(tensor_mul(h, h));
+    loss->backward(true);
+    loss->backward(true);
+    // intermediate gradients are reset per pass, leaf gradients add up
+    check_values(*h->grad, {6, 12, 18}, 0.0, "h.grad");
+    check_values(*x->grad, {36, 72, 108}, 0.0, "x.grad");
+    loss->backward();
+    CHECK_THROWS(loss->backward());
+}
+
+TEST(backward_frees_intermediates_nobody_holds) {
+    auto x = make_tensor<double>({0.5, -1.0, 2.0}, {3}, true);
+    std::weak_ptr<Tensor<double>> hidden;
+    TensorPtr loss;
+    {
+        auto h = tanh_fn(tensor_scalar_mul(x, 2.0));
+        hidden = h;
+        loss = sum(tensor_mul(h, h));
+    }
+    CHECK(!hidden.expired());
+    loss->backward();
+    CHECK(hidden.expired());
+    CHECK(loss->parents.empty());
+}
+
+TEST(shared_subgraphs_run_once) {
+    auto x = make_tensor<double>({1.0, 2.0}, {2}, true);
+    TensorPtr h = x;
+    // each level uses the previous one twice; re-traversal would take 2^40 calls
+    for (int i = 0; i < 40; ++i) h = tensor_add(h, h);
+    sum(h)->backward();
+    check_values(*x->grad, {std::ldexp(1.0, 40), std::ldexp(1.0, 40)}, 0.0, "x.grad");
+}
+
+TEST(gradients_do_not_record_a_graph) {
+    auto x = make_tensor<double>({1, 2, 3}, {3}, true);
+    sum(tensor_mul(tanh_fn(x), x))->backward();
+    CHECK(!x->grad->requires_grad);
+    CHECK(x->grad->grad_fn == nullptr);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "optims/optims.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static std::vector<std::shared_ptr<Linear<double>>> make_layers() {
+    std::vector<std::shared_ptr<Linear<double>>> layers = {
+        std::make_shared<Linear<double>>(3, 5, std::make_shared<Constant_Val<double>>(0.0),
+                                         std::make_shared<Constant_Val<double>>(0.1)),
+        std::make_shared<Linear<double>>(5, 2, std::make_shared<Constant_Val<double>>(0.0),
+                                         std::make_shared<Constant_Val<double>>(0.1))};
+    for (auto& p : hogwild_mlp_parameters(layers)) {
+        for (int i = 0; i < p->size; ++i) p->data[i] = 0.5 * std::sin(i * 0.7 + p->size);
+    }
+    return layers;
+}
+
+static TensorPtr filled(const std::vector<int>& shape, double scale) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = std::sin(i * scale);
+    return make_tensor<double>(values, shape);
+}
+
+TEST(one_worker_matches_sequential_sgd) {
+    auto x = filled({64, 3}, 0.37), y = filled({64, 2}, 0.11);
+    auto layers = make_layers(), reference = make_layers();
+    auto step = hogwild_mlp_step(layers, x, y, "tanh", "mse", 8, 7);
+    HogwildSGD<double> hogwild(hogwild_mlp_parameters(layers), 0.05, 1);
+    auto report = hogwild.run(step, 20);
+    CHECK(report.steps == 20);
+
+    // the same batches through the ordinary optimizer
+    auto params = hogwild_mlp_parameters(reference);
+    SGD<double> optimizer(params, 0.05);
+    double last_loss = 0;
+    for (int s = 0; s < 20; ++s) {
+        optimizer.zero_grad();
+        auto loss = step(params, 0, s);
+        loss->backward();
+        last_loss = loss->data[0];
+        optimizer.step();
+    }
+    CHECK_NEAR(report.final_loss, last_loss, 1e-12);
+    auto trained = hogwild_mlp_parameters(layers);
+    for (size_t k = 0; k < params.size(); ++k) check_values(*trained[k], to_vector(*params[k]), 1e-12, "parameter");
+}
+
+TEST(concurrent_workers_reduce_the_loss) {
+    // y is a linear function of x, so one layer can fit it
+    std::vector<double> features(256 * 3);
+    for (int i = 0; i < 256 * 3; ++i) features[i] = std::fmod(i * 0.6180339887, 1.0) - 0.5;
+    auto x = make_tensor<double>(features, {256, 3});
+    std::vector<double> targets(256 * 2);
+    for (int r = 0; r < 256; ++r) {
+        targets[2 * r] = 0.5 * x->data[3 * r] - x->data[3 * r + 1];
+        targets[2 * r + 1] = 0.2 + x->data[3 * r + 2];
+    }
+    auto y = make_tensor<double>(targets, {256, 2});
+    std::vector<std::shared_ptr<Linear<double>>> layers = {
+        std::make_shared<Linear<double>>(3, 2, std::make_shared<Constant_Val<double>>(0.0),
+                                         std::make_shared<Constant_Val<double>>(0.0))};
+    auto step = hogwild_mlp_step(layers, x, y, "none", "mse", 16, 3);
+    auto params = hogwild_mlp_parameters(layers);
+    double initial = step(params, 0, 0)->data[0];
+    auto version = params[0]->data_version();
+
+    auto report = HogwildSGD<double>(params, 0.5, 4).run(step, 300);
+    CHECK(report.steps == 1200);
+    CHECK(report.final_loss < 1e-4 * initial);
+    CHECK(params[0]->data_version() != version);
+    check_values(*params[0], {0.5, -1, 0, 0, 0, 1}, 1e-2, "weight");
+}
+
+TEST(sparse_gradients_only_touch_their_rows) {
+    std::vector<double> values(10 * 3);
+    for (int i = 0; i < 30; ++i) values[i] = std::sin(i * 0.41);
+    auto table = make_tensor<double>(values, {10, 3}, true);
+    // each worker owns one row, so the result does not depend on scheduling
+    HogwildStep<double> step = [](const std::vector<TensorPtr>& params, int worker, long long) {
+        auto ids = std::make_shared<Tensor<int>>(std::vector<int>{worker}, std::vector<int>{1}, false);
+        auto e = embedding(params[0], ids, true);
+        return sum(tensor_mul(e, e));
+    };
+    HogwildSGD<double>({table}, 0.1, 2).run(step, 5);
+    // d(x^2)/dx = 2x, so every step scales the row by 0.8
+    for (int i = 0; i < 30; ++i) {
+        double expected = i < 6 ? values[i] * std::pow(0.8, 5) : values[i];
+        CHECK_NEAR(table->data[i], expected, 1e-12);
+    }
+}
+
+TEST(worker_errors_are_rethrown) {
+    auto table = make_tensor<double>({1, 2}, {2}, true);
+    HogwildStep<double> step = [](const std::vector<TensorPtr>& params, int worker, long long) {
+        if (worker == 1) throw std::runtime_error("ERROR: worker failed.");
+        return sum(params[0]);
+    };
+    CHECK_THROWS(HogwildSGD<double>({table}, 0.1, 3).run(step, 2));
+}
+
+TEST(mlp_step_checks_its_arguments) {
+    auto layers = make_layers();
+    auto x = filled({8, 3}, 0.3), y = filled({8, 2}, 0.2);
+    CHECK_THROWS(hogwild_mlp_step(layers, x, filled({7, 2}, 0.2), "tanh", "mse", 4, 0));
+    CHECK_THROWS(hogwild_mlp_step(layers, x, y, "gelu", "mse", 4, 0));
+    CHECK_THROWS(hogwild_mlp_step(layers, x, y, "tanh", "huber", 4, 0));
+    CHECK_THROWS(hogwild_mlp_step<double>({}, x, y, "tanh", "mse", 4, 0));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "inference/inference.h"
+
+static std::shared_ptr<Linear<double>> make_linear(int in, int out) {
+    auto linear = std::make_shared<Linear<double>>(in, out, std::make_shared<Constant_Val<double>>(0.0),
+                                                  std::make_shared<Constant_Val<double>>(0.1));
+    auto weight = linear->parameters()[0];
+    for (int i = 0; i < weight->size; ++i) weight->data[i] = 0.4 * std::sin(i * 0.7 + in);
+    return linear;
+}
+
+static std::shared_ptr<InferenceModel<double>> make_model() {
+    auto model = std::make_shared<InferenceModel<double>>();
+    model->add_linear(make_linear(6, 10));
+    model->add_activation("tanh");
+    model->add_linear(make_linear(10, 3));
+    model->add_activation("softmax");
+    return model;
+}
+
+static std::vector<double> row(int i) {
+    std::vector<double> values(6);
+    for (int j = 0; j < 6; ++j) values[j] = std::sin(i * 1.3 + j * 0.4);
+    return values;
+}
+
+static long long total_rows(const InferenceStats& stats) {
+    long long rows = 0;
+    for (size_t b = 0; b < stats.batch_sizes.size(); ++b) rows += b * stats.batch_sizes[b];
+    return rows;
+}
+
+TEST(batched_results_match_single_row_forwards) {
+    auto model = make_model();
+    BatchingEngine<double> engine(model, 8, 1.0, 2);
+    const int threads = 4, per_thread = 50;
+    std::vector<std::vector<std::vector<double>>> results(threads);
+    std::vector<std::thread> clients;
+    for (int t = 0; t < threads; ++t) {
+        clients.emplace_back([&, t] {
+            std::vector<std::future<std::vector<double>>> futures;
+            for (int i = 0; i < per_thread; ++i) futures.push_back(engine.submit(row(t * per_thread + i)));
+            for (auto& f : futures) results[t].push_back(f.get());
+        });
+    }
+    for (auto& c : clients) c.join();
+
+    for (int t = 0; t < threads; ++t) {
+        for (int i = 0; i < per_thread; ++i) {
+            auto expected = model->forward(make_tensor<double>(row(t * per_thread + i), {1, 6}));
+            check_values(*expected, results[t][i], 1e-12, "inference row");
+        }
+    }
+    auto stats = engine.stats();
+    CHECK(stats.requests == threads * per_thread);
+    CHECK(total_rows(stats) == threads * per_thread);
+    CHECK(stats.batch_sizes[0] == 0);
+}
+
+TEST(full_batches_do_not_wait_for_the_deadline) {
+    BatchingEngine<double> engine(make_model(), 4, 60000.0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<std::vector<double>>> futures;
+    for (int i = 0; i < 8; ++i) futures.push_back(engine.submit(row(i)));
+    for (auto& f : futures) CHECK(f.get().size() == 3);
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+    CHECK(engine.stats().batch_sizes[4] == 2);
+}
+
+TEST(partial_batches_are_sent_at_the_deadline) {
+    BatchingEngine<double> engine(make_model(), 32, 5.0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<std::vector<double>>> futures;
+    for (int i = 0; i < 3; ++i) futures.push_back(engine.submit(row(i)));
+    for (auto& f : futures) f.get();
+    CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(5));
+    auto stats = engine.stats();
+    CHECK(stats.requests == 3);
+    CHECK(total_rows(stats) == 3);
+    CHECK(stats.p50_us >= 5000 * 0.95);
+}
+
+TEST(shutdown_drains_the_queue_and_rejects_new_requests) {
+    BatchingEngine<double> engine(make_model(), 32, 60000.0);
+    std::vector<std::future<std::vector<double>>> futures;
+    for (int i = 0; i < 5; ++i) futures.push_back(engine.submit(row(i)));
+    engine.shutdown();
+    for (auto& f : futures) CHECK(f.get().size() == 3);
+    CHECK_THROWS(engine.submit(row(0)));
+    engine.shutdown();
+}
+
+TEST(inference_checks_shapes_and_settings) {
+    auto model = make_model();
+    CHECK_THROWS(model->add_linear(make_linear(4, 2)));
+    CHECK_THROWS(model->add_activation("gelu"));
+    CHECK_THROWS(model->forward(make_tensor<double>(row(0), {2, 3})));
+    CHECK_THROWS(BatchingEngine<double>(std::make_shared<InferenceModel<double>>()));
+    CHECK_THROWS(BatchingEngine<double>(model, 0));
+    CHECK_THROWS(BatchingEngine<double>(model, 4, -1.0));
+    BatchingEngine<double> engine(model);
+    CHECK_THROWS(engine.submit({1.0, 2.0}));
+}
+
+TEST(latency_percentiles_are_within_a_bucket) {
+    LatencyHistogram hist;
+    for (int i = 1; i <= 1000; ++i) hist.record(i * 10.0);
+    CHECK(hist.count() == 1000);
+    CHECK_NEAR(hist.mean(), 5005.0, 1e-9);
+    CHECK(hist.max() == 10000.0);
+    for (double p : {50.0, 90.0, 99.0}) CHECK(std::abs(hist.percentile(p) / (p * 100.0) - 1) < 0.045);
+    hist.reset();
+    CHECK(hist.percentile(50) == 0.0);
+}
+
+int main() { return run_tests(); }
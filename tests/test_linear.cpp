@@ -0,0 +1,100 @@
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "optims/optims.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static std::shared_ptr<Linear<double>> make_linear(int in, int out) {
+    auto linear = std::make_shared<Linear<double>>(in, out, std::make_shared<Constant_Val<double>>(0.0),
+                                                  std::make_shared<Constant_Val<double>>(0.1));
+    auto weight = linear->parameters()[0];
+    for (int i = 0; i < weight->size; ++i) weight->data[i] = 0.4 * std::sin(i * 0.7);
+    return linear;
+}
+
+static TensorPtr filled(const std::vector<int>& shape, double scale, bool requires_grad = false) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = std::sin(i * scale + 0.2);
+    return make_tensor<double>(values, shape, requires_grad);
+}
+
+// x W^T + b from the layer's current parameters, without the packed cache.
+static std::vector<double> reference(Linear<double>& layer, const TensorPtr& x) {
+    auto params = layer.parameters();
+    auto y = tensor_add(mat_mul(x, transpose(params[0])), params[1]);
+    return to_vector(*y);
+}
+
+// wide enough for several packed panels, with partial ones at the edges
+const int in = 300, out = 70;
+
+TEST(forward_and_gradients_match_matmul) {
+    auto layer = make_linear(in, out), twin = make_linear(in, out);
+    auto x = filled({9, in}, 0.13, true), x_twin = filled({9, in}, 0.13, true);
+    auto y = layer->forward(x);
+    check_values(*y, reference(*layer, x), 1e-12, "linear");
+
+    auto weights = filled({9, out}, 0.29);
+    sum(tensor_mul(y, weights))->backward();
+    auto p = twin->parameters();
+    sum(tensor_mul(tensor_add(mat_mul(x_twin, transpose(p[0])), p[1]), weights))->backward();
+    check_values(*x->grad, to_vector(*x_twin->grad), 1e-12, "input grad");
+    check_values(*layer->parameters()[0]->grad, to_vector(*p[0]->grad), 1e-12, "weight grad");
+    check_values(*layer->parameters()[1]->grad, to_vector(*p[1]->grad), 1e-12, "bias grad");
+}
+
+TEST(optimizer_steps_refresh_the_packed_weights) {
+    auto layer = make_linear(in, out);
+    auto x = filled({4, in}, 0.13);
+    SGD<double> sgd(layer->parameters(), 0.1);
+    Adam<double> adam(layer->parameters(), 0.01, 0.9, 0.999, 1e-8);
+    for (int step = 0; step < 4; ++step) {
+        layer->forward(x);
+        for (auto& p : layer->parameters()) p->zero_grad();
+        sum(layer->forward(x))->backward();
+        if (step % 2 == 0) sgd.step();
+        else adam.step();
+        check_values(*layer->forward(x), reference(*layer, x), 1e-12, "after step");
+    }
+}
+
+TEST(set_data_and_flat_buffers_refresh_the_packed_weights) {
+    auto layer = make_linear(in, out);
+    auto x = filled({4, in}, 0.13);
+    layer->forward(x);
+    layer->parameters()[0]->set_data(*filled({out, in}, 0.05));
+    check_values(*layer->forward(x), reference(*layer, x), 1e-12, "after set_data");
+
+    // an optimizer over the flat buffer changes the views' version through their base
+    FlatParameters<double> flat(layer->parameters());
+    check_values(*layer->forward(x), reference(*layer, x), 1e-12, "after flattening");
+    sum(layer->forward(x))->backward();
+    SGD<double>({flat.flat()}, 0.1).step();
+    check_values(*layer->forward(x), reference(*layer, x), 1e-12, "after flat step");
+}
+
+TEST(concurrent_forwards_share_the_cache) {
+    auto layer = make_linear(in, out);
+    auto x = filled({4, in}, 0.13);
+    auto expected = to_vector(*layer->forward(x));
+    // mark the cache stale, so the threads race to repack it
+    layer->parameters()[0]->bump_version();
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t] {
+            for (int r = 0; r < 50; ++r) mismatches[t] += to_vector(*layer->forward(x)) != expected;
+        });
+    }
+    for (auto& w : workers) w.join();
+    for (int m : mismatches) CHECK(m == 0);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,94 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+
+// Largest error of kernel against libm in long double over n points in [lo, hi].
+// Relative errors are measured against max(|exact|, floor).
+template<typename T, typename Kernel, typename Exact>
+static double max_error(Kernel kernel, Exact exact, double lo, double hi, bool relative, double floor = 0.0) {
+    const int n = 20001;
+    std::vector<T> x(n), y(n);
+    for (int i = 0; i < n; ++i) x[i] = static_cast<T>(lo + (hi - lo) * i / (n - 1));
+    kernel(x.data(), y.data(), n);
+    double worst = 0;
+    for (int i = 0; i < n; ++i) {
+        long double e = exact(static_cast<long double>(x[i]));
+        double err = static_cast<double>(std::fabs(static_cast<long double>(y[i]) - e));
+        if (relative) err /= std::max(static_cast<double>(std::fabs(e)), floor);
+        worst = std::max(worst, err);
+    }
+    return worst;
+}
+
+static long double sigmoid_exact(long double x) { return 1 / (1 + std::exp(-x)); }
+
+// The documented bounds in vec_math.h, with a factor of two of headroom.
+template<typename T>
+static void check_accuracy(double rel, double abs_trig, double rel_tan) {
+    CHECK(max_error<T>(vec_exp<T>, [](long double x) { return std::exp(x); }, -80, 80, true) < 2 * rel);
+    CHECK(max_error<T>(vec_log<T>, [](long double x) { return std::log(x); }, 1e-6, 1e6, true, 1e-3) < 2 * rel);
+    CHECK(max_error<T>(vec_tanh<T>, [](long double x) { return std::tanh(x); }, -20, 20, true) < 2 * rel);
+    CHECK(max_error<T>(vec_sigmoid<T>, sigmoid_exact, -40, 40, true) < 2 * rel);
+    CHECK(max_error<T>(vec_sin<T>, [](long double x) { return std::sin(x); }, -100, 100, false) < 2 * abs_trig);
+    CHECK(max_error<T>(vec_cos<T>, [](long double x) { return std::cos(x); }, -100, 100, false) < 2 * abs_trig);
+    CHECK(max_error<T>(vec_tan<T>, [](long double x) { return std::tan(x); }, -1.5, 1.5, true) < 2 * rel_tan);
+}
+
+TEST(kernels_meet_documented_accuracy_float) { check_accuracy<float>(2.5e-7, 1e-7, 2.5e-7); }
+
+TEST(kernels_meet_documented_accuracy_double) { check_accuracy<double>(4.5e-16, 2e-16, 5e-16); }
+
+TEST(trig_beyond_the_reduction_limit_uses_libm) {
+    std::vector<double> x = {1e9, -3e12, 1e15}, y(3);
+    vec_sin(x.data(), y.data(), 3);
+    for (int i = 0; i < 3; ++i) CHECK_NEAR(y[i], std::sin(x[i]), 1e-15);
+}
+
+TEST(exp_saturates) {
+    std::vector<double> x = {1000.0, -1000.0}, y(2);
+    vec_exp(x.data(), y.data(), 2);
+    CHECK(y[0] == std::numeric_limits<double>::infinity());
+    CHECK(y[1] == 0.0);
+}
+
+TEST(math_gradients_match_derivatives) {
+    std::vector<double> v = {0.3, 0.9, 1.7, 2.4};
+    auto check = [&](auto op, auto derivative, const char* what) {
+        auto x = make_tensor<double>(v, {4}, true);
+        sum(op(x))->backward();
+        std::vector<double> expected;
+        for (double value : v) expected.push_back(derivative(value));
+        check_values(*x->grad, expected, 1e-13, what);
+    };
+    check([](auto x) { return tensor_exp<double, double>(x); }, [](double a) { return std::exp(a); }, "exp");
+    check([](auto x) { return tensor_log<double, double>(x); }, [](double a) { return 1 / a; }, "log");
+    check([](auto x) { return tensor_sqrt<double, double>(x); }, [](double a) { return 0.5 / std::sqrt(a); }, "sqrt");
+    check([](auto x) { return tensor_pow<double, double>(x, 3.0f); }, [](double a) { return 3 * a * a; }, "pow");
+    check([](auto x) { return tensor_sin<double, double>(x); }, [](double a) { return std::cos(a); }, "sin");
+    check([](auto x) { return tensor_cos<double, double>(x); }, [](double a) { return -std::sin(a); }, "cos");
+    check([](auto x) { return tensor_tan<double, double>(x); },
+          [](double a) { return 1 / (std::cos(a) * std::cos(a)); }, "tan");
+}
+
+TEST(domain_errors_unless_fast_mode) {
+    auto x = make_tensor<double>({1.0, -1.0}, {2});
+    CHECK_THROWS((tensor_sqrt<double, double>(x)));
+    CHECK_THROWS((tensor_log<double, double>(make_tensor<double>({1.0, 0.0}, {2}))));
+    MathMode::set_fast(true);
+    auto y = tensor_sqrt<double, double>(x);
+    MathMode::set_fast(false);
+    CHECK(y->data[0] == 1.0);
+    CHECK(std::isnan(y->data[1]));
+}
+
+TEST(integer_input_gives_a_float_result_outside_the_graph) {
+    auto x = std::make_shared<Tensor<int>>(std::vector<int>{1, 4, 9}, std::vector<int>{3}, false);
+    auto y = tensor_sqrt<int, float>(x);
+    check_values(*y, {1, 2, 3}, 0.0, "sqrt");
+    CHECK(y->grad_fn == nullptr);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,86 @@
+#include <memory>
+#include <thread>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+
+static MemoryCounter total() { return MemoryStats::instance().snapshot().total; }
+
+static MemoryCounter op(const char* name) { return MemoryStats::instance().snapshot().by_op[name]; }
+
+static MemoryCounter category(MemoryCategory c) {
+    return MemoryStats::instance().snapshot().categories[static_cast<int>(c)];
+}
+
+TEST(allocations_are_released_and_peak_is_kept) {
+    long long before = total().current_bytes;
+    MemoryStats::instance().reset_peak();
+    {
+        MemoryScope scope("test_alloc");
+        auto a = std::make_shared<Tensor<float>>(std::vector<int>{256, 4});
+        auto b = std::make_shared<Tensor<double>>(std::vector<int>{128});
+        CHECK(total().current_bytes == before + 256 * 4 * 4 + 128 * 8);
+        CHECK(op("test_alloc").live_tensors == 2);
+    }
+    MemoryCounter after = total();
+    CHECK(after.current_bytes == before);
+    CHECK(after.peak_bytes >= before + 256 * 4 * 4 + 128 * 8);
+    CHECK(op("test_alloc").current_bytes == 0);
+    CHECK(op("test_alloc").peak_bytes == 256 * 4 * 4 + 128 * 8);
+
+    MemoryStats::instance().reset_peak();
+    CHECK(total().peak_bytes == before);
+}
+
+TEST(innermost_scope_gets_the_credit) {
+    MemoryScope outer("test_outer");
+    std::shared_ptr<Tensor<float>> inner_tensor;
+    {
+        MemoryScope inner("test_inner");
+        inner_tensor = std::make_shared<Tensor<float>>(std::vector<int>{10});
+    }
+    auto outer_tensor = std::make_shared<Tensor<float>>(std::vector<int>{20});
+    CHECK(op("test_inner").current_bytes == 40);
+    CHECK(op("test_outer").current_bytes == 80);
+}
+
+TEST(parameters_and_gradients_are_categorised) {
+    long long params = category(MemoryCategory::Parameter).current_bytes;
+    long long grads = category(MemoryCategory::Gradient).current_bytes;
+    auto linear = std::make_shared<Linear<float>>(8, 4, std::make_shared<Constant_Val<float>>(0.1f),
+                                                 std::make_shared<Constant_Val<float>>(0.0f));
+    CHECK(category(MemoryCategory::Parameter).current_bytes >= params + (8 * 4 + 4) * 4);
+    auto x = std::make_shared<Tensor<float>>(std::vector<int>{2, 8});
+    sum(linear->forward(x))->backward();
+    CHECK(category(MemoryCategory::Gradient).current_bytes >= grads + (8 * 4 + 4) * 4);
+}
+
+TEST(views_are_not_counted) {
+    auto base = std::make_shared<Tensor<float>>(std::vector<int>{64});
+    long long before = total().current_bytes;
+    auto view = std::make_shared<Tensor<float>>(base, false);
+    CHECK(total().current_bytes == before);
+    view.reset();
+    CHECK(total().current_bytes == before);
+}
+
+TEST(counters_balance_across_threads) {
+    long long before = total().current_bytes;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; ++t) {
+        workers.emplace_back([] {
+            MemoryScope scope("test_threads");
+            for (int i = 0; i < 2000; ++i) {
+                auto a = std::make_shared<Tensor<float>>(std::vector<int>{16});
+                auto b = tensor_scalar_mul(a, 2.0f);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    CHECK(total().current_bytes == before);
+    CHECK(op("test_threads").live_tensors == 0);
+    CHECK(op("test_threads").current_bytes == 0);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,91 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static TensorPtr filled(const std::vector<int>& shape, double scale, double offset, bool requires_grad) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = offset + std::sin(i * scale + 0.2);
+    return make_tensor<double>(values, shape, requires_grad);
+}
+
+// Weighted sum, so every output element has a different gradient.
+static TensorPtr weighted(const TensorPtr& y) {
+    std::vector<double> weights(y->size);
+    for (int i = 0; i < y->size; ++i) weights[i] = std::cos(i * 0.9);
+    return sum(tensor_mul(y, make_tensor<double>(weights, y->shape)));
+}
+
+TEST(layer_norm_normalizes_each_row) {
+    auto x = filled({3, 5}, 0.8, 2.0, false);
+    auto y = layer_norm<double>(x, nullptr, nullptr, 0.0);
+    for (int r = 0; r < 3; ++r) {
+        double mean = 0, sq = 0;
+        for (int j = 0; j < 5; ++j) mean += y->data[r * 5 + j] / 5;
+        for (int j = 0; j < 5; ++j) sq += (y->data[r * 5 + j] - mean) * (y->data[r * 5 + j] - mean) / 5;
+        CHECK_NEAR(mean, 0.0, 1e-12);
+        CHECK_NEAR(sq, 1.0, 1e-12);
+    }
+}
+
+TEST(layer_norm_gradients_match_finite_differences) {
+    auto x = filled({4, 6}, 0.7, 0.5, true);
+    auto gamma = filled({6}, 1.1, 1.0, true), beta = filled({6}, 0.4, 0.0, true);
+    auto loss = [&] { return weighted(layer_norm<double>(x, gamma, beta)); };
+    loss()->backward();
+    for (auto& t : {x, gamma, beta}) {
+        auto expected = numeric_grad(t, loss);
+        check_values(*t->grad, expected, 1e-7, "layer_norm grad");
+    }
+}
+
+TEST(statistics_stay_accurate_with_a_large_mean) {
+    auto x = std::make_shared<Tensor<float>>(std::vector<float>{10000.0f, 10001.0f, 10002.0f, 10003.0f},
+                                             std::vector<int>{1, 4}, false);
+    auto y = layer_norm<float>(x, nullptr, nullptr, 0.0f);
+    // var = 1.25, so the outputs are (-1.5, -0.5, 0.5, 1.5) / sqrt(1.25)
+    double s = 1 / std::sqrt(1.25);
+    check_values(*y, {-1.5 * s, -0.5 * s, 0.5 * s, 1.5 * s}, 1e-5, "layer_norm");
+}
+
+TEST(batch_norm_updates_running_statistics) {
+    BatchNorm1d<double> bn(2, 1e-5, 0.1, false);
+    auto x = make_tensor<double>({1, 10, 2, 20, 3, 30, 6, 60}, {4, 2});
+    bn.forward(x);
+    // channel 0: mean 3, unbiased var 14/3; channel 1 is ten times that
+    check_values(*bn.running_mean, {0.3, 3.0}, 1e-12, "running_mean");
+    check_values(*bn.running_var, {0.9 + 0.1 * 14 / 3.0, 0.9 + 0.1 * 1400 / 3.0}, 1e-12, "running_var");
+
+    bn.training = false;
+    auto y = bn.forward(x);
+    CHECK_NEAR(y->data[0], (1 - 0.3) / std::sqrt(bn.running_var->data[0] + 1e-5), 1e-12);
+    check_values(*bn.running_mean, {0.3, 3.0}, 1e-12, "running_mean after eval");
+}
+
+TEST(batch_norm_gradients_match_finite_differences) {
+    for (bool three_d : {false, true}) {
+        auto x = three_d ? filled({3, 2, 4}, 0.6, 1.0, true) : filled({5, 3}, 0.6, 1.0, true);
+        int channels = x->shape[1];
+        auto gamma = filled({channels}, 1.3, 1.0, true), beta = filled({channels}, 0.5, 0.0, true);
+        auto mean = filled({channels}, 0.0, 0.0, false), var = filled({channels}, 0.0, 1.0, false);
+        auto loss = [&] { return weighted(batch_norm<double>(x, mean, var, gamma, beta, true)); };
+        loss()->backward();
+        for (auto& t : {x, gamma, beta}) {
+            auto expected = numeric_grad(t, loss);
+            check_values(*t->grad, expected, 1e-7, "batch_norm grad");
+        }
+    }
+}
+
+TEST(batch_norm_needs_two_values_per_channel) {
+    BatchNorm1d<double> bn(2, 1e-5, 0.1, true);
+    CHECK_THROWS(bn.forward(make_tensor<double>({1, 2}, {1, 2})));
+}
+
+int main() { return run_tests(); }
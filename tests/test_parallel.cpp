@@ -0,0 +1,91 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "test_util.h"
+#include "utils/parallel.h"
+
+// Number of distinct threads that ran a chunk of a 4-thread parallel_for.
+static int threads_used() {
+    std::mutex mutex;
+    std::set<std::thread::id> ids;
+    parallel_for(0, 4, 1, [&](int, int) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::lock_guard<std::mutex> lock(mutex);
+        ids.insert(std::this_thread::get_id());
+    });
+    return static_cast<int>(ids.size());
+}
+
+// Runs check in a forked child, which is killed if it hangs; returns its exit code.
+template<typename F>
+static int in_child(F check) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        alarm(20);
+        _exit(check());
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+TEST(parallel_for_covers_range_once) {
+    set_num_threads(4);
+    std::vector<std::atomic<int>> hits(10007);
+    parallel_for(0, 10007, 16, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) hits[i].fetch_add(1);
+    });
+    int wrong = 0;
+    for (auto& h : hits) wrong += h.load() != 1;
+    CHECK(wrong == 0);
+}
+
+TEST(parallel_for_rethrows_chunk_exception) {
+    set_num_threads(4);
+    CHECK_THROWS(parallel_for(0, 4, 1, [](int begin, int) {
+        if (begin == 2) throw std::runtime_error("chunk failed");
+    }));
+    // the pool is usable after a failed job
+    CHECK(threads_used() == 4);
+}
+
+TEST(parallel_stable_sort_matches_stable_sort) {
+    set_num_threads(4);
+    std::vector<std::pair<int, int>> values;
+    for (int i = 0; i < 50000; ++i) values.push_back({(i * 7919) % 97, i});
+    auto expected = values;
+    auto by_key = [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; };
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    parallel_stable_sort(values, by_key, 1024);
+    CHECK(values == expected);
+}
+
+TEST(forked_child_gets_a_working_pool) {
+    set_num_threads(4);
+    CHECK(threads_used() == 4);
+    CHECK(in_child([] { return threads_used() == 4 ? 0 : 1; }) == 0);
+}
+
+TEST(fork_while_another_thread_runs_a_job) {
+    set_num_threads(4);
+    std::atomic<bool> started{false};
+    std::thread busy([&] {
+        parallel_for(0, 4, 1, [&](int, int) {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        });
+    });
+    while (!started) std::this_thread::yield();
+    // the parent's pool is busy and its mutexes may be held at the fork
+    CHECK(in_child([] { return threads_used() == 4 ? 0 : 1; }) == 0);
+    busy.join();
+    CHECK(threads_used() == 4);
+}
+
+int main() { return run_tests(); }
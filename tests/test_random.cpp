@@ -0,0 +1,161 @@
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "utils/random.h"
+
+// Block 0 of the draw whose counter is (c0, c1, c2, c3) under key (k0, k1).
+static std::vector<uint32_t> philox_block(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t k0, uint32_t k1) {
+    PhiloxState state{(static_cast<uint64_t>(k1) << 32) | k0, (static_cast<uint64_t>(c3) << 32) | c2,
+                      (static_cast<uint64_t>(c1) << 32) | c0};
+    uint32_t words[4][PHILOX_BATCH];
+    philox_batch(state, 0, words);
+    return {words[0][0], words[1][0], words[2][0], words[3][0]};
+}
+
+template<typename T>
+static std::vector<T> draw_uniform(size_t n) {
+    std::vector<T> values(n);
+    random_uniform<T>(values.data(), n, T(-1), T(3));
+    return values;
+}
+
+TEST(philox_matches_the_reference_vectors) {
+    // known-answer tests of Philox4x32-10 from the Random123 distribution
+    CHECK(philox_block(0, 0, 0, 0, 0, 0) == std::vector<uint32_t>({0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    CHECK(philox_block(0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff) ==
+          std::vector<uint32_t>({0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    CHECK(philox_block(0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0) ==
+          std::vector<uint32_t>({0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(manual_seed_makes_draws_reproducible) {
+    manual_seed(1234);
+    CHECK(initial_seed() == 1234);
+    auto a = draw_uniform<float>(1000), b = draw_uniform<float>(1000);
+    CHECK(a != b);
+    manual_seed(1234);
+    CHECK(draw_uniform<float>(1000) == a);
+    CHECK(draw_uniform<float>(1000) == b);
+    manual_seed(1235);
+    CHECK(draw_uniform<float>(1000) != a);
+}
+
+TEST(draws_do_not_depend_on_the_thread_count) {
+    int restore = get_num_threads();
+    const size_t n = 1 << 20;
+    std::vector<double> single(n), multi(n), normal_single(n), normal_multi(n);
+    PhiloxState state{42, 3, 17};
+    set_num_threads(1);
+    philox_uniform<double>(state, single.data(), n, 0.0, 1.0);
+    philox_normal<double>(state, normal_single.data(), n, 0.0, 1.0);
+    set_num_threads(4);
+    philox_uniform<double>(state, multi.data(), n, 0.0, 1.0);
+    philox_normal<double>(state, normal_multi.data(), n, 0.0, 1.0);
+    set_num_threads(restore);
+    CHECK(single == multi);
+    CHECK(normal_single == normal_multi);
+
+    // a shorter draw from the same state is a prefix of the longer one
+    std::vector<double> prefix(1001);
+    philox_uniform<double>(state, prefix.data(), prefix.size(), 0.0, 1.0);
+    CHECK(std::equal(prefix.begin(), prefix.end(), single.begin()));
+}
+
+template<typename T>
+static void check_moments() {
+    const size_t n = 200000;
+    std::vector<T> u(n), z(n);
+    PhiloxState state{7, 0, 0};
+    philox_uniform<T>(state, u.data(), n, T(-1), T(3));
+    philox_normal<T>(state, z.data(), n, T(2), T(0.5));
+    double u_sum = 0, z_sum = 0, z_sq = 0;
+    bool in_range = true;
+    for (size_t i = 0; i < n; ++i) {
+        in_range &= u[i] >= T(-1) && u[i] < T(3) && std::isfinite(z[i]);
+        u_sum += u[i];
+        z_sum += z[i];
+        z_sq += (z[i] - 2.0) * (z[i] - 2.0);
+    }
+    CHECK(in_range);
+    // five standard errors
+    CHECK_NEAR(u_sum / n, 1.0, 5 * 4 / std::sqrt(12.0 * n));
+    CHECK_NEAR(z_sum / n, 2.0, 5 * 0.5 / std::sqrt(1.0 * n));
+    CHECK_NEAR(std::sqrt(z_sq / n), 0.5, 5 * 0.5 / std::sqrt(2.0 * n));
+}
+
+TEST(uniform_and_normal_have_the_right_moments) {
+    check_moments<float>();
+    check_moments<double>();
+}
+
+TEST(private_streams_replay_their_draws) {
+    manual_seed(99);
+    PhiloxState start = RandomGenerator::global().fork_stream();
+    std::vector<float> first, replay;
+    PhiloxState child, child_replay;
+    {
+        RandomStreamGuard guard(start);
+        first = draw_uniform<float>(100);
+        child = RandomGenerator::global().fork_stream();
+    }
+    auto shared = draw_uniform<float>(100);
+    {
+        RandomStreamGuard guard(start);
+        replay = draw_uniform<float>(100);
+        child_replay = RandomGenerator::global().fork_stream();
+    }
+    CHECK(first == replay);
+    CHECK(child.stream == child_replay.stream);
+    CHECK(child.stream != start.stream);
+    CHECK(shared != first);
+    CHECK(RandomGenerator::global().fork_stream().stream != start.stream);
+}
+
+TEST(initializers_follow_the_seed) {
+    auto make = [] {
+        return std::make_shared<Linear<float>>(64, 32, std::make_shared<HeNormal<float>>(),
+                                               std::make_shared<XavierUniform<float>>());
+    };
+    manual_seed(5);
+    auto a = make();
+    manual_seed(5);
+    auto b = make();
+    for (int k = 0; k < 2; ++k) CHECK(to_vector(*a->parameters()[k]) == to_vector(*b->parameters()[k]));
+    CHECK(to_vector(*make()->parameters()[0]) != to_vector(*a->parameters()[0]));
+}
+
+TEST(dropout_masks_are_reproducible_and_reused_in_backward) {
+    const int n = 100000;
+    const double p = 0.3;
+    auto x = make_tensor<double>(std::vector<double>(n, 2.0), {100, 1000}, true);
+    manual_seed(11);
+    auto y = dropout(x, p);
+    manual_seed(11);
+    auto again = dropout(x, p);
+    CHECK(to_vector(*y) == to_vector(*again));
+    CHECK(to_vector(*dropout(x, p)) != to_vector(*y));
+
+    sum(y)->backward();
+    int dropped = 0;
+    bool consistent = true;
+    for (int i = 0; i < n; ++i) {
+        bool kept = y->data[i] != 0.0;
+        dropped += !kept;
+        consistent &= kept ? y->data[i] == 2.0 / (1 - p) && x->grad->data[i] == 1 / (1 - p) : x->grad->data[i] == 0.0;
+    }
+    CHECK(consistent);
+    CHECK_NEAR(dropped / static_cast<double>(n), p, 5 * std::sqrt(p * (1 - p) / n));
+
+    Dropout<double> layer(p);
+    layer.training = false;
+    CHECK(layer.forward(x) == x);
+    CHECK(dropout(x, 0.0) == x);
+    CHECK_THROWS(dropout(x, 1.0));
+    CHECK_THROWS(Dropout<double>(-0.1));
+}
+
+int main() { return run_tests(); }
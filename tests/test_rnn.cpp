@@ -0,0 +1,151 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static TensorPtr filled(const std::vector<int>& shape, double scale, bool requires_grad) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = 0.8 * std::sin(i * scale + 0.4);
+    return make_tensor<double>(values, shape, requires_grad);
+}
+
+static double sigmoid_ref(double x) { return 1 / (1 + std::exp(-x)); }
+
+// Row j of w [rows x cols] times v.
+static double dot_row(const Tensor<double>& w, int j, const double* v) {
+    double acc = 0;
+    for (int k = 0; k < w.shape[1]; ++k) acc += w.data[j * w.shape[1] + k] * v[k];
+    return acc;
+}
+
+// Step-by-step LSTM: returns every hidden state and the final cell state.
+static std::vector<double> lstm_reference(const Tensor<double>& x, const Tensor<double>& h0, const Tensor<double>& c0,
+                                          const Tensor<double>& w_ih, const Tensor<double>& w_hh,
+                                          const Tensor<double>& bias, std::vector<double>& c_last) {
+    int steps = x.shape[0], batch = x.shape[1], in = x.shape[2], H = h0.shape[1];
+    std::vector<double> h(h0.data.get(), h0.data.get() + h0.size), c(c0.data.get(), c0.data.get() + c0.size), out;
+    for (int t = 0; t < steps; ++t) {
+        std::vector<double> h_next(h.size()), c_next(c.size());
+        for (int b = 0; b < batch; ++b) {
+            const double* xt = x.data.get() + (t * batch + b) * in;
+            for (int j = 0; j < H; ++j) {
+                double g[4];
+                for (int k = 0; k < 4; ++k) {
+                    int row = k * H + j;
+                    g[k] = dot_row(w_ih, row, xt) + dot_row(w_hh, row, h.data() + b * H) + bias.data[row];
+                }
+                double cell = sigmoid_ref(g[1]) * c[b * H + j] + sigmoid_ref(g[0]) * std::tanh(g[2]);
+                c_next[b * H + j] = cell;
+                h_next[b * H + j] = sigmoid_ref(g[3]) * std::tanh(cell);
+            }
+        }
+        h = h_next;
+        c = c_next;
+        out.insert(out.end(), h.begin(), h.end());
+    }
+    c_last = c;
+    return out;
+}
+
+// Step-by-step GRU with n = tanh(W_in x + b_in + r * (W_hn h + b_hn)).
+static std::vector<double> gru_reference(const Tensor<double>& x, const Tensor<double>& h0,
+                                         const Tensor<double>& w_ih, const Tensor<double>& w_hh,
+                                         const Tensor<double>& b_ih, const Tensor<double>& b_hh) {
+    int steps = x.shape[0], batch = x.shape[1], in = x.shape[2], H = h0.shape[1];
+    std::vector<double> h(h0.data.get(), h0.data.get() + h0.size), out;
+    for (int t = 0; t < steps; ++t) {
+        std::vector<double> h_next(h.size());
+        for (int b = 0; b < batch; ++b) {
+            const double* xt = x.data.get() + (t * batch + b) * in;
+            const double* hp = h.data() + b * H;
+            for (int j = 0; j < H; ++j) {
+                double xg[3], hg[3];
+                for (int k = 0; k < 3; ++k) {
+                    xg[k] = dot_row(w_ih, k * H + j, xt) + b_ih.data[k * H + j];
+                    hg[k] = dot_row(w_hh, k * H + j, hp) + b_hh.data[k * H + j];
+                }
+                double r = sigmoid_ref(xg[0] + hg[0]), z = sigmoid_ref(xg[1] + hg[1]);
+                double n = std::tanh(xg[2] + r * hg[2]);
+                h_next[b * H + j] = (1 - z) * n + z * hp[j];
+            }
+        }
+        h = h_next;
+        out.insert(out.end(), h.begin(), h.end());
+    }
+    return out;
+}
+
+static TensorPtr weighted(const TensorPtr& y) {
+    std::vector<double> weights(y->size);
+    for (int i = 0; i < y->size; ++i) weights[i] = std::cos(i * 0.7);
+    return sum(tensor_mul(y, make_tensor<double>(weights, y->shape)));
+}
+
+const int steps = 4, batch = 2, features = 3, hidden = 5;
+
+TEST(lstm_matches_step_by_step_reference) {
+    auto x = filled({steps, batch, features}, 0.5, false);
+    auto h0 = filled({batch, hidden}, 0.9, false), c0 = filled({batch, hidden}, 1.7, false);
+    auto w_ih = filled({4 * hidden, features}, 0.3, true), w_hh = filled({4 * hidden, hidden}, 0.7, true);
+    auto bias = filled({4 * hidden}, 1.1, true);
+    auto result = lstm(x, h0, c0, w_ih, w_hh, bias);
+    std::vector<double> c_last;
+    auto expected = lstm_reference(*x, *h0, *c0, *w_ih, *w_hh, *bias, c_last);
+    check_values(*result.output, expected, 1e-12, "lstm output");
+    check_values(*result.h_n, std::vector<double>(expected.end() - batch * hidden, expected.end()), 1e-12, "h_n");
+    check_values(*result.c_n, c_last, 1e-12, "c_n");
+    CHECK(!result.h_n->requires_grad);
+
+    auto last = lstm(x, h0, c0, w_ih, w_hh, bias, false);
+    CHECK(last.output->shape == std::vector<int>({batch, hidden}));
+    check_values(*last.output, to_vector(*result.h_n), 0.0, "last step");
+}
+
+TEST(gru_matches_step_by_step_reference) {
+    auto x = filled({steps, batch, features}, 0.5, false);
+    auto h0 = filled({batch, hidden}, 0.9, false);
+    auto w_ih = filled({3 * hidden, features}, 0.3, true), w_hh = filled({3 * hidden, hidden}, 0.7, true);
+    auto b_ih = filled({3 * hidden}, 1.1, true), b_hh = filled({3 * hidden}, 0.2, true);
+    auto result = gru(x, h0, w_ih, w_hh, b_ih, b_hh);
+    check_values(*result.output, gru_reference(*x, *h0, *w_ih, *w_hh, *b_ih, *b_hh), 1e-12, "gru output");
+}
+
+TEST(lstm_gradients_match_finite_differences) {
+    for (bool sequences : {true, false}) {
+        auto x = filled({steps, batch, features}, 0.5, true);
+        auto h0 = filled({batch, hidden}, 0.9, true), c0 = filled({batch, hidden}, 1.7, true);
+        auto w_ih = filled({4 * hidden, features}, 0.3, true), w_hh = filled({4 * hidden, hidden}, 0.7, true);
+        auto bias = filled({4 * hidden}, 1.1, true);
+        auto loss = [&] { return weighted(lstm(x, h0, c0, w_ih, w_hh, bias, sequences).output); };
+        loss()->backward();
+        for (auto& t : {x, h0, c0, w_ih, w_hh, bias}) check_values(*t->grad, numeric_grad(t, loss), 1e-7, "lstm grad");
+    }
+}
+
+TEST(gru_gradients_match_finite_differences) {
+    for (bool sequences : {true, false}) {
+        auto x = filled({steps, batch, features}, 0.5, true);
+        auto h0 = filled({batch, hidden}, 0.9, true);
+        auto w_ih = filled({3 * hidden, features}, 0.3, true), w_hh = filled({3 * hidden, hidden}, 0.7, true);
+        auto b_ih = filled({3 * hidden}, 1.1, true), b_hh = filled({3 * hidden}, 0.2, true);
+        auto loss = [&] { return weighted(gru(x, h0, w_ih, w_hh, b_ih, b_hh, sequences).output); };
+        loss()->backward();
+        for (auto& t : {x, h0, w_ih, w_hh, b_ih, b_hh}) check_values(*t->grad, numeric_grad(t, loss), 1e-7, "gru grad");
+    }
+}
+
+TEST(recurrent_shapes_are_checked) {
+    auto w_ih = filled({4 * hidden, features}, 0.3, true), w_hh = filled({4 * hidden, hidden}, 0.7, true);
+    CHECK_THROWS(lstm<double>(filled({batch, features}, 0.5, false), nullptr, nullptr, w_ih, w_hh, nullptr));
+    CHECK_THROWS(lstm<double>(filled({steps, batch, features + 1}, 0.5, false), nullptr, nullptr, w_ih, w_hh, nullptr));
+    CHECK_THROWS(lstm<double>(filled({steps, batch, features}, 0.5, false), filled({batch + 1, hidden}, 0.9, false),
+                              nullptr, w_ih, w_hh, nullptr));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,86 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "optims/optims.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+// [5 x 6] with an empty row and a few entries per row.
+static std::shared_ptr<SparseTensor<double>> sample() {
+    return SparseTensor<double>::from_coo(5, 6, {0, 0, 2, 2, 2, 4, 3}, {1, 5, 0, 3, 4, 2, 3},
+                                          {1.5, -2.0, 0.5, 3.0, -1.0, 2.5, 4.0});
+}
+
+static std::shared_ptr<Linear<double>> make_linear(int in, int out) {
+    auto linear = std::make_shared<Linear<double>>(in, out, std::make_shared<Constant_Val<double>>(0.0),
+                                                  std::make_shared<Constant_Val<double>>(0.0));
+    auto params = linear->parameters();
+    for (int i = 0; i < params[0]->size; ++i) params[0]->data[i] = std::sin(i * 0.3);
+    for (int i = 0; i < params[1]->size; ++i) params[1]->data[i] = 0.1 * i;
+    return linear;
+}
+
+TEST(coo_duplicates_are_summed) {
+    auto a = SparseTensor<double>::from_coo(2, 3, {1, 0, 1}, {2, 1, 2}, {1.0, 2.0, 3.0});
+    CHECK(a->nnz() == 2);
+    check_values(*a->to_dense(), {0, 2, 0, 0, 0, 4}, 0.0, "dense");
+}
+
+TEST(dense_round_trip) {
+    auto dense = sample()->to_dense();
+    auto back = SparseTensor<double>::from_dense(*dense);
+    CHECK(back->nnz() == 7);
+    check_values(*back->to_dense(), to_vector(*dense), 0.0, "round trip");
+}
+
+TEST(invalid_csr_is_rejected) {
+    CHECK_THROWS(SparseTensor<double>(2, 3, {0, 2, 2}, {2, 1}, {1.0, 1.0}));
+    CHECK_THROWS(SparseTensor<double>(2, 3, {0, 1, 2}, {0, 3}, {1.0, 1.0}));
+    CHECK_THROWS(SparseTensor<double>(2, 3, {0, 1}, {0}, {1.0}));
+}
+
+TEST(spmm_matches_dense_matmul) {
+    auto a = sample();
+    std::vector<double> values(6 * 4);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = std::cos(i * 0.7);
+    auto b_sparse = make_tensor<double>(values, {6, 4}, true);
+    auto b_dense = make_tensor<double>(values, {6, 4}, true);
+    auto y = spmm(a, b_sparse);
+    auto expected = mat_mul(a->to_dense(), b_dense);
+    check_values(*y, to_vector(*expected), 1e-12, "spmm");
+    sum(tensor_mul(y, y))->backward();
+    sum(tensor_mul(expected, expected))->backward();
+    check_values(*b_sparse->grad, to_vector(*b_dense->grad), 1e-12, "b.grad");
+}
+
+TEST(sparse_linear_matches_dense_linear) {
+    auto sparse_layer = make_linear(6, 3), dense_layer = make_linear(6, 3);
+    auto a = sample();
+    SGD<double> sparse_opt(sparse_layer->parameters(), 0.1), dense_opt(dense_layer->parameters(), 0.1);
+    // the second step runs after the weights changed, so the packed copy must be refreshed
+    for (int step = 0; step < 2; ++step) {
+        sparse_opt.zero_grad();
+        dense_opt.zero_grad();
+        auto y_sparse = sparse_layer->forward(a);
+        auto y_dense = dense_layer->forward(a->to_dense());
+        check_values(*y_sparse, to_vector(*y_dense), 1e-12, "output");
+        sum(tensor_mul(y_sparse, y_sparse))->backward();
+        sum(tensor_mul(y_dense, y_dense))->backward();
+        for (int p = 0; p < 2; ++p) {
+            check_values(*sparse_layer->parameters()[p]->grad, to_vector(*dense_layer->parameters()[p]->grad),
+                         1e-12, "parameter grad");
+        }
+        sparse_opt.step();
+        dense_opt.step();
+    }
+}
+
+TEST(sparse_linear_checks_input_width) {
+    auto layer = make_linear(4, 3);
+    CHECK_THROWS(layer->forward(sample()));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,113 @@
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/activations/activations.h"
+#include "nn/layers/layers.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static std::vector<double> inputs(int n) {
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = std::sin(i * 0.37);
+    return values;
+}
+
+TEST(threads_apply_activations_to_a_shared_intermediate) {
+    const int threads = 8, rounds = 50;
+    std::vector<double> v = inputs(64);
+    auto x = make_tensor<double>(v, {64}, true);
+    auto h = tensor_scalar_mul(x, 2.0);
+    std::vector<std::vector<TensorPtr>> outputs(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int r = 0; r < rounds; ++r) {
+                if (r % 3 == 0) outputs[t].push_back(relu(h));
+                else if (r % 3 == 1) outputs[t].push_back(tanh_fn(h));
+                else outputs[t].push_back(sigmoid(h));
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    auto loss = sum(h);
+    for (auto& per_thread : outputs) {
+        for (auto& y : per_thread) loss = tensor_add(loss, sum(y));
+    }
+    loss->backward();
+
+    int relus = 0, tanhs = 0, sigmoids = 0;
+    for (int r = 0; r < rounds; ++r) (r % 3 == 0 ? relus : r % 3 == 1 ? tanhs : sigmoids) += threads;
+    std::vector<double> expected;
+    for (double value : v) {
+        double a = 2 * value, t = std::tanh(a), s = 1 / (1 + std::exp(-a));
+        expected.push_back(2 * (1 + relus * (a > 0) + tanhs * (1 - t * t) + sigmoids * s * (1 - s)));
+    }
+    check_values(*x->grad, expected, 1e-9, "x.grad");
+}
+
+TEST(concurrent_backward_on_independent_graphs) {
+    const int threads = 4;
+    auto shared = std::make_shared<Linear<double>>(6, 3, std::make_shared<Constant_Val<double>>(0.2),
+                                                  std::make_shared<Constant_Val<double>>(0.1));
+    std::vector<TensorPtr> x;
+    for (int t = 0; t < threads; ++t) x.push_back(make_tensor<double>(inputs(12), {2, 6}, true));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            // a view that does not require grad: the graphs share no tensor that does
+            auto weight = std::make_shared<Tensor<double>>(shared->parameters()[0], false);
+            auto h = mat_mul(x[t], transpose(weight));
+            sum(tensor_add(tanh_fn(h), relu(h)))->backward();
+        });
+    }
+    for (auto& w : workers) w.join();
+    for (int t = 1; t < threads; ++t) check_values(*x[t]->grad, to_vector(*x[0]->grad), 0.0, "x.grad");
+}
+
+TEST(concurrent_forwards_through_shared_layers_match_serial) {
+    const int threads = 6, rounds = 20;
+    auto first = std::make_shared<Linear<double>>(16, 32, std::make_shared<Constant_Val<double>>(0.03),
+                                                 std::make_shared<Constant_Val<double>>(0.1));
+    auto second = std::make_shared<Linear<double>>(32, 4, std::make_shared<Constant_Val<double>>(-0.02),
+                                                  std::make_shared<Constant_Val<double>>(0.2));
+    std::vector<double> w(4 * 8 * 8);
+    for (size_t i = 0; i < w.size(); ++i) w[i] = 0.2 * std::sin(i * 0.13);
+    auto w_ih = make_tensor<double>(w, {32, 8}), w_hh = make_tensor<double>(w, {32, 8});
+    auto forward = [&](int t) {
+        auto x = make_tensor<double>(inputs(8 * 16), {8, 16});
+        auto h = second->forward(relu(first->forward(tensor_scalar_mul(x, 1.0 + t))));
+        auto seq = make_tensor<double>(inputs(3 * 8 * 8), {3, 8, 8});
+        auto out = lstm<double>(tensor_scalar_mul(seq, 1.0 + t), nullptr, nullptr, w_ih, w_hh, nullptr).output;
+        auto values = to_vector(*h);
+        for (double v : to_vector(*out)) values.push_back(v);
+        return values;
+    };
+    std::vector<std::vector<double>> expected;
+    for (int t = 0; t < threads; ++t) expected.push_back(forward(t));
+
+    // the thread count is changed while the kernels run
+    std::atomic<bool> done{false};
+    int restore = get_num_threads();
+    std::thread tuner([&] {
+        for (int n = 0; !done; ++n) set_num_threads(1 + n % 4);
+    });
+    std::vector<int> mismatches(threads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int r = 0; r < rounds; ++r) mismatches[t] += forward(t) != expected[t];
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    done = true;
+    tuner.join();
+    set_num_threads(restore);
+    for (int m : mismatches) CHECK(m == 0);
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "test_util.h"
+#include "tensors/tensors.h"
+#include "nn/layers/layers.h"
+#include "losses/losses.h"
+#include "optims/optims.h"
+
+using TensorPtr = std::shared_ptr<Tensor<double>>;
+
+static std::shared_ptr<Linear<double>> make_linear(int in, int out) {
+    auto linear = std::make_shared<Linear<double>>(in, out, std::make_shared<Constant_Val<double>>(0.0),
+                                                  std::make_shared<Constant_Val<double>>(0.05));
+    auto weight = linear->parameters()[0];
+    for (int i = 0; i < weight->size; ++i) weight->data[i] = 0.5 * std::sin(i * 0.7 + out);
+    return linear;
+}
+
+static TensorPtr filled(const std::vector<int>& shape, double scale) {
+    int n = 1;
+    for (int d : shape) n *= d;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) values[i] = std::sin(i * scale + 0.4);
+    return make_tensor<double>(values, shape);
+}
+
+// 23 rows in batches of 5, so every epoch ends with a short batch
+const int rows = 23, batch = 5;
+
+TEST(fit_matches_a_hand_written_loop) {
+    auto x = filled({rows, 4}, 0.37), y = filled({rows, 2}, 0.91);
+    auto l1 = make_linear(4, 6), l2 = make_linear(6, 2);
+    auto model = std::make_shared<TrainerModel<double>>();
+    model->add_linear(l1);
+    model->add_activation("tanh");
+    model->add_linear(l2);
+    auto sgd = std::make_shared<SGD<double>>(model->parameters(), 0.1);
+    Trainer<double> trainer(model, trainer_loss<double>("mse"), sgd);
+    TensorDataLoader<double> data(x, y, batch, false);
+    auto report = trainer.fit(data, 3);
+    CHECK(report.steps == 3 * 5);
+    CHECK(report.epoch_losses.size() == 3);
+    CHECK(report.final_loss == report.epoch_losses.back());
+
+    auto r1 = make_linear(4, 6), r2 = make_linear(6, 2);
+    std::vector<TensorPtr> params = r1->parameters();
+    for (auto& p : r2->parameters()) params.push_back(p);
+    SGD<double> reference(params, 0.1);
+    for (int epoch = 0; epoch < 3; ++epoch) {
+        double epoch_loss = 0;
+        for (int first = 0; first < rows; first += batch) {
+            int count = std::min(batch, rows - first);
+            std::vector<double> xv(x->data.get() + first * 4, x->data.get() + (first + count) * 4);
+            std::vector<double> yv(y->data.get() + first * 2, y->data.get() + (first + count) * 2);
+            reference.zero_grad();
+            auto loss = mse_loss(make_tensor<double>(yv, {count, 2}),
+                                 r2->forward(tanh_fn(r1->forward(make_tensor<double>(xv, {count, 4})))));
+            loss->backward();
+            reference.step();
+            epoch_loss += loss->data[0];
+        }
+        CHECK_NEAR(report.epoch_losses[epoch], epoch_loss / 5, 1e-12);
+    }
+    auto trained = model->parameters();
+    for (size_t k = 0; k < params.size(); ++k) check_values(*trained[k], to_vector(*params[k]), 1e-12, "parameter");
+}
+
+TEST(shuffled_epochs_visit_every_row_once) {
+    // row r of x holds r, so a batch shows which rows it took
+    std::vector<double> ids(rows);
+    for (int r = 0; r < rows; ++r) ids[r] = r;
+    auto x = make_tensor<double>(ids, {rows, 1}), y = make_tensor<double>(ids, {rows, 1});
+    auto order = [&](TensorDataLoader<double>& data, int epoch) {
+        data.start_epoch(epoch);
+        std::vector<double> seen;
+        for (int b = 0; b < data.num_batches(); ++b) {
+            auto [xb, yb] = data.batch(b);
+            CHECK(xb->shape[0] == (b + 1 < data.num_batches() ? batch : rows % batch));
+            CHECK(to_vector(*xb) == to_vector(*yb));
+            for (double v : to_vector(*xb)) seen.push_back(v);
+        }
+        return seen;
+    };
+    TensorDataLoader<double> data(x, y, batch, true, 7), same(x, y, batch, true, 7), other(x, y, batch, true, 8);
+    CHECK(data.num_batches() == 5);
+    auto first = order(data, 0), second = order(data, 1);
+    auto sorted = first;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(sorted == ids);
+    CHECK(first != ids);
+    CHECK(first != second);
+    CHECK(order(same, 1) == second);
+    CHECK(order(other, 1) != second);
+}
+
+TEST(callback_reports_the_mean_loss_of_its_window) {
+    auto x = filled({rows, 4}, 0.37), y = filled({rows, 2}, 0.91);
+    auto model = std::make_shared<TrainerModel<double>>();
+    model->add_linear(make_linear(4, 2));
+    std::vector<double> losses;
+    TrainerLoss<double> recorded = [&](const TensorPtr& target, const TensorPtr& output) {
+        auto loss = mae_loss(target, output);
+        losses.push_back(loss->data[0]);
+        return loss;
+    };
+    Trainer<double> trainer(model, recorded, std::make_shared<SGD<double>>(model->parameters(), 0.01));
+    TensorDataLoader<double> data(x, y, batch, false);
+    std::vector<TrainerProgress> calls;
+    trainer.fit(data, 2, 3, [&](const TrainerProgress& p) { calls.push_back(p); });
+    // ten steps, logged after steps 3, 6 and 9
+    CHECK(losses.size() == 10);
+    CHECK(calls.size() == 3);
+    for (size_t k = 0; k < calls.size(); ++k) {
+        CHECK(calls[k].step == 3 * static_cast<long long>(k + 1));
+        CHECK(calls[k].epoch == (k == 0 ? 0 : 1));
+        CHECK_NEAR(calls[k].loss, (losses[3 * k] + losses[3 * k + 1] + losses[3 * k + 2]) / 3, 1e-15);
+    }
+}
+
+TEST(adam_with_normalization_and_dropout_reduces_the_loss) {
+    manual_seed(3);
+    auto x = filled({64, 4}, 0.37);
+    std::vector<double> targets(64);
+    for (int r = 0; r < 64; ++r) targets[r] = x->data[4 * r] - 0.5 * x->data[4 * r + 3] > 0 ? 1.0 : 0.0;
+    auto y = make_tensor<double>(targets, {64, 1});
+    auto model = std::make_shared<TrainerModel<double>>();
+    model->add_linear(make_linear(4, 16));
+    model->add_batch_norm(std::make_shared<BatchNorm1d<double>>(16, 1e-5, 0.1, true));
+    model->add_activation("relu");
+    model->add_dropout(std::make_shared<Dropout<double>>(0.1));
+    model->add_layer_norm(std::make_shared<LayerNorm<double>>(16, 1e-5, true));
+    model->add_linear(make_linear(16, 1));
+    model->add_activation("sigmoid");
+    CHECK(model->parameters().size() == 8);
+    auto adam = std::make_shared<Adam<double>>(model->parameters(), 0.01, 0.9, 0.999, 1e-8);
+    Trainer<double> trainer(model, trainer_loss<double>("bce"), adam);
+    TensorDataLoader<double> data(x, y, 16, true, 1);
+    auto report = trainer.fit(data, 30);
+    CHECK(report.final_loss < 0.5 * report.epoch_losses.front());
+}
+
+TEST(trainer_checks_its_arguments) {
+    auto x = filled({rows, 4}, 0.37), y = filled({rows, 2}, 0.91);
+    auto model = std::make_shared<TrainerModel<double>>();
+    auto sgd = std::make_shared<SGD<double>>(std::vector<TensorPtr>{}, 0.1);
+    CHECK_THROWS(Trainer<double>(model, trainer_loss<double>("mse"), sgd));
+    CHECK_THROWS(trainer_loss<double>("huber"));
+    CHECK_THROWS(model->add_activation("gelu"));
+    CHECK_THROWS(TensorDataLoader<double>(x, filled({rows + 1, 2}, 0.9), batch));
+    CHECK_THROWS(TensorDataLoader<double>(x, y, 0));
+    model->add_linear(make_linear(4, 2));
+    TensorDataLoader<double> data(x, y, batch);
+    CHECK_THROWS(Trainer<double>(model, trainer_loss<double>("mse"), sgd).fit(data, -1));
+}
+
+int main() { return run_tests(); }
@@ -0,0 +1,119 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <vector>
+#include "tensors/tensor.h"
+
+// Each test file builds into one executable. Tests are registered with TEST;
+// the CHECK macros report a failure and let the test go on. run_tests runs
+// every test and returns non-zero if any check failed, for ctest.
+struct TestCase {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<TestCase>& test_registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*fn)()) { test_registry().push_back({name, fn}); }
+};
+
+#define TEST(name)                                             \
+    static void name();                                        \
+    static TestRegistrar name##_registrar(#name, name);        \
+    static void name()
+
+#define CHECK(cond)                                                                     \
+    do {                                                                                \
+        if (!(cond)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++test_failures();                                                          \
+        }                                                                               \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                           \
+    do {                                                                                \
+        double check_a_ = static_cast<double>(a), check_b_ = static_cast<double>(b);   \
+        if (!(std::abs(check_a_ - check_b_) <= (tol))) {                                \
+            std::fprintf(stderr, "%s:%d: %s = %.9g, expected %.9g\n", __FILE__, __LINE__, \
+                         #a, check_a_, check_b_);                                       \
+            ++test_failures();                                                          \
+        }                                                                               \
+    } while (0)
+
+#define CHECK_THROWS(expr)                                                              \
+    do {                                                                                \
+        bool threw_ = false;                                                            \
+        try { expr; } catch (const std::exception&) { threw_ = true; }                  \
+        if (!threw_) {                                                                  \
+            std::fprintf(stderr, "%s:%d: %s did not throw\n", __FILE__, __LINE__, #expr); \
+            ++test_failures();                                                          \
+        }                                                                               \
+    } while (0)
+
+// Element-wise comparison of a tensor with expected values.
+template<typename T>
+void check_values(const Tensor<T>& t, const std::vector<double>& expected, double tol, const char* what) {
+    if (t.size != static_cast<int>(expected.size())) {
+        std::fprintf(stderr, "%s: size %d, expected %zu\n", what, t.size, expected.size());
+        ++test_failures();
+        return;
+    }
+    for (int i = 0; i < t.size; ++i) {
+        if (!(std::abs(static_cast<double>(t.data[i]) - expected[i]) <= tol)) {
+            std::fprintf(stderr, "%s[%d] = %.9g, expected %.9g\n", what, i, static_cast<double>(t.data[i]), expected[i]);
+            ++test_failures();
+        }
+    }
+}
+
+template<typename T>
+std::shared_ptr<Tensor<T>> make_tensor(const std::vector<T>& values, const std::vector<int>& shape, bool requires_grad = false) {
+    return std::make_shared<Tensor<T>>(values, shape, requires_grad);
+}
+
+// Central-difference gradient of the scalar loss() with respect to x. loss is
+// evaluated with grad mode off, so it must not depend on x->grad.
+template<typename T, typename F>
+std::vector<double> numeric_grad(const std::shared_ptr<Tensor<T>>& x, F loss, double h = 1e-6) {
+    NoGradGuard no_grad;
+    std::vector<double> grad(x->size);
+    for (int i = 0; i < x->size; ++i) {
+        T saved = x->data[i];
+        x->data[i] = static_cast<T>(saved + h);
+        double plus = static_cast<double>(loss()->data[0]);
+        x->data[i] = static_cast<T>(saved - h);
+        double minus = static_cast<double>(loss()->data[0]);
+        x->data[i] = saved;
+        grad[i] = (plus - minus) / (2 * h);
+    }
+    return grad;
+}
+
+inline int run_tests() {
+    for (const auto& test : test_registry()) {
+        int before = test_failures();
+        try {
+            test.fn();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s: unexpected exception: %s\n", test.name, e.what());
+            ++test_failures();
+        }
+        std::printf("%s %s\n", test_failures() == before ? "PASS" : "FAIL", test.name);
+    }
+    return test_failures() == 0 ? 0 : 1;
+}
+
+#endif
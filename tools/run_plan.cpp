@@ -0,0 +1,88 @@
+// Standalone runner for plans written by minitensor.export. Needs only the
+// C++ standard library:
+//
+//   run_plan model.plan < rows.txt          one input row per line, prints one output row per line
+//   run_plan model.plan --bench 1000 [rows] times 1000 calls on random rows (default: the plan's max_batch)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "export/inference_plan.h"
+
+static int usage() {
+    std::fprintf(stderr, "usage: run_plan <model.plan> [--bench <iterations> [rows]]\n");
+    return 2;
+}
+
+static void print_rows(const std::vector<float>& values, int width) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        std::printf("%.9g%c", values[i], (i + 1) % width == 0 ? '\n' : ' ');
+    }
+}
+
+static int run_stdin(PlanRunner& runner) {
+    const InferencePlan& plan = runner.get_plan();
+    std::vector<float> input;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(std::cin, line)) {
+        ++line_number;
+        std::istringstream fields(line);
+        size_t before = input.size();
+        float value;
+        while (fields >> value) input.push_back(value);
+        size_t count = input.size() - before;
+        if (count == 0) continue;
+        if (count != static_cast<size_t>(plan.input_features)) {
+            std::fprintf(stderr, "ERROR: Line %d has %zu values, the plan expects %d.\n",
+                         line_number, count, plan.input_features);
+            return 1;
+        }
+    }
+    print_rows(runner.run(input), plan.output_features);
+    return 0;
+}
+
+static int run_bench(PlanRunner& runner, long iterations, int rows) {
+    const InferencePlan& plan = runner.get_plan();
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> input(static_cast<size_t>(rows) * plan.input_features);
+    std::vector<float> output(static_cast<size_t>(rows) * plan.output_features);
+    for (float& v : input) v = dist(gen);
+
+    runner.run(input.data(), rows, output.data());   // warm up
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) runner.run(input.data(), rows, output.data());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%ld calls of %d rows: %.2f us/call, %.0f rows/s\n", iterations, rows,
+                seconds / iterations * 1e6, iterations * static_cast<double>(rows) / seconds);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 4 && argc != 5) return usage();
+    try {
+        auto plan = std::make_shared<InferencePlan>(InferencePlan::load(argv[1]));
+        PlanRunner runner(plan);
+        if (argc == 2) return run_stdin(runner);
+
+        if (std::string(argv[2]) != "--bench") return usage();
+        long iterations = std::atol(argv[3]);
+        int rows = argc == 5 ? std::atoi(argv[4]) : plan->max_batch;
+        if (iterations < 1 || rows < 1) return usage();
+        std::fprintf(stderr, "%s", plan->summary().c_str());
+        return run_bench(runner, iterations, rows);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}